@@ -22,14 +22,14 @@ int cfb8_init(byte_t* key, EVP_CIPHER_CTX** e, EVP_CIPHER_CTX** d) {
 
 }
 
-int cfb8_encrypt(EVP_CIPHER_CTX* e, byte_t* restrict data, size_t len, byte_t* restrict out) {
+int cfb8_encrypt(EVP_CIPHER_CTX* e, byte_t* data, size_t len, byte_t* out) {
 
 	int out_len = len;
 	return EVP_EncryptUpdate(e, out, &out_len, data, len);
 
 }
 
-int cfb8_decrypt(EVP_CIPHER_CTX* d, byte_t* restrict data, size_t len, byte_t* restrict out) {
+int cfb8_decrypt(EVP_CIPHER_CTX* d, byte_t* data, size_t len, byte_t* out) {
 
 	int out_len = len;
 	return EVP_DecryptUpdate(d, out, &out_len, data, len);
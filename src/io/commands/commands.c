@@ -1,4 +1,6 @@
 #include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
 #include "commands.h"
 #include "graph.h"
 #include "../../motor.h"
@@ -7,6 +9,8 @@
 #include "../../listening/phd/play.h"
 #include "../../plugin/manager.h"
 #include "../../jobs/board.h"
+#include "../../jobs/tick/tick.h"
+#include "../../world/edit.h"
 #include "../logger/logger.h"
 
 utl_tree_t cmd_handlers = UTL_TREE_INITIALIZER;
@@ -15,7 +19,9 @@ UTL_VECTOR_DEFAULT(cmd_list, cmd_command_t*,
 	&cmd_stop_h,
 	&cmd_help_h,
 	&cmd_plugins_h,
-	&cmd_jb_h
+	&cmd_jb_h,
+	&cmd_mspt_h,
+	&cmd_edit_h
 );
 
 void cmd_add_defaults() {
@@ -284,4 +290,111 @@ bool cmd_jb(char* args, const cmd_sender_t* sender) {
 
 	return true;
 
+}
+
+bool cmd_mspt(char* args, const cmd_sender_t* sender) {
+
+	if (args != NULL) {
+		return false;
+	}
+
+	float64_t phases[tck_phase_count];
+	float64_t total = 0;
+
+	for (tck_phase_t phase = 0; phase < tck_phase_count; ++phase) {
+		phases[phase] = tck_get_mspt(phase);
+		total += phases[phase];
+	}
+
+	char mspt[256];
+	size_t mspt_len = sprintf(mspt, "MSPT: %.2f (", total);
+
+	for (tck_phase_t phase = 0; phase < tck_phase_count; ++phase) {
+		mspt_len += sprintf(mspt + mspt_len, "%s%s %.2f", phase == 0 ? "" : ", ", tck_get_phase_name(phase), phases[phase]);
+	}
+
+	mspt_len += sprintf(mspt + mspt_len, ")");
+
+	cht_component_t msg = cht_new;
+	msg.text = UTL_ARRTOSTR(mspt, mspt_len);
+
+	cmd_message(sender, &msg);
+
+	return true;
+
+}
+
+// the blocks last copied with /edit copy, shared by every sender
+static struct {
+
+	pthread_mutex_t lock;
+	wld_clipboard_t* clipboard;
+
+} cmd_edit_clipboard = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.clipboard = NULL
+};
+
+static bool cmd_edit_is_block(mat_block_protocol_id_t block, void* type) {
+	return mat_get_block_type_by_protocol_id(block) == *(mat_block_type_t*) type;
+}
+
+bool cmd_edit(char* args, const cmd_sender_t* sender) {
+
+	if (args == NULL) {
+		return false;
+	}
+
+	char operation[8];
+	int32_t x1, z1, x2, z2;
+	int16_t y1, y2;
+	char from_name[64];
+	char to_name[64];
+
+	const int read = sscanf(args, "%7s %d %hd %d %d %hd %d %63s %63s", operation, &x1, &y1, &z1, &x2, &y2, &z2, from_name, to_name);
+
+	// blocks are given by name, like stone or minecraft:stone
+	const mat_block_type_t from = read >= 8 ? mat_get_block_type_by_name(from_name, strlen(from_name)) : mat_block_count;
+	const mat_block_type_t to = read >= 9 ? mat_get_block_type_by_name(to_name, strlen(to_name)) : mat_block_count;
+
+	wld_world_t* world = wld_get_default();
+	uint64_t changed = 0;
+	uint64_t copied = 0;
+
+	if (read == 8 && strcmp(operation, "fill") == 0 && from < mat_block_count) {
+		changed = wld_fill_blocks(world, x1, y1, z1, x2, y2, z2, mat_get_block_default_protocol_id_by_type(from));
+	} else if (read == 9 && strcmp(operation, "replace") == 0 && from < mat_block_count && to < mat_block_count) {
+		mat_block_type_t type = from;
+		changed = wld_replace_blocks(world, x1, y1, z1, x2, y2, z2, cmd_edit_is_block, &type, mat_get_block_default_protocol_id_by_type(to));
+	} else if (read == 7 && strcmp(operation, "copy") == 0) {
+		wld_clipboard_t* clipboard = wld_copy_blocks(world, x1, y1, z1, x2, y2, z2);
+		if (clipboard != NULL) {
+			copied = (uint64_t) clipboard->width * clipboard->length * clipboard->height;
+		}
+		with_lock (&cmd_edit_clipboard.lock) {
+			if (cmd_edit_clipboard.clipboard != NULL) {
+				wld_free_clipboard(cmd_edit_clipboard.clipboard);
+			}
+			cmd_edit_clipboard.clipboard = clipboard;
+		}
+	} else if (read == 4 && strcmp(operation, "paste") == 0) {
+		with_lock (&cmd_edit_clipboard.lock) {
+			if (cmd_edit_clipboard.clipboard != NULL) {
+				changed = wld_paste_blocks(world, cmd_edit_clipboard.clipboard, x1, y1, z1);
+			}
+		}
+	} else {
+		return false;
+	}
+
+	char message[64];
+	const size_t message_len = strcmp(operation, "copy") == 0 ? sprintf(message, "Copied %" PRIu64 " blocks", copied) : sprintf(message, "Changed %" PRIu64 " blocks", changed);
+
+	cht_component_t msg = cht_new;
+	msg.text = UTL_ARRTOSTR(message, message_len);
+
+	cmd_message(sender, &msg);
+
+	return true;
+
 }
\ No newline at end of file
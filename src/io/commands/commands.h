@@ -125,6 +125,8 @@ extern bool cmd_stop(char*, const cmd_sender_t*);
 extern bool cmd_help(char*, const cmd_sender_t*);
 extern bool cmd_plugins(char*, const cmd_sender_t*);
 extern bool cmd_jb(char*, const cmd_sender_t*);
+extern bool cmd_mspt(char*, const cmd_sender_t*);
+extern bool cmd_edit(char*, const cmd_sender_t*);
 
 static const cmd_command_t cmd_stop_h = {
 	.label = UTL_CSTRTOSTR("stop"),
@@ -155,6 +157,20 @@ static const cmd_command_t cmd_jb_h = {
 	.handler = cmd_jb
 };
 
+static const cmd_command_t cmd_mspt_h = {
+	.label = UTL_CSTRTOSTR("mspt"),
+	.description = UTL_CSTRTOSTR("Get the milliseconds each phase of a tick took on average"),
+	.handler = cmd_mspt
+};
+
+static const cmd_command_t cmd_edit_h = {
+	.label = UTL_CSTRTOSTR("edit"),
+	.description = UTL_CSTRTOSTR("Fill, replace, copy and paste blocks of the default world"),
+	.usage = UTL_CSTRTOSTR("Usage: /edit fill <x1> <y1> <z1> <x2> <y2> <z2> <block> | replace <x1> <y1> <z1> <x2> <y2> <z2> <block> <block> | copy <x1> <y1> <z1> <x2> <y2> <z2> | paste <x> <y> <z>"),
+	.permission = UTL_CSTRTOSTR("server.edit"),
+	.handler = cmd_edit
+};
+
 /* CONSTANT MESSAGES */
 static const cht_component_t cmd_no_permission = {
 	.text = UTL_CSTRTOSTR("You don't have permission to use this command!"),
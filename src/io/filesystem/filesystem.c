@@ -71,7 +71,8 @@ bool fs_get_dir_contents(const char* path, const char* extension, void (*handler
 		size_t extension_len = strnlen(extension, PATH_MAX);
 
 		while ((dir = readdir(d)) != NULL) {
-			if (strcmp(dir->d_name + (strnlen(dir->d_name, PATH_MAX) - extension_len), extension) == 0) {
+			const size_t name_len = strnlen(dir->d_name, PATH_MAX);
+			if (name_len >= extension_len && strcmp(dir->d_name + (name_len - extension_len), extension) == 0) {
 				handler(dir->d_name);
 			}
 		}
@@ -94,4 +95,19 @@ bool fs_file_exists(const char* path) {
 
 	return false;
 
+}
+
+// removes a file or an empty directory
+bool fs_remove(const char* path) {
+
+#ifdef __WINDOWS__
+	if (fs_dir_exists(path)) {
+		return RemoveDirectoryA((LPCSTR) path) ? true : false;
+	}
+
+	return DeleteFileA((LPCSTR) path) ? true : false;
+#else
+	return remove(path) == 0 ? true : false;
+#endif
+
 }
\ No newline at end of file
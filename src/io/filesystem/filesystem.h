@@ -6,4 +6,6 @@ extern bool fs_dir_exists(const char*);
 
 extern bool fs_get_dir_contents(const char*, const char*, void (*) (const char*));
 
-extern bool fs_file_exists(const char*);
\ No newline at end of file
+extern bool fs_file_exists(const char*);
+
+extern bool fs_remove(const char*);
\ No newline at end of file
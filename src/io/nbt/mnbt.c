@@ -306,17 +306,28 @@ size_t mnbt_write(mnbt_doc* document, uint8_t* bytes, mnbt_compression compressi
 			return length;
 		}
 		case MNBT_GZIP: {
+			// libdeflate can't compress in place
+			uint8_t* uncompressed = malloc(length);
+			memcpy(uncompressed, bytes, length);
+
 			struct libdeflate_compressor* compressor = libdeflate_alloc_compressor(6);
-			length = libdeflate_gzip_compress(compressor, bytes, length, bytes, length * 4);
+			length = libdeflate_gzip_compress(compressor, uncompressed, length, bytes, length * 4);
 			libdeflate_free_compressor(compressor);
 
+			free(uncompressed);
+
 			return length;
 		}
 		case MNBT_ZLIB: {
+			uint8_t* uncompressed = malloc(length);
+			memcpy(uncompressed, bytes, length);
+
 			struct libdeflate_compressor* compressor = libdeflate_alloc_compressor(6);
-			length = libdeflate_zlib_compress(compressor, bytes, length, bytes, length * 4);
+			length = libdeflate_zlib_compress(compressor, uncompressed, length, bytes, length * 4);
 			libdeflate_free_compressor(compressor);
 
+			free(uncompressed);
+
 			return length;
 		}
 		default: {
@@ -333,6 +344,10 @@ size_t mnbt_write_file(mnbt_doc* document, const char* file, size_t max_file_len
 
 	FILE* f = fopen(file, "wb");
 
+	if (f == NULL) {
+		return 0;
+	}
+
 	fwrite(buffer, size, 1, f);
 
 	fclose(f);
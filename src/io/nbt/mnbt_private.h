@@ -34,12 +34,12 @@ static inline uint64_t _mnbt_reverse_long(uint64_t num) {
 #else
 	return
 		((num & 0xff00000000000000L) >> 56) |
-		((num & 0x00ff000000000000L) >> 48) |
+		((num & 0x00ff000000000000L) >> 40) |
 		((num & 0x0000ff0000000000L) >> 24) |
 		((num & 0x000000ff00000000L) >> 8) |
 		((num & 0x00000000ff000000L) << 8) |
 		((num & 0x0000000000ff0000L) << 24) |
-		((num & 0x000000000000ff00L) << 48) |
+		((num & 0x000000000000ff00L) << 40) |
 		(num << 56);
 #endif
 }
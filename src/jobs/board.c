@@ -1,5 +1,8 @@
+#include <stdlib.h>
 #include "board.h"
 #include "handlers.h"
+#include "tick/tick.h"
+#include "../io/logger/logger.h"
 #include "../motor.h"
 #include "../util/vector.h"
 
@@ -36,12 +39,6 @@ UTL_VECTOR_DEFAULT(job_entity_move_handlers, job_handler_t,
 UTL_VECTOR_DEFAULT(job_entity_teleport_handlers, job_handler_t,
 	job_handle_entity_teleport
 );
-UTL_VECTOR_DEFAULT(job_living_entity_look_handlers, job_handler_t,
-	job_handle_living_entity_look
-);
-UTL_VECTOR_DEFAULT(job_living_entity_move_look_handlers, job_handler_t,
-	job_handle_living_entity_move_look
-);
 UTL_VECTOR_DEFAULT(job_living_entity_teleport_look_handlers, job_handler_t,
 	job_handle_living_entity_teleport_look
 );
@@ -51,6 +48,18 @@ UTL_VECTOR_DEFAULT(job_living_entity_damage_handlers, job_handler_t,
 UTL_VECTOR_DEFAULT(job_tick_world_handlers, job_handler_t,
 	job_handle_tick_world
 );
+UTL_VECTOR_DEFAULT(job_save_world_handlers, job_handler_t,
+	job_handle_save_world
+);
+UTL_VECTOR_DEFAULT(job_chunk_loaded_handlers, job_handler_t,
+	job_handle_chunk_loaded
+);
+UTL_VECTOR_DEFAULT(job_edit_world_handlers, job_handler_t,
+	job_handle_edit_world
+);
+UTL_VECTOR_DEFAULT(job_update_region_blocks_handlers, job_handler_t,
+	job_handle_update_region_blocks
+);
 
 UTL_VECTOR_DEFAULT(job_handlers, utl_vector_t*,
 	&job_keep_alive_handlers,
@@ -63,41 +72,121 @@ UTL_VECTOR_DEFAULT(job_handlers, utl_vector_t*,
 	&job_dig_block_handlers,
 	&job_entity_move_handlers,
 	&job_entity_teleport_handlers,
-	&job_living_entity_look_handlers,
-	&job_living_entity_move_look_handlers,
 	&job_living_entity_teleport_look_handlers,
 	&job_living_entity_damage_handlers,
 	&job_tick_world_handlers,
+	&job_save_world_handlers,
+	&job_chunk_loaded_handlers,
+	&job_edit_world_handlers,
+	&job_update_region_blocks_handlers,
 );
 
 job_board_t job_board = {
 	.queue = {
 		.lock = PTHREAD_MUTEX_INITIALIZER,
-		.wait = PTHREAD_COND_INITIALIZER,
 		.list = UTL_LIST_INITIALIZER(uint32_t)
 	},
+	.idle = {
+		.lock = PTHREAD_MUTEX_INITIALIZER,
+		.wait = PTHREAD_COND_INITIALIZER,
+		.sleeping = 0
+	},
+	.pending = 0,
+	.next_worker = 0,
 	.heap = {
+		.pages = { NULL },
 		.lock = PTHREAD_MUTEX_INITIALIZER,
-		.jobs = UTL_ID_VECTOR_INITIALIZER(job_work_t)
+		.allocated = 0,
+		.unused = 0
 	}
 };
 
-uint32_t job_new(job_type_t type, const job_payload_t payload) {
+// the worker running on this thread, NULL on threads that aren't workers
+static _Thread_local sky_worker_t* job_worker = NULL;
 
-	const job_work_t init = {
-		.type = type,
-		.payload = payload
-	};
+static inline job_work_t* job_get_slot(uint32_t index) {
+	return &job_board.heap.pages[index >> JOB_SLAB_PAGE_BITS][index & (JOB_SLAB_PAGE_SIZE - 1)];
+}
 
-	uint32_t id = 0;
+// the id the slot gets after this one
+static inline uint32_t job_next_id(uint32_t id) {
 
-	with_lock (&job_board.heap.lock) {
+	uint32_t generation = ((id >> JOB_ID_INDEX_BITS) + 1) & (UINT32_MAX >> JOB_ID_INDEX_BITS);
+	if (generation == 0) {
+		generation = 1;
+	}
+
+	return (generation << JOB_ID_INDEX_BITS) | (id & JOB_ID_INDEX_MASK);
 
-		id = utl_id_vector_push(&job_board.heap.jobs, &init);
+}
 
+// takes an unused slot, or one that was never used when there are none
+static job_work_t* job_take_slot() {
+
+	uint64_t unused = job_board.heap.unused;
+
+	while ((uint32_t) unused != 0) {
+
+		const job_work_t* first = job_get_slot((uint32_t) unused - 1);
+		const uint64_t next = (((unused >> 32) + 1) << 32) | first->next_unused;
+
+		if (atomic_compare_exchange_weak(&job_board.heap.unused, &unused, next)) {
+			return job_get_slot((uint32_t) unused - 1);
+		}
+
+	}
+
+	const uint32_t index = job_board.heap.allocated++;
+
+	if (index > JOB_ID_INDEX_MASK) {
+		log_error("Too many jobs, the job board only holds %d", JOB_ID_INDEX_MASK + 1);
+		abort();
+	}
+
+	const uint32_t page = index >> JOB_SLAB_PAGE_BITS;
+
+	if (job_board.heap.pages[page] == NULL) {
+		with_lock (&job_board.heap.lock) {
+			if (job_board.heap.pages[page] == NULL) {
+				job_work_t* slots = calloc(JOB_SLAB_PAGE_SIZE, sizeof(job_work_t));
+				for (uint32_t i = 0; i < JOB_SLAB_PAGE_SIZE; ++i) {
+					slots[i].id = job_next_id((page << JOB_SLAB_PAGE_BITS) | i);
+				}
+				job_board.heap.pages[page] = slots;
+			}
+		}
 	}
 
-	return id;
+	return job_get_slot(index);
+
+}
+
+// puts the slot back, old ids stop finding it
+static void job_release_slot(job_work_t* work) {
+
+	const uint32_t index = work->id & JOB_ID_INDEX_MASK;
+
+	work->id = job_next_id(work->id);
+
+	uint64_t unused = job_board.heap.unused;
+
+	do {
+		work->next_unused = (uint32_t) unused;
+	} while (!atomic_compare_exchange_weak(&job_board.heap.unused, &unused, (((unused >> 32) + 1) << 32) | (index + 1)));
+
+}
+
+uint32_t job_new(job_type_t type, const job_payload_t payload) {
+
+	job_work_t* work = job_take_slot();
+
+	work->type = type;
+	work->canceled = false;
+	work->on_board = 0;
+	work->repeat = 0;
+	work->payload = payload;
+
+	return work->id;
 
 }
 
@@ -109,18 +198,24 @@ void job_add_handler(job_type_t job, job_handler_t handler) {
 
 void job_handle(uint32_t id) {
 
-	job_type_t type = job_count;
-	job_payload_t payload = { .client = NULL };
-	with_lock (&job_board.heap.lock) {
-		job_work_t* work = utl_id_vector_get(&job_board.heap.jobs, id);
-		if (work == NULL || work->canceled) {
-			pthread_mutex_unlock(&job_board.heap.lock);
-			return;
+	const job_work_t* work = job_get_work(id);
+
+	// a job holds its slot while it's on the board so its id can't be stale here, a stale id couldn't tell which phase to finish
+	assert(work != NULL);
+
+	const job_type_t type = work->type;
+	const tck_phase_t phase = tck_get_job_phase(type);
+
+	if (work->canceled) {
+		job_free(id);
+		if (phase != tck_phase_count) {
+			tck_done(phase);
 		}
-		type = work->type;
-		payload = work->payload;
+		return;
 	}
 
+	job_payload_t payload = work->payload;
+
 	utl_vector_t* work_handlers = UTL_VECTOR_GET_AS(utl_vector_t*, &job_handlers, type);
 
 	if (work_handlers != NULL) {
@@ -138,107 +233,218 @@ void job_handle(uint32_t id) {
 
 	job_free(id);
 
+	if (phase != tck_phase_count) {
+		tck_done(phase);
+	}
+
 }
 
 void job_add(uint32_t id) {
 	
-	job_work_t* work = utl_id_vector_get(&job_board.heap.jobs, id);
+	job_work_t* work = job_get_work(id);
+
+	work->on_board++;
+
+	job_push(id);
+
+}
+
+void job_defer(uint32_t id) {
+
+	job_work_t* work = job_get_work(id);
+	const tck_phase_t phase = tck_get_job_phase(work->type);
 
 	work->on_board++;
 
-	with_lock (&job_board.queue.lock) {
-		utl_list_push(&job_board.queue.list, &id);
+	if (phase != tck_phase_count) {
+		tck_defer(phase, id);
+	} else {
+		job_post(id);
 	}
 
-	with_lock (&job_board.queue.lock) {
-		pthread_cond_signal(&job_board.queue.wait);
+}
+
+void job_push(uint32_t id) {
+
+	const tck_phase_t phase = tck_get_job_phase(job_get_type(id));
+
+	if (phase != tck_phase_count) {
+		tck_add(phase, id);
+	} else {
+		job_post(id);
+	}
+
+}
+
+void job_post(uint32_t id) {
+
+	if (job_worker != NULL) {
+
+		// jobs added while working stay with the worker, it'll most likely get to them first
+		utl_deque_push(&job_worker->jobs.local, id);
+
+	} else if (sky_get_worker_count() != 0) {
+
+		sky_worker_t* worker = UTL_VECTOR_GET_AS(sky_worker_t*, &sky_main.workers.vector, job_board.next_worker++ % sky_get_worker_count());
+
+		with_lock (&worker->jobs.inbox.lock) {
+			utl_list_push(&worker->jobs.inbox.list, &id);
+		}
+
+	} else {
+
+		with_lock (&job_board.queue.lock) {
+			utl_list_push(&job_board.queue.list, &id);
+		}
+
+	}
+
+	// counted after the job can be found, a worker that sees no pending jobs goes to sleep only after this checks for sleeping workers
+	job_board.pending++;
+
+	if (job_board.idle.sleeping != 0) {
+		with_lock (&job_board.idle.lock) {
+			pthread_cond_signal(&job_board.idle.wait);
+		}
 	}
 
 }
 
 void job_resume() {
 
-	with_lock (&job_board.queue.lock) {
-		pthread_cond_broadcast(&job_board.queue.wait);
+	with_lock (&job_board.idle.lock) {
+		pthread_cond_broadcast(&job_board.idle.wait);
 	}
 
 }
 
 void job_free(uint32_t id) {
 
-	with_lock (&job_board.heap.lock) {
-		job_work_t* work = utl_id_vector_get(&job_board.heap.jobs, id);
+	job_work_t* work = job_get_work(id);
+
+	if (work == NULL) {
+		return;
+	}
+
+	if (--work->on_board != 0) {
+		return;
+	}
+
+	job_release_slot(work);
+
+}
+
+void job_init_queue(job_queue_t* queue) {
+
+	queue->local.top = 0;
+	queue->local.bottom = 0;
+	queue->local.buffer = NULL;
 
-		work->on_board--;
+	pthread_mutex_init(&queue->inbox.lock, NULL);
+	utl_init_list(&queue->inbox.list, sizeof(uint32_t));
 
-		if (work->repeat || work->on_board != 0) {
-			pthread_mutex_unlock(&job_board.heap.lock);
-			return;
+}
+
+// takes the first job in the list, if there is one
+static bool job_list_take(pthread_mutex_t* lock, utl_list_t* list, uint32_t* job) {
+
+	bool taken = false;
+
+	with_lock (lock) {
+		if (list->length != 0) {
+			memcpy(job, utl_list_first(list), sizeof(uint32_t));
+			utl_list_shift(list);
+			taken = true;
+		}
+	}
+
+	return taken;
+
+}
+
+// takes the oldest job of another worker, starting with the next one so thieves spread out
+static bool job_steal(const sky_worker_t* thief, uint32_t* job) {
+
+	const size_t count = sky_get_worker_count();
+
+	for (size_t i = 1; i < count; ++i) {
+
+		sky_worker_t* worker = UTL_VECTOR_GET_AS(sky_worker_t*, &sky_main.workers.vector, (thief->id + i) % count);
+
+		if (utl_deque_steal(&worker->jobs.local, job)) {
+			return true;
+		}
+
+		if (worker->jobs.inbox.list.length != 0 && job_list_take(&worker->jobs.inbox.lock, &worker->jobs.inbox.list, job)) {
+			return true;
 		}
 
-		utl_id_vector_remove(&job_board.heap.jobs, id);
 	}
 
+	return false;
+
 }
 
-uint32_t job_get() {
+uint32_t job_get(sky_worker_t* worker) {
 
 	uint32_t job = 0;
 
-	// wait for jobs
-	with_lock (&job_board.queue.lock) {
-	
-		while (job_board.queue.list.length == 0) {
-		
-			if (sky_get_status() == sky_stopping) {
+	for (;;) {
+
+		if (
+			utl_deque_pop(&worker->jobs.local, &job) ||
+			(worker->jobs.inbox.list.length != 0 && job_list_take(&worker->jobs.inbox.lock, &worker->jobs.inbox.list, &job)) ||
+			job_steal(worker, &job) ||
+			(job_board.queue.list.length != 0 && job_list_take(&job_board.queue.lock, &job_board.queue.list, &job))
+		) {
+			job_board.pending--;
+			return job;
+		}
+
+		if (sky_get_status() == sky_stopping) {
+			return 0;
+		}
 
-				pthread_mutex_unlock(&job_board.queue.lock);
+		// wait for jobs, unless one was added since looking
+		with_lock (&job_board.idle.lock) {
 
-				return 0;
+			job_board.idle.sleeping++;
 
+			if (job_board.pending == 0 && sky_get_status() != sky_stopping) {
+				pthread_cond_wait(&job_board.idle.wait, &job_board.idle.lock);
 			}
 
-			pthread_cond_wait(&job_board.queue.wait, &job_board.queue.lock);
-		
+			job_board.idle.sleeping--;
+
 		}
-		
-		memcpy(&job, utl_list_first(&job_board.queue.list), sizeof(uint32_t));
-		utl_list_shift(&job_board.queue.list);
 
 	}
 
-	return job;
-
 }
 
 size_t job_get_count() {
 
-	size_t length = 0;
-
-	with_lock (&job_board.queue.lock) {
-		length = job_board.queue.list.length;
-	}
-
-	return length;
+	return job_board.pending;
 
 }
 
 job_type_t job_get_type(uint32_t job) {
 
-	job_type_t type = job_count;
+	const job_work_t* work = job_get_work(job);
 
-	with_lock (&job_board.heap.lock) {
-		job_work_t* work = utl_id_vector_get(&job_board.heap.jobs, job);
-		type = work->type;
+	if (work == NULL) {
+		return job_count;
 	}
 
-	return type;
+	return work->type;
 
 }
 
 void job_work(sky_worker_t* worker) {
 
-	const uint32_t job = job_get();
+	job_worker = worker;
+
+	const uint32_t job = job_get(worker);
 	worker->job = job;
 	job_handle(job);
 
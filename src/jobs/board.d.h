@@ -1,6 +1,7 @@
 #pragma once
 
 typedef struct job_board job_board_t;
+typedef struct job_queue job_queue_t;
 
 typedef enum {
 
@@ -14,11 +15,13 @@ typedef enum {
 	job_dig_block,
 	job_entity_move,
 	job_entity_teleport,
-	job_living_entity_look,
-	job_living_entity_move_look,
 	job_living_entity_teleport_look,
 	job_living_entity_damage,
 	job_tick_world,
+	job_save_world,
+	job_chunk_loaded,
+	job_edit_world,
+	job_update_region_blocks,
 
 	job_count
 
@@ -11,18 +11,67 @@
 
 #include "../main.h"
 #include "../util/list.h"
+#include "../util/deque.h"
+
+/*
+ * A job id is the index of its slot in the low bits and the generation of the slot in the high bits,
+ * the generation goes up every time the slot is freed so old ids don't find the job that reused it,
+ * it's never 0 so 0 is never a job
+ *
+ * The generation has 12 bits and wraps after the slot is reused 4095 times, so an id is only kept while its job is on the board
+ * or in the scheduler, and dropped once the job is done, an id kept longer could find another job
+ */
+#define JOB_ID_INDEX_BITS 20
+#define JOB_ID_INDEX_MASK ((1 << JOB_ID_INDEX_BITS) - 1)
+#define JOB_SLAB_PAGE_BITS 10
+#define JOB_SLAB_PAGE_SIZE (1 << JOB_SLAB_PAGE_BITS)
+#define JOB_SLAB_PAGES (1 << (JOB_ID_INDEX_BITS - JOB_SLAB_PAGE_BITS))
+
+// the jobs of a worker, it works its own jobs first and steals from the other workers when it runs out
+struct job_queue {
+
+	// jobs added by the worker itself, other workers steal from the other end
+	utl_deque_t local;
+
+	// jobs added by threads that aren't workers
+	struct {
+		pthread_mutex_t lock;
+		utl_list_t list;
+	} inbox;
+
+};
 
 struct job_board {
 
+	// jobs added before there were any workers
 	struct {
 		pthread_mutex_t lock;
-		pthread_cond_t wait;
 		utl_list_t list;
 	} queue;
 
+	// workers with nothing to do wait here
 	struct {
 		pthread_mutex_t lock;
-		utl_id_vector_t jobs;
+		pthread_cond_t wait;
+		atomic_uint_fast32_t sleeping;
+	} idle;
+
+	// jobs on the board that no worker has taken yet
+	atomic_size_t pending;
+
+	// the worker that gets the next job added by a thread that isn't a worker
+	atomic_uint_fast32_t next_worker;
+
+	// every job, in pages that are never moved or freed so a job can be read without locking
+	struct {
+		job_work_t* _Atomic pages[JOB_SLAB_PAGES];
+		pthread_mutex_t lock; // only for adding pages
+
+		// slots handed out at least once
+		_Atomic uint32_t allocated;
+
+		// the index + 1 of the first unused slot in the low half, counted up with every change in the high half so a slot taken and put back between reading and swapping isn't missed
+		_Atomic uint64_t unused;
 	} heap;
 
 };
@@ -60,19 +109,10 @@ union job_payload {
 
 	wld_region_t* region;
 
-	struct {
+	wld_chunk_t* chunk;
 
-		ent_entity_t* entity;
-		
-		wld_chunk_t* initial_chunk;
-
-		float64_t d_x;
-		float64_t d_y;
-		float64_t d_z;
-
-		bool on_ground;
-
-	} entity_move;
+	wld_edit_t* edit;
+	ent_entity_t* entity;
 
 	struct {
 
@@ -90,34 +130,6 @@ union job_payload {
 
 	} entity_teleport;
 
-	struct {
-
-		ent_living_entity_t* entity;
-
-		float32_t yaw;
-		float32_t pitch;
-
-		bool on_ground;
-
-	} living_entity_look;
-
-	struct {
-
-		ent_living_entity_t* entity;
-		
-		wld_chunk_t* initial_chunk;
-
-		float64_t d_x;
-		float64_t d_y;
-		float64_t d_z;
-
-		float32_t yaw;
-		float32_t pitch;
-
-		bool on_ground;
-
-	} living_entity_move_look;
-
 	struct {
 
 		ent_living_entity_t* entity;
@@ -151,15 +163,42 @@ union job_payload {
 
 struct job_work {
 
-	const job_type_t type : 4;
-	uint8_t repeat;
-	uint8_t on_board;
+	// the id of the job using the slot, or the id the next one will get
+	_Atomic uint32_t id;
+
+	// the index + 1 of the next unused slot while this one is unused
+	uint32_t next_unused;
+
+	job_type_t type : 5;
 	bool canceled;
 
+	// times the job is on the board or in the scheduler, it's freed when this gets back to 0
+	_Atomic uint8_t on_board;
+	uint32_t repeat;
+
 	job_payload_t payload;
 
 };
 
+// gets the job with the id, NULL when it was freed
+static inline job_work_t* job_get_work(uint32_t id) {
+
+	const uint32_t index = id & JOB_ID_INDEX_MASK;
+
+	if (index >= job_board.heap.allocated) {
+		return NULL;
+	}
+
+	job_work_t* page = job_board.heap.pages[index >> JOB_SLAB_PAGE_BITS];
+
+	if (page == NULL || page[index & (JOB_SLAB_PAGE_SIZE - 1)].id != id) {
+		return NULL;
+	}
+
+	return &page[index & (JOB_SLAB_PAGE_SIZE - 1)];
+
+}
+
 extern uint32_t job_new(job_type_t type, job_payload_t payload);
 
 typedef bool (*job_handler_t) (job_payload_t* payload);
@@ -167,11 +206,22 @@ typedef bool (*job_handler_t) (job_payload_t* payload);
 extern void job_add_handler(job_type_t type, job_handler_t handler);
 extern void job_handle(uint32_t id);
 extern void job_add(uint32_t id);
+
+// adds the job to the next tick instead of the one running, a job of a phase adding itself again would keep the phase from ending
+extern void job_defer(uint32_t id);
+
+// puts the job on the board without counting it as added again, for the scheduler
+extern void job_push(uint32_t id);
+
+// gives the job to a worker right away, even when it belongs to a tick phase that isn't running
+extern void job_post(uint32_t id);
 extern void job_resume();
 
 extern void job_free(uint32_t id);
 
-extern uint32_t job_get();
+extern void job_init_queue(job_queue_t* queue);
+
+extern uint32_t job_get(sky_worker_t* worker);
 
 extern size_t job_get_count();
 extern job_type_t job_get_type(uint32_t job);
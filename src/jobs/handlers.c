@@ -5,6 +5,8 @@
 #include "../io/logger/logger.h"
 #include "../motor.h"
 #include "../world/entity/living/player/player.h"
+#include "../world/edit.h"
+#include "tick/tick.h"
 
 bool job_handle_keep_alive(job_payload_t* payload) {
 	
@@ -42,13 +44,16 @@ bool job_handle_global_chat_message(job_payload_t* payload) {
 	char out[1536];
 	const size_t out_len = cht_write_translation(&translation, out);
 
+	ltg_broadcast_t* chat_message = phd_broadcast_chat_message(out, out_len, ltg_client_get_uuid(payload->global_chat_message.client));
+
 	const uint32_t online_length = ltg_get_online_length(sky_get_listener());
 	for (uint32_t i = 0; i < online_length; ++i) {
 		ltg_client_t* client = ltg_get_online_client(sky_get_listener(), i);
 		if (client != NULL) {
-			phd_send_chat_message(client, out, out_len, ltg_client_get_uuid(payload->global_chat_message.client));
+			ltg_send_broadcast(client, chat_message);
 		}
 	}
+	ltg_broadcast_release(chat_message);
 	cht_term_translation(&translation);
 
 	free(payload->global_chat_message.message.value);
@@ -81,16 +86,23 @@ bool job_handle_player_join(job_payload_t* payload) {
 
 	char out[128];
 	const size_t out_len = cht_write_translation(&translation, out);
+
+	ltg_broadcast_t* player_info = phd_broadcast_player_info_add_player(payload->client);
+	ltg_broadcast_t* chat_message = phd_broadcast_system_chat_message(out, out_len);
+
 	// lock client vector
 	const uint32_t online_length = ltg_get_online_length(sky_get_listener());
 	for (uint32_t i = 0; i < online_length; ++i) {
 		ltg_client_t* client = ltg_get_online_client(sky_get_listener(), i);
 		if (client != NULL) {
-			phd_send_player_info_add_player(client, payload->client);
-			phd_send_system_chat_message(client, out, out_len);
+			ltg_send_broadcast(client, player_info);
+			ltg_send_broadcast(client, chat_message);
 		}
 	}
 
+	ltg_broadcast_release(player_info);
+	ltg_broadcast_release(chat_message);
+
 	cht_term_translation(&translation);
 
 	ent_entity_t* entity = ent_player_get_entity(ltg_client_get_entity(payload->client));
@@ -117,16 +129,22 @@ bool job_handle_player_leave(job_payload_t* payload) {
 
 	char out[128];
 	const size_t out_len = cht_write_translation(&translation, out);
+
+	ltg_broadcast_t* player_info = phd_broadcast_player_info_remove_player(payload->player_leave.uuid);
+	ltg_broadcast_t* chat_message = phd_broadcast_system_chat_message(out, out_len);
 	
 	const uint32_t online_length = ltg_get_online_length(sky_get_listener());
 	for (uint32_t i = 0; i < online_length; ++i) {
 		ltg_client_t* client = ltg_get_online_client(sky_get_listener(), i);
 		if (client != NULL) {
-			phd_send_player_info_remove_player(client, payload->player_leave.uuid);
-			phd_send_system_chat_message(client, out, out_len);
+			ltg_send_broadcast(client, player_info);
+			ltg_send_broadcast(client, chat_message);
 		}
 	}
 
+	ltg_broadcast_release(player_info);
+	ltg_broadcast_release(chat_message);
+
 	cht_term_translation(&translation);
 
 	return true;
@@ -135,50 +153,282 @@ bool job_handle_player_leave(job_payload_t* payload) {
 
 bool job_handle_send_update_pings(__attribute__((unused)) job_payload_t* payload) {
 
+	ltg_broadcast_t* player_info = phd_broadcast_player_info_update_latency();
+
 	const uint32_t online_length = ltg_get_online_length(sky_get_listener());
 	for (uint32_t i = 0; i < online_length; ++i) {
 		ltg_client_t* client = ltg_get_online_client(sky_get_listener(), i);
 		if (client != NULL) {
-			phd_send_player_info_update_latency(client);
+			ltg_send_broadcast(client, player_info);
 		}
 	}
 
+	ltg_broadcast_release(player_info);
+
 	return true;
 
 }
 
+// relative moves can only be up to 8 blocks
+static inline bool job_is_relative_move(float64_t d_x, float64_t d_y, float64_t d_z) {
+	return UTL_ABS(d_x) < 8 && UTL_ABS(d_y) < 8 && UTL_ABS(d_z) < 8;
+}
+
+// the chunk the entity was in before moving, and the packets for the other clients
+typedef struct {
+
+	ent_entity_t* entity;
+	wld_chunk_t* initial_chunk;
+	uint64_t tick;
+
+	// what changed since the last tick, NULL when nothing did
+	ltg_broadcast_t* packets[2];
+
+	// where the entity is, for viewers that missed some movement, made when the first one is due
+	ltg_broadcast_t* absolute[2];
+
+	// viewers that still miss some movement after this tick
+	uint32_t behind;
+
+	// only for entities moved by the region tick, the chunk the entity is in after moving and whether its store had it behind
+	wld_chunk_t* chunk;
+	bool was_behind;
+
+} job_movement_update_t;
+
+static inline void job_send_entity_position(ltg_client_t* client, job_movement_update_t* update) {
+
+	ent_entity_t* entity = update->entity;
+
+	if (update->absolute[0] == NULL) {
+		if (ent_is_le(entity)) {
+			update->absolute[0] = phd_broadcast_living_entity_teleport((ent_living_entity_t*) entity);
+			update->absolute[1] = phd_broadcast_entity_head_look((ent_living_entity_t*) entity);
+		} else {
+			update->absolute[0] = phd_broadcast_entity_teleport(entity);
+		}
+	}
+
+	for (uint8_t i = 0; i < 2 && update->absolute[i] != NULL; ++i) {
+		ltg_send_broadcast(client, update->absolute[i]);
+	}
+
+}
+
+// sends the movement to the viewer if it's due at its distance, otherwise marks the viewer behind
+static inline void job_send_entity_move(ltg_client_t* client, uint32_t client_id, ent_player_t* viewer, job_movement_update_t* update) {
+
+	ent_entity_t* entity = update->entity;
+
+	// viewers without an entity yet are treated as close by
+	float64_t distance_squared = 0;
+	if (viewer != NULL) {
+		const float64_t d_x = ent_get_x(entity) - ent_get_x(ent_player_get_entity(viewer));
+		const float64_t d_y = ent_get_y(entity) - ent_get_y(ent_player_get_entity(viewer));
+		const float64_t d_z = ent_get_z(entity) - ent_get_z(ent_player_get_entity(viewer));
+		distance_squared = d_x * d_x + d_y * d_y + d_z * d_z;
+	}
+
+	const uint32_t interval = ent_tracker_get_interval(distance_squared);
+	const bool behind = ent_tracker_is_behind(&entity->tracker, client_id);
+
+	if (!ent_tracker_is_due(ent_get_id(entity), client_id, interval, update->tick)) {
+		if (behind || update->packets[0] != NULL) {
+			ent_tracker_set_behind(&entity->tracker, client_id, true);
+			update->behind++;
+		}
+		return;
+	}
+
+	if (behind) {
+		job_send_entity_position(client, update);
+		ent_tracker_set_behind(&entity->tracker, client_id, false);
+	} else {
+		for (uint8_t i = 0; i < 2 && update->packets[i] != NULL; ++i) {
+			ltg_send_broadcast(client, update->packets[i]);
+		}
+	}
+
+}
+
+static inline void job_update_entity_move(uint32_t client_id, void* args) {
+	
+	job_movement_update_t* update = args;
+	ent_entity_t* entity = update->entity;
+	
+	ltg_client_t* client = ltg_get_client_by_id(sky_get_listener(), client_id);
+
+	if (client == NULL) return;
+	
+	ent_player_t* viewer = ltg_client_get_entity(client);
+
+	if (ent_get_type(entity) == ent_player && ent_player_get_entity(viewer) == entity) {
+		if (ent_get_chunk(entity) != update->initial_chunk) {
+			phd_update_sent_chunks_move(client, update->initial_chunk);
+		}
+		return;
+	}
+
+	job_send_entity_move(client, client_id, viewer, update);
+
+}
+
+// the entities the tick moved in one chunk
+typedef struct {
+
+	job_movement_update_t* updates;
+	uint32_t count;
+
+} job_chunk_moves_t;
+
+static void job_update_chunk_moves(uint32_t client_id, void* args) {
+
+	job_chunk_moves_t* moves = args;
+
+	ltg_client_t* client = ltg_get_client_by_id(sky_get_listener(), client_id);
+
+	if (client == NULL) return;
+
+	ent_player_t* viewer = ltg_client_get_entity(client);
+
+	for (uint32_t i = 0; i < moves->count; ++i) {
+		job_send_entity_move(client, client_id, viewer, &moves->updates[i]);
+	}
+
+}
+
+static int job_compare_update_chunks(const void* a, const void* b) {
+
+	const uintptr_t chunk_a = (uintptr_t) ((const job_movement_update_t*) a)->chunk;
+	const uintptr_t chunk_b = (uintptr_t) ((const job_movement_update_t*) b)->chunk;
+
+	return (chunk_a > chunk_b) - (chunk_a < chunk_b);
+
+}
+
+/*
+ * Writes the positions the tick moved the entities to back into them, then sends the movement
+ * of the entities of each chunk to its subscribers at once, so each subscriber is looked up once per chunk
+ */
+static void job_apply_store_moves(utl_vector_t* moved) {
+
+	if (moved->size == 0) {
+		return;
+	}
+
+	const uint64_t tick = tck_get_tick();
+	job_movement_update_t* updates = malloc(sizeof(job_movement_update_t) * moved->size);
+
+	for (uint32_t i = 0; i < moved->size; ++i) {
+
+		const ent_store_move_t* move = utl_vector_get(moved, i);
+		ent_entity_t* entity = move->entity;
+
+		// only the tick moves simulated entities to other chunks, so their chunk is read without locking them
+		updates[i] = (job_movement_update_t) {
+			.entity = entity,
+			.initial_chunk = entity->chunk,
+			.tick = tick,
+			.packets = { NULL, NULL },
+			.absolute = { NULL, NULL },
+			.behind = 0,
+			.chunk = entity->chunk,
+			.was_behind = move->behind
+		};
+
+		const float64_t d_x = move->x - entity->position.x;
+		const float64_t d_y = move->y - entity->position.y;
+		const float64_t d_z = move->z - entity->position.z;
+
+		entity->position.x = move->x;
+		entity->position.y = move->y;
+		entity->position.z = move->z;
+		entity->on_ground = move->on_ground;
+
+		// entities that are only behind didn't move
+		if (d_x == 0 && d_y == 0 && d_z == 0) {
+			continue;
+		}
+
+		if (!wld_in_chunk(updates[i].initial_chunk, ent_get_block_x(entity), ent_get_block_z(entity))) {
+			ent_set_chunk(entity);
+			updates[i].chunk = entity->chunk;
+		}
+
+		if (!job_is_relative_move(d_x, d_y, d_z)) {
+			updates[i].packets[0] = ent_is_le(entity) ? phd_broadcast_living_entity_teleport((ent_living_entity_t*) entity) : phd_broadcast_entity_teleport(entity);
+		} else {
+			updates[i].packets[0] = phd_broadcast_entity_position(entity, d_x, d_y, d_z);
+		}
+
+	}
+
+	qsort(updates, moved->size, sizeof(job_movement_update_t), job_compare_update_chunks);
+
+	for (uint32_t i = 0; i < moved->size;) {
+
+		wld_chunk_t* chunk = updates[i].chunk;
+
+		job_chunk_moves_t moves = {
+			.updates = &updates[i],
+			.count = 0
+		};
+		while (i + moves.count < moved->size && updates[i + moves.count].chunk == chunk) {
+			moves.count++;
+		}
+
+		wld_chunk_subscribers_foreach(chunk, job_update_chunk_moves, &moves);
+
+		i += moves.count;
+
+	}
+
+	for (uint32_t i = 0; i < moved->size; ++i) {
+
+		for (uint8_t j = 0; j < 2; ++j) {
+			if (updates[i].packets[j] != NULL) {
+				ltg_broadcast_release(updates[i].packets[j]);
+			}
+			if (updates[i].absolute[j] != NULL) {
+				ltg_broadcast_release(updates[i].absolute[j]);
+			}
+		}
+
+	}
+
+	// the store only has to be told when it changed
+	for (uint32_t i = 0; i < moved->size; ++i) {
+		if (updates[i].was_behind != (updates[i].behind != 0)) {
+			ent_store_set_behind(updates[i].entity, updates[i].behind != 0);
+		}
+	}
+
+	free(updates);
+
+}
+
 bool job_handle_tick_region(job_payload_t* payload) {
 
 	// TODO what if this region is unloaded by the time this is handled?
 
-	const mat_dimension_t* dimension = mat_get_dimension_by_type(wld_get_environment(wld_region_get_world(payload->region)));
+	wld_region_t* region = payload->region;
+	const mat_dimension_t* dimension = mat_get_dimension_by_type(wld_get_environment(wld_region_get_world(region)));
+
+	bool ticking[32 * 32];
 	
 	for (uint32_t i = 0; i < 32 * 32; ++i) {
 
-		wld_chunk_t* chunk = wld_region_get_chunk_by_idx(payload->region, i);
+		wld_chunk_t* chunk = wld_region_get_chunk_by_idx(region, i);
+
+		ticking[i] = false;
 
 		if (chunk != NULL) {
 
 			chunk->subtick = (chunk->subtick == 199 ? 0 : chunk->subtick + 1);
 
 			if (wld_chunk_get_ticket(chunk) <= WLD_TICKET_TICK_ENTITIES) {
-				// entities and chunk ticks
-				const uint32_t entity_length = wld_chunk_get_entity_length(chunk);
-				for (uint32_t j = 0; j < entity_length; ++j) {
-					ent_entity_t* entity = wld_chunk_get_entity(chunk, j);
-					if (entity != NULL) {
-						// void damage
-						if (ent_get_y(entity) <= (dimension->min_y - 64)) {
-							if (ent_is_le(entity)) {
-								if (chunk->subtick % 10 == 0) {
-									ent_le_damage((ent_living_entity_t*) entity, NULL, 4);
-								}
-							} else {
-								ent_free(entity);
-							}
-						}
-					}
-				}
+				// entities
+				ticking[i] = true;
 			}
 
 			if (wld_chunk_get_ticket(chunk) <= WLD_TICKET_TICK) {
@@ -191,6 +441,45 @@ bool job_handle_tick_region(job_payload_t* payload) {
 		}
 	}
 
+	utl_vector_t moved = UTL_VECTOR_INITIALIZER(ent_store_move_t);
+	utl_vector_t in_void = UTL_VECTOR_INITIALIZER(ent_entity_t*);
+
+	ent_store_tick(&region->entities, region, ticking, dimension->min_y - 64, &moved, &in_void);
+
+	job_apply_store_moves(&moved);
+
+	// void damage
+	for (uint32_t i = 0; i < in_void.size; ++i) {
+		ent_entity_t* entity = UTL_VECTOR_GET_AS(ent_entity_t*, &in_void, i);
+		if (ent_is_le(entity)) {
+			if (ent_get_chunk(entity)->subtick % 10 == 0) {
+				ent_le_damage((ent_living_entity_t*) entity, NULL, 4);
+			}
+		} else {
+			ent_free(entity);
+		}
+	}
+
+	utl_term_vector(&moved);
+	utl_term_vector(&in_void);
+
+	return true;
+
+}
+
+bool job_handle_update_region_blocks(job_payload_t* payload) {
+
+	// runs after every region tick, so it has all the changes of the tick
+	for (uint32_t i = 0; i < 32 * 32; ++i) {
+
+		wld_chunk_t* chunk = wld_region_get_chunk_by_idx(payload->region, i);
+
+		if (chunk != NULL) {
+			phd_update_send_block_changes(chunk);
+		}
+
+	}
+
 	return true;
 
 }
@@ -200,7 +489,15 @@ bool job_handle_unload_region(job_payload_t* payload) {
 	// what if this region is unloaded by the time this is handled?
 
 	if (wld_region_get_loaded_chunks(payload->region) == 0) {
-		wld_unload_region(payload->region);
+
+		// chunks are still being loaded or saved, try again later
+		if (!wld_unload_region(payload->region)) {
+			if (wld_region_get_loaded_chunks(payload->region) == 0) {
+				sch_schedule(job_new(job_unload_region, (job_payload_t) { .region = payload->region }), 100);
+			}
+			return false;
+		}
+
 		return true;
 	}
 
@@ -227,49 +524,106 @@ bool job_handle_dig_block(job_payload_t* payload) {
 
 }
 
-static inline void job_update_entity_move(uint32_t client_id, void* args) {
-	
-	job_payload_t* payload = args;
-	ent_entity_t* entity = payload->entity_move.entity;
-	
-	ltg_client_t* client = ltg_get_client_by_id(sky_get_listener(), client_id);
+// passed to the subscriber callbacks, so packets are only encoded once for all subscribers
+typedef struct {
 
-	if (client == NULL) return;
-	
-	if (ent_get_type(entity) == ent_player && ent_player_get_entity(ltg_client_get_entity(client)) == entity) {
-		if (ent_get_chunk(entity) != payload->entity_move.initial_chunk) {
-			phd_update_sent_chunks_move(client, payload->entity_move.initial_chunk);
-		}
-	} else {
-		phd_send_entity_position(client, entity, payload->entity_move.d_x, payload->entity_move.d_y, payload->entity_move.d_z);
-	}
+	job_payload_t* payload;
+	ltg_broadcast_t* packets[2];
 
-}
+} job_update_t;
 
 bool job_handle_entity_move(job_payload_t* payload) {
 	
 	// what if the entity has been destroyed by the time this is handled? TODO
 
-	ent_entity_t* entity = payload->entity_move.entity;
+	ent_entity_t* entity = payload->entity;
+
+	// everything the entity was told since the last tick, the job stays queued so new movement waits for it
+	ent_movement_t movement = { .moved = false };
+	with_lock (&entity->lock) {
+		movement = entity->movement;
+		entity->movement.moved = false;
+		entity->movement.looked = false;
+	}
+
+	job_movement_update_t update = {
+		.entity = entity,
+		.initial_chunk = ent_get_chunk(entity),
+		.tick = tck_get_tick(),
+		.packets = { NULL, NULL },
+		.absolute = { NULL, NULL },
+		.behind = 0
+	};
+
+	const float64_t d_x = movement.moved ? movement.x - entity->position.x : 0;
+	const float64_t d_y = movement.moved ? movement.y - entity->position.y : 0;
+	const float64_t d_z = movement.moved ? movement.z - entity->position.z : 0;
 
 	// why not +=?
 	// well, Atomic implementations vary from PC to PC and operating system to operating system,
 	// and additions on floats are not very commonly implemented, but set usually is
-	entity->position.x = entity->position.x + payload->entity_move.d_x;
-	entity->position.y = entity->position.y + payload->entity_move.d_y;
-	entity->position.z = entity->position.z + payload->entity_move.d_z;
+	if (movement.moved) {
+		entity->position.x = movement.x;
+		entity->position.y = movement.y;
+		entity->position.z = movement.z;
+	}
+
+	entity->on_ground = movement.on_ground;
 
-	entity->on_ground = payload->entity_move.on_ground;
+	const bool living = ent_is_le(entity);
+	const bool looked = movement.looked && living;
+
+	if (looked) {
+		((ent_living_entity_t*) entity)->rotation.yaw = movement.yaw;
+		((ent_living_entity_t*) entity)->rotation.pitch = movement.pitch;
+	}
 
 	// TODO physics
 
-	if (!wld_in_chunk(ent_get_chunk(entity), ent_get_block_x(entity), ent_get_block_z(entity))) {
+	if (movement.moved && !wld_in_chunk(update.initial_chunk, ent_get_block_x(entity), ent_get_block_z(entity))) {
 		// change chunk
 		ent_set_chunk(entity);
 	}
 
+	ent_store_update(entity);
+
+	if (movement.moved && !job_is_relative_move(d_x, d_y, d_z)) {
+		update.packets[0] = living ? phd_broadcast_living_entity_teleport((ent_living_entity_t*) entity) : phd_broadcast_entity_teleport(entity);
+	} else if (movement.moved && looked) {
+		update.packets[0] = phd_broadcast_entity_position_and_rotation((ent_living_entity_t*) entity, d_x, d_y, d_z);
+	} else if (movement.moved) {
+		update.packets[0] = phd_broadcast_entity_position(entity, d_x, d_y, d_z);
+	} else if (looked) {
+		update.packets[0] = phd_broadcast_entity_rotation((ent_living_entity_t*) entity);
+	}
+
+	if (looked) {
+		update.packets[1] = phd_broadcast_entity_head_look((ent_living_entity_t*) entity);
+	}
+
+	// viewers that are behind are caught up even when nothing changed
 	wld_chunk_t* chunk = ent_get_chunk(entity);
-	wld_chunk_subscribers_foreach(chunk, job_update_entity_move, payload);
+	wld_chunk_subscribers_foreach(chunk, job_update_entity_move, &update);
+
+	for (uint8_t i = 0; i < 2; ++i) {
+		if (update.packets[i] != NULL) {
+			ltg_broadcast_release(update.packets[i]);
+		}
+		if (update.absolute[i] != NULL) {
+			ltg_broadcast_release(update.absolute[i]);
+		}
+	}
+
+	// the job runs again next tick while there's movement it hasn't applied or sent to every viewer
+	bool requeue = false;
+	with_lock (&entity->lock) {
+		requeue = update.behind != 0 || entity->movement.moved || entity->movement.looked;
+		entity->movement.queued = requeue;
+	}
+
+	if (requeue) {
+		job_defer(job_new(job_entity_move, (job_payload_t) { .entity = entity }));
+	}
 
 	return true;
 
@@ -277,7 +631,8 @@ bool job_handle_entity_move(job_payload_t* payload) {
 
 static inline void job_update_entity_teleport(uint32_t client_id, void* args) {
 	
-	job_payload_t* payload = args;
+	job_update_t* update = args;
+	job_payload_t* payload = update->payload;
 	ent_entity_t* entity = payload->entity_teleport.entity;
 	
 	ltg_client_t* client = ltg_get_client_by_id(sky_get_listener(), client_id);
@@ -290,7 +645,7 @@ static inline void job_update_entity_teleport(uint32_t client_id, void* args) {
 		}
 		phd_send_player_position_and_look(client);
 	} else {
-		phd_send_entity_teleport(client, entity);
+		ltg_send_broadcast(client, update->packets[0]);
 	}
 
 }
@@ -299,6 +654,11 @@ bool job_handle_entity_teleport(job_payload_t* payload) {
 
 	ent_entity_t* entity = payload->entity_teleport.entity;
 
+	// a move told before the teleport would put the entity back
+	with_lock (&entity->lock) {
+		entity->movement.moved = false;
+	}
+
 	entity->position.world = payload->entity_teleport.world;
 	entity->position.x = payload->entity_teleport.x;
 	entity->position.y = payload->entity_teleport.y;
@@ -313,89 +673,17 @@ bool job_handle_entity_teleport(job_payload_t* payload) {
 		ent_set_chunk(entity);
 	}
 
-	wld_chunk_t* chunk = ent_get_chunk(entity);
-	wld_chunk_subscribers_foreach(chunk, job_update_entity_teleport, payload);
-
-	return true;
-
-}
-
-static inline void job_update_living_entity_look(uint32_t client_id, void* args) {
-	
-	job_payload_t* payload = args;
-	ent_living_entity_t* entity = payload->living_entity_look.entity;
-	
-	ltg_client_t* client = ltg_get_client_by_id(sky_get_listener(), client_id);
-	
-	if (client == NULL) return;
-
-	if (ent_get_type(ent_le_get_entity(entity)) == ent_player && ent_player_get_le(ltg_client_get_entity(client)) == entity) {
-		// Do nothing
-	} else {
-		phd_send_entity_rotation(client, entity);
-		phd_send_entity_head_look(client, entity);
-	}
-
-}
-
-bool job_handle_living_entity_look(job_payload_t* payload) {
-
-	ent_living_entity_t* entity = payload->living_entity_look.entity;
-
-	entity->rotation.yaw = payload->living_entity_look.yaw;
-	entity->rotation.pitch = payload->living_entity_look.pitch;
-
-	entity->entity.on_ground = payload->living_entity_look.on_ground;
-
-	wld_chunk_t* chunk = ent_get_chunk(ent_le_get_entity(entity));
-	wld_chunk_subscribers_foreach(chunk, job_update_living_entity_look, payload);
-
-	return true;
-
-}
-
-static inline void job_update_living_entity_move_look(uint32_t client_id, void* args) {
-
-	job_payload_t* payload = args;
-	ent_living_entity_t* entity = payload->living_entity_move_look.entity;
-
-	ltg_client_t* client = ltg_get_client_by_id(sky_get_listener(), client_id);
-	
-	if (client == NULL) return;
-
-	if (ent_get_type(ent_le_get_entity(entity)) == ent_player && ent_player_get_le(ltg_client_get_entity(client)) == entity) {
-		if (ent_get_chunk(ent_le_get_entity(entity)) != payload->living_entity_move_look.initial_chunk) {
-			phd_update_sent_chunks_move(client, payload->living_entity_move_look.initial_chunk);
-		}
-	} else {
-		phd_send_entity_position_and_rotation(client, entity, payload->living_entity_move_look.d_x, payload->living_entity_move_look.d_y, payload->living_entity_move_look.d_z);
-		phd_send_entity_head_look(client, entity);
-	}
-	
-}
-
-bool job_handle_living_entity_move_look(job_payload_t* payload) {
-
-	ent_living_entity_t* entity = payload->living_entity_move_look.entity;
-
-	entity->entity.position.x = entity->entity.position.x + payload->living_entity_move_look.d_x;
-	entity->entity.position.y = entity->entity.position.y + payload->living_entity_move_look.d_y;
-	entity->entity.position.z = entity->entity.position.z + payload->living_entity_move_look.d_z;
+	ent_store_update(entity);
 
-	entity->rotation.yaw = payload->living_entity_move_look.yaw;
-	entity->rotation.pitch = payload->living_entity_move_look.pitch;
-
-	entity->entity.on_ground = payload->living_entity_move_look.on_ground;
-
-	// TODO physics
+	job_update_t update = {
+		.payload = payload,
+		.packets = { phd_broadcast_entity_teleport(entity) }
+	};
 
-	if (!wld_in_chunk(ent_get_chunk(ent_le_get_entity(entity)), ent_get_block_x(ent_le_get_entity(entity)), ent_get_block_z(ent_le_get_entity(entity)))) {
-		// change chunk
-		ent_set_chunk(ent_le_get_entity(entity));
-	}
+	wld_chunk_t* chunk = ent_get_chunk(entity);
+	wld_chunk_subscribers_foreach(chunk, job_update_entity_teleport, &update);
 
-	wld_chunk_t* chunk = ent_get_chunk(ent_le_get_entity(entity));
-	wld_chunk_subscribers_foreach(chunk, job_update_living_entity_move_look, payload);
+	ltg_broadcast_release(update.packets[0]);
 
 	return true;
 
@@ -403,7 +691,8 @@ bool job_handle_living_entity_move_look(job_payload_t* payload) {
 
 static inline void job_update_living_entity_teleport_look(uint32_t client_id, void* args) {
 	
-	job_payload_t* payload = args;
+	job_update_t* update = args;
+	job_payload_t* payload = update->payload;
 	ent_living_entity_t* entity = payload->living_entity_teleport_look.entity;
 	
 	ltg_client_t* client = ltg_get_client_by_id(sky_get_listener(), client_id);
@@ -416,8 +705,8 @@ static inline void job_update_living_entity_teleport_look(uint32_t client_id, vo
 		}
 		phd_send_player_position_and_look(client);
 	} else {
-		phd_send_living_entity_teleport(client, entity);
-		phd_send_entity_head_look(client, entity);
+		ltg_send_broadcast(client, update->packets[0]);
+		ltg_send_broadcast(client, update->packets[1]);
 	}
 
 }
@@ -426,6 +715,12 @@ bool job_handle_living_entity_teleport_look(job_payload_t* payload) {
 
 	ent_living_entity_t* entity = payload->living_entity_teleport_look.entity;
 
+	// a move or look told before the teleport would put the entity back
+	with_lock (&entity->entity.lock) {
+		entity->entity.movement.moved = false;
+		entity->entity.movement.looked = false;
+	}
+
 	entity->entity.position.world = payload->living_entity_teleport_look.world;
 
 	entity->entity.position.x = payload->living_entity_teleport_look.x;
@@ -444,8 +739,18 @@ bool job_handle_living_entity_teleport_look(job_payload_t* payload) {
 		ent_set_chunk(ent_le_get_entity(entity));
 	}
 
+	ent_store_update(ent_le_get_entity(entity));
+
+	job_update_t update = {
+		.payload = payload,
+		.packets = { phd_broadcast_living_entity_teleport(entity), phd_broadcast_entity_head_look(entity) }
+	};
+
 	wld_chunk_t* chunk = ent_get_chunk(ent_le_get_entity(entity));
-	wld_chunk_subscribers_foreach(chunk, job_update_living_entity_teleport_look, payload);
+	wld_chunk_subscribers_foreach(chunk, job_update_living_entity_teleport_look, &update);
+
+	ltg_broadcast_release(update.packets[0]);
+	ltg_broadcast_release(update.packets[1]);
 
 	return true;
 
@@ -453,14 +758,15 @@ bool job_handle_living_entity_teleport_look(job_payload_t* payload) {
 
 static inline void job_update_living_entity_damage(uint32_t client_id, void* args) {
 
-	job_payload_t* payload = args;
+	job_update_t* update = args;
+	job_payload_t* payload = update->payload;
 	ent_living_entity_t* entity = payload->living_entity_damage.entity;
 
 	ltg_client_t* client = ltg_get_client_by_id(sky_get_listener(), client_id);
 	
 	if (client == NULL) return;
 
-	phd_send_entity_status(client, ent_le_get_entity(entity), ent_le_is_dead(entity) ? 3 : 2);
+	ltg_send_broadcast(client, update->packets[0]);
 
 	if (payload->living_entity_damage.damage > 0 && ent_get_type(ent_le_get_entity(entity)) == ent_player && ent_player_get_le(ltg_client_get_entity(client)) == entity) {
 		phd_send_update_health(client);
@@ -486,8 +792,15 @@ bool job_handle_living_entity_damage(job_payload_t* payload) {
 
 	entity->health = entity->health - payload->living_entity_damage.damage;
 
+	job_update_t update = {
+		.payload = payload,
+		.packets = { phd_broadcast_entity_status(ent_le_get_entity(entity), ent_le_is_dead(entity) ? 3 : 2) }
+	};
+
 	// play hurt animation
-	wld_chunk_subscribers_foreach(ent_get_chunk(ent_le_get_entity(entity)), job_update_living_entity_damage, payload);
+	wld_chunk_subscribers_foreach(ent_get_chunk(ent_le_get_entity(entity)), job_update_living_entity_damage, &update);
+
+	ltg_broadcast_release(update.packets[0]);
 
 	return true;
 
@@ -498,6 +811,11 @@ bool job_handle_tick_world(job_payload_t* payload) {
 	wld_world_t* world = payload->world;
 
 	world->age++;
+
+	// tables the region map replaced while lookups were running are freed once none are
+	with_lock (&world->lock) {
+		utl_hash_map_reclaim(&world->regions);
+	}
 	
 	if (wld_is_time_progressing(world)) {
 		world->time++;
@@ -508,4 +826,29 @@ bool job_handle_tick_world(job_payload_t* payload) {
 	
 	return true;
 
+}
+
+bool job_handle_save_world(job_payload_t* payload) {
+
+	wld_save(payload->world);
+
+	return true;
+
+}
+
+bool job_handle_chunk_loaded(job_payload_t* payload) {
+
+	wld_run_chunk_requests(payload->chunk);
+
+	return true;
+
+}
+
+bool job_handle_edit_world(job_payload_t* payload) {
+
+	wld_work_edit(payload->edit);
+	wld_release_edit(payload->edit);
+
+	return true;
+
 }
\ No newline at end of file
@@ -12,8 +12,10 @@ extern bool job_handle_unload_region(job_payload_t* payload);
 extern bool job_handle_dig_block(job_payload_t* payload);
 extern bool job_handle_entity_move(job_payload_t* payload);
 extern bool job_handle_entity_teleport(job_payload_t* payload);
-extern bool job_handle_living_entity_look(job_payload_t* payload);
-extern bool job_handle_living_entity_move_look(job_payload_t* payload);
 extern bool job_handle_living_entity_teleport_look(job_payload_t* payload);
 extern bool job_handle_living_entity_damage(job_payload_t* payload);
-extern bool job_handle_tick_world(job_payload_t* payload);
\ No newline at end of file
+extern bool job_handle_tick_world(job_payload_t* payload);
+extern bool job_handle_save_world(job_payload_t* payload);
+extern bool job_handle_chunk_loaded(job_payload_t* payload);
+extern bool job_handle_edit_world(job_payload_t* payload);
+extern bool job_handle_update_region_blocks(job_payload_t* payload);
\ No newline at end of file
@@ -1,38 +1,118 @@
 #include "scheduler.h"
 #include "../board.h"
 #include "../../motor.h"
-#include "../../util/id_vector.h"
-#include "../../util/vector.h"
+#include <stdlib.h>
 #include <pthread.h>
 
+typedef struct sch_timer sch_timer_t;
+
+struct sch_timer {
+
+	sch_timer_t* next;
+
+	// the tick the job is due
+	uint64_t expires;
+	uint32_t id;
+
+};
+
+typedef struct {
+
+	sch_timer_t* first;
+	sch_timer_t* last;
+
+} sch_slot_t;
+
+/*
+ * Hierarchical timing wheel
+ *
+ * Level 0 has a slot for each of the next ticks, every level above has a slot for each span covered by a whole level below,
+ * when the level below wraps around the next slot of the level above is spread over the levels below it,
+ * so scheduling, canceling and running a job take the same time however far away it is
+ */
 struct {
 
 	pthread_mutex_t lock;
-	utl_vector_t tape;
+
+	// the tick that runs next
+	uint64_t tick;
+
+	sch_slot_t wheel[SCH_WHEEL_LEVELS][SCH_WHEEL_SLOTS];
+
+	// timers that can be used again
+	sch_timer_t* unused;
 
 } sch_scheduler = {
 	.lock = PTHREAD_MUTEX_INITIALIZER,
-	.tape = UTL_VECTOR_INITIALIZER(utl_vector_t)
+	.tick = 0,
+	.unused = NULL
 };
 
-static inline void sch_push_l(uint32_t id, uint32_t delay) {
+static inline void sch_slot_push(sch_slot_t* slot, sch_timer_t* timer) {
 
-	const utl_vector_t empty = UTL_VECTOR_INITIALIZER(uint32_t);
+	timer->next = NULL;
 
-	while (delay >= sch_scheduler.tape.size) { // fill up to the delay with empty vectors
+	if (slot->last == NULL) {
+		slot->first = timer;
+	} else {
+		slot->last->next = timer;
+	}
+	slot->last = timer;
 
-		utl_vector_push(&sch_scheduler.tape, &empty);
-	
+}
+
+static inline sch_timer_t* sch_slot_take(sch_slot_t* slot) {
+
+	sch_timer_t* first = slot->first;
+
+	slot->first = NULL;
+	slot->last = NULL;
+
+	return first;
+
+}
+
+// puts the timer in the lowest level that reaches the tick it expires
+static inline void sch_insert_l(sch_timer_t* timer) {
+
+	const uint64_t delta = timer->expires - sch_scheduler.tick;
+
+	for (uint8_t level = 0; level < SCH_WHEEL_LEVELS - 1; ++level) {
+		if (delta < (uint64_t) 1 << (SCH_WHEEL_BITS * (level + 1))) {
+			sch_slot_push(&sch_scheduler.wheel[level][(timer->expires >> (SCH_WHEEL_BITS * level)) & (SCH_WHEEL_SLOTS - 1)], timer);
+			return;
+		}
 	}
 
-	utl_vector_t* vector = utl_vector_get(&sch_scheduler.tape, delay);
+	// too far for the wheel, it goes around the top level until it's close enough
+	const uint8_t top = SCH_WHEEL_LEVELS - 1;
+	const uint64_t expires = delta < (uint64_t) 1 << (SCH_WHEEL_BITS * SCH_WHEEL_LEVELS) ? timer->expires : sch_scheduler.tick + ((uint64_t) 1 << (SCH_WHEEL_BITS * SCH_WHEEL_LEVELS)) - 1;
+	sch_slot_push(&sch_scheduler.wheel[top][(expires >> (SCH_WHEEL_BITS * top)) & (SCH_WHEEL_SLOTS - 1)], timer);
 
-	utl_vector_push(vector, &id);
+}
+
+static inline void sch_push_l(uint32_t id, uint32_t delay) {
+
+	sch_timer_t* timer = sch_scheduler.unused;
+
+	if (timer != NULL) {
+		sch_scheduler.unused = timer->next;
+	} else {
+		timer = malloc(sizeof(sch_timer_t));
+	}
+
+	timer->id = id;
+	timer->expires = sch_scheduler.tick + delay;
+
+	sch_insert_l(timer);
 
 }
 
+// the job stays on the board while it's in the scheduler
 static inline void sch_push(uint32_t id, uint32_t delay) {
 
+	job_get_work(id)->on_board++;
+
 	with_lock (&sch_scheduler.lock) {
 
 		sch_push_l(id, delay);
@@ -57,7 +137,7 @@ uint32_t sch_schedule_repeating(uint32_t id, uint32_t delay, uint32_t interval)
 	assert(delay != 0);
 	assert(interval != 0);
 
-	job_work_t* job = utl_id_vector_get(&job_board.heap.jobs, id);
+	job_work_t* job = job_get_work(id);
 
 	job->repeat = interval;
 
@@ -69,11 +149,11 @@ uint32_t sch_schedule_repeating(uint32_t id, uint32_t delay, uint32_t interval)
 
 void sch_cancel(uint32_t id) {
 
-	job_work_t* work = utl_id_vector_get(&job_board.heap.jobs, id);
+	job_work_t* work = job_get_work(id);
 
 	if (work == NULL) return;
 
-	work->repeat = false;
+	work->repeat = 0;
 	work->canceled = true;
 
 }
@@ -82,51 +162,77 @@ void sch_tick() {
 	
 	with_lock (&sch_scheduler.lock) {
 
-		// get schedule
-		if (sch_scheduler.tape.size == 0) {
-			pthread_mutex_unlock(&sch_scheduler.lock);
-			return;
+		const uint64_t tick = sch_scheduler.tick;
+
+		// a level wrapped around, its next slot of the level above comes down
+		for (uint8_t level = 1; level < SCH_WHEEL_LEVELS; ++level) {
+
+			if ((tick & (((uint64_t) 1 << (SCH_WHEEL_BITS * level)) - 1)) != 0) {
+				break;
+			}
+
+			sch_timer_t* timer = sch_slot_take(&sch_scheduler.wheel[level][(tick >> (SCH_WHEEL_BITS * level)) & (SCH_WHEEL_SLOTS - 1)]);
+			while (timer != NULL) {
+				sch_timer_t* next = timer->next;
+				sch_insert_l(timer);
+				timer = next;
+			}
+
 		}
 
-		utl_vector_t* vector = utl_vector_get(&sch_scheduler.tape, 0);
+		sch_timer_t* timer = sch_slot_take(&sch_scheduler.wheel[0][tick & (SCH_WHEEL_SLOTS - 1)]);
 
-		if (vector->size > 0) {
+		sch_scheduler.tick++;
 
-			with_lock (&job_board.queue.lock) {
+		while (timer != NULL) {
 
-				for (uint32_t i = 0; i < vector->size; ++i) {
+			sch_timer_t* next = timer->next;
 
-					uint32_t id = UTL_VECTOR_GET_AS(uint32_t, vector, i);
+			job_work_t* scheduled = job_get_work(timer->id);
 
-					job_work_t* scheduled = utl_id_vector_get(&job_board.heap.jobs, id);
+			// the job was freed while it was scheduled, its timer is dropped
+			if (scheduled == NULL) {
 
-					if (!scheduled->canceled) {
+				timer->next = sch_scheduler.unused;
+				sch_scheduler.unused = timer;
 
-						utl_list_push(&job_board.queue.list, &id);
+				timer = next;
+				continue;
 
-						if (scheduled->repeat) {
+			}
 
-							sch_push_l(id, scheduled->repeat);
+			if (!scheduled->canceled) {
 
-						}
+				// a repeating job is on the board again for its next run before this one can be freed
+				const uint32_t repeat = scheduled->repeat;
+				if (repeat) {
+					scheduled->on_board++;
+				}
 
-					} else {
+				job_push(timer->id);
 
-						scheduled->repeat = 0;
-						job_free(id);
+				if (repeat) {
 
-					}
+					timer->expires = tick + repeat;
+					sch_insert_l(timer);
+					timer = next;
+					continue;
 
 				}
 
+			} else {
+
+				scheduled->repeat = 0;
+				job_free(timer->id);
+
 			}
 
-			job_resume();
+			timer->next = sch_scheduler.unused;
+			sch_scheduler.unused = timer;
 
-		}
+			timer = next;
 
-		utl_term_vector(vector);
-		utl_vector_shift(&sch_scheduler.tape);
+		}
 
 	}
 
@@ -1,6 +1,10 @@
 #pragma once
 #include "../../main.h"
 
+#define SCH_WHEEL_BITS 6
+#define SCH_WHEEL_SLOTS (1 << SCH_WHEEL_BITS) // slots in each level of the timing wheel
+#define SCH_WHEEL_LEVELS 4 // levels of the timing wheel, jobs further away than its slots reach wait at the top
+
 /*
 Schedule a job to be done at a specific time
 1 delay = next available tick
@@ -0,0 +1,286 @@
+#include <time.h>
+#include <pthread.h>
+#include "tick.h"
+#include "../scheduler/scheduler.h"
+#include "../../motor.h"
+#include "../../util/util.h"
+#include "../../util/vector.h"
+#include "../../world/storage.h"
+
+static const char* tck_phase_names[tck_phase_count] = {
+	[tck_input] = "input",
+	[tck_world] = "world",
+	[tck_entities] = "entities",
+	[tck_blocks] = "blocks",
+	[tck_flush] = "flush"
+};
+
+typedef struct {
+
+	pthread_mutex_t lock;
+
+	// jobs added since the phase last ran
+	utl_vector_t waiting;
+
+	// jobs run every tick
+	utl_vector_t repeating;
+
+	// jobs added while the phase runs are started right away
+	bool running;
+
+	// jobs started in this run of the phase that aren't done yet
+	_Atomic uint32_t remaining;
+
+	uint64_t nanos[TCK_MSPT_TICKS];
+
+} tck_phase_state_t;
+
+#define TCK_PHASE_INITIALIZER { .lock = PTHREAD_MUTEX_INITIALIZER, .waiting = UTL_VECTOR_INITIALIZER(uint32_t), .repeating = UTL_VECTOR_INITIALIZER(uint32_t), .running = false, .remaining = 0 }
+
+static struct {
+
+	tck_phase_state_t phases[tck_phase_count];
+
+	// the main thread waits here for the jobs of a phase
+	pthread_mutex_t lock;
+	pthread_cond_t done;
+
+	// the jobs started by the phase running now, only used by the main thread
+	utl_vector_t started;
+
+	_Atomic uint64_t tick;
+
+} tck_ticker = {
+	.phases = {
+		TCK_PHASE_INITIALIZER,
+		TCK_PHASE_INITIALIZER,
+		TCK_PHASE_INITIALIZER,
+		TCK_PHASE_INITIALIZER,
+		TCK_PHASE_INITIALIZER
+	},
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.done = PTHREAD_COND_INITIALIZER,
+	.started = UTL_VECTOR_INITIALIZER(uint32_t),
+	.tick = 0
+};
+
+tck_phase_t tck_get_job_phase(job_type_t type) {
+
+	switch (type) {
+		case job_dig_block:
+		case job_entity_move:
+		case job_entity_teleport:
+		case job_living_entity_teleport_look:
+			return tck_input;
+		case job_tick_world:
+		case job_unload_region:
+			return tck_world;
+		case job_tick_region:
+		case job_living_entity_damage:
+			return tck_entities;
+		case job_update_region_blocks:
+			return tck_blocks;
+		default:
+			return tck_phase_count;
+	}
+
+}
+
+const char* tck_get_phase_name(tck_phase_t phase) {
+	return tck_phase_names[phase];
+}
+
+void tck_add(tck_phase_t phase, uint32_t id) {
+
+	tck_phase_state_t* state = &tck_ticker.phases[phase];
+	bool start = false;
+
+	with_lock (&state->lock) {
+		if (state->running) {
+			state->remaining++;
+			start = true;
+		} else {
+			utl_vector_push(&state->waiting, &id);
+		}
+	}
+
+	if (start) {
+		job_post(id);
+	}
+
+}
+
+void tck_defer(tck_phase_t phase, uint32_t id) {
+
+	tck_phase_state_t* state = &tck_ticker.phases[phase];
+
+	with_lock (&state->lock) {
+		utl_vector_push(&state->waiting, &id);
+	}
+
+}
+
+uint32_t tck_schedule_repeating(uint32_t id) {
+
+	job_work_t* work = job_get_work(id);
+	const tck_phase_t phase = tck_get_job_phase(work->type);
+
+	assert(phase != tck_phase_count);
+
+	// the job stays on the board while the phase repeats it
+	work->on_board++;
+
+	tck_phase_state_t* state = &tck_ticker.phases[phase];
+
+	with_lock (&state->lock) {
+		utl_vector_push(&state->repeating, &id);
+	}
+
+	return id;
+
+}
+
+void tck_done(tck_phase_t phase) {
+
+	if (--tck_ticker.phases[phase].remaining == 0) {
+		with_lock (&tck_ticker.lock) {
+			pthread_cond_signal(&tck_ticker.done);
+		}
+	}
+
+}
+
+// puts the jobs of the phase in the started vector and marks the phase running
+static void tck_start_phase(tck_phase_state_t* state) {
+
+	utl_vector_t* started = &tck_ticker.started;
+	started->size = 0;
+
+	with_lock (&state->lock) {
+
+		// canceled jobs are dropped, the rest run again
+		uint32_t kept = 0;
+		for (uint32_t i = 0; i < state->repeating.size; ++i) {
+
+			const uint32_t id = UTL_VECTOR_GET_AS(uint32_t, &state->repeating, i);
+			job_work_t* work = job_get_work(id);
+
+			if (work->canceled) {
+				job_free(id);
+				continue;
+			}
+
+			work->on_board++;
+			utl_vector_push(started, &id);
+			utl_vector_set(&state->repeating, kept++, &id);
+
+		}
+		state->repeating.size = kept;
+
+		if (state->waiting.size != 0) {
+			utl_vector_push_many(started, state->waiting.array, state->waiting.size);
+			state->waiting.size = 0;
+		}
+
+		state->remaining = started->size;
+		state->running = true;
+
+	}
+
+}
+
+// waits until every job of the phase is done, jobs can still be added to it while waiting
+static void tck_finish_phase(tck_phase_state_t* state) {
+
+	bool finished = false;
+
+	while (!finished) {
+
+		with_lock (&tck_ticker.lock) {
+			while (state->remaining != 0 && sky_get_status() != sky_stopping) {
+				pthread_cond_wait(&tck_ticker.done, &tck_ticker.lock);
+			}
+		}
+
+		// nothing can be added once the phase has stopped running
+		with_lock (&state->lock) {
+			if (state->remaining == 0 || sky_get_status() == sky_stopping) {
+				state->running = false;
+				finished = true;
+			}
+		}
+
+	}
+
+}
+
+uint64_t tck_get_tick() {
+	return tck_ticker.tick;
+}
+
+void tck_run() {
+
+	for (tck_phase_t phase = 0; phase < tck_phase_count; ++phase) {
+
+		tck_phase_state_t* state = &tck_ticker.phases[phase];
+
+		struct timespec start, end;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+
+		switch (phase) {
+			case tck_input: {
+				// scheduled jobs with a phase wait for it, the ones of this phase start with it
+				sch_tick();
+			} break;
+			case tck_flush: {
+				ltg_flush_all(sky_get_listener());
+			} break;
+			default: {
+				// only jobs
+			} break;
+		}
+
+		tck_start_phase(state);
+
+		for (uint32_t i = 0; i < tck_ticker.started.size; ++i) {
+			job_post(UTL_VECTOR_GET_AS(uint32_t, &tck_ticker.started, i));
+		}
+
+		tck_finish_phase(state);
+
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		state->nanos[tck_ticker.tick % TCK_MSPT_TICKS] = sky_to_nanos(end) - sky_to_nanos(start);
+
+	}
+
+	// every phase is done, block storages replaced in the tick before are no longer read
+	wld_reclaim_block_storages();
+
+	tck_ticker.tick++;
+
+}
+
+void tck_resume() {
+
+	with_lock (&tck_ticker.lock) {
+		pthread_cond_broadcast(&tck_ticker.done);
+	}
+
+}
+
+float64_t tck_get_mspt(tck_phase_t phase) {
+
+	const uint64_t ticks = UTL_MIN(tck_ticker.tick, TCK_MSPT_TICKS);
+
+	if (ticks == 0) {
+		return 0;
+	}
+
+	uint64_t nanos = 0;
+	for (uint64_t i = 0; i < ticks; ++i) {
+		nanos += tck_ticker.phases[phase].nanos[i];
+	}
+
+	return nanos / (float64_t) ticks / 1000000.0;
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "../board.h"
+#include "../../main.h"
+
+#define TCK_MSPT_TICKS 100 // ticks the time of a phase is averaged over
+
+/*
+ * Phases of a tick, run in this order by the main thread
+ *
+ * Jobs of a phase are held until it starts, then spread over the workers, the next phase only starts when they're all done,
+ * so jobs of different phases never run at the same time, jobs without a phase run whenever a worker gets to them
+ */
+typedef enum {
+
+	tck_input, // scheduled jobs and what players did since the last tick
+	tck_world, // world time and unloading regions
+	tck_entities, // region ticks
+	tck_blocks, // block ticks and sending block changes
+	tck_flush, // sending the packets of the tick
+
+	tck_phase_count
+
+} tck_phase_t;
+
+// the phase jobs of the type run in, tck_phase_count when they can run at any time
+extern tck_phase_t tck_get_job_phase(job_type_t type);
+
+extern const char* tck_get_phase_name(tck_phase_t phase);
+
+// holds the job until its phase runs, or starts it right away when the phase is running
+extern void tck_add(tck_phase_t phase, uint32_t id);
+
+// holds the job until the next run of its phase, even when the phase is running, for jobs adding themselves again
+extern void tck_defer(tck_phase_t phase, uint32_t id);
+
+// runs the job in its phase every tick until it's canceled with sch_cancel
+extern uint32_t tck_schedule_repeating(uint32_t id);
+
+// called when a job of the phase is done
+extern void tck_done(tck_phase_t phase);
+
+// ticks run since the server started
+extern uint64_t tck_get_tick();
+
+// runs every phase, the tick is over when it returns
+extern void tck_run();
+
+// stops waiting for the jobs of a phase, when the server is stopping
+extern void tck_resume();
+
+// the average milliseconds the phase took over the last ticks
+extern float64_t tck_get_mspt(tck_phase_t phase);
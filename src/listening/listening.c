@@ -1,4 +1,8 @@
 #include <libdeflate.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
 #include "listening.h"
 #include "../motor.h"
 #include "../jobs/board.h"
@@ -15,6 +19,18 @@
 #include "phd/login.h"
 #include "phd/play.h"
 
+// every thread that creates broadcasts compresses them with its own compressor, freed when the thread exits
+static pthread_key_t ltg_broadcast_compressor;
+static pthread_once_t ltg_broadcast_compressor_once = PTHREAD_ONCE_INIT;
+
+static void ltg_free_broadcast_compressor(void* compressor) {
+	libdeflate_free_compressor(compressor);
+}
+
+static void ltg_create_broadcast_compressor_key() {
+	pthread_key_create(&ltg_broadcast_compressor, ltg_free_broadcast_compressor);
+}
+
 void ltg_init(ltg_listener_t* listener) {
 
 	log_info("Starting listener...");
@@ -22,6 +38,46 @@ void ltg_init(ltg_listener_t* listener) {
 	// generate RSA keypair
 	cry_rsa_gen_key_pair(&listener->keypair);
 
+	// start I/O threads
+	if (listener->io.count > 0) {
+#ifdef __linux__
+		listener->io.threads = calloc(listener->io.count, sizeof(ltg_io_thread_t));
+
+		for (uint16_t i = 0; i < listener->io.count; ++i) {
+
+			ltg_io_thread_t* io = &listener->io.threads[i];
+			io->listener = listener;
+			io->id = i;
+			io->epoll = epoll_create1(0);
+			io->wake = eventfd(0, 0);
+
+			// the wake event is the only one without a client
+			struct epoll_event event = {
+				.events = EPOLLIN,
+				.data.ptr = NULL
+			};
+
+			if (io->epoll == -1 || io->wake == -1 || epoll_ctl(io->epoll, EPOLL_CTL_ADD, io->wake, &event) != 0) {
+				log_error("Failed to create I/O thread #%u!", i);
+				listener->io.count = i;
+				break;
+			}
+
+			pthread_create(&io->thread, NULL, t_ltg_io, io);
+
+		}
+
+		if (listener->io.count > 0) {
+			log_info("Started %u I/O threads", listener->io.count);
+		} else {
+			log_warn("No I/O threads could be started, using a thread per client");
+		}
+#else
+		log_warn("I/O threads are not supported on this platform, using a thread per client");
+		listener->io.count = 0;
+#endif
+	}
+
 	// start listening thread
 	pthread_create(&listener->thread, NULL, t_ltg_run, listener);
 
@@ -79,6 +135,7 @@ void* t_ltg_run(void* args) {
 			client->address.addr = address;
 			client->address.size = address_size;
 			client->state = ltg_handshake;
+			utl_init_vector(&client->send.queue, sizeof(byte_t));
 
 			// accept the client
 			ltg_accept(client);
@@ -90,262 +147,587 @@ void* t_ltg_run(void* args) {
 
 }
 
+static void ltg_free_client(ltg_client_t*);
+
 void ltg_accept(ltg_client_t* client) {
 
+	ltg_listener_t* listener = client->listener;
+
 	// lock clients
-	with_lock (&client->listener->clients.lock) {
-		client->id = utl_id_vector_push(&client->listener->clients.vector, &client);
+	with_lock (&listener->clients.lock) {
+		client->id = utl_id_vector_push(&listener->clients.vector, &client);
+	}
+
+#ifdef __linux__
+	if (listener->io.count > 0) {
+
+		// hand the client to the next I/O thread
+		ltg_io_thread_t* io = &listener->io.threads[listener->io.next];
+		listener->io.next = (listener->io.next + 1) % listener->io.count;
+
+		client->io = io;
+		client->thread = io->thread;
+
+		struct epoll_event event = {
+			.events = EPOLLIN | EPOLLRDHUP,
+			.data.ptr = client
+		};
+
+		if (sck_set_nonblocking(client->socket) != SCK_OK || epoll_ctl(io->epoll, EPOLL_CTL_ADD, client->socket, &event) != 0) {
+			log_error("Failed to add client to I/O thread #%u!", io->id);
+			ltg_free_client(client);
+		}
+
+		return;
+
 	}
+#endif
 
 	// create client listening thread
 	pthread_create(&client->thread, NULL, t_ltg_client, client);
 
 }
 
-void* t_ltg_client(void* args) {
+#ifdef __linux__
+// start or stop waiting for the socket to be writable (I/O threads only)
+static inline void ltg_wait_writable(ltg_client_t* client, bool wait) {
 
-	ltg_client_t* client = args;
+	client->send.waiting = wait;
 
-	// create receive packet (on stack)
-	PCK_INLINE(recvd, LTG_MAX_RECEIVE, io_big_endian);
+	struct epoll_event event = {
+		// nothing is read from a client that closed its side
+		.events = (client->send.closing ? 0 : EPOLLIN | EPOLLRDHUP) | (wait ? EPOLLOUT : 0),
+		.data.ptr = client
+	};
+	epoll_ctl(client->io->epoll, EPOLL_CTL_MOD, client->socket, &event);
 
-	for (;;) {
+}
+#endif
 
-		// receive packet
-		recvd->length = sck_recv(client->socket, (char*) recvd->bytes, LTG_MAX_RECEIVE);
+// send as much of the queue as the socket takes without blocking, the client must be locked
+static void ltg_flush_l(ltg_client_t* client) {
 
-		if ((int32_t) recvd->length <= 0) {
-			// client disconnected
-			break;
-		} else {
-			// handle packet
-			recvd->cursor = 0;
+	if (client->send.queue.size == 0 || client->send.waiting) {
+		// nothing to send, or the I/O thread sends it once the socket is writable
+		return;
+	}
 
-			if (client->encryption.enabled) {
-				PCK_INLINE(decrypted, recvd->length, io_big_endian);
-				if (cfb8_decrypt(client->encryption.decrypt, recvd->bytes, recvd->length, decrypted->bytes) != 1) {
-					log_error("Decryption failed");
-					break;
-				}
-				decrypted->length = recvd->length;
+	int32_t sent = sck_send_nowait(client->socket, (char*) client->send.queue.array, client->send.queue.size);
 
-				if (!ltg_handle_packet(client, decrypted)) {
-					break;
+	if (sent == SCK_WOULD_BLOCK) {
+		sent = 0;
+	} else if (sent < 0) {
+		// connection is broken, the client's thread frees it
+		client->send.queue.size = 0;
+		sck_shutdown(client->socket);
+		return;
+	}
+
+	utl_vector_shift_many(&client->send.queue, sent);
+
+#ifdef __linux__
+	if (client->send.queue.size > 0 && client->io != NULL) {
+		ltg_wait_writable(client, true);
+	}
+#endif
+
+}
+
+void ltg_flush(ltg_client_t* client) {
+
+	with_lock (&client->lock) {
+		ltg_flush_l(client);
+	}
+
+}
+
+void ltg_flush_all(ltg_listener_t* listener) {
+
+	with_lock (&listener->clients.lock) {
+		for (uint32_t i = 0; i < listener->clients.vector.array.size; ++i) {
+			ltg_client_t* client = UTL_ID_VECTOR_GET_AS(ltg_client_t*, &listener->clients.vector, i);
+			if (client != NULL) {
+				ltg_flush(client);
+			}
+		}
+	}
+
+}
+
+// make sure there is room for at least `length` more bytes after the received bytes
+static inline void ltg_receive_reserve(ltg_client_t* client, uint32_t length) {
+
+	if (client->receive.capacity - client->receive.end >= length) {
+		return;
+	}
+
+	// move the unhandled bytes to the front
+	if (client->receive.start > 0) {
+		memmove(client->receive.packet->bytes, client->receive.packet->bytes + client->receive.start, client->receive.end - client->receive.start);
+		client->receive.decrypted -= client->receive.start;
+		client->receive.end -= client->receive.start;
+		client->receive.start = 0;
+	}
+
+	if (client->receive.capacity - client->receive.end < length) {
+		client->receive.capacity = UTL_MAX(client->receive.capacity * 2, client->receive.end + length);
+		client->receive.packet = realloc(client->receive.packet, sizeof(pck_packet_t) + client->receive.capacity);
+	}
+
+}
+
+/*
+ * Handle every whole packet that has been received
+ * If return is false, disconnect the client
+ */
+static bool ltg_receive_packets(ltg_client_t* client) {
+
+	pck_packet_t* packet = client->receive.packet;
+
+	while (client->receive.start < client->receive.end) {
+
+		// decrypt new bytes
+		if (client->receive.decrypted < client->receive.end) {
+			if (client->encryption.enabled && cfb8_decrypt(client->encryption.decrypt, packet->bytes + client->receive.decrypted, client->receive.end - client->receive.decrypted, packet->bytes + client->receive.decrypted) != 1) {
+				log_error("Decryption failed");
+				return false;
+			}
+			client->receive.decrypted = client->receive.end;
+		}
+
+		const byte_t* bytes = packet->bytes + client->receive.start;
+		const uint32_t available = client->receive.end - client->receive.start;
+
+		uint32_t length = 0;
+		uint32_t length_length = 0;
+
+		if (client->state == ltg_handshake && bytes[0] == 0xFE) {
+			// legacy server list ping isn't length prefixed
+			length = available;
+		} else {
+			// read the length, which may not have been fully received yet
+			for (;;) {
+				if (length_length == available) {
+					return true;
 				}
-			} else {
-				if (!ltg_handle_packet(client, recvd)) {
+				const byte_t byte = bytes[length_length];
+				length |= (byte & 0x7F) << (7 * length_length++);
+				if (!(byte & 0x80)) {
 					break;
 				}
+				if (length_length == 3) {
+					log_error("Client sent a packet that is too long!");
+					return false;
+				}
 			}
+			if (length == 0) {
+				log_error("Client sent an empty packet!");
+				return false;
+			}
+			length += length_length;
+		}
 
+		if (length > available) {
+			// wait for the rest of the packet
+			ltg_receive_reserve(client, length - available);
+			return true;
 		}
+
+		packet->cursor = client->receive.start;
+		packet->length = client->receive.start + length;
+
+		const bool encryption_enabled = client->encryption.enabled;
+
+		if (!ltg_handle_packet(client, packet)) {
+			return false;
+		}
+
+		client->receive.start += length;
+
+		// bytes after the packet that enabled encryption are encrypted
+		if (!encryption_enabled && client->encryption.enabled) {
+			client->receive.decrypted = client->receive.start;
+		}
+
 	}
 
-	ltg_disconnect(client);
+	client->receive.start = client->receive.decrypted = client->receive.end = 0;
+
+	return true;
 
-	return NULL;
 }
 
 /*
- * Handle packets
+ * Receive bytes from the socket and handle the packets they complete
  * If return is false, disconnect the client
  */
-bool ltg_handle_packet(ltg_client_t* client, pck_packet_t* packet) {
+static bool ltg_receive(ltg_client_t* client) {
 
-	size_t next_packet = 0;
+	if (client->receive.packet == NULL) {
+		client->receive.packet = pck_create(LTG_MAX_RECEIVE, io_big_endian);
+		client->receive.capacity = LTG_MAX_RECEIVE;
+	} else {
+		ltg_receive_reserve(client, LTG_MAX_RECEIVE);
+	}
 
-	do {
-		packet->cursor = next_packet;
+	const int32_t received = sck_recv(client->socket, (char*) client->receive.packet->bytes + client->receive.end, client->receive.capacity - client->receive.end);
 
-		if (client->compression_enabled) {
-			const int32_t packet_length = pck_read_var_int(packet);
-			const size_t length_ptr = packet->cursor;
-			const int32_t data_length = pck_read_var_int(packet);
+	if (received == SCK_WOULD_BLOCK) {
+		// nothing to read yet
+		return true;
+	} else if (received <= 0) {
+		// client disconnected
+		return false;
+	}
 
-			if (data_length == 0) { // uncompressed
-				packet->sub_length = packet_length - 1;
-				next_packet = packet->cursor + packet->sub_length;
-			} else {
-				packet->sub_length = data_length;
-				next_packet = length_ptr + packet_length;
+	client->receive.end += received;
 
-				PCK_INLINE(decompressed, data_length, io_big_endian);
-				
-				// it's zlib compression time
-				if (client->compression.decompressor == NULL) {
-					client->compression.decompressor = libdeflate_alloc_decompressor();
-				}
+	if (!ltg_receive_packets(client)) {
+		return false;
+	}
 
-				size_t actual_length = 0;
-				if (libdeflate_zlib_decompress(client->compression.decompressor, pck_cursor(packet), packet_length - (packet->cursor - length_ptr), pck_cursor(decompressed), data_length, &actual_length) != LIBDEFLATE_SUCCESS) {
-					log_error("Client sent a corrupt packet! (0)");
-					return false;
-				}
+	// send responses right away
+	ltg_flush(client);
 
-				if (actual_length != (unsigned) data_length) {
-					log_error("Client sent a corrupt packet! (1)");
-					return false;
-				}
+	return true;
 
-				decompressed->sub_length = decompressed->length =  actual_length;
+}
 
-				switch (client->state) {
-					case ltg_handshake: {
-						if (!phd_handshake(client, decompressed)) {
-							return false;
-						}
-					} break;
-					case ltg_status: {
-						if (!phd_status(client, decompressed)) {
-							return false;
-						}
-					} break;
-					case ltg_login: {
-						if (!phd_login(client, decompressed)) {
-							return false;
-						}
-					} break;
-					case ltg_play: {
-						if (!phd_play(client, decompressed)) {
-							return false;
-						}
-					} break;
-					default: {
-						log_warn("Client is in an unknown state! (%d)", client->state);
-						return false;
-					}
-				}
+void* t_ltg_client(void* args) {
 
-				continue;
+	ltg_client_t* client = args;
+
+	while (ltg_receive(client)) {
+		// receive until the client disconnects
+	}
+
+	ltg_disconnect(client);
+
+	return NULL;
+}
+
+#ifdef __linux__
+void* t_ltg_io(void* args) {
+
+	ltg_io_thread_t* io = args;
+
+	struct epoll_event events[LTG_IO_EVENTS];
 
+	for (;;) {
+
+		const int32_t count = epoll_wait(io->epoll, events, LTG_IO_EVENTS, -1);
+
+		if (count < 0) {
+			if (errno == EINTR) {
+				continue;
 			}
-		} else {
-			packet->sub_length = pck_read_var_int(packet);
-			next_packet = packet->cursor + packet->sub_length;
+			log_error("I/O thread #%u failed to wait for events!", io->id);
+			break;
 		}
 
-		switch (client->state) {
-			case ltg_handshake: {
-				if (!phd_handshake(client, packet)) {
-					return false;
-				}
-			} break;
-			case ltg_status: {
-				if (!phd_status(client, packet)) {
-					return false;
+		for (int32_t i = 0; i < count; ++i) {
+
+			ltg_client_t* client = events[i].data.ptr;
+
+			if (client == NULL) {
+				// woken up to stop
+				return NULL;
+			}
+
+			// the client can send packets right before closing its side, they're still read and handled first
+			const bool closed = (events[i].events & (EPOLLHUP | EPOLLRDHUP)) != 0;
+			// nothing can be sent to the client anymore either
+			const bool hung_up = (events[i].events & (EPOLLHUP | EPOLLERR)) != 0;
+			bool connected = !(events[i].events & EPOLLERR);
+
+			if (connected && !hung_up && (events[i].events & EPOLLOUT)) {
+				with_lock (&client->lock) {
+					client->send.waiting = false;
+					ltg_flush_l(client);
+					if (!client->send.waiting) {
+						ltg_wait_writable(client, false);
+					}
+					// everything queued for a client that closed its side is sent
+					if (client->send.closing && client->send.queue.size == 0) {
+						connected = false;
+					}
 				}
-			} break;
-			case ltg_login: {
-				if (!phd_login(client, packet)) {
-					return false;
+			}
+
+			if (connected && !client->send.closing && ((events[i].events & EPOLLIN) || closed)) {
+				connected = ltg_receive(client);
+				// once the client has closed its side, receiving never blocks and fails when nothing is left
+				while (connected && closed) {
+					connected = ltg_receive(client);
 				}
-			} break;
-			case ltg_play: {
-				if (!phd_play(client, packet)) {
-					return false;
+				// a client that only closed its side still reads what is queued for it, so it's freed once that is sent
+				if (closed && !hung_up) {
+					with_lock (&client->lock) {
+						if (client->send.queue.size > 0) {
+							client->send.closing = true;
+							ltg_wait_writable(client, true);
+							connected = true;
+						}
+					}
 				}
-			} break;
-			default: {
-				log_warn("Client is in an unknown state! (%d)", client->state);
+			}
+
+			if (!connected || hung_up) {
+				ltg_free_client(client);
+			}
+
+		}
+	}
+
+	return NULL;
+
+}
+#endif
+
+// pass the packet to the handler of the client's state
+static inline bool ltg_dispatch_packet(ltg_client_t* client, pck_packet_t* packet) {
+
+	switch (client->state) {
+		case ltg_handshake: {
+			return phd_handshake(client, packet);
+		}
+		case ltg_status: {
+			return phd_status(client, packet);
+		}
+		case ltg_login: {
+			return phd_login(client, packet);
+		}
+		case ltg_play: {
+			return phd_play(client, packet);
+		}
+		default: {
+			log_warn("Client is in an unknown state! (%d)", client->state);
+			return false;
+		}
+	}
+
+}
+
+/*
+ * Handle a whole packet, starting at the cursor and ending at the packet length
+ * If return is false, disconnect the client
+ */
+bool ltg_handle_packet(ltg_client_t* client, pck_packet_t* packet) {
+
+	if (client->compression_enabled) {
+		const int32_t packet_length = pck_read_var_int(packet);
+		const size_t length_ptr = packet->cursor;
+		const int32_t data_length = pck_read_var_int(packet);
+
+		if (data_length == 0) { // uncompressed
+			packet->sub_length = packet_length - 1;
+		} else {
+			packet->sub_length = data_length;
+
+			PCK_INLINE(decompressed, data_length, io_big_endian);
+			
+			// it's zlib compression time
+			if (client->compression.decompressor == NULL) {
+				client->compression.decompressor = libdeflate_alloc_decompressor();
+			}
+
+			size_t actual_length = 0;
+			if (libdeflate_zlib_decompress(client->compression.decompressor, pck_cursor(packet), packet_length - (packet->cursor - length_ptr), pck_cursor(decompressed), data_length, &actual_length) != LIBDEFLATE_SUCCESS) {
+				log_error("Client sent a corrupt packet! (0)");
+				return false;
+			}
+
+			if (actual_length != (unsigned) data_length) {
+				log_error("Client sent a corrupt packet! (1)");
 				return false;
 			}
+
+			decompressed->sub_length = decompressed->length =  actual_length;
+
+			return ltg_dispatch_packet(client, decompressed);
+
 		}
-	} while (next_packet < packet->length);
+	} else {
+		packet->sub_length = pck_read_var_int(packet);
+	}
 
-	return true;
+	return ltg_dispatch_packet(client, packet);
 
 }
 
-// send encryption step (used in compressed and uncompressed)
-static inline void ltg_send_e(ltg_client_t* client, byte_t* bytes, size_t length) {
-	
+// queue bytes to be sent, the client must be locked
+static inline void ltg_queue_l(ltg_client_t* client, byte_t* bytes, size_t length) {
+
+	if (client->send.queue.size + length > LTG_MAX_QUEUED) {
+		log_warn("Client #%u is not receiving data fast enough, disconnecting", client->id);
+		sck_shutdown(client->socket);
+		return;
+	}
+
+	byte_t* queued = utl_vector_push_many(&client->send.queue, bytes, length);
+
+	// encrypt packet
 	if (client->encryption.enabled) {
+		cfb8_encrypt(client->encryption.encrypt, queued, length, queued);
+	}
 
-		// encrypt packet
-		byte_t encrypted[length];
+	if (client->send.queue.size >= LTG_SEND_THRESHOLD) {
+		ltg_flush_l(client);
+	}
+
+}
+
+// whether a packet of this length is compressed, if compression is enabled
+static inline bool ltg_should_compress(bool compression_enabled, size_t length) {
+	return compression_enabled && length >= sky_get_network_compression_threshold();
+}
+
+/*
+ * Frame a packet with its length (and data length if compression is enabled), compressing it if it's long enough
+ * `compressed` must hold the packet length + 10 bytes when the packet should be compressed
+ * Returns the length of the framed packet, which `framed` is set to
+ */
+static size_t ltg_frame(struct libdeflate_compressor** compressor, bool compression_enabled, pck_packet_t* packet, byte_t* compressed, byte_t** framed) {
+
+	size_t length = packet->cursor;
+	byte_t* bytes = NULL;
+
+	if (compression_enabled) {
+
+		if (ltg_should_compress(compression_enabled, length)) { // compress the packet
+		
+			size_t compressed_length = 0;
+
+			bytes = compressed + 10;
+			
+			// it's zlib compression time
+			if (*compressor == NULL) {
+				*compressor = libdeflate_alloc_compressor(6);
+			}
+
+			compressed_length = libdeflate_zlib_compress(*compressor, packet->bytes, length, bytes, length);
+
+			if (compressed_length != 0) {
+
+				const size_t data_length_length = io_var_int_length(length);
+				const size_t packet_length_length = io_var_int_length(compressed_length + data_length_length);
+				
+				bytes = bytes - data_length_length - packet_length_length;
+				io_write_var_int(bytes, compressed_length + data_length_length, 5);
+				io_write_var_int(bytes + packet_length_length, length, 5);
+
+				*framed = bytes;
+				return compressed_length + data_length_length + packet_length_length;
 
-		cfb8_encrypt(client->encryption.encrypt, bytes, length, encrypted);
+			}
 
-		sck_send(client->socket, (char*) encrypted, length);
+		}
+		
+		// do not compress the packet
+		const size_t length_length = io_var_int_length(length + 1);
+		bytes = packet->bytes - length_length - 1;
+		io_write_var_int(bytes, length + 1, 5);
+		bytes[length_length] = 0;
+		length += length_length + 1;
 
 	} else {
-		sck_send(client->socket, (char*) bytes, length);
+
+		const size_t length_length = io_var_int_length(length);
+		bytes = packet->bytes - length_length;
+		io_write_var_int(bytes, length, 5);
+		length += length_length;
+
 	}
 
+	*framed = bytes;
+	return length;
+
 }
 
-// sends the packet to the client specified
+// queues the packet to be sent to the client specified
 void ltg_send(ltg_client_t* client, pck_packet_t* packet) {
 
 	with_lock (&client->lock) {
 
-		size_t length = packet->cursor;
+		byte_t compressed[ltg_should_compress(client->compression_enabled, packet->cursor) ? packet->cursor + 10 : 1];
 		byte_t* bytes = NULL;
 
-		if (client->compression_enabled) {
+		const size_t length = ltg_frame(&client->compression.compressor, client->compression_enabled, packet, compressed, &bytes);
 
-			if (length >= sky_get_network_compression_threshold()) { // compress the packet
-			
-				byte_t compressed[length + 10];
-				size_t compressed_length = 0;
+		ltg_queue_l(client, bytes, length);
 
-				bytes = compressed + 10;
-				
-				// it's zlib compression time
-				if (client->compression.compressor == NULL) {
-					client->compression.compressor = libdeflate_alloc_compressor(6);
-				}
+	}
 
-				compressed_length = libdeflate_zlib_compress(client->compression.compressor, packet->bytes, length, bytes, length);
+}
 
-				if (compressed_length != 0) {
+ltg_broadcast_t* ltg_broadcast_create(pck_packet_t* packet) {
 
-					const size_t data_length_length = io_var_int_length(length);
-					const size_t packet_length_length = io_var_int_length(compressed_length + data_length_length);
-					
-					bytes = bytes - data_length_length - packet_length_length;
-					io_write_var_int(bytes, compressed_length + data_length_length, 5);
-					io_write_var_int(bytes + packet_length_length, length, 5);
-					length = compressed_length + data_length_length + packet_length_length;
+	// clients in the play state have compression enabled if the server has
+	const bool compression_enabled = sky_get_network_compression_threshold() > 0;
 
-					ltg_send_e(client, bytes, length);
+	byte_t compressed[ltg_should_compress(compression_enabled, packet->cursor) ? packet->cursor + 10 : 1];
+	byte_t* bytes = NULL;
 
-					pthread_mutex_unlock(&client->lock);
-					return;
+	// broadcasts can be created before the listener is started, so the key is created on first use
+	pthread_once(&ltg_broadcast_compressor_once, ltg_create_broadcast_compressor_key);
 
-				}
+	struct libdeflate_compressor* compressor = pthread_getspecific(ltg_broadcast_compressor);
 
-			}
-			
-			// do not compress the packet
-			const size_t length_length = io_var_int_length(length + 1);
-			bytes = packet->bytes - length_length - 1;
-			io_write_var_int(bytes, length + 1, 5);
-			bytes[length_length] = 0;
-			length += length_length + 1;
+	const size_t length = ltg_frame(&compressor, compression_enabled, packet, compressed, &bytes);
 
-		} else {
+	pthread_setspecific(ltg_broadcast_compressor, compressor);
 
-			const size_t length_length = io_var_int_length(length);
-			bytes = packet->bytes - length_length;
-			io_write_var_int(bytes, length, 5);
-			length += length_length;
+	ltg_broadcast_t* broadcast = malloc(sizeof(ltg_broadcast_t) + length);
+	broadcast->references = 1;
+	broadcast->length = length;
+	memcpy(broadcast->bytes, bytes, length);
 
-		}
+	return broadcast;
+
+}
 
-		ltg_send_e(client, bytes, length);
+void ltg_broadcast_release(ltg_broadcast_t* broadcast) {
+
+	if (--broadcast->references == 0) {
+		free(broadcast);
+	}
 
+}
+
+// queues the already framed packet, only encryption is done per client
+void ltg_send_broadcast(ltg_client_t* client, ltg_broadcast_t* broadcast) {
+
+	with_lock (&client->lock) {
+		ltg_queue_l(client, broadcast->bytes, broadcast->length);
 	}
 
 }
 
+// sends the packet and everything queued before it right away
+void ltg_send_immediately(ltg_client_t* client, pck_packet_t* packet) {
+
+	ltg_send(client, packet);
+	ltg_flush(client);
+
+}
+
 void ltg_disconnect(ltg_client_t* client) {
 
-	if (pthread_self() != client->thread) {
+	// clients are freed by their own thread, I/O threads notice the shutdown and free the client
+	if (client->io != NULL || pthread_self() != client->thread) {
+		ltg_flush(client);
 		sck_shutdown(client->socket);
 		return;
 	}
-		
+
+	ltg_free_client(client);
+
+}
+
+static void ltg_free_client(ltg_client_t* client) {
+
+	// send what is left in the queue (like a disconnect message)
+	ltg_flush(client);
 	sck_shutdown(client->socket);
 
 	switch (client->state) {
@@ -379,15 +761,20 @@ void ltg_disconnect(ltg_client_t* client) {
 		} break;
 	}
 
-	pthread_mutex_lock(&client->lock);
-	pthread_mutex_destroy(&client->lock);
-	sck_close(client->socket);
-
-	// remove from client list
+	// remove from client list (before the lock is gone, so it can't be flushed anymore)
 	with_lock (&client->listener->clients.lock) {
 		utl_id_vector_remove(&client->listener->clients.vector, client->id);
 	}
 
+	pthread_mutex_lock(&client->lock);
+	pthread_mutex_destroy(&client->lock);
+#ifdef __linux__
+	if (client->io != NULL) {
+		epoll_ctl(client->io->epoll, EPOLL_CTL_DEL, client->socket, NULL);
+	}
+#endif
+	sck_close(client->socket);
+
 	// free compressors
 	libdeflate_free_compressor(client->compression.compressor);
 	libdeflate_free_decompressor(client->compression.decompressor);
@@ -404,6 +791,10 @@ void ltg_disconnect(ltg_client_t* client) {
 		cfb8_done(client->encryption.encrypt, client->encryption.decrypt);
 	}
 
+	// free unsent and unhandled bytes
+	utl_term_vector(&client->send.queue);
+	free(client->receive.packet);
+
 	free(client);
 
 }
@@ -421,6 +812,16 @@ void ltg_term(ltg_listener_t* listener) {
 	char message[128];
 	size_t message_length = cht_write_translation(&disconnect_message, message);
 
+#ifdef __linux__
+	// stop I/O threads, their clients are freed below
+	for (uint16_t i = 0; i < listener->io.count; ++i) {
+		const uint64_t wake = 1;
+		if (write(listener->io.threads[i].wake, &wake, sizeof(wake)) == sizeof(wake)) {
+			pthread_join(listener->io.threads[i].thread, NULL);
+		}
+	}
+#endif
+
 	// disconnect all clients
 	with_lock (&listener->clients.lock) {
 		for (uint32_t i = 0; i < listener->clients.vector.array.size; ++i) {
@@ -428,15 +829,27 @@ void ltg_term(ltg_listener_t* listener) {
 			if (client != NULL) {
 				pthread_mutex_unlock(&listener->clients.lock);
 				phd_send_disconnect(client, message, message_length);
-				ltg_disconnect(client);
-				if (pthread_self() != client->thread) {
-					pthread_join(client->thread, NULL);
+				if (client->io != NULL) {
+					ltg_free_client(client);
+				} else {
+					ltg_disconnect(client);
+					if (pthread_self() != client->thread) {
+						pthread_join(client->thread, NULL);
+					}
 				}
 				pthread_mutex_lock(&listener->clients.lock);
 			}
 		}
 	}
 
+#ifdef __linux__
+	for (uint16_t i = 0; i < listener->io.count; ++i) {
+		close(listener->io.threads[i].epoll);
+		close(listener->io.threads[i].wake);
+	}
+	free(listener->io.threads);
+#endif
+
 	sck_term();
 
 }
\ No newline at end of file
@@ -124,13 +124,20 @@ typedef enum {
 
 } ltg_locale_t;
 
-#define LTG_MAX_RECEIVE 3276 // max amount of bytes client can send
+#define LTG_MAX_RECEIVE 3276 // amount of bytes received at once
 #define LTG_AES_KEY_LENGTH 16 // length of AES key
+#define LTG_MAX_QUEUED 0x2000000 // max amount of bytes waiting to be sent before the client is disconnected
+#define LTG_SEND_THRESHOLD 0x10000 // amount of queued bytes that are sent without waiting for the end of the tick
+#define LTG_IO_EVENTS 64 // max amount of events an I/O thread handles per wait
 
 typedef byte_t ltg_uuid_t[16];
 
 typedef struct ltg_listener ltg_listener_t;
 
+typedef struct ltg_io_thread ltg_io_thread_t;
+
+typedef struct ltg_broadcast ltg_broadcast_t;
+
 typedef enum {
 
 	ltg_handshake = 0,
@@ -6,6 +6,7 @@
 
 #include "../main.h"
 #include "../util/id_vector.h"
+#include "../util/vector.h"
 #include "../util/util.h"
 #include "../util/lock_util.h"
 #include "../util/str_util.h"
@@ -38,16 +39,56 @@ struct ltg_listener {
 		_Atomic uint32_t max;
 	} online;
 
+	// I/O threads (if count is 0, each client gets its own thread)
+	struct {
+		uint16_t count;
+		uint16_t next;
+		ltg_io_thread_t* threads;
+	} io;
+
 	cry_rsa_keypair_t keypair;
 
 };
 
+// I/O threads wait on many non-blocking client sockets at once
+struct ltg_io_thread {
+
+	ltg_listener_t* listener;
+
+	pthread_t thread;
+
+	int32_t epoll;
+	int32_t wake;
+
+	uint16_t id;
+
+};
+
 struct ltg_client {
 
 	ltg_listener_t* listener;
 
 	// client's thread
 	pthread_t thread;
+
+	// I/O thread (only non-null when the listener uses I/O threads)
+	ltg_io_thread_t* io;
+
+	// bytes waiting to be sent, flushed at the end of every tick
+	struct {
+		utl_vector_t queue;
+		bool waiting : 1; // I/O thread is waiting for the socket to be writable
+		bool closing : 1; // client closed its side, it's freed once the queue is sent (I/O threads only)
+	} send;
+
+	// received bytes, packets are handled once they have been fully received
+	struct {
+		pck_packet_t* packet;
+		uint32_t capacity;
+		uint32_t start;
+		uint32_t decrypted;
+		uint32_t end;
+	} receive;
 	
 	// player entity (only non-null when in PLAY state)
 	ent_player_t* entity;
@@ -112,10 +153,21 @@ struct ltg_client {
 
 };
 
+// a packet framed and compressed once, to be sent to many clients in the play state
+struct ltg_broadcast {
+
+	_Atomic uint32_t references;
+
+	size_t length;
+	byte_t bytes[];
+
+};
+
 extern void ltg_init();
 extern void* t_ltg_run(void*);
 extern void ltg_accept(ltg_client_t*);
 extern void* t_ltg_client(void*);
+extern void* t_ltg_io(void*);
 
 static inline ltg_client_t* ltg_get_client_by_id(ltg_listener_t* listener, uint32_t id) {
 	
@@ -132,6 +184,18 @@ static inline ltg_client_t* ltg_get_client_by_id(ltg_listener_t* listener, uint3
 extern bool ltg_handle_packet(ltg_client_t* client, pck_packet_t* packet);
 
 extern void ltg_send(ltg_client_t*, pck_packet_t*);
+extern void ltg_send_immediately(ltg_client_t*, pck_packet_t*);
+
+extern ltg_broadcast_t* ltg_broadcast_create(pck_packet_t*);
+extern void ltg_broadcast_release(ltg_broadcast_t*);
+extern void ltg_send_broadcast(ltg_client_t*, ltg_broadcast_t*);
+
+static inline void ltg_broadcast_retain(ltg_broadcast_t* broadcast) {
+	broadcast->references++;
+}
+
+extern void ltg_flush(ltg_client_t*);
+extern void ltg_flush_all(ltg_listener_t*);
 
 extern void ltg_disconnect(ltg_client_t*);
 
@@ -271,6 +335,14 @@ static inline pthread_t ltg_get_thread(const ltg_listener_t* listener) {
 	return listener->thread;
 }
 
+static inline uint16_t ltg_get_io_thread_count(const ltg_listener_t* listener) {
+	return listener->io.count;
+}
+
+static inline pthread_t ltg_get_io_thread(const ltg_listener_t* listener, uint16_t idx) {
+	return listener->io.threads[idx].thread;
+}
+
 static inline uint32_t ltg_get_client_count(ltg_listener_t* listener) {
 	
 	uint32_t size = 0;
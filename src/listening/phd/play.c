@@ -516,11 +516,7 @@ bool phd_handle_player_position(ltg_client_t* client, pck_packet_t* packet) {
 	const float64_t z = pck_read_float64(packet);
 	const bool on_ground = pck_read_int8(packet);
 
-	const float64_t d_x = x - ent_get_x(entity);
-	const float64_t d_y = y - ent_get_y(entity);
-	const float64_t d_z = z - ent_get_z(entity);
-
-	ent_move(entity, d_x, d_y, d_z, on_ground);
+	ent_move(entity, x, y, z, on_ground);
 
 	/*
 	if (old_chunk != player->living_entity.entity.chunk) {
@@ -548,11 +544,7 @@ bool phd_handle_player_position_and_look(ltg_client_t* client, pck_packet_t* pac
 
 	const bool on_ground = pck_read_int8(packet);
 
-	const float64_t d_x = x - ent_get_x(ent_le_get_entity(player));
-	const float64_t d_y = y - ent_get_y(ent_le_get_entity(player));
-	const float64_t d_z = z - ent_get_z(ent_le_get_entity(player));
-
-	ent_le_move_look(player, d_x, d_y, d_z, yaw, pitch, on_ground);
+	ent_le_move_look(player, x, y, z, yaw, pitch, on_ground);
 
 	/*if (old_chunk != player->living_entity.entity.chunk) {
 
@@ -832,6 +824,22 @@ void phd_send_spawn_player(ltg_client_t* client, ent_player_t* player) {
 
 }
 
+ltg_broadcast_t* phd_broadcast_block_change(int32_t x, int16_t y, int32_t z, mat_block_protocol_id_t block) {
+
+	PCK_INLINE(packet, 14, io_big_endian);
+
+	pck_write_var_int(packet, 0x0C);
+	pck_write_position(packet, (pck_position_t) {
+		.x = x,
+		.y = y,
+		.z = z
+	});
+	pck_write_var_int(packet, block);
+
+	return ltg_broadcast_create(packet);
+
+}
+
 void phd_send_server_difficulty(ltg_client_t* client) {
 
 	PCK_INLINE(packet, 3, io_big_endian);
@@ -844,7 +852,7 @@ void phd_send_server_difficulty(ltg_client_t* client) {
 
 }
 
-void phd_send_chat_message(ltg_client_t* client, const char* message, size_t message_len, const ltg_uuid_t uuid) {
+ltg_broadcast_t* phd_broadcast_chat_message(const char* message, size_t message_len, const ltg_uuid_t uuid) {
 
 	PCK_INLINE(packet, 23 + message_len, io_big_endian);
 
@@ -853,24 +861,40 @@ void phd_send_chat_message(ltg_client_t* client, const char* message, size_t mes
 	pck_write_int8(packet, 0); // position
 	pck_write_bytes(packet, uuid, 16);
 
-	ltg_send(client, packet);
+	return ltg_broadcast_create(packet);
 
 }
 
-void phd_send_system_chat_message(ltg_client_t* client, const char* message, size_t message_len) {
-
-	PCK_INLINE(packet, 23 + message_len, io_big_endian);
+static inline void phd_write_system_chat_message(pck_packet_t* packet, const char* message, size_t message_len) {
 
 	pck_write_var_int(packet, 0x0F);
 	pck_write_string(packet, message, message_len);
 	pck_write_int8(packet, 1); // position
 	pck_write_int64(packet, 0); // sender
 	pck_write_int64(packet, 0);
+
+}
+
+void phd_send_system_chat_message(ltg_client_t* client, const char* message, size_t message_len) {
+
+	PCK_INLINE(packet, 23 + message_len, io_big_endian);
+
+	phd_write_system_chat_message(packet, message, message_len);
 	
 	ltg_send(client, packet);
 
 }
 
+ltg_broadcast_t* phd_broadcast_system_chat_message(const char* message, size_t message_len) {
+
+	PCK_INLINE(packet, 23 + message_len, io_big_endian);
+
+	phd_write_system_chat_message(packet, message, message_len);
+	
+	return ltg_broadcast_create(packet);
+
+}
+
 void phd_send_declare_commands(ltg_client_t* client) {
 
 	ltg_send(client, cmd_get_graph());
@@ -919,18 +943,34 @@ void phd_send_disconnect(ltg_client_t* client, const char* message, size_t messa
 
 }
 
-void phd_send_entity_status(ltg_client_t* client, ent_entity_t* entity, uint8_t status) {
-
-	PCK_INLINE(packet, 6, io_big_endian);
+static inline void phd_write_entity_status(pck_packet_t* packet, ent_entity_t* entity, uint8_t status) {
 
 	pck_write_var_int(packet, 0x1b);
 	pck_write_int32(packet, ent_get_id(entity));
 	pck_write_int8(packet, status);
 
+}
+
+void phd_send_entity_status(ltg_client_t* client, ent_entity_t* entity, uint8_t status) {
+
+	PCK_INLINE(packet, 6, io_big_endian);
+
+	phd_write_entity_status(packet, entity, status);
+
 	ltg_send(client, packet);
 
 }
 
+ltg_broadcast_t* phd_broadcast_entity_status(ent_entity_t* entity, uint8_t status) {
+
+	PCK_INLINE(packet, 6, io_big_endian);
+
+	phd_write_entity_status(packet, entity, status);
+
+	return ltg_broadcast_create(packet);
+
+}
+
 void phd_send_unload_chunk(ltg_client_t* client, wld_chunk_t* chunk) {
 	
 	PCK_INLINE(packet, 9, io_big_endian);
@@ -969,329 +1009,342 @@ void phd_send_keep_alive(ltg_client_t* client, uint64_t id) {
 	pck_write_var_int(packet, 0x21);
 	pck_write_int64(packet, id);
 
-	ltg_send(client, packet);
+	// sent right away so the ping isn't skewed by the tick
+	ltg_send_immediately(client, packet);
 
 }
 
-struct {
-	pck_packet_t* packet;
-	pthread_mutex_t lock;
-} phd_chunk_packet = {
-	.packet = NULL,
-	.lock = PTHREAD_MUTEX_INITIALIZER
-};
+// writes the block states and biomes of a section
+static inline void phd_write_chunk_section(pck_packet_t* packet, wld_chunk_section_t* section) {
 
-// This is one chunky function, optimize it if possible TODO
-void phd_send_chunk_data_and_update_light(ltg_client_t* client, wld_chunk_t* chunk) {
+	const uint16_t block_count = wld_chunk_section_get_block_count(section);
 
-	with_lock (&phd_chunk_packet.lock) {
+	// block state array
+	wld_block_storage_t* blocks = wld_chunk_section_get_blocks(section);
 
-		if (phd_chunk_packet.packet == NULL) {
-			phd_chunk_packet.packet = pck_create(262144, io_big_endian);
+	if (block_count > 0 && blocks->bits > 0) {
+
+		// the data is copied before the palette is read, so the palette has every block it points to
+		uint64_t data[blocks->data_length];
+		for (uint16_t j = 0; j < blocks->data_length; ++j) {
+			data[j] = blocks->data[j];
 		}
 
-		pck_packet_t* packet = phd_chunk_packet.packet;
+		pck_write_int8(packet, blocks->bits);
 
-		packet->cursor = 0;
-		
-		pck_write_var_int(packet, 0x22);
-		pck_write_int32(packet, wld_get_chunk_x(chunk));
-		pck_write_int32(packet, wld_get_chunk_z(chunk));
+		if (blocks->bits != WLD_STORAGE_DIRECT_BITS) {
+			// use palette
+			const uint16_t palette_length = blocks->palette_length;
+			_Atomic mat_block_protocol_id_t* palette = wld_block_storage_get_palette(blocks);
+
+			pck_write_var_int(packet, palette_length);
+			for (uint16_t j = 0; j < palette_length; ++j) {
+				const mat_block_protocol_id_t block = palette[j];
+				pck_write_var_int(packet, block == WLD_STORAGE_NO_BLOCK ? 0 : block);
+			}
+		}
 
-		// CHUNK MASK
+		pck_write_var_int(packet, blocks->data_length);
+		for (uint16_t j = 0; j < blocks->data_length; ++j) {
+			pck_write_int64(packet, data[j]);
+		}
 
-		/*
-		const uint16_t chunk_mask_length = ((chunk_height - 1) >> 6) + 1;
-		pck_write_var_int(packet, chunk_mask_length);
-		int64_t primary_chunk_mask[chunk_mask_length];
-		memset(primary_chunk_mask, 0, sizeof(primary_chunk_mask));
-		for (uint16_t i = 0; i < chunk_height; ++i) {
-			if (wld_chunk_section_get_block_count(wld_chunk_get_section(chunk, i)) != 0) {
-				primary_chunk_mask[i >> 6] |= (1 << (i & 0x3f));
+	} else {
+		pck_write_int8(packet, 0);
+		pck_write_var_int(packet, block_count > 0 ? wld_block_storage_get_palette(blocks)[0] : mat_get_block_default_protocol_id_by_type(mat_block_air));
+		pck_write_var_int(packet, 0);
+	}
+	// biome array
+	{
+		struct {
+			mat_biome_type_t array[64];
+			uint8_t length;
+		} palette = {
+			.length = 1
+		};
+		palette.array[0] = wld_chunk_section_get_biomes(section)[0];
+
+		int8_t biome_array[64];
+
+		struct {
+			mat_biome_type_t biome;
+			uint16_t palette;
+		} previous = {
+			.biome = palette.array[0],
+			.palette = 0
+		};
+
+		for (uint16_t j = 0; j < 64; ++j) {
+
+			const mat_biome_type_t biome = wld_chunk_section_get_biomes(section)[j];
+			if (biome == previous.biome) {
+				biome_array[j] = previous.palette;
+			} else {
+				// test if block is in palette
+				for (uint8_t k = 0; k < palette.length; ++k) {
+					if (palette.array[k] == biome) {
+						biome_array[j] = previous.palette = k;
+						previous.biome = biome;
+
+						goto endb;
+					}
+				}
+
+				// add to palette (it hasn't been found)
+				if (palette.length < 8) {
+					palette.array[palette.length] = biome;
+					biome_array[j] = previous.palette = palette.length++;
+					previous.biome = biome;
+				} else {
+					// palette is too big, use direct
+					break;
+				}
 			}
+			endb:{}
 		}
-		for (uint16_t i = 0; i < chunk_mask_length; ++i) {
-			pck_write_int64(packet, primary_chunk_mask[i]);
-		}*/
 
-		/*
-		int32_t primary_chunk_mask = 0;
-		for (uint16_t i = 0; i < chunk_height; ++i) {
-			if (chunk->sections[i].block_count != 0) {
-				primary_chunk_mask |= (1 << i);
+		if (palette.length == 1) {
+			pck_write_int8(packet, 0);
+			pck_write_var_int(packet, palette.array[0]);
+			pck_write_var_int(packet, 0);
+		} else if (palette.length < 9) {
+			// use palette
+			uint8_t bits_per_biome;
+			if (palette.length < 3) {
+				bits_per_biome = 1;
+			} else if (palette.length < 5) {
+				bits_per_biome = 2;
+			} else {
+				bits_per_biome = 3;
 			}
+			const uint8_t biomes_per_long = 64 / bits_per_biome;
+			const int32_t data_array_length = 1 + (63 / biomes_per_long);
+
+			pck_write_int8(packet, bits_per_biome);
+			pck_write_var_int(packet, palette.length);
+			for (uint8_t j = 0; j < palette.length; ++j) {
+				pck_write_var_int(packet, palette.array[j]);
+			}
+
+			pck_write_var_int(packet, data_array_length);
+			
+			utl_encode_bytes_to_longs_r(biome_array, 64, bits_per_biome, (int64_t*) pck_cursor(packet));
+			packet->cursor += data_array_length << 3;
+		} else {
+			// direct
+			const uint8_t bits_per_biome = 4; // log2(biome_count)
+			const uint8_t biomes_per_long = 64 / bits_per_biome;
+			const int32_t data_array_length = 1 + (63 / biomes_per_long);
+
+			pck_write_int8(packet, bits_per_biome);
+			pck_write_var_int(packet, data_array_length); // data array length
+			
+			utl_encode_bytes_to_longs_r((int8_t*) wld_chunk_section_get_biomes(section), 64, bits_per_biome, (int64_t*) pck_cursor(packet));
+			packet->cursor += data_array_length << 3;
 		}
-		pck_write_var_int(packet, primary_chunk_mask);
-		*/
+	}
 
-		// HEIGHTMAP
-		
-		const uint16_t chunk_height = mat_get_chunk_height(wld_get_environment(wld_chunk_get_world(chunk)));
+}
 
-		const uint8_t bits_per_heightmap = ceil(log2((chunk_height << 4) + 1));
-		const uint32_t heightmap_size = 1 + (255 / (64 / bits_per_heightmap));
-		int64_t motion_blocking[heightmap_size];
-		int64_t world_surface[heightmap_size];
+// every thread encodes chunks into its own buffer, which is freed when the thread exits
+static pthread_key_t phd_chunk_packet;
+static pthread_once_t phd_chunk_packet_once = PTHREAD_ONCE_INIT;
 
-		utl_encode_shorts_to_longs(wld_chunk_get_highest_motion_blocking(chunk), 256, bits_per_heightmap, motion_blocking);
-		utl_encode_shorts_to_longs(wld_chunk_get_highest_world_surface(chunk), 256, bits_per_heightmap, world_surface);
+static void phd_create_chunk_packet_key() {
+	pthread_key_create(&phd_chunk_packet, free);
+}
 
-		// create heightmap
-		mnbt_doc* doc = mnbt_new();
-		mnbt_tag* tag = mnbt_new_tag(doc, UTL_CSTRTOARG(""), MNBT_COMPOUND, mnbt_val_compound());
-		mnbt_push_tag(tag, mnbt_new_tag(doc, UTL_CSTRTOARG("MOTION_BLOCKING"), MNBT_LONG_ARRAY, mnbt_val_long_array(motion_blocking, heightmap_size)));
-		mnbt_push_tag(tag, mnbt_new_tag(doc, UTL_CSTRTOARG("WORLD_SURFACE"), MNBT_LONG_ARRAY, mnbt_val_long_array(world_surface, heightmap_size)));
-		mnbt_set_root(doc, tag);
+// This is one chunky function, optimize it if possible TODO
+// expects the chunk's encode lock to be locked
+static ltg_broadcast_t* phd_create_chunk_data_and_update_light(wld_chunk_t* chunk) {
 
-		pck_write_nbt(packet, doc);
+	pthread_once(&phd_chunk_packet_once, phd_create_chunk_packet_key);
 
-		mnbt_free(doc);
+	pck_packet_t* packet = pthread_getspecific(phd_chunk_packet);
 
-		// BIOMES
+	if (packet == NULL) {
+		packet = pck_create(262144, io_big_endian);
+		pthread_setspecific(phd_chunk_packet, packet);
+	}
 
-		/*
-		pck_write_var_int(packet, chunk_height << 6);
+	packet->cursor = 0;
+	
+	pck_write_var_int(packet, 0x22);
+	pck_write_int32(packet, wld_get_chunk_x(chunk));
+	pck_write_int32(packet, wld_get_chunk_z(chunk));
 
-		for (uint16_t i = 0; i < chunk_height; ++i) {
-			for (uint8_t x = 0; x < 4; ++x) {
-				for (uint8_t z = 0; z < 4; ++z) {
-					for (uint8_t y = 0; y < 4; ++y) {
-						pck_write_var_int(packet, wld_chunk_section_get_biome(wld_chunk_get_section(chunk, i), x, y, z));
-					}
-				}
-			}
+	// CHUNK MASK
+
+	/*
+	const uint16_t chunk_mask_length = ((chunk_height - 1) >> 6) + 1;
+	pck_write_var_int(packet, chunk_mask_length);
+	int64_t primary_chunk_mask[chunk_mask_length];
+	memset(primary_chunk_mask, 0, sizeof(primary_chunk_mask));
+	for (uint16_t i = 0; i < chunk_height; ++i) {
+		if (wld_chunk_section_get_block_count(wld_chunk_get_section(chunk, i)) != 0) {
+			primary_chunk_mask[i >> 6] |= (1 << (i & 0x3f));
 		}
-		*/
+	}
+	for (uint16_t i = 0; i < chunk_mask_length; ++i) {
+		pck_write_int64(packet, primary_chunk_mask[i]);
+	}*/
 
-		// CHUNK DATA
+	/*
+	int32_t primary_chunk_mask = 0;
+	for (uint16_t i = 0; i < chunk_height; ++i) {
+		if (chunk->sections[i].block_count != 0) {
+			primary_chunk_mask |= (1 << i);
+		}
+	}
+	pck_write_var_int(packet, primary_chunk_mask);
+	*/
 
-		// am i really gonna waste time copying data from one stream to another or am i gonna just waste 4 bytes?
-		// you're damn right i'm gonna waste 4 bytes, speed is key
-		const size_t data_len = packet->cursor;
-		packet->cursor += 5;
+	// HEIGHTMAP
+	
+	const uint16_t chunk_height = mat_get_chunk_height(wld_get_environment(wld_chunk_get_world(chunk)));
 
-		for (uint16_t i = 0; i < chunk_height; ++i) {
+	const uint8_t bits_per_heightmap = ceil(log2((chunk_height << 4) + 1));
+	const uint32_t heightmap_size = 1 + (255 / (64 / bits_per_heightmap));
+	int64_t motion_blocking[heightmap_size];
+	int64_t world_surface[heightmap_size];
 
-			const uint16_t block_count = wld_chunk_section_get_block_count(wld_chunk_get_section(chunk, i));
-
-			pck_write_int16(packet, block_count);
-
-			// block state array
-			if (block_count > 0) {
-				struct {
-					mat_block_protocol_id_t array[256];
-					uint8_t length;
-				} palette = {
-					.length = 1
-				};
-				palette.array[0] = wld_chunk_section_get_blocks(wld_chunk_get_section(chunk, i))[0];
-				
-				int8_t block_array[4096];
-
-				struct {
-					mat_block_protocol_id_t block;
-					uint16_t palette;
-				} previous = {
-					.block = palette.array[0],
-					.palette = 0
-				};
-
-				for (uint16_t j = 0; j < 4096; ++j) {
-
-					const mat_block_protocol_id_t block = wld_chunk_section_get_blocks(wld_chunk_get_section(chunk, i))[j];
-					if (block == previous.block) {
-						block_array[j] = previous.palette;
-					} else {
-						// test if block is in palette
-						for (uint8_t k = 0; k < palette.length; ++k) {
-							if (palette.array[k] == block) {
-								block_array[j] = previous.palette = k;
-								previous.block = block;
+	utl_encode_shorts_to_longs(wld_chunk_get_highest_motion_blocking(chunk), 256, bits_per_heightmap, motion_blocking);
+	utl_encode_shorts_to_longs(wld_chunk_get_highest_world_surface(chunk), 256, bits_per_heightmap, world_surface);
 
-								goto end;
-							}
-						}
+	// create heightmap
+	mnbt_doc* doc = mnbt_new();
+	mnbt_tag* tag = mnbt_new_tag(doc, UTL_CSTRTOARG(""), MNBT_COMPOUND, mnbt_val_compound());
+	mnbt_push_tag(tag, mnbt_new_tag(doc, UTL_CSTRTOARG("MOTION_BLOCKING"), MNBT_LONG_ARRAY, mnbt_val_long_array(motion_blocking, heightmap_size)));
+	mnbt_push_tag(tag, mnbt_new_tag(doc, UTL_CSTRTOARG("WORLD_SURFACE"), MNBT_LONG_ARRAY, mnbt_val_long_array(world_surface, heightmap_size)));
+	mnbt_set_root(doc, tag);
 
-						// add to palette (it hasn't been found)
-						if (palette.length < 255) {
-							palette.array[palette.length] = block;
-							block_array[j] = previous.palette = palette.length++;
-							previous.block = block;
-						} else {
-							// palette is too big, use direct
-							break;
-						}
-					}
-					end:{}
-				}
+	pck_write_nbt(packet, doc);
 
-				if (palette.length == 1) {
-					pck_write_int8(packet, 0);
-					pck_write_var_int(packet, palette.array[0]);
-					pck_write_var_int(packet, 0);
-				} else if (palette.length < 255) {
-					// use palette
-					uint8_t bits_per_block;
-					if (palette.length < 17) {
-						bits_per_block = 4;
-					} else if (palette.length < 33) {
-						bits_per_block = 5;
-					} else if (palette.length < 65) {
-						bits_per_block = 6;
-					} else if (palette.length < 129) {
-						bits_per_block = 7;
-					} else {
-						bits_per_block = 8;
-					}
-					const uint8_t blocks_per_long = 64 / bits_per_block;
-					const int32_t data_array_length = 1 + (4095 / blocks_per_long);
+	mnbt_free(doc);
 
-					pck_write_int8(packet, bits_per_block);
-					pck_write_var_int(packet, palette.length);
-					for (uint8_t j = 0; j < palette.length; ++j) {
-						pck_write_var_int(packet, palette.array[j]);
-					}
+	// BIOMES
 
-					pck_write_var_int(packet, data_array_length);
-					
-					utl_encode_bytes_to_longs_r(block_array, 4096, bits_per_block, (int64_t*) pck_cursor(packet));
-					packet->cursor += data_array_length << 3;
-				} else {
-					// direct
-					const uint8_t bits_per_block = 15; // log2(block_state_count)
-					const uint8_t blocks_per_long = 64 / bits_per_block;
-					const int32_t data_array_length = 1 + (4095 / blocks_per_long);
-
-					pck_write_int8(packet, bits_per_block);
-					pck_write_var_int(packet, data_array_length); // data array length
-					
-					utl_encode_shorts_to_longs_r((int16_t*) wld_chunk_section_get_blocks(wld_chunk_get_section(chunk, i)), 4096, bits_per_block, (int64_t*) pck_cursor(packet));
-					packet->cursor += data_array_length << 3;
+	/*
+	pck_write_var_int(packet, chunk_height << 6);
+
+	for (uint16_t i = 0; i < chunk_height; ++i) {
+		for (uint8_t x = 0; x < 4; ++x) {
+			for (uint8_t z = 0; z < 4; ++z) {
+				for (uint8_t y = 0; y < 4; ++y) {
+					pck_write_var_int(packet, wld_chunk_section_get_biome(wld_chunk_get_section(chunk, i), x, y, z));
 				}
-			} else {
-				pck_write_int8(packet, 0);
-				pck_write_var_int(packet, mat_get_block_default_protocol_id_by_type(mat_block_air));
-				pck_write_var_int(packet, 0);
 			}
-			// biome array
-			{
-				struct {
-					mat_biome_type_t array[64];
-					uint8_t length;
-				} palette = {
-					.length = 1
-				};
-				palette.array[0] = wld_chunk_section_get_biomes(wld_chunk_get_section(chunk, i))[0];
-
-				int8_t biome_array[64];
-
-				struct {
-					mat_biome_type_t biome;
-					uint16_t palette;
-				} previous = {
-					.biome = palette.array[0],
-					.palette = 0
-				};
-
-				for (uint16_t j = 0; j < 64; ++j) {
-
-					const mat_biome_type_t biome = wld_chunk_section_get_biomes(wld_chunk_get_section(chunk, i))[j];
-					if (biome == previous.biome) {
-						biome_array[j] = previous.palette;
-					} else {
-						// test if block is in palette
-						for (uint8_t k = 0; k < palette.length; ++k) {
-							if (palette.array[k] == biome) {
-								biome_array[j] = previous.palette = k;
-								previous.biome = biome;
+		}
+	}
+	*/
 
-								goto endb;
-							}
-						}
+	// CHUNK DATA
 
-						// add to palette (it hasn't been found)
-						if (palette.length < 8) {
-							palette.array[palette.length] = biome;
-							biome_array[j] = previous.palette = palette.length++;
-							previous.biome = biome;
-						} else {
-							// palette is too big, use direct
-							break;
-						}
-					}
-					endb:{}
-				}
+	// am i really gonna waste time copying data from one stream to another or am i gonna just waste 4 bytes?
+	// you're damn right i'm gonna waste 4 bytes, speed is key
+	const size_t data_len = packet->cursor;
+	packet->cursor += 5;
 
-				if (palette.length == 1) {
-					pck_write_int8(packet, 0);
-					pck_write_var_int(packet, palette.array[0]);
-					pck_write_var_int(packet, 0);
-				} else if (palette.length < 9) {
-					// use palette
-					uint8_t bits_per_biome;
-					if (palette.length < 3) {
-						bits_per_biome = 1;
-					} else if (palette.length < 5) {
-						bits_per_biome = 2;
-					} else {
-						bits_per_biome = 3;
-					}
-					const uint8_t biomes_per_long = 64 / bits_per_biome;
-					const int32_t data_array_length = 1 + (63 / biomes_per_long);
+	// sections are only encoded again if they changed since they were last sent
+	for (uint16_t i = 0; i < chunk_height; ++i) {
 
-					pck_write_int8(packet, bits_per_biome);
-					pck_write_var_int(packet, palette.length);
-					for (uint8_t j = 0; j < palette.length; ++j) {
-						pck_write_var_int(packet, palette.array[j]);
-					}
+		wld_chunk_section_t* section = wld_chunk_get_section(chunk, i);
+
+		pck_write_int16(packet, wld_chunk_section_get_block_count(section));
+
+		if (wld_chunk_section_is_empty(section)) {
+
+			// the empty section is shared by every chunk, it is cheap to write so it isn't cached
+			phd_write_chunk_section(packet, section);
+
+		} else if (section->encoded.bytes == NULL || section->encoded.outdated) {
+
+			// clear first, so changes made while encoding mark it outdated again
+			section->encoded.outdated = false;
+
+			const size_t start = packet->cursor;
+			phd_write_chunk_section(packet, section);
+
+			section->encoded.length = packet->cursor - start;
+			section->encoded.bytes = realloc(section->encoded.bytes, section->encoded.length);
+			memcpy(section->encoded.bytes, packet->bytes + start, section->encoded.length);
+
+		} else {
+
+			pck_write_bytes(packet, section->encoded.bytes, section->encoded.length);
 
-					pck_write_var_int(packet, data_array_length);
-					
-					utl_encode_bytes_to_longs_r(biome_array, 64, bits_per_biome, (int64_t*) pck_cursor(packet));
-					packet->cursor += data_array_length << 3;
-				} else {
-					// direct
-					const uint8_t bits_per_biome = 4; // log2(biome_count)
-					const uint8_t biomes_per_long = 64 / bits_per_biome;
-					const int32_t data_array_length = 1 + (63 / biomes_per_long);
-
-					pck_write_int8(packet, bits_per_biome);
-					pck_write_var_int(packet, data_array_length); // data array length
-					
-					utl_encode_bytes_to_longs_r((int8_t*) wld_chunk_section_get_biomes(wld_chunk_get_section(chunk, i)), 64, bits_per_biome, (int64_t*) pck_cursor(packet));
-					packet->cursor += data_array_length << 3;
-				}
-			}
 		}
 
-		const size_t current = packet->cursor;
-		packet->cursor = data_len;
-		pck_write_long_var_int(packet, current - data_len - 5);
-		packet->cursor = current;
+	}
 
-		// BLOCK ENTITIES
-		// TODO block entities
-		pck_write_var_int(packet, 0);
+	const size_t current = packet->cursor;
+	packet->cursor = data_len;
+	pck_write_long_var_int(packet, current - data_len - 5);
+	packet->cursor = current;
+
+	// BLOCK ENTITIES
+	// TODO block entities
+	pck_write_var_int(packet, 0);
+
+	// light
+	pck_write_int8(packet, true); // trust edges
+
+	pck_write_var_int(packet, 0); // sky light mask length
 
-		// light
-		pck_write_int8(packet, true); // trust edges
+	pck_write_var_int(packet, 0); // block light mask length
+
+	pck_write_var_int(packet, 0); // empty sky light mask length
+
+	pck_write_var_int(packet, 0); // empty block light mask length
+
+	pck_write_var_int(packet, 0); // sky light array count
+
+	pck_write_var_int(packet, 0); // block light array count
+
+	return ltg_broadcast_create(packet);
 
-		pck_write_var_int(packet, 0); // sky light mask length
+}
 
-		pck_write_var_int(packet, 0); // block light mask length
+void phd_send_chunk_data_and_update_light(ltg_client_t* client, wld_chunk_t* chunk) {
 
-		pck_write_var_int(packet, 0); // empty sky light mask length
+	ltg_broadcast_t* chunk_data = NULL;
 
-		pck_write_var_int(packet, 0); // empty block light mask length
+	// only the first viewer of a chunk version encodes and compresses it
+	with_lock (&chunk->encode_lock) {
 
-		pck_write_var_int(packet, 0); // sky light array count
+		const uint32_t version = wld_chunk_get_version(chunk);
 
-		pck_write_var_int(packet, 0); // block light array count
+		chunk_data = wld_get_cached_chunk_packet(chunk, version);
 
-		ltg_send(client, packet);
+		if (chunk_data == NULL) {
+			chunk_data = phd_create_chunk_data_and_update_light(chunk);
+			wld_cache_chunk_packet(chunk, version, chunk_data);
+		}
 
 	}
 
+	ltg_send_broadcast(client, chunk_data);
+	ltg_broadcast_release(chunk_data);
+
+}
+
+void phd_send_subscribed_chunk(wld_chunk_t* chunk, void* client_id) {
+
+	ltg_client_t* client = ltg_get_client_by_id(sky_get_listener(), (uintptr_t) client_id);
+
+	if (client == NULL || !wld_chunk_has_subscriber(chunk, (uintptr_t) client_id)) return;
+
+	phd_send_chunk_data_and_update_light(client, chunk);
+
+	// send chunk entities
+	uint32_t entity_length = wld_chunk_get_entity_length(chunk);
+	for (uint32_t i = 0; i < entity_length; ++i) {
+		ent_entity_t* entity = wld_chunk_get_entity(chunk, i);
+		if (entity != NULL) {
+			phd_update_send_entity(client, entity);
+		}
+	}
+
 }
 
 void phd_send_update_light(ltg_client_t* client, wld_chunk_t* chunk) {
@@ -1422,7 +1475,7 @@ void phd_send_join_game(ltg_client_t* client) {
 
 }
 
-void phd_send_entity_position(ltg_client_t* client, ent_entity_t* entity, float64_t d_x, float64_t d_y, float64_t d_z) {
+ltg_broadcast_t* phd_broadcast_entity_position(ent_entity_t* entity, float64_t d_x, float64_t d_y, float64_t d_z) {
 
 	PCK_INLINE(packet, 13, io_big_endian);
 
@@ -1434,11 +1487,11 @@ void phd_send_entity_position(ltg_client_t* client, ent_entity_t* entity, float6
 	pck_write_int16(packet, d_z * 4096);
 	pck_write_int8(packet, ent_is_on_ground(entity));
 
-	ltg_send(client, packet);
+	return ltg_broadcast_create(packet);
 
 }
 
-void phd_send_entity_position_and_rotation(ltg_client_t* client, ent_living_entity_t* entity, float64_t d_x, float64_t d_y, float64_t d_z) {
+ltg_broadcast_t* phd_broadcast_entity_position_and_rotation(ent_living_entity_t* entity, float64_t d_x, float64_t d_y, float64_t d_z) {
 
 	PCK_INLINE(packet, 15, io_big_endian);
 
@@ -1452,11 +1505,11 @@ void phd_send_entity_position_and_rotation(ltg_client_t* client, ent_living_enti
 	pck_write_int8(packet, io_angle_to_byte(ent_le_get_pitch(entity)));
 	pck_write_int8(packet, ent_is_on_ground(ent_le_get_entity(entity)));
 
-	ltg_send(client, packet);
+	return ltg_broadcast_create(packet);
 
 }
 
-void phd_send_entity_rotation(ltg_client_t* client, ent_living_entity_t* entity) {
+ltg_broadcast_t* phd_broadcast_entity_rotation(ent_living_entity_t* entity) {
 	
 	PCK_INLINE(packet, 9, io_big_endian);
 
@@ -1468,7 +1521,7 @@ void phd_send_entity_rotation(ltg_client_t* client, ent_living_entity_t* entity)
 	pck_write_int8(packet, io_angle_to_byte(ent_le_get_pitch(entity)));
 	pck_write_int8(packet, ent_is_on_ground(ent_le_get_entity(entity)));
 
-	ltg_send(client, packet);
+	return ltg_broadcast_create(packet);
 
 }
 
@@ -1552,7 +1605,7 @@ void phd_send_player_info_add_players(ltg_client_t* client) {
 
 }
 
-void phd_send_player_info_add_player(ltg_client_t* client, ltg_client_t* player) {
+ltg_broadcast_t* phd_broadcast_player_info_add_player(ltg_client_t* player) {
 
 	PCK_INLINE(packet, 2048, io_big_endian);
 	pck_write_var_int(packet, 0x36);
@@ -1581,7 +1634,7 @@ void phd_send_player_info_add_player(ltg_client_t* client, ltg_client_t* player)
 
 	pck_write_int8(packet, false); // has display name
 
-	ltg_send(client, packet);
+	return ltg_broadcast_create(packet);
 
 }
 
@@ -1589,7 +1642,7 @@ void phd_send_player_info_update_gamemode(__attribute__((unused)) ltg_client_t*
 
 }
 
-void phd_send_player_info_update_latency(ltg_client_t* client) {
+ltg_broadcast_t* phd_broadcast_player_info_update_latency() {
 
 	uint32_t online_count = ltg_get_online_count(sky_get_listener());
 
@@ -1610,7 +1663,7 @@ void phd_send_player_info_update_latency(ltg_client_t* client) {
 		}
 	}
 
-	ltg_send(client, packet);
+	return ltg_broadcast_create(packet);
 
 }
 
@@ -1618,7 +1671,7 @@ void phd_send_player_info_update_display_name(__attribute__((unused)) ltg_client
 
 }
 
-void phd_send_player_info_remove_player(ltg_client_t* client, ltg_uuid_t uuid) {
+ltg_broadcast_t* phd_broadcast_player_info_remove_player(ltg_uuid_t uuid) {
 
 	PCK_INLINE(packet, 19, io_big_endian);
 	pck_write_var_int(packet, 0x36);
@@ -1626,7 +1679,7 @@ void phd_send_player_info_remove_player(ltg_client_t* client, ltg_uuid_t uuid) {
 	pck_write_var_int(packet, 1);
 	pck_write_bytes(packet, uuid, 16);
 
-	ltg_send(client, packet);
+	return ltg_broadcast_create(packet);
 
 }
 
@@ -1711,18 +1764,61 @@ void phd_send_respawn(ltg_client_t* client, wld_world_t* world, bool keep_metada
 
 }
 
-void phd_send_entity_head_look(ltg_client_t* client, ent_living_entity_t* entity) {
-
-	PCK_INLINE(packet, 7, io_big_endian);
+static inline void phd_write_entity_head_look(pck_packet_t* packet, ent_living_entity_t* entity) {
 
 	pck_write_var_int(packet, 0x3e);
 	pck_write_var_int(packet, ent_get_id(ent_le_get_entity(entity)));
 	pck_write_int8(packet, io_angle_to_byte(ent_le_get_yaw(entity)));
 
+}
+
+void phd_send_entity_head_look(ltg_client_t* client, ent_living_entity_t* entity) {
+
+	PCK_INLINE(packet, 7, io_big_endian);
+
+	phd_write_entity_head_look(packet, entity);
+
 	ltg_send(client, packet);
 
 }
 
+ltg_broadcast_t* phd_broadcast_entity_head_look(ent_living_entity_t* entity) {
+
+	PCK_INLINE(packet, 7, io_big_endian);
+
+	phd_write_entity_head_look(packet, entity);
+
+	return ltg_broadcast_create(packet);
+
+}
+
+ltg_broadcast_t* phd_broadcast_multi_block_change(wld_chunk_t* chunk, uint16_t section_index, const wld_section_changes_t* changes) {
+
+	wld_chunk_section_t* section = wld_chunk_get_section(chunk, section_index);
+	const int32_t section_y = section_index + (mat_get_dimension_by_type(wld_get_environment(wld_chunk_get_world(chunk)))->min_y >> 4);
+
+	PCK_INLINE(packet, 14 + changes->count * 10, io_big_endian);
+
+	pck_write_var_int(packet, 0x3f);
+	pck_write_int64(packet, (((uint64_t) wld_get_chunk_x(chunk) & 0x3FFFFF) << 42) | (((uint64_t) wld_get_chunk_z(chunk) & 0x3FFFFF) << 20) | ((uint64_t) section_y & 0xFFFFF));
+	pck_write_int8(packet, false); // trust edges
+	pck_write_var_int(packet, changes->count);
+
+	// the blocks as they are now, a block changed twice is only sent once
+	for (uint16_t i = 0; i < 4096 / 64; ++i) {
+		uint64_t blocks = changes->blocks[i];
+		while (blocks != 0) {
+			const uint16_t index = (i << 6) | __builtin_ctzll(blocks);
+			blocks &= blocks - 1;
+			const uint64_t block = wld_block_storage_get(section->blocks, index);
+			pck_write_var_long(packet, (block << 12) | ((index & 0xF) << 8) | (((index >> 4) & 0xF) << 4) | (index >> 8));
+		}
+	}
+
+	return ltg_broadcast_create(packet);
+
+}
+
 void phd_send_held_item_change(ltg_client_t* client) {
 	
 	PCK_INLINE(packet, 2, io_big_endian);
@@ -1824,7 +1920,7 @@ void phd_send_time_update(ltg_client_t* client, wld_world_t* world) {
 
 }
 
-void phd_send_entity_teleport(ltg_client_t* client, ent_entity_t* entity) {
+ltg_broadcast_t* phd_broadcast_entity_teleport(ent_entity_t* entity) {
 	
 	PCK_INLINE(packet, 43, io_big_endian);
 
@@ -1838,11 +1934,11 @@ void phd_send_entity_teleport(ltg_client_t* client, ent_entity_t* entity) {
 	pck_write_int8(packet, 0);
 	pck_write_int8(packet, ent_is_on_ground(entity));
 
-	ltg_send(client, packet);
+	return ltg_broadcast_create(packet);
 
 }
 
-void phd_send_living_entity_teleport(ltg_client_t* client, ent_living_entity_t* entity) {
+ltg_broadcast_t* phd_broadcast_living_entity_teleport(ent_living_entity_t* entity) {
 
 	PCK_INLINE(packet, 43, io_big_endian);
 
@@ -1856,7 +1952,7 @@ void phd_send_living_entity_teleport(ltg_client_t* client, ent_living_entity_t*
 	pck_write_int8(packet, io_angle_to_byte(ent_le_get_pitch(entity)));
 	pck_write_int8(packet, ent_is_on_ground(ent_le_get_entity(entity)));
 
-	ltg_send(client, packet);
+	return ltg_broadcast_create(packet);
 
 }
 
@@ -1955,7 +2051,7 @@ void phd_update_sent_chunks(ltg_client_t* client) {
 
 	for (int16_t x = -max_loop; x <= max_loop; ++x) {
 		for (int16_t z = -max_loop; z <= max_loop; ++z) {
-			wld_chunk_t* v_c = wld_relative_chunk(chunk, x, z);
+			wld_chunk_t* v_c = wld_request_relative_chunk(chunk, x, z, WLD_TICKET_MAX);
 			const uint8_t distance = UTL_MAX(UTL_ABS(x), UTL_ABS(z));
 
 			if (distance <= server_simulation_distance + 2) {
@@ -1983,7 +2079,7 @@ void phd_update_sent_chunks_view_distance(ltg_client_t* client, uint8_t view_dis
 		for (int16_t x = -ltg_client_get_render_distance(client); x <= ltg_client_get_render_distance(client); ++x) {
 			for (int16_t z = -ltg_client_get_render_distance(client); z <= ltg_client_get_render_distance(client); ++z) {
 				if (x < -view_distance || x > view_distance || z < -view_distance || z > view_distance) {
-					wld_chunk_t* v_c = wld_relative_chunk(chunk, x, z);
+					wld_chunk_t* v_c = wld_request_relative_chunk(chunk, x, z, WLD_TICKET_MAX);
 					phd_update_unsubscribe_chunk(client, v_c);
 				}
 			}
@@ -1992,7 +2088,7 @@ void phd_update_sent_chunks_view_distance(ltg_client_t* client, uint8_t view_dis
 		for (int16_t x = -view_distance; x <= view_distance; ++x) {
 			for (int16_t z = -view_distance; z <= view_distance; ++z) {
 				if (x < -ltg_client_get_render_distance(client) || x > ltg_client_get_render_distance(client) || z < -ltg_client_get_render_distance(client) || z > ltg_client_get_render_distance(client)) {
-					wld_chunk_t* v_c = wld_relative_chunk(chunk, x, z);
+					wld_chunk_t* v_c = wld_request_relative_chunk(chunk, x, z, WLD_TICKET_MAX);
 					phd_update_subscribe_chunk(client, v_c);
 				}
 			}
@@ -2026,8 +2122,8 @@ void phd_update_sent_chunks_move(ltg_client_t* client, const wld_chunk_t* old_ch
 			const int32_t n_x = client_render_distance + 1;
 
 			for (int32_t c_z = -client_render_distance; c_z <= client_render_distance; ++c_z) {
-				phd_update_unsubscribe_chunk(client, wld_relative_chunk(old_chunk, o_x, c_z));
-				phd_update_subscribe_chunk(client, wld_relative_chunk(old_chunk, n_x, c_z));
+				phd_update_unsubscribe_chunk(client, wld_request_relative_chunk(old_chunk, o_x, c_z, WLD_TICKET_MAX));
+				phd_update_subscribe_chunk(client, wld_request_relative_chunk(old_chunk, n_x, c_z, WLD_TICKET_MAX));
 			}
 		}
 
@@ -2036,12 +2132,12 @@ void phd_update_sent_chunks_move(ltg_client_t* client, const wld_chunk_t* old_ch
 			const int32_t n_x = server_simulation_distance + 3;
 
 			for (int32_t c_z = -(server_simulation_distance + 2); c_z <= server_simulation_distance + 2; ++c_z) {
-				wld_remove_player_chunk(wld_relative_chunk(old_chunk, o_x, c_z), ltg_client_get_id(client));
-				wld_recalc_chunk_ticket(wld_relative_chunk(old_chunk, o_x + 1, c_z));
-				wld_recalc_chunk_ticket(wld_relative_chunk(old_chunk, o_x + 2, c_z));
-				wld_recalc_chunk_ticket(wld_relative_chunk(old_chunk, n_x - 2, c_z));
-				wld_recalc_chunk_ticket(wld_relative_chunk(old_chunk, n_x - 1, c_z));
-				wld_add_player_chunk(wld_relative_chunk(old_chunk, n_x, c_z), ltg_client_get_id(client), WLD_TICKET_BORDER);
+				wld_remove_player_chunk(wld_request_relative_chunk(old_chunk, o_x, c_z, WLD_TICKET_MAX), ltg_client_get_id(client));
+				wld_recalc_chunk_ticket(wld_request_relative_chunk(old_chunk, o_x + 1, c_z, WLD_TICKET_MAX));
+				wld_recalc_chunk_ticket(wld_request_relative_chunk(old_chunk, o_x + 2, c_z, WLD_TICKET_MAX));
+				wld_recalc_chunk_ticket(wld_request_relative_chunk(old_chunk, n_x - 2, c_z, WLD_TICKET_MAX));
+				wld_recalc_chunk_ticket(wld_request_relative_chunk(old_chunk, n_x - 1, c_z, WLD_TICKET_MAX));
+				wld_add_player_chunk(wld_request_relative_chunk(old_chunk, n_x, c_z, WLD_TICKET_MAX), ltg_client_get_id(client), WLD_TICKET_BORDER);
 			}
 		}
 
@@ -2052,8 +2148,8 @@ void phd_update_sent_chunks_move(ltg_client_t* client, const wld_chunk_t* old_ch
 			const int32_t n_x = -client_render_distance - 1;
 
 			for (int32_t c_z = -client_render_distance; c_z <= client_render_distance; ++c_z) {
-				phd_update_unsubscribe_chunk(client, wld_relative_chunk(old_chunk, o_x, c_z));
-				phd_update_subscribe_chunk(client, wld_relative_chunk(old_chunk, n_x, c_z));
+				phd_update_unsubscribe_chunk(client, wld_request_relative_chunk(old_chunk, o_x, c_z, WLD_TICKET_MAX));
+				phd_update_subscribe_chunk(client, wld_request_relative_chunk(old_chunk, n_x, c_z, WLD_TICKET_MAX));
 			}
 		}
 
@@ -2062,12 +2158,12 @@ void phd_update_sent_chunks_move(ltg_client_t* client, const wld_chunk_t* old_ch
 			const int32_t n_x = -(server_simulation_distance + 3);
 
 			for (int32_t c_z = -(server_simulation_distance + 2); c_z <= server_simulation_distance + 2; ++c_z) {
-				wld_remove_player_chunk(wld_relative_chunk(old_chunk, o_x, c_z), ltg_client_get_id(client));
-				wld_recalc_chunk_ticket(wld_relative_chunk(old_chunk, o_x - 1, c_z));
-				wld_recalc_chunk_ticket(wld_relative_chunk(old_chunk, o_x - 2, c_z));
-				wld_recalc_chunk_ticket(wld_relative_chunk(old_chunk, n_x + 2, c_z));
-				wld_recalc_chunk_ticket(wld_relative_chunk(old_chunk, n_x + 1, c_z));
-				wld_add_player_chunk(wld_relative_chunk(old_chunk, n_x, c_z), ltg_client_get_id(client), WLD_TICKET_BORDER);
+				wld_remove_player_chunk(wld_request_relative_chunk(old_chunk, o_x, c_z, WLD_TICKET_MAX), ltg_client_get_id(client));
+				wld_recalc_chunk_ticket(wld_request_relative_chunk(old_chunk, o_x - 1, c_z, WLD_TICKET_MAX));
+				wld_recalc_chunk_ticket(wld_request_relative_chunk(old_chunk, o_x - 2, c_z, WLD_TICKET_MAX));
+				wld_recalc_chunk_ticket(wld_request_relative_chunk(old_chunk, n_x + 2, c_z, WLD_TICKET_MAX));
+				wld_recalc_chunk_ticket(wld_request_relative_chunk(old_chunk, n_x + 1, c_z, WLD_TICKET_MAX));
+				wld_add_player_chunk(wld_request_relative_chunk(old_chunk, n_x, c_z, WLD_TICKET_MAX), ltg_client_get_id(client), WLD_TICKET_BORDER);
 			}
 		}
 
@@ -2080,8 +2176,8 @@ void phd_update_sent_chunks_move(ltg_client_t* client, const wld_chunk_t* old_ch
 			const int32_t n_z = client_render_distance + 1;
 			
 			for (int32_t c_x = -client_render_distance; c_x <= client_render_distance; ++c_x) {
-				phd_update_unsubscribe_chunk(client, wld_relative_chunk(old_chunk, c_x, o_z));
-				phd_update_subscribe_chunk(client, wld_relative_chunk(old_chunk, c_x, n_z));
+				phd_update_unsubscribe_chunk(client, wld_request_relative_chunk(old_chunk, c_x, o_z, WLD_TICKET_MAX));
+				phd_update_subscribe_chunk(client, wld_request_relative_chunk(old_chunk, c_x, n_z, WLD_TICKET_MAX));
 			}
 		}
 
@@ -2090,12 +2186,12 @@ void phd_update_sent_chunks_move(ltg_client_t* client, const wld_chunk_t* old_ch
 			const int32_t n_z = server_simulation_distance + 3;
 
 			for (int32_t c_x = -(server_simulation_distance + 2); c_x <= server_simulation_distance + 2; ++c_x) {
-				wld_remove_player_chunk(wld_relative_chunk(old_chunk, c_x, o_z), ltg_client_get_id(client));
-				wld_recalc_chunk_ticket(wld_relative_chunk(old_chunk, c_x, o_z + 1));
-				wld_recalc_chunk_ticket(wld_relative_chunk(old_chunk, c_x, o_z + 2));
-				wld_recalc_chunk_ticket(wld_relative_chunk(old_chunk, c_x, n_z - 2));
-				wld_recalc_chunk_ticket(wld_relative_chunk(old_chunk, c_x, n_z - 1));
-				wld_add_player_chunk(wld_relative_chunk(old_chunk, c_x, n_z), ltg_client_get_id(client), WLD_TICKET_BORDER);
+				wld_remove_player_chunk(wld_request_relative_chunk(old_chunk, c_x, o_z, WLD_TICKET_MAX), ltg_client_get_id(client));
+				wld_recalc_chunk_ticket(wld_request_relative_chunk(old_chunk, c_x, o_z + 1, WLD_TICKET_MAX));
+				wld_recalc_chunk_ticket(wld_request_relative_chunk(old_chunk, c_x, o_z + 2, WLD_TICKET_MAX));
+				wld_recalc_chunk_ticket(wld_request_relative_chunk(old_chunk, c_x, n_z - 2, WLD_TICKET_MAX));
+				wld_recalc_chunk_ticket(wld_request_relative_chunk(old_chunk, c_x, n_z - 1, WLD_TICKET_MAX));
+				wld_add_player_chunk(wld_request_relative_chunk(old_chunk, c_x, n_z, WLD_TICKET_MAX), ltg_client_get_id(client), WLD_TICKET_BORDER);
 			}
 		}
 
@@ -2106,8 +2202,8 @@ void phd_update_sent_chunks_move(ltg_client_t* client, const wld_chunk_t* old_ch
 			const int32_t n_z = -client_render_distance - 1;
 			
 			for (int32_t c_x = -client_render_distance; c_x <= client_render_distance; ++c_x) {
-				phd_update_unsubscribe_chunk(client, wld_relative_chunk(old_chunk, c_x, o_z));
-				phd_update_subscribe_chunk(client, wld_relative_chunk(old_chunk, c_x, n_z));
+				phd_update_unsubscribe_chunk(client, wld_request_relative_chunk(old_chunk, c_x, o_z, WLD_TICKET_MAX));
+				phd_update_subscribe_chunk(client, wld_request_relative_chunk(old_chunk, c_x, n_z, WLD_TICKET_MAX));
 			}
 		}
 
@@ -2116,12 +2212,12 @@ void phd_update_sent_chunks_move(ltg_client_t* client, const wld_chunk_t* old_ch
 			const int32_t n_z = -(server_simulation_distance + 3);
 
 			for (int32_t c_x = -(server_simulation_distance + 2); c_x <= server_simulation_distance + 2; ++c_x) {
-				wld_remove_player_chunk(wld_relative_chunk(old_chunk, c_x, o_z), ltg_client_get_id(client));
-				wld_recalc_chunk_ticket(wld_relative_chunk(old_chunk, c_x, o_z - 1));
-				wld_recalc_chunk_ticket(wld_relative_chunk(old_chunk, c_x, o_z - 2));
-				wld_recalc_chunk_ticket(wld_relative_chunk(old_chunk, c_x, n_z + 2));
-				wld_recalc_chunk_ticket(wld_relative_chunk(old_chunk, c_x, n_z + 1));
-				wld_add_player_chunk(wld_relative_chunk(old_chunk, c_x, n_z), ltg_client_get_id(client), WLD_TICKET_BORDER);
+				wld_remove_player_chunk(wld_request_relative_chunk(old_chunk, c_x, o_z, WLD_TICKET_MAX), ltg_client_get_id(client));
+				wld_recalc_chunk_ticket(wld_request_relative_chunk(old_chunk, c_x, o_z - 1, WLD_TICKET_MAX));
+				wld_recalc_chunk_ticket(wld_request_relative_chunk(old_chunk, c_x, o_z - 2, WLD_TICKET_MAX));
+				wld_recalc_chunk_ticket(wld_request_relative_chunk(old_chunk, c_x, n_z + 2, WLD_TICKET_MAX));
+				wld_recalc_chunk_ticket(wld_request_relative_chunk(old_chunk, c_x, n_z + 1, WLD_TICKET_MAX));
+				wld_add_player_chunk(wld_request_relative_chunk(old_chunk, c_x, n_z, WLD_TICKET_MAX), ltg_client_get_id(client), WLD_TICKET_BORDER);
 			}
 		}
 
@@ -2158,7 +2254,7 @@ void phd_update_sent_chunks_teleport(ltg_client_t* client, const wld_chunk_t* ol
 	{ // old chunk
 		for (int32_t c_x = -client_render_distance; c_x <= client_render_distance; ++c_x) {
 			for (int32_t c_z = -client_render_distance; c_z <= client_render_distance; ++c_z) {
-				wld_chunk_t* c_c = wld_relative_chunk(old_chunk, c_x, c_z);
+				wld_chunk_t* c_c = wld_request_relative_chunk(old_chunk, c_x, c_z, WLD_TICKET_MAX);
 				// test if in render distance
 				if (UTL_MAX(UTL_ABS(c_x + old_x - x), UTL_ABS(c_z + old_z - z)) > client_render_distance) {
 					// no longer in view
@@ -2171,7 +2267,7 @@ void phd_update_sent_chunks_teleport(ltg_client_t* client, const wld_chunk_t* ol
 	{ // new chunk
 		for (int32_t c_x = -client_render_distance; c_x <= client_render_distance; ++c_x) {
 			for (int32_t c_z = -client_render_distance; c_z <= client_render_distance; ++c_z) {
-				wld_chunk_t* c_c = wld_relative_chunk(chunk, c_x, c_z);
+				wld_chunk_t* c_c = wld_request_relative_chunk(chunk, c_x, c_z, WLD_TICKET_MAX);
 				if (!wld_chunk_has_subscriber(c_c, ltg_client_get_id(client))) {
 					phd_update_subscribe_chunk(client, c_c);
 				}
@@ -2194,7 +2290,7 @@ void phd_update_sent_chunks_remove(ltg_client_t* client, const wld_chunk_t* chun
 	// player chunks
 	for (int16_t x = -max_loop; x <= max_loop; ++x) {
 		for (int16_t z = -max_loop; z <= max_loop; ++z) {
-			wld_chunk_t* v_c = wld_relative_chunk(chunk, x, z);
+			wld_chunk_t* v_c = wld_request_relative_chunk(chunk, x, z, WLD_TICKET_MAX);
 
 			const uint8_t distance = UTL_MAX(UTL_ABS(x), UTL_ABS(z));
 			
@@ -2218,6 +2314,76 @@ void phd_update_sent_chunks_leave(ltg_client_t* client) {
 
 }
 
+static inline void phd_update_send_broadcast(uint32_t client_id, void* broadcast) {
+
+	ltg_client_t* client = ltg_get_client_by_id(sky_get_listener(), client_id);
+
+	if (client == NULL) return;
+
+	ltg_send_broadcast(client, broadcast);
+
+}
+
+static inline void phd_update_resend_chunk(uint32_t client_id, void* chunk) {
+
+	ltg_client_t* client = ltg_get_client_by_id(sky_get_listener(), client_id);
+
+	if (client == NULL) return;
+
+	phd_send_chunk_data_and_update_light(client, chunk);
+
+}
+
+void phd_update_send_block_changes(wld_chunk_t* chunk) {
+
+	const uint16_t chunk_height = mat_get_chunk_height(wld_get_environment(wld_chunk_get_world(chunk)));
+
+	wld_section_changes_t* changes[chunk_height];
+
+	if (!wld_chunk_take_changes(chunk, changes)) return;
+
+	bool resend = false;
+	for (uint16_t i = 0; i < chunk_height; ++i) {
+		if (changes[i] != NULL && changes[i]->count >= WLD_SECTION_RESEND_CHANGES) {
+			resend = true;
+		}
+	}
+
+	if (resend) {
+		// the whole chunk is smaller than that many changes
+		wld_chunk_subscribers_foreach(chunk, phd_update_resend_chunk, chunk);
+	} else {
+		const int16_t min_y = mat_get_dimension_by_type(wld_get_environment(wld_chunk_get_world(chunk)))->min_y;
+		for (uint16_t i = 0; i < chunk_height; ++i) {
+			if (changes[i] == NULL) continue;
+
+			ltg_broadcast_t* broadcast;
+			if (changes[i]->count == 1) {
+				uint16_t index = 0;
+				while (!wld_section_changes_has(changes[i], index)) {
+					index++;
+				}
+				broadcast = phd_broadcast_block_change(
+					(wld_get_chunk_x(chunk) << 4) | (index & 0xF),
+					min_y + (i << 4) + (index >> 8),
+					(wld_get_chunk_z(chunk) << 4) | ((index >> 4) & 0xF),
+					wld_block_storage_get(wld_chunk_get_section(chunk, i)->blocks, index)
+				);
+			} else {
+				broadcast = phd_broadcast_multi_block_change(chunk, i, changes[i]);
+			}
+
+			wld_chunk_subscribers_foreach(chunk, phd_update_send_broadcast, broadcast);
+			ltg_broadcast_release(broadcast);
+		}
+	}
+
+	for (uint16_t i = 0; i < chunk_height; ++i) {
+		free(changes[i]);
+	}
+
+}
+
 void phd_update_respawn(ltg_client_t* client) {
 
 	// TODO do something here
@@ -69,12 +69,13 @@ extern void phd_send_acknowledge_player_digging(ltg_client_t*);
 extern void phd_send_block_break_animation(ltg_client_t*);
 extern void phd_send_block_entity_data(ltg_client_t*);
 extern void phd_send_block_action(ltg_client_t*);
-extern void phd_send_block_change(ltg_client_t*);
+extern ltg_broadcast_t* phd_broadcast_block_change(int32_t x, int16_t y, int32_t z, mat_block_protocol_id_t block);
 extern void phd_send_boss_bar(ltg_client_t*);
 extern void phd_send_server_difficulty(ltg_client_t* client);
 
-extern void phd_send_chat_message(ltg_client_t* client, const char* message, size_t message_length, const ltg_uuid_t uuid);
+extern ltg_broadcast_t* phd_broadcast_chat_message(const char* message, size_t message_length, const ltg_uuid_t uuid);
 extern void phd_send_system_chat_message(ltg_client_t* client, const char* message, size_t message_length);
+extern ltg_broadcast_t* phd_broadcast_system_chat_message(const char* message, size_t message_length);
 
 extern void phd_send_clear_tiles(ltg_client_t*);
 extern void phd_send_tab_complete(ltg_client_t*);
@@ -89,6 +90,7 @@ extern void phd_send_plugin_message(ltg_client_t* client, const char* identifier
 extern void phd_send_named_sound_effect(ltg_client_t*);
 extern void phd_send_disconnect(ltg_client_t* client, const char* message, size_t message_len);
 extern void phd_send_entity_status(ltg_client_t* client, ent_entity_t* entity, uint8_t status);
+extern ltg_broadcast_t* phd_broadcast_entity_status(ent_entity_t* entity, uint8_t status);
 extern void phd_send_explosion(ltg_client_t*);
 extern void phd_send_unload_chunk(ltg_client_t* client, wld_chunk_t* chunk);
 extern void phd_send_change_game_state(ltg_client_t*);
@@ -102,9 +104,9 @@ extern void phd_send_update_light(ltg_client_t* client, wld_chunk_t* chunk);
 extern void phd_send_join_game(ltg_client_t* client);
 extern void phd_send_map_data(ltg_client_t*);
 extern void phd_send_trade_list(ltg_client_t*);
-extern void phd_send_entity_position(ltg_client_t* client, ent_entity_t* entity, float64_t d_x, float64_t d_y, float64_t d_z);
-extern void phd_send_entity_position_and_rotation(ltg_client_t* client, ent_living_entity_t* entity, float64_t d_x, float64_t d_y, float64_t d_z);
-extern void phd_send_entity_rotation(ltg_client_t* client, ent_living_entity_t* entity);
+extern ltg_broadcast_t* phd_broadcast_entity_position(ent_entity_t* entity, float64_t d_x, float64_t d_y, float64_t d_z);
+extern ltg_broadcast_t* phd_broadcast_entity_position_and_rotation(ent_living_entity_t* entity, float64_t d_x, float64_t d_y, float64_t d_z);
+extern ltg_broadcast_t* phd_broadcast_entity_rotation(ent_living_entity_t* entity);
 extern void phd_send_vehicle_move(ltg_client_t*);
 extern void phd_send_open_book(ltg_client_t*);
 extern void phd_send_open_window(ltg_client_t*);
@@ -117,12 +119,12 @@ extern void phd_send_enter_combat_event(ltg_client_t*);
 extern void phd_send_death_combat_event(ltg_client_t* client, ent_player_t* player, ent_entity_t* killer, const char* message, size_t message_length);
 
 extern void phd_send_player_info_add_players(ltg_client_t* client);
-extern void phd_send_player_info_add_player(ltg_client_t* client, ltg_client_t* player);
+extern ltg_broadcast_t* phd_broadcast_player_info_add_player(ltg_client_t* player);
 extern void phd_send_player_info_update_gamemode(ltg_client_t* client, ltg_client_t* player);
 // does NOT lock players list, expects it to be locked beforehand
-extern void phd_send_player_info_update_latency(ltg_client_t* client);
+extern ltg_broadcast_t* phd_broadcast_player_info_update_latency();
 extern void phd_send_player_info_update_display_name(ltg_client_t* client, ltg_client_t* player);
-extern void phd_send_player_info_remove_player(ltg_client_t* client, ltg_uuid_t uuid);
+extern ltg_broadcast_t* phd_broadcast_player_info_remove_player(ltg_uuid_t uuid);
 
 extern void phd_send_face_player(ltg_client_t*);
 extern void phd_send_player_position_and_look(ltg_client_t* client);
@@ -133,7 +135,8 @@ extern void phd_send_remove_entity_effect(ltg_client_t*);
 extern void phd_send_resource_pack_send(ltg_client_t*);
 extern void phd_send_respawn(ltg_client_t* client, wld_world_t* world, bool keep_metadata);
 extern void phd_send_entity_head_look(ltg_client_t* client, ent_living_entity_t* entity);
-extern void phd_send_multi_block_change(ltg_client_t*);
+extern ltg_broadcast_t* phd_broadcast_entity_head_look(ent_living_entity_t* entity);
+extern ltg_broadcast_t* phd_broadcast_multi_block_change(wld_chunk_t* chunk, uint16_t section, const wld_section_changes_t* changes);
 extern void phd_send_select_advancement_tab(ltg_client_t*);
 extern void phd_send_action_bar(ltg_client_t*);
 extern void phd_send_world_border_center(ltg_client_t*);
@@ -169,8 +172,8 @@ extern void phd_send_stop_sound(ltg_client_t*);
 extern void phd_send_player_list_header_and_footer(ltg_client_t*);
 extern void phd_send_nbt_query_response(ltg_client_t*);
 extern void phd_send_collect_item(ltg_client_t*);
-extern void phd_send_entity_teleport(ltg_client_t* client, ent_entity_t* entity);
-extern void phd_send_living_entity_teleport(ltg_client_t* client, ent_living_entity_t* entity);
+extern ltg_broadcast_t* phd_broadcast_entity_teleport(ent_entity_t* entity);
+extern ltg_broadcast_t* phd_broadcast_living_entity_teleport(ent_living_entity_t* entity);
 extern void phd_send_advancements(ltg_client_t*);
 extern void phd_send_entity_properties(ltg_client_t*);
 extern void phd_send_entity_effect(ltg_client_t*);
@@ -191,19 +194,15 @@ static inline void phd_update_send_entity(ltg_client_t* client, ent_entity_t* en
 	}
 }
 
+// sends the chunk and its entities to the client (by id) if it is still subscribed to it
+extern void phd_send_subscribed_chunk(wld_chunk_t* chunk, void* client_id);
+
 static inline void phd_update_subscribe_chunk(ltg_client_t* client, wld_chunk_t* chunk) {
 
-	phd_send_chunk_data_and_update_light(client, chunk);
+	// subscribed first so the chunk isn't sent if the client unsubscribes before it is loaded
 	wld_subscribe_chunk(chunk, ltg_client_get_id(client));
+	wld_on_chunk_load(chunk, phd_send_subscribed_chunk, (void*) (uintptr_t) ltg_client_get_id(client));
 
-	// send chunk entities
-	uint32_t entity_length = wld_chunk_get_entity_length(chunk);
-	for (uint32_t i = 0; i < entity_length; ++i) {
-		ent_entity_t* entity = wld_chunk_get_entity(chunk, i);
-		if (entity != NULL) {
-			phd_update_send_entity(client, entity);
-		}
-	}
 }
 
 static inline void phd_update_unsubscribe_chunk(ltg_client_t* client, wld_chunk_t* chunk) {
@@ -218,4 +217,7 @@ extern void phd_update_sent_chunks_teleport(ltg_client_t* client, const wld_chun
 extern void phd_update_sent_chunks_remove(ltg_client_t* client, const wld_chunk_t* chunk);
 extern void phd_update_sent_chunks_leave(ltg_client_t* client);
 
+// sends the blocks changed in the chunk since the last call to its subscribers, the whole chunk again if a section changed a lot
+extern void phd_update_send_block_changes(wld_chunk_t* chunk);
+
 extern void phd_update_respawn(ltg_client_t* client);
\ No newline at end of file
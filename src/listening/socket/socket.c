@@ -70,9 +70,55 @@ int32_t sck_accept(int32_t l, struct sockaddr* addr, int* addrSize) {
 
 }
 
+int32_t sck_set_nonblocking(int32_t s) {
+
+#ifdef __WINDOWS__
+	u_long mode = 1;
+	return ioctlsocket(s, FIONBIO, &mode);
+#else
+	const int32_t flags = fcntl(s, F_GETFL, 0);
+
+	if (flags == -1) {
+		return SCK_FAILED;
+	}
+
+	return fcntl(s, F_SETFL, flags | O_NONBLOCK);
+#endif
+
+}
+
+// returns SCK_WOULD_BLOCK instead of failing when a non-blocking socket isn't ready
+static inline int32_t sck_check_would_block(int32_t r) {
+
+	if (r < 0) {
+#ifdef __WINDOWS__
+		if (WSAGetLastError() == WSAEWOULDBLOCK) {
+			return SCK_WOULD_BLOCK;
+		}
+#else
+		if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			return SCK_WOULD_BLOCK;
+		}
+#endif
+	}
+
+	return r;
+
+}
+
 int32_t sck_send(int32_t s, char* message, int32_t len) {
 
-	return send(s, message, len, 0);
+	return sck_check_would_block(send(s, message, len, 0));
+
+}
+
+int32_t sck_send_nowait(int32_t s, char* message, int32_t len) {
+
+#ifdef __WINDOWS__
+	return sck_check_would_block(send(s, message, len, 0));
+#else
+	return sck_check_would_block(send(s, message, len, MSG_DONTWAIT));
+#endif
 
 }
 
@@ -80,7 +126,7 @@ int32_t sck_recv(int32_t s, char* message, int32_t maxlen) {
 
 	int32_t r = recv(s, message, maxlen, 0);
 
-	return r;
+	return sck_check_would_block(r);
 
 }
 
@@ -3,11 +3,14 @@
 
 #define SCK_OK 0
 #define SCK_FAILED -1
+#define SCK_WOULD_BLOCK -2 // non-blocking socket isn't ready
 
 #ifdef __WINDOWS__
 #include <winsock2.h>
 #else
 #include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #endif
@@ -17,7 +20,9 @@ extern int32_t sck_create();
 extern int32_t sck_bind(int32_t, struct sockaddr*, int32_t);
 extern int32_t sck_listen(int32_t);
 extern int32_t sck_accept(int32_t, struct sockaddr*, int*);
+extern int32_t sck_set_nonblocking(int32_t);
 extern int32_t sck_send(int32_t, char*, int32_t);
+extern int32_t sck_send_nowait(int32_t, char*, int32_t);
 extern int32_t sck_recv(int32_t, char*, int32_t);
 extern int32_t sck_shutdown(int32_t);
 extern int32_t sck_close(int32_t);
@@ -7,6 +7,7 @@
 #include "jobs/board.h"
 #include "jobs/handlers.h"
 #include "jobs/scheduler/scheduler.h"
+#include "jobs/tick/tick.h"
 #include "util/ansi_escapes.h"
 #include "util/util.h"
 #include "plugin/manager.h"
@@ -109,6 +110,13 @@ void sky_handle_signal_crash(int signal) {
 			}
 		}
 
+		for (uint16_t i = 0; i < ltg_get_io_thread_count(sky_get_listener()); ++i) {
+			if (pthread_self() == ltg_get_io_thread(sky_get_listener(), i)) {
+				log_error("\t\tI/O THREAD #%u", i);
+				goto identified;
+			}
+		}
+
 		for (size_t i = 0; i < ltg_get_client_count(sky_get_listener()); ++i) {
 			ltg_client_t* client = ltg_get_client_by_id(sky_get_listener(), i);
 			if (client != NULL && pthread_self() == ltg_client_get_thread(client)) {
@@ -226,14 +234,15 @@ int main(int argc, char* argv[]) {
 	// we're ready for takeoff
 	sky_main.status = sky_running;
 
-	// start main thread
-	pthread_create(&sky_main.thread, NULL, t_sky_main, NULL);
+	// create worker threads, the vector never grows so other threads can add jobs while it's filled
+	utl_vector_resize(&sky_main.workers.vector, sky_main.workers.count);
 
-	// create worker threads
 	for (size_t i = 0; i < sky_main.workers.count; ++i) {
 
 		sky_worker_t* worker = malloc(sizeof(sky_worker_t));
 		worker->id = i;
+		worker->job = 0;
+		job_init_queue(&worker->jobs);
 
 		utl_vector_push(&sky_main.workers.vector, &worker);
 
@@ -241,6 +250,9 @@ int main(int argc, char* argv[]) {
 
 	}
 
+	// start main thread
+	pthread_create(&sky_main.thread, NULL, t_sky_main, NULL);
+
 	struct timespec time_now;
 	clock_gettime(CLOCK_REALTIME, &time_now);
 	log_info("Done (%.3fs)! For help type 'help'", ((time_now.tv_sec * SKY_NANOS_PER_SECOND + time_now.tv_nsec) - (start.tv_sec * SKY_NANOS_PER_SECOND + start.tv_nsec)) / 1000000000.0f);
@@ -295,8 +307,8 @@ void* t_sky_main(__attribute__((unused)) void* input) {
 
 		nanosleep(&sleepTime, NULL);
 
-		// do tick stuff
-		sch_tick();
+		// do tick stuff, packets queued during the tick are sent at the end of it
+		tck_run();
 
 	}
 
@@ -335,6 +347,9 @@ void sky_load_server_json() {
 				case 0x574c2735: { // "worker-count"
 					sky_main.workers.count = mjson_get_int(key_val.value);
 				} break;
+				case 0x5aa3e8b8: { // "io-thread-count"
+					sky_main.listener.io.count = mjson_get_int(key_val.value);
+				} break;
 				case 0x6f29f27f: { // "max-tick-time"
 					sky_main.max_tick_time = mjson_get_int(key_val.value);
 				} break;
@@ -508,6 +523,8 @@ void sky_gen_server_json() {
 	const byte_t server_json[] = {
 		0x7b, 0x0d, 0x0a, 0x09, 0x22, 0x77, 0x6f, 0x72, 0x6b, 0x65, 0x72, 0x2d,
 		0x63, 0x6f, 0x75, 0x6e, 0x74, 0x22, 0x3a, 0x20, 0x34, 0x2c, 0x0d, 0x0a,
+		0x09, 0x22, 0x69, 0x6f, 0x2d, 0x74, 0x68, 0x72, 0x65, 0x61, 0x64, 0x2d,
+		0x63, 0x6f, 0x75, 0x6e, 0x74, 0x22, 0x3a, 0x20, 0x32, 0x2c, 0x0d, 0x0a,
 		0x09, 0x22, 0x6d, 0x61, 0x78, 0x2d, 0x74, 0x69, 0x63, 0x6b, 0x2d, 0x74,
 		0x69, 0x6d, 0x65, 0x22, 0x3a, 0x20, 0x36, 0x30, 0x30, 0x30, 0x30, 0x2c,
 		0x0d, 0x0a, 0x09, 0x22, 0x6c, 0x65, 0x76, 0x65, 0x6c, 0x22, 0x3a, 0x20,
@@ -606,7 +623,8 @@ void sky_term() {
 	// stop listening
 	ltg_term(sky_get_listener());
 
-	// join main thread
+	// join main thread, it could be waiting for the jobs of a tick phase
+	tck_resume();
 	pthread_join(sky_main.thread, NULL);
 
 	// join to each worker
@@ -6,6 +6,7 @@
 #include "main.h"
 #include "listening/listening.h"
 #include "io/commands/commands.h"
+#include "jobs/board.h"
 
 // Workers do all the dirty work, all the things on the job board and the scheduler, but are not guaranteed any time to happen
 struct sky_worker {
@@ -14,6 +15,8 @@ struct sky_worker {
 	uint32_t job;
 	uint16_t id;
 
+	job_queue_t jobs;
+
 };
 
 /*
@@ -113,6 +116,11 @@ static inline cmd_sender_t sky_get_console() {
 	return sky_main.console;
 }
 
+// workers that were created, none while the tests run
+static inline size_t sky_get_worker_count() {
+	return sky_main.workers.vector.size;
+}
+
 static inline ltg_listener_t* sky_get_listener() {
 	return &sky_main.listener;
 }
@@ -193,6 +193,16 @@ typedef void* player_t;
 
 typedef void* entity_t;
 
+// WORLDS
+
+typedef void* world_t;
+
+// blocks copied out of a world
+typedef void* clipboard_t;
+
+// a block state, as its protocol id
+typedef uint16_t block_t;
+
 // CHAT
 
 typedef enum {
@@ -388,6 +398,32 @@ typedef struct {
 
 	} chat;
 
+	// All world related functions
+	// Edits are split by chunk section across the server's workers and return once every block is written
+	struct {
+
+		// Get the default world
+		world_t (*const get_default) ();
+
+		// Fill a box (corners included) with a block, returns how many blocks changed
+		uint64_t (*const fill) (world_t world, int32_t x1, int16_t y1, int32_t z1, int32_t x2, int16_t y2, int32_t z2, block_t block);
+
+		// Replace the blocks of a box the predicate returns true for, returns how many blocks changed
+		// NOTE: The predicate is called from several threads at once
+		uint64_t (*const replace) (world_t world, int32_t x1, int16_t y1, int32_t z1, int32_t x2, int16_t y2, int32_t z2, bool (*predicate) (block_t block, void* args), void* args, block_t block);
+
+		// Copy a box into a new clipboard (NULL if the box is outside the world)
+		// NOTE: You MUST free all clipboards you copy
+		clipboard_t (*const copy) (world_t world, int32_t x1, int16_t y1, int32_t z1, int32_t x2, int16_t y2, int32_t z2);
+
+		// Paste a clipboard with its lowest corner at a position, returns how many blocks changed
+		uint64_t (*const paste) (world_t world, const clipboard_t clipboard, int32_t x, int16_t y, int32_t z);
+
+		// Free a clipboard
+		void (*const free_clipboard) (clipboard_t clipboard);
+
+	} world;
+
 } motor_api_t;
 
 static motor_api_t const* motor;
@@ -7,6 +7,7 @@
 #include "../listening/listening.h"
 #include "../io/logger/logger.h"
 #include "../io/commands/commands.h"
+#include "../world/edit.h"
 #include "../util/vector.h"
 
 #ifdef __WINDOWS__
@@ -104,6 +105,18 @@ struct plg_interface {
 
 	} chat;
 
+	struct {
+
+		wld_world_t* (*const get_default) ();
+
+		uint64_t (*const fill) (wld_world_t*, int32_t, int16_t, int32_t, int32_t, int16_t, int32_t, mat_block_protocol_id_t);
+		uint64_t (*const replace) (wld_world_t*, int32_t, int16_t, int32_t, int32_t, int16_t, int32_t, wld_edit_predicate_t, void*, mat_block_protocol_id_t);
+		wld_clipboard_t* (*const copy) (wld_world_t*, int32_t, int16_t, int32_t, int32_t, int16_t, int32_t);
+		uint64_t (*const paste) (wld_world_t*, const wld_clipboard_t*, int32_t, int16_t, int32_t);
+		void (*const free_clipboard) (wld_clipboard_t*);
+
+	} world;
+
 };
 
 static const plg_interface_t plg_interface = {
@@ -159,6 +172,15 @@ static const plg_interface_t plg_interface = {
 		.get_color = cht_get_color,
 		.add_extra = cht_add_extra,
 		.free = cht_free
+	},
+
+	.world = {
+		.get_default = wld_get_default,
+		.fill = wld_fill_blocks,
+		.replace = wld_replace_blocks,
+		.copy = wld_copy_blocks,
+		.paste = wld_paste_blocks,
+		.free_clipboard = wld_free_clipboard
 	}
 
 };
@@ -1,12 +1,35 @@
 #include "tests.h"
 #include <stdlib.h>
+#include <stdio.h>
 #include <inttypes.h>
+#include <pthread.h>
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "../io/io.h"
 #include "../io/logger/logger.h"
 #include "../io/packet/packet.h"
+#include "../listening/listening.h"
+#include "../listening/phd/play.h"
+#include "../motor.h"
 #include "../util/util.h"
 #include "../util/str_util.h"
+#include "../util/hash_map.h"
+#include "../util/deque.h"
 #include "../world/material/material.h"
 #include "../world/world.h"
+#include "../world/storage.h"
+#include "../world/region_file.h"
+#include "../world/cursor.h"
+#include "../world/edit.h"
+#include "../world/entity/entity.h"
+#include "../world/entity/store.h"
+#include "../world/entity/collision.h"
+#include "../io/filesystem/filesystem.h"
+#include "../jobs/board.h"
+#include "../jobs/handlers.h"
+#include "../jobs/scheduler/scheduler.h"
 
 bool test_materials() {
 
@@ -77,6 +100,19 @@ bool test_materials() {
 		return false;
 	}
 
+	// test names, with and without the namespace
+	for (uint16_t i = 0; i < mat_block_count; ++i) {
+		const string_t name = mat_get_block_name_by_type(i);
+		if (mat_get_block_type_by_name(UTL_STRTOARG(name)) != i || mat_get_block_type_by_name(name.value + 10, name.length - 10) != i) {
+			log_error("Block %d isn't found by its name", i);
+			return false;
+		}
+	}
+	if (mat_get_block_type_by_name(UTL_CSTRTOARG("minecraft:stone_not")) != mat_block_count || mat_get_block_type_by_name(UTL_CSTRTOARG("ston")) != mat_block_count) {
+		log_error("Unknown block name was found");
+		return false;
+	}
+
 	return true;
 
 }
@@ -164,36 +200,1873 @@ bool test_packets() {
 
 }
 
+// connects a client to the other end of a socket pair, the client is handled by its own thread like any other
+static int32_t test_connect_client(pthread_t* thread) {
+
+	int sockets[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+		return -1;
+	}
+
+	ltg_client_t* client = calloc(1, sizeof(ltg_client_t));
+	client->listener = sky_get_listener();
+	client->socket = sockets[0];
+	pthread_mutex_init(&client->lock, NULL);
+	client->state = ltg_handshake;
+	utl_init_vector(&client->send.queue, sizeof(byte_t));
+
+	ltg_accept(client);
+	*thread = client->thread;
+
+	return sockets[1];
+
+}
+
+// reads exactly length bytes, false if the client disconnected first
+static bool test_read_client(int32_t socket, byte_t* bytes, size_t length) {
+
+	size_t read = 0;
+
+	while (read < length) {
+		const ssize_t received = recv(socket, bytes + read, length - read, 0);
+		if (received <= 0) {
+			return false;
+		}
+		read += received;
+	}
+
+	return true;
+
+}
+
+// a handshake to the status state, long enough for its length to take two bytes
+static size_t test_write_handshake(pck_packet_t* packet) {
+
+	char address[200];
+	memset(address, 'a', sizeof(address));
+
+	PCK_INLINE(handshake, 256, io_big_endian);
+	pck_write_var_int(handshake, 0x00);
+	pck_write_var_int(handshake, __MC_PRO__);
+	pck_write_string(handshake, address, sizeof(address));
+	pck_write_int16(handshake, 25565);
+	pck_write_var_int(handshake, ltg_status);
+
+	pck_write_var_int(packet, handshake->cursor);
+	pck_write_bytes(packet, handshake->bytes, handshake->cursor);
+
+	return handshake->cursor;
+
+}
+
+static void test_write_ping(pck_packet_t* packet, int64_t payload) {
+
+	pck_write_var_int(packet, 9);
+	pck_write_var_int(packet, 0x01);
+	pck_write_int64(packet, payload);
+
+}
+
+// the pong the client should get back for a ping
+static bool test_read_pong(int32_t socket, int64_t payload) {
+
+	byte_t pong[10];
+	if (!test_read_client(socket, pong, sizeof(pong))) {
+		log_error("Client was disconnected instead of getting a pong");
+		return false;
+	}
+
+	PCK_INLINE(expected, 10, io_big_endian);
+	test_write_ping(expected, payload);
+
+	if (memcmp(pong, expected->bytes, sizeof(pong)) != 0) {
+		log_error("Client got a wrong pong for %" PRIi64, payload);
+		return false;
+	}
+
+	return true;
+
+}
+
+bool test_packet_framing() {
+
+	PCK_INLINE(packet, 512, io_big_endian);
+	pthread_t thread;
+
+	// a byte at a time, the length of the handshake is split between two reads
+	if (test_write_handshake(packet) < 128) {
+		log_error("Handshake length fits in one byte");
+		return false;
+	}
+	test_write_ping(packet, 0x0123456789ABCDEFL);
+
+	int32_t socket = test_connect_client(&thread);
+	if (socket < 0) {
+		log_error("Couldn't make a socket pair");
+		return false;
+	}
+
+	for (size_t i = 0; i < packet->cursor; ++i) {
+		send(socket, packet->bytes + i, 1, 0);
+		usleep(200);
+	}
+
+	if (!test_read_pong(socket, 0x0123456789ABCDEFL)) {
+		return false;
+	}
+
+	close(socket);
+	pthread_join(thread, NULL);
+
+	// the handshake and several pings in one read, each is handled
+	packet->cursor = 0;
+	test_write_handshake(packet);
+	for (int64_t i = 0; i < 4; ++i) {
+		test_write_ping(packet, i);
+	}
+
+	socket = test_connect_client(&thread);
+	send(socket, packet->bytes, packet->cursor, 0);
+
+	for (int64_t i = 0; i < 4; ++i) {
+		if (!test_read_pong(socket, i)) {
+			return false;
+		}
+	}
+
+	close(socket);
+	pthread_join(thread, NULL);
+
+	// the legacy server list ping isn't length prefixed, it's answered and the client is disconnected
+	cht_component_t motd = cht_new;
+	motd.text = UTL_CSTRTOSTR("A Minecraft server");
+	cht_component_t* previous_motd = sky_main.motd;
+	sky_main.motd = &motd;
+
+	socket = test_connect_client(&thread);
+	send(socket, (byte_t[]) { 0xFE, 0x01 }, 2, 0);
+
+	byte_t kick = 0;
+	const bool answered = test_read_client(socket, &kick, 1);
+
+	close(socket);
+	pthread_join(thread, NULL);
+
+	sky_main.motd = previous_motd;
+
+	if (!answered || kick != 0xFF) {
+		log_error("Legacy server list ping wasn't answered");
+		return false;
+	}
+
+	return true;
+
+}
+
+bool test_hash_map() {
+
+	utl_hash_map_t map = UTL_HASH_MAP_INITIALIZER;
+
+	// keys are region coordinates, values are anything but NULL
+	for (int32_t i = 0; i < 4096; ++i) {
+		utl_hash_map_put(&map, wld_region_key(i - 2048, -i), (void*) (uintptr_t) (i + 1));
+	}
+
+	// removed and put back again, so removed slots are reused
+	for (uint32_t round = 0; round < 8; ++round) {
+		for (int32_t i = 0; i < 4096; i += 2) {
+			if (utl_hash_map_remove(&map, wld_region_key(i - 2048, -i)) != (void*) (uintptr_t) (i + 1)) {
+				log_error("Wrong value removed for %d", i);
+				return false;
+			}
+		}
+		for (int32_t i = 0; i < 4096; i += 2) {
+			utl_hash_map_put(&map, wld_region_key(i - 2048, -i), (void*) (uintptr_t) (i + 1));
+		}
+	}
+
+	if (utl_hash_map_length(&map) != 4096) {
+		log_error("Wrong length %u", utl_hash_map_length(&map));
+		return false;
+	}
+
+	for (int32_t i = 0; i < 4096; ++i) {
+		if (utl_hash_map_get(&map, wld_region_key(i - 2048, -i)) != (void*) (uintptr_t) (i + 1)) {
+			log_error("Wrong value for %d", i);
+			return false;
+		}
+	}
+
+	if (utl_hash_map_get(&map, wld_region_key(5000, 5000)) != NULL) {
+		log_error("Found a key that was never put");
+		return false;
+	}
+
+	// no lookups were running while it changed, so the replaced tables are gone
+	if (map.table->previous != NULL) {
+		log_error("Replaced tables weren't freed");
+		return false;
+	}
+
+	// a lookup running keeps the table it reads
+	map.readers++;
+	for (int32_t i = 4096; i < 16384; ++i) {
+		utl_hash_map_put(&map, wld_region_key(i - 2048, -i), (void*) (uintptr_t) (i + 1));
+	}
+	if (map.table->previous == NULL) {
+		log_error("Replaced table was freed during a lookup");
+		return false;
+	}
+	map.readers--;
+	utl_hash_map_reclaim(&map);
+	if (map.table->previous != NULL) {
+		log_error("Replaced tables weren't freed after the lookup");
+		return false;
+	}
+
+	utl_term_hash_map(&map);
+
+	return true;
+
+}
+
+#define TEST_DEQUE_VALUES 200000
+#define TEST_DEQUE_THIEVES 3
+
+static struct {
+	utl_deque_t deque;
+	_Atomic uint8_t taken[TEST_DEQUE_VALUES];
+	atomic_bool done;
+} test_deque_state;
+
+static void* test_deque_thief(__attribute__((unused)) void* args) {
+
+	uint32_t value;
+
+	while (!test_deque_state.done || utl_deque_length(&test_deque_state.deque) != 0) {
+		if (utl_deque_steal(&test_deque_state.deque, &value)) {
+			test_deque_state.taken[value]++;
+		}
+	}
+
+	return NULL;
+
+}
+
+bool test_deque() {
+
+	test_deque_state.deque = (utl_deque_t) UTL_DEQUE_INITIALIZER;
+	test_deque_state.done = false;
+
+	pthread_t thieves[TEST_DEQUE_THIEVES];
+	for (uint32_t i = 0; i < TEST_DEQUE_THIEVES; ++i) {
+		pthread_create(&thieves[i], NULL, test_deque_thief, NULL);
+	}
+
+	// the owner pops some of what it pushes, so the last value is fought over and the buffer grows while being stolen from
+	uint32_t value;
+	for (uint32_t i = 0; i < TEST_DEQUE_VALUES; ++i) {
+		utl_deque_push(&test_deque_state.deque, i);
+		if (i % 3 == 0 && utl_deque_pop(&test_deque_state.deque, &value)) {
+			test_deque_state.taken[value]++;
+		}
+	}
+
+	while (utl_deque_pop(&test_deque_state.deque, &value)) {
+		test_deque_state.taken[value]++;
+	}
+
+	test_deque_state.done = true;
+
+	for (uint32_t i = 0; i < TEST_DEQUE_THIEVES; ++i) {
+		pthread_join(thieves[i], NULL);
+	}
+
+	for (uint32_t i = 0; i < TEST_DEQUE_VALUES; ++i) {
+		if (test_deque_state.taken[i] != 1) {
+			log_error("Value %u was taken %u times", i, test_deque_state.taken[i]);
+			return false;
+		}
+	}
+
+	utl_term_deque(&test_deque_state.deque);
+
+	return true;
+
+}
+
+static void test_remove_region_file(const char* file) {
+
+	char path[256];
+	sprintf(path, "test_world/region/%s", file);
+	fs_remove(path);
+
+}
+
+// removes the world saved by a test
+static void test_remove_world() {
+
+	fs_get_dir_contents("test_world/region", ".mca", test_remove_region_file);
+	fs_remove("test_world/region");
+	fs_remove("test_world/level.dat");
+	fs_remove("test_world");
+
+}
+
 bool test_worlds() {
 
 	for (uint32_t i = 0; i < 10; ++i) {
-		wld_new(UTL_CSTRTOSTR("world"), i, mat_dimension_overworld);
+		wld_new(UTL_CSTRTOSTR("test_world"), i, mat_dimension_overworld);
 		wld_unload_all();
 	}
 
+	test_remove_world();
+
 	return true;
 
 }
 
-typedef struct {
-	bool (*func)();
-	string_t label;
-} test_t;
+bool test_region_files() {
 
-int test_run_all() {
+	wld_world_t* world = wld_new(UTL_CSTRTOSTR("test_world"), 42, mat_dimension_overworld);
 
-	const test_t tests[] = {
-		(test_t) {
-			.func = test_materials,
-			.label = UTL_CSTRTOSTR("materials")
-		},
-		(test_t) {
-			.func = test_packets,
-			.label = UTL_CSTRTOSTR("packets")
-		},
-		(test_t) {
-			.func = test_worlds,
-			.label = UTL_CSTRTOSTR("worlds")
+	wld_chunk_t* chunk = wld_get_chunk_at(world, wld_get_spawn_x(world), wld_get_spawn_z(world));
+	const int32_t x = wld_get_chunk_x(chunk) << 4;
+	const int32_t z = wld_get_chunk_z(chunk) << 4;
+
+	// a direct section and a paletted one
+	for (uint16_t i = 0; i < 4096; ++i) {
+		wld_set_block_at(chunk, x + (i & 0xF), i >> 8, z + ((i >> 4) & 0xF), i % 300 + 1);
+		wld_set_block_at(chunk, x + (i & 0xF), 64 + (i >> 8), z + ((i >> 4) & 0xF), i % 3 + 1);
+	}
+
+	wld_unload_all();
+
+	world = wld_load(UTL_CSTRTOSTR("test_world"));
+
+	if (wld_get_seed(world) != 42) {
+		log_error("Wrong seed after loading (%"PRId64")", wld_get_seed(world));
+		return false;
+	}
+
+	chunk = wld_get_chunk_at(world, x, z);
+
+	for (uint16_t i = 0; i < 4096; ++i) {
+		if (wld_get_block_at(chunk, x + (i & 0xF), i >> 8, z + ((i >> 4) & 0xF)) != i % 300 + 1) {
+			log_error("Wrong block at %u after loading", i);
+			return false;
+		}
+		if (wld_get_block_at(chunk, x + (i & 0xF), 64 + (i >> 8), z + ((i >> 4) & 0xF)) != i % 3 + 1) {
+			log_error("Wrong paletted block at %u after loading", i);
+			return false;
+		}
+	}
+
+	const int16_t min_y = mat_get_dimension_by_type(wld_get_environment(world))->min_y;
+	if (wld_chunk_section_get_block_count(wld_chunk_get_section(chunk, -min_y >> 4)) != 4096) {
+		log_error("Wrong block count after loading");
+		return false;
+	}
+
+	// sections that were never written to stay empty
+	if (!wld_chunk_section_is_empty(wld_chunk_get_section(chunk, (200 - min_y) >> 4))) {
+		log_error("Empty section was allocated after loading");
+		return false;
+	}
+
+	char path[256];
+	sprintf(path, "test_world/region/r.%d.%d.mca", wld_get_chunk_x(chunk) >> 5, wld_get_chunk_z(chunk) >> 5);
+	const uint16_t index = ((wld_get_chunk_z(chunk) & 0x1F) << 5) | (wld_get_chunk_x(chunk) & 0x1F);
+
+	wld_unload_all();
+
+	// a chunk that can't be read isn't saved over
+	wld_region_file_t* file = wld_open_region_file(path);
+	const size_t offset = (size_t) (io_read_int32(file->bytes + (index << 2), io_big_endian) >> 8) * WLD_REGION_FILE_SECTOR;
+	const byte_t garbage[16] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+	if (pwrite(file->fd, garbage, sizeof(garbage), offset + 5) != sizeof(garbage)) {
+		log_error("Could not write over the saved chunk");
+		return false;
+	}
+	wld_close_region_file(file);
+
+	world = wld_load(UTL_CSTRTOSTR("test_world"));
+	chunk = wld_get_chunk_at(world, x, z);
+
+	if (!chunk->unreadable) {
+		log_error("Chunk that couldn't be read was loaded");
+		return false;
+	}
+
+	wld_set_block_at(chunk, x, 0, z, 1);
+
+	wld_unload_all();
+
+	file = wld_open_region_file(path);
+	const bool kept = (uint32_t) io_read_int32(file->bytes + (index << 2), io_big_endian) >> 8 == offset / WLD_REGION_FILE_SECTOR && memcmp(file->bytes + offset + 5, garbage, sizeof(garbage)) == 0;
+	wld_close_region_file(file);
+
+	if (!kept) {
+		log_error("Chunk that couldn't be read was saved over");
+		return false;
+	}
+
+	test_remove_world();
+
+	return true;
+
+}
+
+static void test_count_chunk_load(__attribute__((unused)) wld_chunk_t* chunk, void* count) {
+	(*(uint32_t*) count)++;
+}
+
+bool test_chunk_loading() {
+
+	wld_world_t* world = wld_new(UTL_CSTRTOSTR("test_world"), 7, mat_dimension_overworld);
+
+	// far from spawn, so none of these are loaded yet
+	wld_chunk_t* chunks[64];
+	for (uint32_t i = 0; i < 64; ++i) {
+		chunks[i] = wld_request_world_chunk(world, 1000 + (i & 7), 1000 + (i >> 3));
+	}
+
+	if (wld_request_world_chunk(world, 1000, 1000) != chunks[0]) {
+		log_error("Chunk was requested twice");
+		return false;
+	}
+
+	const int16_t min_y = mat_get_dimension_by_type(wld_get_environment(world))->min_y;
+
+	for (uint32_t i = 0; i < 64; ++i) {
+		wld_await_chunk(chunks[i]);
+		if (wld_get_block_type_at(chunks[i], (1000 + (i & 7)) << 4, min_y, (1000 + (i >> 3)) << 4) != mat_block_dirt) {
+			log_error("Chunk %u wasn't generated", i);
+			return false;
+		}
+	}
+
+	// loaded chunks call back right away
+	uint32_t count = 0;
+	wld_on_chunk_load(chunks[0], test_count_chunk_load, &count);
+	if (count != 1) {
+		log_error("Callback of a loaded chunk wasn't called");
+		return false;
+	}
+
+	// none of the chunks have a ticket, so the region can be unloaded once they're done loading, but not while the world saves
+	wld_region_t* region = wld_chunk_get_region(chunks[0]);
+	while (region->loading != 0) {
+		usleep(1000);
+	}
+
+	world->saving = true;
+	if (wld_unload_region(region)) {
+		log_error("Region was unloaded while the world was saving");
+		return false;
+	}
+	world->saving = false;
+
+	// or while one of its chunks is pinned by an edit
+	if (wld_pin_chunk(world, 1000, 1000) != chunks[0]) {
+		log_error("Pinned chunk isn't the loaded chunk");
+		return false;
+	}
+	if (wld_unload_region(region)) {
+		log_error("Region was unloaded while a chunk was pinned");
+		return false;
+	}
+	wld_unpin_chunk(chunks[0]);
+
+	if (!wld_unload_region(region)) {
+		log_error("Region without loaded chunks wasn't unloaded");
+		return false;
+	}
+	if (utl_hash_map_get(&world->regions, wld_region_key(1000 >> 5, 1000 >> 5)) != NULL) {
+		log_error("Unloaded region can still be found");
+		return false;
+	}
+
+	wld_unload_all();
+
+	test_remove_world();
+
+	return true;
+
+}
+
+bool test_save_snapshots() {
+
+	wld_world_t* world = wld_new(UTL_CSTRTOSTR("test_world"), 3, mat_dimension_overworld);
+
+	wld_chunk_t* chunk = wld_get_chunk_at(world, wld_get_spawn_x(world), wld_get_spawn_z(world));
+	const int32_t x = wld_get_chunk_x(chunk) << 4;
+	const int32_t z = wld_get_chunk_z(chunk) << 4;
+	const int16_t min_y = mat_get_dimension_by_type(wld_get_environment(world))->min_y;
+
+	wld_set_block_at(chunk, x, 0, z, 1);
+
+	// a save starts, but hasn't reached the chunk yet
+	world->saving = true;
+	const uint32_t epoch = ++world->save_epoch;
+
+	wld_set_block_at(chunk, x, 0, z, 2);
+
+	wld_chunk_section_t* section = wld_chunk_get_section(chunk, -min_y >> 4);
+	if (wld_block_storage_get(wld_chunk_section_get_saved_blocks(section, epoch), 0) != 1) {
+		log_error("Section written during a save wasn't copied first");
+		return false;
+	}
+	if (wld_block_storage_get(wld_chunk_section_get_blocks(section), 0) != 2) {
+		log_error("Section written during a save wasn't written");
+		return false;
+	}
+
+	world->saving = false;
+
+	wld_unload_all();
+
+	world = wld_load(UTL_CSTRTOSTR("test_world"));
+	chunk = wld_get_chunk_at(world, x, z);
+
+	if (wld_get_block_at(chunk, x, 0, z) != 2) {
+		log_error("Block written during a save wasn't saved after it");
+		return false;
+	}
+
+	wld_unload_all();
+
+	test_remove_world();
+
+	return true;
+
+}
+
+static void test_cursor_set_stone(wld_cursor_t* cursor, __attribute__((unused)) void* args) {
+	wld_cursor_set_type(cursor, mat_block_stone);
+}
+
+static void test_cursor_count_stone(wld_cursor_t* cursor, void* count) {
+	if (wld_cursor_get_type(cursor) == mat_block_stone) {
+		(*(uint32_t*) count)++;
+	}
+}
+
+bool test_cursor() {
+
+	wld_world_t* world = wld_new(UTL_CSTRTOSTR("test_world"), 3, mat_dimension_overworld);
+
+	wld_chunk_t* chunk = wld_get_chunk_at(world, wld_get_spawn_x(world), wld_get_spawn_z(world));
+	const int32_t x = wld_get_chunk_x(chunk) << 4;
+	const int32_t z = wld_get_chunk_z(chunk) << 4;
+
+	// across four chunks and two sections
+	wld_cursor_t cursor = wld_cursor_at(chunk, x - 3, 10, z - 3);
+	wld_cursor_foreach_in_box(&cursor, x - 3, 10, z - 3, x + 2, 20, z + 2, test_cursor_set_stone, NULL);
+
+	for (int32_t b_x = x - 3; b_x <= x + 2; ++b_x) {
+		for (int16_t b_y = 10; b_y <= 20; ++b_y) {
+			for (int32_t b_z = z - 3; b_z <= z + 2; ++b_z) {
+				if (wld_get_block_type_at(chunk, b_x, b_y, b_z) != mat_block_stone) {
+					log_error("Block at %d %d %d wasn't set by the cursor", b_x, b_y, b_z);
+					return false;
+				}
+			}
+		}
+	}
+
+	uint32_t count = 0;
+	wld_cursor_foreach_in_box(&cursor, x - 4, 9, z - 4, x + 3, 21, z + 3, test_cursor_count_stone, &count);
+	if (count != 6 * 11 * 6) {
+		log_error("Cursor read %u stone blocks instead of %u", count, 6 * 11 * 6);
+		return false;
+	}
+
+	// above the world is air and can't be set
+	const int16_t max_y = mat_get_dimension_by_type(wld_get_environment(world))->min_y + (mat_get_chunk_height(wld_get_environment(world)) << 4);
+	wld_cursor_move_to(&cursor, x, max_y, z);
+	wld_cursor_set_type(&cursor, mat_block_stone);
+	if (wld_cursor_get_type(&cursor) != mat_block_air) {
+		log_error("Cursor above the world didn't read air");
+		return false;
+	}
+
+	wld_unload_all();
+
+	test_remove_world();
+
+	return true;
+
+}
+
+bool test_block_changes() {
+
+	wld_world_t* world = wld_new(UTL_CSTRTOSTR("test_world"), 3, mat_dimension_overworld);
+
+	wld_chunk_t* chunk = wld_get_chunk_at(world, wld_get_spawn_x(world), wld_get_spawn_z(world));
+	const int32_t x = wld_get_chunk_x(chunk) << 4;
+	const int32_t z = wld_get_chunk_z(chunk) << 4;
+	const int16_t min_y = mat_get_dimension_by_type(wld_get_environment(world))->min_y;
+	const uint16_t chunk_height = mat_get_chunk_height(wld_get_environment(world));
+
+	// changes made by the tests before
+	wld_section_changes_t* changes[chunk_height];
+	if (wld_chunk_take_changes(chunk, changes)) {
+		for (uint16_t i = 0; i < chunk_height; ++i) {
+			free(changes[i]);
+		}
+	}
+
+	// the same block twice, and a block that stays the same
+	wld_set_block_type_at(chunk, x + 1, 0, z, mat_block_stone);
+	wld_set_block_type_at(chunk, x + 1, 0, z, mat_block_stone);
+	wld_set_block_type_at(chunk, x + 2, 0, z, mat_block_stone);
+	wld_set_block_type_at(chunk, x + 3, 0, z, mat_block_air);
+
+	if (!wld_chunk_take_changes(chunk, changes)) {
+		log_error("Changes weren't recorded");
+		return false;
+	}
+
+	const uint16_t section = -min_y >> 4;
+	for (uint16_t i = 0; i < chunk_height; ++i) {
+		if (i != section && changes[i] != NULL) {
+			log_error("Section %u has changes", i);
+			return false;
+		}
+	}
+	if (changes[section] == NULL || changes[section]->count != 2 || !wld_section_changes_has(changes[section], 1) || !wld_section_changes_has(changes[section], 2)) {
+		log_error("Wrong changes recorded");
+		return false;
+	}
+	free(changes[section]);
+
+	if (wld_chunk_take_changes(chunk, changes)) {
+		log_error("Changes were taken twice");
+		return false;
+	}
+
+	wld_unload_all();
+
+	test_remove_world();
+
+	return true;
+
+}
+
+static bool test_edit_is_stone(mat_block_protocol_id_t block, __attribute__((unused)) void* args) {
+	return mat_get_block_type_by_protocol_id(block) == mat_block_stone;
+}
+
+bool test_edit() {
+
+	wld_world_t* world = wld_new(UTL_CSTRTOSTR("test_world"), 3, mat_dimension_overworld);
+
+	wld_chunk_t* chunk = wld_get_chunk_at(world, wld_get_spawn_x(world), wld_get_spawn_z(world));
+	const int32_t x = wld_get_chunk_x(chunk) << 4;
+	const int32_t z = wld_get_chunk_z(chunk) << 4;
+
+	// across four chunks and three sections
+	if (wld_fill_blocks(world, x - 5, 10, z - 5, x + 4, 40, z + 4, mat_get_block_default_protocol_id_by_type(mat_block_stone)) != 10 * 31 * 10) {
+		log_error("Fill changed the wrong amount of blocks");
+		return false;
+	}
+
+	const int16_t min_y = mat_get_dimension_by_type(wld_get_environment(world))->min_y;
+	if (wld_chunk_get_section(chunk, (16 - min_y) >> 4)->block_count != 5 * 16 * 5 || wld_chunk_get_highest_motion_blocking(chunk)[0] != 40) {
+		log_error("Fill didn't update the section");
+		return false;
+	}
+
+	if (wld_replace_blocks(world, x - 5, 10, z - 5, x + 4, 20, z + 4, test_edit_is_stone, NULL, mat_get_block_default_protocol_id_by_type(mat_block_dirt)) != 10 * 11 * 10) {
+		log_error("Replace changed the wrong amount of blocks");
+		return false;
+	}
+
+	wld_clipboard_t* clipboard = wld_copy_blocks(world, x - 5, 10, z - 5, x + 4, 40, z + 4);
+	wld_paste_blocks(world, clipboard, x + 100, 50, z);
+	wld_free_clipboard(clipboard);
+
+	for (int32_t b_x = -5; b_x <= 4; ++b_x) {
+		for (int16_t b_y = 10; b_y <= 40; ++b_y) {
+			for (int32_t b_z = -5; b_z <= 4; ++b_z) {
+				const mat_block_type_t type = wld_get_block_type_at(chunk, x + 100 + b_x + 5, b_y + 40, z + b_z + 5);
+				if (type != (b_y <= 20 ? mat_block_dirt : mat_block_stone)) {
+					log_error("Pasted block at %d %d %d is %u", b_x, b_y, b_z, type);
+					return false;
+				}
+			}
+		}
+	}
+
+	// emptying the top of a column lowers it
+	wld_fill_blocks(world, x, 21, z, x, 40, z, mat_get_block_default_protocol_id_by_type(mat_block_air));
+	if (wld_chunk_get_highest_motion_blocking(chunk)[0] != 20 || wld_chunk_get_highest_world_surface(chunk)[0] != 20) {
+		log_error("Highest block is at %d (surface %d) instead of 20", wld_chunk_get_highest_motion_blocking(chunk)[0], wld_chunk_get_highest_world_surface(chunk)[0]);
+		return false;
+	}
+
+	// a torch is on the surface but doesn't block motion
+	wld_fill_blocks(world, x, 21, z, x, 21, z, mat_get_block_default_protocol_id_by_type(mat_block_torch));
+	if (wld_chunk_get_highest_motion_blocking(chunk)[0] != 20 || wld_chunk_get_highest_world_surface(chunk)[0] != 21) {
+		log_error("Torch put the highest blocks at %d (surface %d)", wld_chunk_get_highest_motion_blocking(chunk)[0], wld_chunk_get_highest_world_surface(chunk)[0]);
+		return false;
+	}
+
+	// with the dirt under it gone, only the surface stays at the torch
+	wld_fill_blocks(world, x, 20, z, x, 20, z, mat_get_block_default_protocol_id_by_type(mat_block_air));
+	if (wld_chunk_get_highest_motion_blocking(chunk)[0] != 19 || wld_chunk_get_highest_world_surface(chunk)[0] != 21) {
+		log_error("Removing the block under the torch put the highest blocks at %d (surface %d)", wld_chunk_get_highest_motion_blocking(chunk)[0], wld_chunk_get_highest_world_surface(chunk)[0]);
+		return false;
+	}
+
+	wld_unload_all();
+
+	test_remove_world();
+
+	return true;
+
+}
+
+bool test_scheduler() {
+
+	// in every level of the wheel, on both sides of their edges, and past the top
+	const uint32_t delays[] = { 1, 2, 63, 64, 65, 200, 4095, 4096, 4097, 5000, 262145, 20000000 };
+	const uint32_t delay_count = sizeof(delays) / sizeof(delays[0]);
+
+	for (uint32_t i = 0; i < delay_count; ++i) {
+		sch_schedule(job_new(job_keep_alive, (job_payload_t) { .client = NULL }), delays[i]);
+	}
+
+	const uint32_t repeating = sch_schedule_repeating(job_new(job_keep_alive, (job_payload_t) { .client = NULL }), 2, 3);
+	const uint32_t canceled = sch_schedule(job_new(job_keep_alive, (job_payload_t) { .client = NULL }), 10);
+	sch_cancel(canceled);
+
+	for (uint32_t tick = 1; tick <= 20000000; ++tick) {
+
+		uint32_t expected = 0;
+		for (uint32_t i = 0; i < delay_count; ++i) {
+			expected += delays[i] == tick;
+		}
+		if (tick <= 100 && tick >= 2 && (tick - 2) % 3 == 0) {
+			expected++;
+		}
+
+		const size_t before = job_get_count();
+		sch_tick();
+		const size_t ran = job_get_count() - before;
+
+		if (ran != expected) {
+			log_error("%zu jobs ran at tick %u instead of %u", ran, tick, expected);
+			return false;
+		}
+
+		if (tick == 100) {
+			sch_cancel(repeating);
+		}
+
+	}
+
+	return true;
+
+}
+
+#define TEST_JOB_THREADS 4
+#define TEST_JOB_ROUNDS 20000
+
+// every thread keeps a few jobs at a time, each pointing at the thread, so a job handed out twice is noticed
+static void* t_test_jobs(void* args) {
+
+	uint32_t ids[16];
+
+	for (uint32_t round = 0; round < TEST_JOB_ROUNDS; ++round) {
+
+		for (uint32_t i = 0; i < 16; ++i) {
+			ids[i] = job_new(job_keep_alive, (job_payload_t) { .client = args });
+			job_get_work(ids[i])->on_board++;
+		}
+
+		for (uint32_t i = 0; i < 16; ++i) {
+
+			const job_work_t* work = job_get_work(ids[i]);
+			if (work == NULL || work->payload.client != args) {
+				log_error("Job %08x was given to two threads", ids[i]);
+				return args;
+			}
+
+			job_free(ids[i]);
+
+			if (job_get_work(ids[i]) != NULL) {
+				log_error("Job %08x was found after being freed", ids[i]);
+				return args;
+			}
+
+		}
+
+	}
+
+	return NULL;
+
+}
+
+static ent_entity_t* test_create_entity(ent_type_t type, float64_t y) {
+
+	ent_entity_t* entity = calloc(1, sizeof(ent_entity_t));
+	memcpy((ent_type_t*) &entity->type, &type, sizeof(type));
+	entity->position.y = y;
+
+	return entity;
+
+}
+
+bool test_entity_store() {
+
+	ent_store_t store;
+	ent_init_store(&store, 0, 0);
+
+	// enough to grow the arrays
+	ent_entity_t* entities[ENT_STORE_MIN_CAPACITY + 4];
+	const uint32_t count = sizeof(entities) / sizeof(entities[0]);
+
+	for (uint32_t i = 0; i < count; ++i) {
+		entities[i] = test_create_entity(i % 2 == 0 ? ent_item : ent_player, 100);
+		ent_store_add(&store, entities[i], i % 4);
+		ent_store_set_velocity(entities[i], 1, 0, 0);
+	}
+
+	// below the world without gravity, in a chunk that ticks
+	entities[2]->position.y = -200;
+	entities[2]->no_gravity = true;
+	ent_store_remove(entities[2]);
+	ent_store_add(&store, entities[2], 0);
+
+	if (entities[count - 1]->store_index != 2 || store.entities[2] != entities[count - 1]) {
+		log_error("The last entity wasn't moved to the removed one");
+		return false;
+	}
+
+	bool ticking[32 * 32] = { false };
+	ticking[0] = true;
+	ticking[1] = true;
+	ticking[3] = true;
+
+	utl_vector_t moved = UTL_VECTOR_INITIALIZER(ent_store_move_t);
+	utl_vector_t in_void = UTL_VECTOR_INITIALIZER(ent_entity_t*);
+
+	ent_store_tick(&store, NULL, ticking, -128, &moved, &in_void);
+
+	if (in_void.size != 1 || UTL_VECTOR_GET_AS(ent_entity_t*, &in_void, 0) != entities[2]) {
+		log_error("Found %u entities in the void", in_void.size);
+		return false;
+	}
+
+	// players aren't moved, neither are entities in chunk 2, which doesn't tick
+	for (uint32_t i = 0; i < moved.size; ++i) {
+
+		const ent_store_move_t* move = utl_vector_get(&moved, i);
+		const uint32_t index = move->entity->store_index;
+
+		if (ent_get_type(move->entity) == ent_player || store.chunk[index] == 2) {
+			log_error("Moved an entity that shouldn't move");
+			return false;
+		}
+
+		if (move->x != 1 || store.velocity_x[index] != ENT_AIR_FRICTION) {
+			log_error("Moved an entity to x %f with velocity %f", move->x, store.velocity_x[index]);
+			return false;
+		}
+
+		if (store.velocity_y[index] != -ENT_GRAVITY * ENT_DRAG) {
+			log_error("Entity fell with velocity %f", store.velocity_y[index]);
+			return false;
+		}
+
+	}
+
+	// items in chunk 0, the one added again has no velocity
+	if (moved.size != count / 4) {
+		log_error("Moved %u entities", moved.size);
+		return false;
+	}
+
+	// slow enough to stop after one more tick
+	ent_store_set_velocity(entities[0], ENT_MIN_VELOCITY, 0, 0);
+	ent_store_tick(&store, NULL, ticking, -128, &moved, &in_void);
+
+	if (store.velocity_x[entities[0]->store_index] != 0) {
+		log_error("Entity didn't stop with velocity %f", store.velocity_x[entities[0]->store_index]);
+		return false;
+	}
+
+	utl_term_vector(&moved);
+	utl_term_vector(&in_void);
+
+	for (uint32_t i = 0; i < count - 1; ++i) {
+		ent_store_remove(entities[i]);
+		free(entities[i]);
+	}
+
+	if (store.length != 1) {
+		log_error("%u entities left in the store", store.length);
+		return false;
+	}
+
+	// the entity still in the store is taken out when the store goes away
+	ent_term_store(&store);
+
+	if (entities[count - 1]->store != NULL) {
+		log_error("Entity still points at the terminated store");
+		return false;
+	}
+
+	free(entities[count - 1]);
+
+	return true;
+
+}
+
+#define TEST_GRID_ENTITIES 400
+
+// counts the entities in the box by going over all of them
+static uint32_t test_count_in_box(ent_store_t* store, float64_t min_x, float64_t min_y, float64_t min_z, float64_t max_x, float64_t max_y, float64_t max_z) {
+
+	uint32_t count = 0;
+
+	for (uint32_t i = 0; i < store->length; ++i) {
+		const float64_t half_width = store->width[i] / 2;
+		if (store->x[i] - half_width <= max_x && store->x[i] + half_width >= min_x
+		&& store->z[i] - half_width <= max_z && store->z[i] + half_width >= min_z
+		&& store->y[i] <= max_y && store->y[i] + store->height[i] >= min_y) {
+			count++;
+		}
+	}
+
+	return count;
+
+}
+
+static bool test_grid_box(ent_store_t* store, float64_t min_x, float64_t min_z, float64_t max_x, float64_t max_z) {
+
+	utl_vector_t found = UTL_VECTOR_INITIALIZER(ent_entity_t*);
+	ent_store_get_in_box(store, min_x, 64, min_z, max_x, 65, max_z, &found);
+
+	const uint32_t expected = test_count_in_box(store, min_x, 64, min_z, max_x, 65, max_z);
+	const uint32_t size = found.size;
+
+	utl_term_vector(&found);
+
+	if (size != expected) {
+		log_error("Found %u entities in %.1f %.1f %.1f %.1f instead of %u", size, min_x, min_z, max_x, max_z, expected);
+		return false;
+	}
+
+	return true;
+
+}
+
+bool test_entity_grid() {
+
+	ent_store_t store;
+	ent_init_store(&store, 512, -512);
+
+	// spread over the region and a bit outside it, every 7th is a player
+	ent_entity_t* entities[TEST_GRID_ENTITIES];
+	for (uint32_t i = 0; i < TEST_GRID_ENTITIES; ++i) {
+		entities[i] = test_create_entity(i % 7 == 0 ? ent_player : ent_item, 64);
+		entities[i]->position.x = 500.0 + (i * 37) % 540 + (i % 10) * 0.1;
+		entities[i]->position.z = -520.0 + (i * 53) % 540 + (i % 3) * 0.3;
+		ent_store_add(&store, entities[i], 0);
+	}
+
+	const float64_t boxes[][4] = {
+		{ 512, -512, 1023, -1 },
+		{ 600.5, -300, 610, -290.25 },
+		{ 490, -530, 515, -505 },
+		{ 1000, -20, 1100, 40 },
+		{ 700, -200, 700, -200 }
+	};
+	const uint32_t box_count = sizeof(boxes) / sizeof(boxes[0]);
+
+	for (uint32_t i = 0; i < box_count; ++i) {
+		if (!test_grid_box(&store, boxes[i][0], boxes[i][1], boxes[i][2], boxes[i][3])) {
+			return false;
+		}
+	}
+
+	// moving an entity moves it to its new cell
+	ent_entity_t* moving = entities[1];
+	moving->position.x = 605;
+	moving->position.z = -295;
+	ent_store_update(moving);
+
+	utl_vector_t found = UTL_VECTOR_INITIALIZER(ent_entity_t*);
+	ent_store_get_in_radius(&store, 605, 64, -295, 0.5, &found);
+
+	bool moved = false;
+	for (uint32_t i = 0; i < found.size; ++i) {
+		moved |= UTL_VECTOR_GET_AS(ent_entity_t*, &found, i) == moving;
+	}
+
+	if (!moved) {
+		log_error("Didn't find the moved entity");
+		return false;
+	}
+
+	utl_term_vector(&found);
+
+	// the nearest player of all of them
+	ent_entity_t* nearest = ent_store_get_nearest_player(&store, 800, 64, -200, 100);
+	float64_t nearest_distance = INFINITY;
+	for (uint32_t i = 0; i < TEST_GRID_ENTITIES; i += 7) {
+		const float64_t d_x = ent_get_x(entities[i]) - 800;
+		const float64_t d_z = ent_get_z(entities[i]) + 200;
+		nearest_distance = UTL_MIN(nearest_distance, sqrt(d_x * d_x + d_z * d_z));
+	}
+
+	if (nearest == NULL || ent_get_type(nearest) != ent_player) {
+		log_error("Didn't find the nearest player");
+		return false;
+	}
+
+	// the box of the player found can be closer than its position, but not by more than its width
+	const float64_t d_x = ent_get_x(nearest) - 800;
+	const float64_t d_z = ent_get_z(nearest) + 200;
+	if (sqrt(d_x * d_x + d_z * d_z) > nearest_distance + 1) {
+		log_error("Found a player %f blocks away, the nearest is %f away", sqrt(d_x * d_x + d_z * d_z), nearest_distance);
+		return false;
+	}
+
+	// two entities next to each other overlap
+	entities[2]->position.x = 605.1;
+	entities[2]->position.z = -295;
+	ent_store_update(entities[2]);
+
+	utl_vector_t pairs = UTL_VECTOR_INITIALIZER(ent_store_pair_t);
+	ent_store_get_pairs(&store, &pairs);
+
+	bool paired = false;
+	for (uint32_t i = 0; i < pairs.size; ++i) {
+		const ent_store_pair_t* pair = utl_vector_get(&pairs, i);
+		if (pair->a == pair->b) {
+			log_error("Paired an entity with itself");
+			return false;
+		}
+		paired |= (pair->a == moving && pair->b == entities[2]) || (pair->a == entities[2] && pair->b == moving);
+	}
+
+	if (!paired) {
+		log_error("Didn't pair entities that overlap");
+		return false;
+	}
+
+	utl_term_vector(&pairs);
+
+	// removing moves entities to other indexes, the cells have to follow
+	for (uint32_t i = 0; i < TEST_GRID_ENTITIES; i += 2) {
+		ent_store_remove(entities[i]);
+	}
+
+	for (uint32_t i = 0; i < box_count; ++i) {
+		if (!test_grid_box(&store, boxes[i][0], boxes[i][1], boxes[i][2], boxes[i][3])) {
+			return false;
+		}
+	}
+
+	for (uint32_t i = 0; i < TEST_GRID_ENTITIES; ++i) {
+		ent_store_remove(entities[i]);
+		free(entities[i]);
+	}
+
+	ent_term_store(&store);
+
+	return true;
+
+}
+
+// a client in the play state that isn't handled by any thread, what is sent to it is read from the other end
+static ltg_client_t* test_create_client(int32_t* other) {
+
+	int sockets[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+		return NULL;
+	}
+
+	ltg_client_t* client = calloc(1, sizeof(ltg_client_t));
+	client->listener = sky_get_listener();
+	client->socket = sockets[0];
+	pthread_mutex_init(&client->lock, NULL);
+	client->state = ltg_play;
+	utl_init_vector(&client->send.queue, sizeof(byte_t));
+
+	*other = sockets[1];
+
+	return client;
+
+}
+
+static void test_free_client(ltg_client_t* client, int32_t other) {
+
+	close(client->socket);
+	close(other);
+	pthread_mutex_destroy(&client->lock);
+	utl_term_vector(&client->send.queue);
+	free(client);
+
+}
+
+bool test_send_queue() {
+
+	int32_t other = -1;
+	ltg_client_t* client = test_create_client(&other);
+
+	PCK_INLINE(packet, 16, io_big_endian);
+	pck_write_var_int(packet, 0x01);
+	pck_write_int64(packet, 42);
+
+	// packets are queued until the client is flushed
+	ltg_send(client, packet);
+	ltg_send(client, packet);
+
+	byte_t frames[20];
+	if (recv(other, frames, sizeof(frames), MSG_DONTWAIT) > 0) {
+		log_error("Packet was sent before the client was flushed");
+		return false;
+	}
+
+	if (client->send.queue.size != sizeof(frames)) {
+		log_error("%zu bytes were queued instead of %zu", client->send.queue.size, sizeof(frames));
+		return false;
+	}
+
+	// both go out together
+	ltg_flush(client);
+
+	if (client->send.queue.size != 0 || !test_read_client(other, frames, sizeof(frames)) || memcmp(frames, frames + 10, 10) != 0) {
+		log_error("Flush didn't send the queued packets");
+		return false;
+	}
+
+	test_free_client(client, other);
+
+	return true;
+
+}
+
+bool test_broadcasts() {
+
+	// compared to what the client gets, which has compression off
+	const uint16_t compression_threshold = sky_main.network_compression_threshold;
+	sky_main.network_compression_threshold = 0;
+
+	int32_t other = -1;
+	ltg_client_t* client = test_create_client(&other);
+
+	PCK_INLINE(packet, 16, io_big_endian);
+	pck_write_var_int(packet, 0x01);
+	pck_write_int64(packet, 42);
+
+	ltg_send_immediately(client, packet);
+
+	byte_t frame[10];
+	if (!test_read_client(other, frame, sizeof(frame))) {
+		log_error("Packet wasn't sent");
+		return false;
+	}
+
+	// a broadcast is framed like the packet sent on its own, and kept until the last reference is released
+	ltg_broadcast_t* broadcast = ltg_broadcast_create(packet);
+	if (broadcast->references != 1 || broadcast->length != sizeof(frame) || memcmp(broadcast->bytes, frame, sizeof(frame)) != 0) {
+		log_error("Broadcast isn't framed like the packet");
+		return false;
+	}
+
+	ltg_broadcast_retain(broadcast);
+	ltg_send_broadcast(client, broadcast);
+	ltg_send_broadcast(client, broadcast);
+	ltg_broadcast_release(broadcast);
+
+	if (broadcast->references != 1) {
+		log_error("Broadcast has %u references instead of 1", broadcast->references);
+		return false;
+	}
+
+	ltg_broadcast_release(broadcast);
+
+	// the queue holds copies, so it is still sent after the broadcast is freed
+	ltg_flush(client);
+
+	byte_t frames[20];
+	if (!test_read_client(other, frames, sizeof(frames)) || memcmp(frames, frame, sizeof(frame)) != 0 || memcmp(frames + 10, frame, sizeof(frame)) != 0) {
+		log_error("Broadcast wasn't sent twice");
+		return false;
+	}
+
+	test_free_client(client, other);
+
+	sky_main.network_compression_threshold = compression_threshold;
+
+	return true;
+
+}
+
+#define TEST_CHUNK_THREADS 4
+
+typedef struct {
+
+	wld_chunk_t* chunk;
+	bool passed;
+
+} test_chunk_sender_t;
+
+// changes a block and sends the chunk again, over and over, each packet must be the chunk it was sent for
+static void* test_send_chunks(void* args) {
+
+	test_chunk_sender_t* sender = args;
+	wld_chunk_t* chunk = sender->chunk;
+
+	int32_t other = -1;
+	ltg_client_t* client = test_create_client(&other);
+
+	const int32_t x = wld_get_chunk_x(chunk) << 4;
+	const int32_t z = wld_get_chunk_z(chunk) << 4;
+
+	sender->passed = true;
+
+	for (uint32_t i = 0; i < 256 && sender->passed; ++i) {
+
+		wld_set_block_type_at(chunk, x + (i & 0xF), 100, z, i & 1 ? mat_block_gold_block : mat_block_stone);
+
+		phd_send_chunk_data_and_update_light(client, chunk);
+
+		// read from the queue, which only this thread uses
+		pck_packet_t* packet = pck_create(client->send.queue.size, io_big_endian);
+		memcpy(packet->bytes, client->send.queue.array, client->send.queue.size);
+		client->send.queue.size = 0;
+
+		const size_t length = pck_read_var_int(packet);
+		if (length != packet->length - packet->cursor || pck_read_var_int(packet) != 0x22 || pck_read_int32(packet) != wld_get_chunk_x(chunk) || pck_read_int32(packet) != wld_get_chunk_z(chunk)) {
+			sender->passed = false;
+		}
+
+		free(packet);
+
+	}
+
+	test_free_client(client, other);
+
+	return NULL;
+
+}
+
+bool test_chunk_buffers() {
+
+	// packets are read as they are queued, without compression
+	const uint16_t compression_threshold = sky_main.network_compression_threshold;
+	sky_main.network_compression_threshold = 0;
+
+	wld_world_t* world = wld_new(UTL_CSTRTOSTR("test_world"), 3, mat_dimension_overworld);
+	wld_chunk_t* chunk = wld_get_chunk_at(world, wld_get_spawn_x(world), wld_get_spawn_z(world));
+
+	// threads encode into their own buffers, so chunks encoded at the same time don't mix
+	pthread_t threads[TEST_CHUNK_THREADS];
+	test_chunk_sender_t senders[TEST_CHUNK_THREADS];
+
+	for (uint32_t i = 0; i < TEST_CHUNK_THREADS; ++i) {
+		senders[i].chunk = wld_get_chunk(world, wld_get_chunk_x(chunk) + i, wld_get_chunk_z(chunk));
+		pthread_create(&threads[i], NULL, test_send_chunks, &senders[i]);
+	}
+
+	for (uint32_t i = 0; i < TEST_CHUNK_THREADS; ++i) {
+		pthread_join(threads[i], NULL);
+		if (!senders[i].passed) {
+			log_error("Chunk sent from thread %u was mixed up", i);
+			return false;
+		}
+	}
+
+	wld_unload_all();
+
+	test_remove_world();
+
+	sky_main.network_compression_threshold = compression_threshold;
+
+	return true;
+
+}
+
+// reads an uncompressed frame sent to the client into packet, false if it couldn't be read or is longer than capacity
+static bool test_read_frame(int32_t socket, pck_packet_t* packet, uint32_t capacity) {
+
+	uint32_t length = 0;
+	byte_t byte = 0x80;
+
+	for (uint8_t i = 0; byte & 0x80; ++i) {
+		if (i == 3 || !test_read_client(socket, &byte, 1)) {
+			return false;
+		}
+		length |= (byte & 0x7F) << (7 * i);
+	}
+
+	if (length > capacity) {
+		return false;
+	}
+
+	packet->cursor = 0;
+	packet->length = length;
+
+	return test_read_client(socket, packet->bytes, length);
+
+}
+
+bool test_section_encoding() {
+
+	const uint16_t compression_threshold = sky_main.network_compression_threshold;
+	sky_main.network_compression_threshold = 0;
+
+	wld_world_t* world = wld_new(UTL_CSTRTOSTR("test_world"), 3, mat_dimension_overworld);
+	wld_chunk_t* chunk = wld_get_chunk_at(world, wld_get_spawn_x(world), wld_get_spawn_z(world));
+	const int32_t x = wld_get_chunk_x(chunk) << 4;
+	const int32_t z = wld_get_chunk_z(chunk) << 4;
+	const int16_t min_y = mat_get_dimension_by_type(wld_get_environment(world))->min_y;
+
+	int32_t other = -1;
+	ltg_client_t* client = test_create_client(&other);
+	PCK_INLINE(packet, 262144, io_big_endian);
+
+	// the bottom section is encoded when the chunk is first sent
+	phd_send_chunk_data_and_update_light(client, chunk);
+	ltg_flush(client);
+
+	if (!test_read_frame(other, packet, 262144)) {
+		log_error("Chunk packet wasn't sent");
+		return false;
+	}
+
+	wld_chunk_section_t* section = wld_chunk_get_section(chunk, 0);
+	if (section->encoded.bytes == NULL || section->encoded.outdated) {
+		log_error("Section wasn't encoded");
+		return false;
+	}
+
+	const uint32_t encoded_length = section->encoded.length;
+	byte_t encoded[encoded_length];
+	memcpy(encoded, section->encoded.bytes, encoded_length);
+
+	// and again after a block in it changes
+	wld_set_block_type_at(chunk, x, min_y, z, mat_block_gold_block);
+
+	if (!section->encoded.outdated) {
+		log_error("Block change didn't outdate the section");
+		return false;
+	}
+
+	phd_send_chunk_data_and_update_light(client, chunk);
+	ltg_flush(client);
+
+	if (!test_read_frame(other, packet, 262144)) {
+		log_error("Chunk packet wasn't sent again");
+		return false;
+	}
+
+	if (section->encoded.outdated || (section->encoded.length == encoded_length && memcmp(section->encoded.bytes, encoded, encoded_length) == 0)) {
+		log_error("Section wasn't encoded again");
+		return false;
+	}
+
+	test_free_client(client, other);
+
+	wld_unload_all();
+
+	test_remove_world();
+
+	sky_main.network_compression_threshold = compression_threshold;
+
+	return true;
+
+}
+
+bool test_chunk_packet_cache() {
+
+	wld_world_t* world = wld_new(UTL_CSTRTOSTR("test_world"), 3, mat_dimension_overworld);
+	wld_chunk_t* chunk = wld_get_chunk_at(world, wld_get_spawn_x(world), wld_get_spawn_z(world));
+	const int32_t x = wld_get_chunk_x(chunk) << 4;
+	const int32_t z = wld_get_chunk_z(chunk) << 4;
+
+	int32_t other = -1;
+	ltg_client_t* client = test_create_client(&other);
+
+	// the packet is kept for the version it was sent at
+	phd_send_chunk_data_and_update_light(client, chunk);
+
+	const uint32_t version = wld_chunk_get_version(chunk);
+	ltg_broadcast_t* cached = wld_get_cached_chunk_packet(chunk, version);
+	if (cached == NULL) {
+		log_error("Chunk packet wasn't cached");
+		return false;
+	}
+	ltg_broadcast_release(cached);
+
+	// a block change makes it stale
+	wld_set_block_type_at(chunk, x, 100, z, mat_block_gold_block);
+
+	if (wld_chunk_get_version(chunk) == version || wld_get_cached_chunk_packet(chunk, wld_chunk_get_version(chunk)) != NULL) {
+		log_error("Stale chunk packet was used");
+		return false;
+	}
+
+	phd_send_chunk_data_and_update_light(client, chunk);
+
+	cached = wld_get_cached_chunk_packet(chunk, wld_chunk_get_version(chunk));
+	if (cached == NULL || cached->references != 2) {
+		log_error("Chunk packet wasn't cached again");
+		return false;
+	}
+
+	// the least recently sent packet is dropped once too many are cached
+	wld_chunk_t* others = calloc(WLD_MAX_CACHED_CHUNK_PACKETS, sizeof(wld_chunk_t));
+	for (uint32_t i = 0; i < WLD_MAX_CACHED_CHUNK_PACKETS; ++i) {
+		wld_cache_chunk_packet(&others[i], 0, cached);
+	}
+
+	const bool evicted = wld_get_cached_chunk_packet(chunk, wld_chunk_get_version(chunk)) == NULL;
+
+	for (uint32_t i = 0; i < WLD_MAX_CACHED_CHUNK_PACKETS; ++i) {
+		wld_uncache_chunk_packet(&others[i]);
+	}
+	free(others);
+
+	if (!evicted || cached->references != 1) {
+		log_error("Least recently sent chunk packet wasn't evicted (%u references)", cached->references);
+		return false;
+	}
+	ltg_broadcast_release(cached);
+
+	test_free_client(client, other);
+
+	wld_unload_all();
+
+	test_remove_world();
+
+	return true;
+
+}
+
+// the move jobs of the entity on the board, id is set to the last one found
+static uint32_t test_count_move_jobs(ent_entity_t* entity, uint32_t* id) {
+
+	uint32_t count = 0;
+
+	for (uint32_t i = 0; i < job_board.heap.allocated; ++i) {
+		job_work_t* work = &job_board.heap.pages[i >> JOB_SLAB_PAGE_BITS][i & (JOB_SLAB_PAGE_SIZE - 1)];
+		if (work->on_board != 0 && work->type == job_entity_move && work->payload.entity == entity) {
+			*id = work->id;
+			count++;
+		}
+	}
+
+	return count;
+
+}
+
+// handles the move job of the entity like its phase would
+static bool test_handle_move_job(ent_entity_t* entity) {
+
+	uint32_t id = 0;
+	const uint32_t count = test_count_move_jobs(entity, &id);
+
+	if (count != 1) {
+		log_error("%u move jobs were added instead of 1", count);
+		return false;
+	}
+
+	job_handle_entity_move(&job_get_work(id)->payload);
+	job_free(id);
+
+	return true;
+
+}
+
+bool test_entity_moves() {
+
+	const uint16_t compression_threshold = sky_main.network_compression_threshold;
+	sky_main.network_compression_threshold = 0;
+
+	wld_world_t* world = wld_new(UTL_CSTRTOSTR("test_world"), 3, mat_dimension_overworld);
+
+	ent_entity_t* entity = test_create_entity(ent_item, 100);
+	entity->position.world = world;
+	entity->position.x = wld_get_spawn_x(world) + 0.5;
+	entity->position.z = wld_get_spawn_z(world) + 0.5;
+	ent_register_entity(entity);
+
+	// a viewer of the chunk the entity is in
+	int32_t other = -1;
+	ltg_client_t* client = test_create_client(&other);
+	with_lock (&client->listener->clients.lock) {
+		client->id = utl_id_vector_push(&client->listener->clients.vector, &client);
+	}
+	wld_subscribe_chunk(ent_get_chunk(entity), client->id);
+
+	PCK_INLINE(packet, 64, io_big_endian);
+
+	// moves told in the same tick are applied by one job, which sends only the last position
+	const float64_t x = entity->position.x;
+	ent_move(entity, x + 1, 100, entity->position.z, false);
+	ent_move(entity, x + 2, 100, entity->position.z, false);
+	ent_move(entity, x + 3, 101, entity->position.z, true);
+
+	if (!test_handle_move_job(entity)) {
+		return false;
+	}
+
+	ltg_flush(client);
+
+	if (!test_read_frame(other, packet, 64) || pck_read_var_int(packet) != 0x29 || (uint32_t) pck_read_var_int(packet) != ent_get_id(entity) || pck_read_int16(packet) != 3 * 4096 || pck_read_int16(packet) != 4096 || pck_read_int16(packet) != 0 || pck_read_int8(packet) != 1) {
+		log_error("Moves weren't sent as one relative move");
+		return false;
+	}
+
+	if (entity->position.x != x + 3 || entity->position.y != 101 || entity->movement.queued) {
+		log_error("Entity wasn't moved to the last position");
+		return false;
+	}
+
+	// a move told before a teleport doesn't put the entity back after it
+	ent_move(entity, x + 4, 101, entity->position.z, true);
+
+	job_payload_t teleport = {
+		.entity_teleport = {
+			.entity = entity,
+			.world = world,
+			.x = x + 5,
+			.y = 120,
+			.z = entity->position.z,
+			.on_ground = false
+		}
+	};
+	job_handle_entity_teleport(&teleport);
+
+	if (!test_handle_move_job(entity)) {
+		return false;
+	}
+
+	ltg_flush(client);
+
+	if (!test_read_frame(other, packet, 64) || pck_read_var_int(packet) != 0x62 || (uint32_t) pck_read_var_int(packet) != ent_get_id(entity) || pck_read_float64(packet) != x + 5 || pck_read_float64(packet) != 120) {
+		log_error("Teleport wasn't sent");
+		return false;
+	}
+
+	byte_t extra;
+	if (recv(other, &extra, 1, MSG_DONTWAIT) > 0 || entity->position.x != x + 5 || entity->position.y != 120 || entity->movement.queued) {
+		log_error("Move told before the teleport was applied after it");
+		return false;
+	}
+
+	wld_unsubscribe_chunk(ent_get_chunk(entity), client->id);
+	with_lock (&client->listener->clients.lock) {
+		utl_id_vector_remove(&client->listener->clients.vector, client->id);
+	}
+	test_free_client(client, other);
+
+	ent_free_entity(entity);
+
+	wld_unload_all();
+
+	test_remove_world();
+
+	sky_main.network_compression_threshold = compression_threshold;
+
+	return true;
+
+}
+
+bool test_collision() {
+
+	wld_world_t* world = wld_new(UTL_CSTRTOSTR("test_world"), 3, mat_dimension_overworld);
+
+	wld_chunk_t* chunk = wld_get_chunk_at(world, wld_get_spawn_x(world), wld_get_spawn_z(world));
+	const int32_t x = wld_get_chunk_x(chunk) << 4;
+	const int32_t z = wld_get_chunk_z(chunk) << 4;
+
+	// a floor of stone high above the ground, with a bottom slab and a fence on it
+	for (int32_t b_x = x; b_x < x + 4; ++b_x) {
+		wld_set_block_type_at(chunk, b_x, 200, z, mat_block_stone);
+	}
+	wld_set_block_at(chunk, x + 2, 201, z, mat_set_block_state_value(mat_get_block_default_protocol_id_by_type(mat_block_stone_slab), mat_state_modifier_slab_type, 1));
+	wld_set_block_type_at(chunk, x + 3, 201, z, mat_block_oak_fence);
+
+	const struct {
+		float64_t x, y;
+		float64_t motion[3];
+		float64_t expected[3];
+		uint8_t collisions;
+	} sweeps[] = {
+		// falls onto the stone
+		{ 0.5, 205, { 0, -10, 0 }, { 0, -4, 0 }, ent_collision_y },
+		// walks into the side of the slab
+		{ 0.5, 201, { 2, 0, 0 }, { 1.2, 0, 0 }, ent_collision_x },
+		// falls onto the slab, then slides along it into the fence
+		{ 2.5, 203, { 1, -2, 0 }, { 0.2, -1.5, 0 }, ent_collision_x | ent_collision_y },
+		// jumps over the slab, not over the fence
+		{ 1.5, 201.6, { 2, 0, 0 }, { 1.2, 0, 0 }, ent_collision_x },
+		// air above the floor
+		{ 0.5, 210, { 0, -4, 0 }, { 0, -4, 0 }, 0 }
+	};
+
+	for (uint32_t i = 0; i < sizeof(sweeps) / sizeof(sweeps[0]); ++i) {
+
+		ent_box_t box = {
+			.min = { x + sweeps[i].x - 0.3, sweeps[i].y, z + 0.2 },
+			.max = { x + sweeps[i].x + 0.3, sweeps[i].y + 1.8, z + 0.8 }
+		};
+		float64_t motion[3] = { sweeps[i].motion[0], sweeps[i].motion[1], sweeps[i].motion[2] };
+
+		const uint8_t collisions = ent_sweep(chunk, &box, motion);
+
+		for (ent_axis_t axis = ent_axis_x; axis <= ent_axis_z; ++axis) {
+			if (fabs(motion[axis] - sweeps[i].expected[axis]) > 1e-6) {
+				log_error("Sweep %u moved %f on axis %u instead of %f", i, motion[axis], axis, sweeps[i].expected[axis]);
+				return false;
+			}
+		}
+
+		if (collisions != sweeps[i].collisions) {
+			log_error("Sweep %u collided on %u instead of %u", i, collisions, sweeps[i].collisions);
+			return false;
+		}
+
+	}
+
+	// blocks that aren't full cubes, the default states face north and aren't connected
+	const uint8_t* shapes = mat_get_shape_table();
+	const mat_block_protocol_id_t door = mat_get_block_default_protocol_id_by_type(mat_block_oak_door);
+	const struct {
+		mat_block_protocol_id_t block;
+		mat_shape_type_t shape;
+	} shaped[] = {
+		{ mat_get_block_default_protocol_id_by_type(mat_block_stone_brick_stairs), mat_shape_stairs_bottom_north },
+		{ mat_get_block_default_protocol_id_by_type(mat_block_oak_trapdoor), mat_shape_trapdoor_bottom },
+		{ door, mat_shape_side_south },
+		{ mat_set_block_state_value(door, mat_state_modifier_door_open, 0), mat_shape_side_west },
+		{ mat_get_block_default_protocol_id_by_type(mat_block_ladder), mat_shape_side_south },
+		{ mat_get_block_default_protocol_id_by_type(mat_block_glass_pane), mat_shape_pane },
+		{ mat_set_block_state_value(mat_get_block_default_protocol_id_by_type(mat_block_iron_bars), mat_state_modifier_east, 0), mat_shape_pane + 8 },
+		{ mat_get_block_default_protocol_id_by_type(mat_block_lantern), mat_shape_lantern },
+		{ mat_get_block_default_protocol_id_by_type(mat_block_flower_pot), mat_shape_flower_pot }
+	};
+	for (uint32_t i = 0; i < sizeof(shaped) / sizeof(shaped[0]); ++i) {
+		if (shapes[shaped[i].block] != shaped[i].shape) {
+			log_error("Block %u has shape %u instead of %u", shaped[i].block, shapes[shaped[i].block], shaped[i].shape);
+			return false;
+		}
+	}
+
+	wld_unload_all();
+
+	test_remove_world();
+
+	return true;
+
+}
+
+bool test_jobs() {
+
+	pthread_t threads[TEST_JOB_THREADS];
+	ltg_client_t* owners[TEST_JOB_THREADS];
+
+	for (uint32_t i = 0; i < TEST_JOB_THREADS; ++i) {
+		owners[i] = (ltg_client_t*) &owners[i];
+		pthread_create(&threads[i], NULL, t_test_jobs, owners[i]);
+	}
+
+	bool passed = true;
+
+	for (uint32_t i = 0; i < TEST_JOB_THREADS; ++i) {
+		void* failed;
+		pthread_join(threads[i], &failed);
+		passed &= failed == NULL;
+	}
+
+	// the slots were reused, not handed out again and again
+	if (job_board.heap.allocated > JOB_SLAB_PAGE_SIZE * 2) {
+		log_error("%u job slots were used for %u jobs at a time", job_board.heap.allocated, TEST_JOB_THREADS * 16);
+		return false;
+	}
+
+	return passed;
+
+}
+
+wld_block_storage_t* _Atomic test_shared_storage;
+
+// every thread sets every fourth block, starting at its offset
+static void* t_test_block_storage(void* args) {
+
+	const uint16_t offset = *(uint16_t*) args;
+
+	for (uint16_t i = offset; i < 4096; i += 4) {
+		wld_block_storage_set(&test_shared_storage, i, i % 300);
+	}
+
+	return NULL;
+
+}
+
+bool test_block_storage() {
+
+	wld_block_storage_t* _Atomic storage = wld_create_block_storage(0, 0);
+
+	// grows from a single block to direct
+	for (uint16_t i = 0; i < 4096; ++i) {
+		if (wld_block_storage_set(&storage, i, i % 300) != 0) {
+			log_error("Wrong previous block at %u", i);
+			return false;
+		}
+	}
+
+	for (uint16_t i = 0; i < 4096; ++i) {
+		if (wld_block_storage_get(storage, i) != i % 300) {
+			log_error("Wrong block at %u (%u bits)", i, storage->bits);
+			return false;
+		}
+	}
+
+	wld_free_block_storage(storage);
+
+	// grows while other threads are writing to it
+	test_shared_storage = wld_create_block_storage(0, 0);
+
+	pthread_t threads[4];
+	uint16_t offsets[4];
+	for (uint16_t i = 0; i < 4; ++i) {
+		offsets[i] = i;
+		pthread_create(&threads[i], NULL, t_test_block_storage, &offsets[i]);
+	}
+	for (uint16_t i = 0; i < 4; ++i) {
+		pthread_join(threads[i], NULL);
+	}
+
+	for (uint16_t i = 0; i < 4096; ++i) {
+		if (wld_block_storage_get(test_shared_storage, i) != i % 300) {
+			log_error("Wrong block at %u after concurrent writes (%u bits)", i, test_shared_storage->bits);
+			return false;
+		}
+	}
+
+	wld_free_block_storage(test_shared_storage);
+
+	// the storages that were grown out of are freed a tick after they're replaced
+	wld_reclaim_block_storages();
+	wld_reclaim_block_storages();
+
+	return true;
+
+}
+
+typedef struct {
+	bool (*func)();
+	string_t label;
+} test_t;
+
+int test_run_all() {
+
+	const test_t tests[] = {
+		(test_t) {
+			.func = test_materials,
+			.label = UTL_CSTRTOSTR("materials")
+		},
+		(test_t) {
+			.func = test_packets,
+			.label = UTL_CSTRTOSTR("packets")
+		},
+		(test_t) {
+			.func = test_packet_framing,
+			.label = UTL_CSTRTOSTR("packet framing")
+		},
+		(test_t) {
+			.func = test_worlds,
+			.label = UTL_CSTRTOSTR("worlds")
+		},
+		(test_t) {
+			.func = test_hash_map,
+			.label = UTL_CSTRTOSTR("hash map")
+		},
+		(test_t) {
+			.func = test_deque,
+			.label = UTL_CSTRTOSTR("deque")
+		},
+		(test_t) {
+			.func = test_block_storage,
+			.label = UTL_CSTRTOSTR("block storage")
+		},
+		(test_t) {
+			.func = test_region_files,
+			.label = UTL_CSTRTOSTR("region files")
+		},
+		(test_t) {
+			.func = test_chunk_loading,
+			.label = UTL_CSTRTOSTR("chunk loading")
+		},
+		(test_t) {
+			.func = test_save_snapshots,
+			.label = UTL_CSTRTOSTR("save snapshots")
+		},
+		(test_t) {
+			.func = test_cursor,
+			.label = UTL_CSTRTOSTR("cursor")
+		},
+		(test_t) {
+			.func = test_block_changes,
+			.label = UTL_CSTRTOSTR("block changes")
+		},
+		(test_t) {
+			.func = test_send_queue,
+			.label = UTL_CSTRTOSTR("send queue")
+		},
+		(test_t) {
+			.func = test_broadcasts,
+			.label = UTL_CSTRTOSTR("broadcasts")
+		},
+		(test_t) {
+			.func = test_chunk_buffers,
+			.label = UTL_CSTRTOSTR("chunk buffers")
+		},
+		(test_t) {
+			.func = test_section_encoding,
+			.label = UTL_CSTRTOSTR("section encoding")
+		},
+		(test_t) {
+			.func = test_chunk_packet_cache,
+			.label = UTL_CSTRTOSTR("chunk packet cache")
+		},
+		(test_t) {
+			.func = test_edit,
+			.label = UTL_CSTRTOSTR("edit")
+		},
+		(test_t) {
+			.func = test_scheduler,
+			.label = UTL_CSTRTOSTR("scheduler")
+		},
+		(test_t) {
+			.func = test_entity_store,
+			.label = UTL_CSTRTOSTR("entity store")
+		},
+		(test_t) {
+			.func = test_entity_grid,
+			.label = UTL_CSTRTOSTR("entity grid")
+		},
+		(test_t) {
+			.func = test_entity_moves,
+			.label = UTL_CSTRTOSTR("entity moves")
+		},
+		(test_t) {
+			.func = test_collision,
+			.label = UTL_CSTRTOSTR("collision")
+		},
+		(test_t) {
+			.func = test_jobs,
+			.label = UTL_CSTRTOSTR("jobs")
 		}
 	};
 
@@ -3,6 +3,27 @@
 
 extern bool test_materials();
 extern bool test_packets();
+extern bool test_packet_framing();
 extern bool test_worlds();
+extern bool test_hash_map();
+extern bool test_deque();
+extern bool test_block_storage();
+extern bool test_region_files();
+extern bool test_chunk_loading();
+extern bool test_save_snapshots();
+extern bool test_cursor();
+extern bool test_block_changes();
+extern bool test_send_queue();
+extern bool test_broadcasts();
+extern bool test_chunk_buffers();
+extern bool test_section_encoding();
+extern bool test_chunk_packet_cache();
+extern bool test_edit();
+extern bool test_scheduler();
+extern bool test_entity_store();
+extern bool test_entity_grid();
+extern bool test_entity_moves();
+extern bool test_collision();
+extern bool test_jobs();
 
 extern int test_run_all();
\ No newline at end of file
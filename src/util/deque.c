@@ -0,0 +1,126 @@
+#include <stdlib.h>
+#include "deque.h"
+
+static utl_deque_buffer_t* utl_create_deque_buffer(int64_t capacity) {
+
+	utl_deque_buffer_t* buffer = malloc(sizeof(utl_deque_buffer_t) + sizeof(uint32_t) * capacity);
+
+	buffer->previous = NULL;
+	buffer->capacity = capacity;
+
+	return buffer;
+
+}
+
+static inline uint32_t utl_deque_buffer_get(const utl_deque_buffer_t* buffer, int64_t i) {
+	return atomic_load_explicit(&buffer->values[i & (buffer->capacity - 1)], memory_order_relaxed);
+}
+
+static inline void utl_deque_buffer_set(utl_deque_buffer_t* buffer, int64_t i, uint32_t value) {
+	atomic_store_explicit(&buffer->values[i & (buffer->capacity - 1)], value, memory_order_relaxed);
+}
+
+// copies the values between top and bottom into a buffer twice as big
+static utl_deque_buffer_t* utl_deque_grow(utl_deque_t* deque, utl_deque_buffer_t* buffer, int64_t top, int64_t bottom) {
+
+	utl_deque_buffer_t* copy = utl_create_deque_buffer(buffer == NULL ? UTL_DEQUE_MIN_CAPACITY : buffer->capacity << 1);
+
+	for (int64_t i = top; i < bottom; ++i) {
+		utl_deque_buffer_set(copy, i, utl_deque_buffer_get(buffer, i));
+	}
+
+	copy->previous = buffer;
+	atomic_store_explicit(&deque->buffer, copy, memory_order_release);
+
+	return copy;
+
+}
+
+void utl_deque_push(utl_deque_t* deque, uint32_t value) {
+
+	const int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+	const int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+	utl_deque_buffer_t* buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+
+	if (buffer == NULL || bottom - top > buffer->capacity - 1) {
+		buffer = utl_deque_grow(deque, buffer, top, bottom);
+	}
+
+	utl_deque_buffer_set(buffer, bottom, value);
+
+	// the value is written before thieves can see it
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+
+}
+
+bool utl_deque_pop(utl_deque_t* deque, uint32_t* value) {
+
+	const int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+	utl_deque_buffer_t* buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+
+	// claim the bottom before looking at the top, thieves do it the other way around
+	atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+
+	int64_t top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+	if (top > bottom) {
+		atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+		return false;
+	}
+
+	*value = utl_deque_buffer_get(buffer, bottom);
+
+	if (top == bottom) {
+
+		// the last value, a thief could be taking it too
+		const bool won = atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed);
+		atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+
+		return won;
+
+	}
+
+	return true;
+
+}
+
+bool utl_deque_steal(utl_deque_t* deque, uint32_t* value) {
+
+	int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	const int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+
+	if (top >= bottom) {
+		return false;
+	}
+
+	const utl_deque_buffer_t* buffer = atomic_load_explicit(&deque->buffer, memory_order_consume);
+	const uint32_t stolen = utl_deque_buffer_get(buffer, top);
+
+	if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+		return false;
+	}
+
+	*value = stolen;
+
+	return true;
+
+}
+
+void utl_term_deque(utl_deque_t* deque) {
+
+	utl_deque_buffer_t* buffer = deque->buffer;
+
+	while (buffer != NULL) {
+		utl_deque_buffer_t* previous = buffer->previous;
+		free(buffer);
+		buffer = previous;
+	}
+
+	deque->buffer = NULL;
+	deque->top = 0;
+	deque->bottom = 0;
+
+}
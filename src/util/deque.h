@@ -0,0 +1,50 @@
+#pragma once
+#include "../main.h"
+
+#define UTL_DEQUE_MIN_CAPACITY 64
+
+typedef struct utl_deque_buffer utl_deque_buffer_t;
+
+struct utl_deque_buffer {
+
+	// the buffer this one replaced, thieves could still be reading it
+	utl_deque_buffer_t* previous;
+
+	int64_t capacity;
+	_Atomic uint32_t values[];
+
+};
+
+/*
+ * Chase-Lev work stealing deque of 32 bit values
+ *
+ * Only the thread that owns it pushes and pops, at the bottom, any thread can steal from the top, nothing locks,
+ * the buffer is replaced by one twice as big when it's full, old buffers are kept until the deque is freed
+ */
+typedef struct {
+
+	_Atomic int64_t top;
+	_Atomic int64_t bottom;
+
+	utl_deque_buffer_t* _Atomic buffer;
+
+} utl_deque_t;
+
+#define UTL_DEQUE_INITIALIZER { .top = 0, .bottom = 0, .buffer = NULL }
+
+// owner only
+extern void utl_deque_push(utl_deque_t* deque, uint32_t value);
+
+// owner only, takes the value pushed last, returns false when empty
+extern bool utl_deque_pop(utl_deque_t* deque, uint32_t* value);
+
+// takes the value pushed first, returns false when empty or when another thread took it first
+extern bool utl_deque_steal(utl_deque_t* deque, uint32_t* value);
+
+// only a guess when other threads are using the deque
+static inline int64_t utl_deque_length(const utl_deque_t* deque) {
+	const int64_t length = deque->bottom - deque->top;
+	return length > 0 ? length : 0;
+}
+
+extern void utl_term_deque(utl_deque_t* deque);
@@ -0,0 +1,196 @@
+#include <stdlib.h>
+#include "hash_map.h"
+
+static utl_hash_map_table_t* utl_create_hash_map_table(uint32_t capacity) {
+
+	utl_hash_map_table_t* table = malloc(sizeof(utl_hash_map_table_t) + sizeof(utl_hash_map_slot_t) * capacity);
+
+	table->previous = NULL;
+	table->capacity = capacity;
+
+	for (uint32_t i = 0; i < capacity; ++i) {
+		table->slots[i].key = UTL_HASH_MAP_EMPTY;
+		table->slots[i].value = NULL;
+	}
+
+	return table;
+
+}
+
+// puts the key in a table that nothing reads yet
+static inline void utl_hash_map_table_put(utl_hash_map_table_t* table, uint32_t key, void* value) {
+
+	const uint32_t mask = table->capacity - 1;
+
+	uint32_t i = utl_hash_map_hash(key) & mask;
+	while (table->slots[i].key != UTL_HASH_MAP_EMPTY) {
+		i = (i + 1) & mask;
+	}
+
+	table->slots[i].value = value;
+	table->slots[i].key = key;
+
+}
+
+// copies the map into a table at most a quarter full, leaving removed slots behind
+static void utl_hash_map_grow(utl_hash_map_t* map) {
+
+	utl_hash_map_table_t* table = map->table;
+
+	uint32_t capacity = UTL_HASH_MAP_MIN_CAPACITY;
+	while (capacity < (map->length + 1) * 4) {
+		capacity <<= 1;
+	}
+
+	utl_hash_map_table_t* copy = utl_create_hash_map_table(capacity);
+
+	if (table != NULL) {
+		for (uint32_t i = 0; i < table->capacity; ++i) {
+			const uint64_t key = table->slots[i].key;
+			if (key != UTL_HASH_MAP_EMPTY && key != UTL_HASH_MAP_REMOVED) {
+				utl_hash_map_table_put(copy, key, table->slots[i].value);
+			}
+		}
+	}
+
+	copy->previous = table;
+	map->table = copy;
+	map->used = map->length;
+
+}
+
+void utl_hash_map_reclaim(utl_hash_map_t* map) {
+
+	utl_hash_map_table_t* table = map->table;
+
+	// checked after the table was replaced, lookups starting after this read the new one
+	if (table == NULL || table->previous == NULL || map->readers != 0) {
+		return;
+	}
+
+	utl_hash_map_table_t* previous = table->previous;
+	table->previous = NULL;
+
+	while (previous != NULL) {
+		utl_hash_map_table_t* next = previous->previous;
+		free(previous);
+		previous = next;
+	}
+
+}
+
+void utl_hash_map_put(utl_hash_map_t* map, uint32_t key, void* value) {
+
+	// kept at most half full, so lookups stay short
+	if (map->table == NULL || (map->used + 1) * 2 > map->table->capacity) {
+		utl_hash_map_grow(map);
+	}
+
+	utl_hash_map_table_t* table = map->table;
+	const uint32_t mask = table->capacity - 1;
+
+	uint32_t i = utl_hash_map_hash(key) & mask;
+	uint32_t free_slot = table->capacity;
+
+	for (;; i = (i + 1) & mask) {
+
+		const uint64_t slot_key = table->slots[i].key;
+
+		if (slot_key == key) {
+			table->slots[i].value = value;
+			utl_hash_map_reclaim(map);
+			return;
+		}
+
+		if (slot_key == UTL_HASH_MAP_REMOVED && free_slot == table->capacity) {
+			free_slot = i;
+		}
+
+		if (slot_key == UTL_HASH_MAP_EMPTY) {
+			break;
+		}
+
+	}
+
+	// removed slots are used again, the key isn't in the map so nothing is looking for it there
+	if (free_slot == table->capacity) {
+		free_slot = i;
+		map->used++;
+	}
+
+	// the value is set before the key, so a lookup that finds the key finds the value
+	table->slots[free_slot].value = value;
+	table->slots[free_slot].key = key;
+
+	map->length++;
+
+	utl_hash_map_reclaim(map);
+
+}
+
+void* utl_hash_map_remove(utl_hash_map_t* map, uint32_t key) {
+
+	utl_hash_map_table_t* table = map->table;
+
+	if (table == NULL) {
+		return NULL;
+	}
+
+	const uint32_t mask = table->capacity - 1;
+
+	for (uint32_t i = utl_hash_map_hash(key) & mask;; i = (i + 1) & mask) {
+
+		const uint64_t slot_key = table->slots[i].key;
+
+		if (slot_key == key) {
+			void* value = table->slots[i].value;
+			table->slots[i].key = UTL_HASH_MAP_REMOVED;
+			table->slots[i].value = NULL;
+			map->length--;
+			utl_hash_map_reclaim(map);
+			return value;
+		}
+
+		if (slot_key == UTL_HASH_MAP_EMPTY) {
+			return NULL;
+		}
+
+	}
+
+}
+
+uint32_t utl_hash_map_values(const utl_hash_map_t* map, void** values) {
+
+	const utl_hash_map_table_t* table = map->table;
+	uint32_t count = 0;
+
+	if (table == NULL) {
+		return 0;
+	}
+
+	for (uint32_t i = 0; i < table->capacity; ++i) {
+		const uint64_t key = table->slots[i].key;
+		if (key != UTL_HASH_MAP_EMPTY && key != UTL_HASH_MAP_REMOVED) {
+			values[count++] = table->slots[i].value;
+		}
+	}
+
+	return count;
+
+}
+
+void utl_term_hash_map(utl_hash_map_t* map) {
+
+	utl_hash_map_table_t* table = map->table;
+
+	while (table != NULL) {
+		utl_hash_map_table_t* previous = table->previous;
+		free(table);
+		table = previous;
+	}
+
+	map->table = NULL;
+	map->used = 0;
+	map->length = 0;
+
+}
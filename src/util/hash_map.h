@@ -0,0 +1,122 @@
+#pragma once
+#include "../main.h"
+
+#define UTL_HASH_MAP_EMPTY 0xFFFFFFFFFFFFFFFF // slot that was never used, ends a lookup
+#define UTL_HASH_MAP_REMOVED 0xFFFFFFFFFFFFFFFE // slot that was used, lookups go past it
+#define UTL_HASH_MAP_MIN_CAPACITY 16
+
+typedef struct {
+
+	_Atomic uint64_t key;
+	void* _Atomic value;
+
+} utl_hash_map_slot_t;
+
+typedef struct utl_hash_map_table utl_hash_map_table_t;
+
+struct utl_hash_map_table {
+
+	// the table this one replaced, kept until no lookups are running
+	utl_hash_map_table_t* previous;
+
+	uint32_t capacity;
+	utl_hash_map_slot_t slots[];
+
+};
+
+/*
+ * Open addressing hash map from 32 bit keys to pointers
+ *
+ * Lookups don't lock and never wait, changes must be made by one thread at a time (under a lock)
+ * the table is copied into a new one when it gets too full, lookups are counted while they run so the old table
+ * is freed by the first change (or utl_hash_map_reclaim) that happens while none are running
+ */
+typedef struct {
+
+	utl_hash_map_table_t* _Atomic table;
+
+	// lookups running now
+	_Atomic uint32_t readers;
+
+	// used slots, including removed ones
+	uint32_t used;
+	uint32_t length;
+
+} utl_hash_map_t;
+
+#define UTL_HASH_MAP_INITIALIZER { .table = NULL, .readers = 0, .used = 0, .length = 0 }
+
+static inline uint32_t utl_hash_map_hash(uint32_t key) {
+
+	// murmur3 finalizer
+	key ^= key >> 16;
+	key *= 0x85ebca6b;
+	key ^= key >> 13;
+	key *= 0xc2b2ae35;
+	key ^= key >> 16;
+
+	return key;
+
+}
+
+static inline void* utl_hash_map_table_get(const utl_hash_map_table_t* table, uint32_t key) {
+
+	if (table == NULL) {
+		return NULL;
+	}
+
+	const uint32_t mask = table->capacity - 1;
+
+	for (uint32_t i = utl_hash_map_hash(key) & mask;; i = (i + 1) & mask) {
+
+		const uint64_t slot_key = table->slots[i].key;
+
+		if (slot_key == key) {
+
+			void* value = table->slots[i].value;
+
+			// the key could have been removed and its slot used by another one while the value was read
+			if (table->slots[i].key == key) {
+				return value;
+			}
+
+			i = (utl_hash_map_hash(key) - 1) & mask;
+			continue;
+
+		}
+
+		if (slot_key == UTL_HASH_MAP_EMPTY) {
+			return NULL;
+		}
+
+	}
+
+}
+
+static inline void* utl_hash_map_get(utl_hash_map_t* map, uint32_t key) {
+
+	// counted before the table is read, so a table replaced after this isn't freed until the lookup is done
+	map->readers++;
+
+	void* value = utl_hash_map_table_get(map->table, key);
+
+	map->readers--;
+
+	return value;
+
+}
+
+extern void utl_hash_map_put(utl_hash_map_t* map, uint32_t key, void* value);
+extern void* utl_hash_map_remove(utl_hash_map_t* map, uint32_t key);
+
+static inline uint32_t utl_hash_map_length(const utl_hash_map_t* map) {
+	return map->length;
+}
+
+// copies the values into the array given, which should fit the length of the map, returns how many there were
+extern uint32_t utl_hash_map_values(const utl_hash_map_t* map, void** values);
+
+// frees the tables the map replaced if no lookups are running, like a change does, the map should be locked
+extern void utl_hash_map_reclaim(utl_hash_map_t* map);
+
+extern void utl_term_hash_map(utl_hash_map_t* map);
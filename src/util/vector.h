@@ -78,6 +78,20 @@ static inline void* utl_vector_push(utl_vector_t* vector, const void* element) {
 
 }
 
+static inline void* utl_vector_push_many(utl_vector_t* vector, const void* elements, uint32_t count) {
+
+	if (vector->size + count > vector->capacity) {
+		utl_vector_resize(vector, (vector->size * 2 > vector->size + count ? vector->size * 2 : vector->size + count));
+	}
+
+	void* ptr = vector->array + (vector->bytes_per_element * vector->size);
+	memcpy(ptr, elements, (size_t) vector->bytes_per_element * count);
+	vector->size += count;
+
+	return ptr;
+
+}
+
 static inline void* utl_vector_get(const utl_vector_t* vector, uint32_t idx) {
 	
 	if (vector == NULL) return NULL;
@@ -105,6 +119,20 @@ static inline void utl_vector_shift(utl_vector_t* vector) {
 
 }
 
+static inline void utl_vector_shift_many(utl_vector_t* vector, uint32_t count) {
+
+	if (vector == NULL) return;
+
+	if (count >= vector->size) {
+		vector->size = 0;
+		return;
+	}
+
+	vector->size -= count;
+	memmove(vector->array, vector->array + (vector->bytes_per_element * count), (size_t) vector->bytes_per_element * vector->size);
+
+}
+
 static inline void utl_vector_set(utl_vector_t* vector, uint32_t idx, const void* value) {
 
 	memcpy(vector->array + (vector->bytes_per_element * idx), value, vector->bytes_per_element);
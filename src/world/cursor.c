@@ -0,0 +1,33 @@
+#include "cursor.h"
+
+void wld_cursor_foreach_in_box(wld_cursor_t* cursor, int32_t x1, int16_t y1, int32_t z1, int32_t x2, int16_t y2, int32_t z2, void (*const function) (wld_cursor_t*, void*), void* args) {
+
+	const int32_t min_x = UTL_MIN(x1, x2);
+	const int32_t max_x = UTL_MAX(x1, x2);
+	const int16_t min_y = UTL_MIN(y1, y2);
+	const int16_t max_y = UTL_MAX(y1, y2);
+	const int32_t min_z = UTL_MIN(z1, z2);
+	const int32_t max_z = UTL_MAX(z1, z2);
+
+	for (int32_t c_x = min_x >> 4; c_x <= max_x >> 4; ++c_x) {
+		for (int32_t c_z = min_z >> 4; c_z <= max_z >> 4; ++c_z) {
+
+			// the part of the box in this chunk
+			const int32_t from_x = UTL_MAX(min_x, c_x << 4);
+			const int32_t to_x = UTL_MIN(max_x, (c_x << 4) | 0xF);
+			const int32_t from_z = UTL_MAX(min_z, c_z << 4);
+			const int32_t to_z = UTL_MIN(max_z, (c_z << 4) | 0xF);
+
+			for (int16_t y = min_y; y <= max_y; ++y) {
+				for (int32_t z = from_z; z <= to_z; ++z) {
+					for (int32_t x = from_x; x <= to_x; ++x) {
+						wld_cursor_move_to(cursor, x, y, z);
+						function(cursor, args);
+					}
+				}
+			}
+
+		}
+	}
+
+}
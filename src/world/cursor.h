@@ -0,0 +1,133 @@
+#pragma once
+#include "../main.h"
+#include "world.d.h"
+#include "world.h"
+
+/*
+ * A position in a world that remembers its chunk and section, for reading and writing many blocks close together
+ *
+ * Moving only looks up the chunk again when it leaves the chunk, and the section when it leaves the section,
+ * cursors belong to the thread using them and shouldn't be shared
+ */
+struct wld_cursor {
+
+	wld_chunk_t* chunk;
+
+	// NULL above and below the world
+	wld_chunk_section_t* section;
+
+	int32_t x;
+	int32_t z;
+	int16_t y;
+
+	int16_t min_y;
+	uint16_t section_index;
+	uint16_t chunk_height;
+
+};
+
+static inline void wld_cursor_find_section(wld_cursor_t* cursor) {
+
+	const int16_t index = (cursor->y - cursor->min_y) >> 4;
+
+	if (index < 0 || index >= cursor->chunk_height) {
+		cursor->section = NULL;
+		return;
+	}
+
+	cursor->section_index = index;
+	cursor->section = wld_chunk_get_section(cursor->chunk, index);
+
+}
+
+// creates a cursor at the position, the chunk can be any loaded chunk in the same world
+static inline wld_cursor_t wld_cursor_at(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z) {
+
+	const mat_dimension_type_t environment = wld_get_environment(wld_chunk_get_world(chunk));
+
+	wld_cursor_t cursor = {
+		.chunk = wld_relative_chunk(chunk, (x >> 4) - wld_get_chunk_x(chunk), (z >> 4) - wld_get_chunk_z(chunk)),
+		.x = x,
+		.y = y,
+		.z = z,
+		.min_y = mat_get_dimension_by_type(environment)->min_y,
+		.chunk_height = mat_get_chunk_height(environment)
+	};
+
+	wld_cursor_find_section(&cursor);
+
+	return cursor;
+
+}
+
+static inline void wld_cursor_move_to(wld_cursor_t* cursor, int32_t x, int16_t y, int32_t z) {
+
+	const bool chunk_changed = (x >> 4) != (cursor->x >> 4) || (z >> 4) != (cursor->z >> 4);
+	const bool section_changed = (y >> 4) != (cursor->y >> 4);
+
+	if (chunk_changed) {
+		cursor->chunk = wld_relative_chunk(cursor->chunk, (x >> 4) - (cursor->x >> 4), (z >> 4) - (cursor->z >> 4));
+	}
+
+	cursor->x = x;
+	cursor->y = y;
+	cursor->z = z;
+
+	if (chunk_changed || section_changed) {
+		wld_cursor_find_section(cursor);
+	}
+
+}
+
+static inline void wld_cursor_move(wld_cursor_t* cursor, int32_t d_x, int16_t d_y, int32_t d_z) {
+	wld_cursor_move_to(cursor, cursor->x + d_x, cursor->y + d_y, cursor->z + d_z);
+}
+
+static inline wld_chunk_t* wld_cursor_get_chunk(const wld_cursor_t* cursor) {
+	return cursor->chunk;
+}
+
+static inline uint16_t wld_cursor_get_section_index(const wld_cursor_t* cursor) {
+	return ((cursor->y & 0xF) << 8) | ((cursor->z & 0xF) << 4) | (cursor->x & 0xF);
+}
+
+// gets the block, air above and below the world
+static inline mat_block_protocol_id_t wld_cursor_get(wld_cursor_t* cursor) {
+
+	if (cursor->section == NULL) {
+		return mat_get_block_default_protocol_id_by_type(mat_block_air);
+	}
+
+	// another thread could have put something in the section since it was found
+	if (wld_chunk_section_is_empty(cursor->section)) {
+		cursor->section = wld_chunk_get_section(cursor->chunk, cursor->section_index);
+	}
+
+	return wld_block_storage_get(cursor->section->blocks, wld_cursor_get_section_index(cursor));
+
+}
+
+static inline mat_block_type_t wld_cursor_get_type(wld_cursor_t* cursor) {
+	return mat_get_block_type_by_protocol_id(wld_cursor_get(cursor));
+}
+
+// sets the block, blocks above and below the world are ignored
+static inline void wld_cursor_set(wld_cursor_t* cursor, mat_block_protocol_id_t block) {
+
+	if (cursor->section == NULL) {
+		return;
+	}
+
+	cursor->section = wld_chunk_set_block(cursor->chunk, cursor->section_index, cursor->x, cursor->y, cursor->z, block);
+
+}
+
+static inline void wld_cursor_set_type(wld_cursor_t* cursor, mat_block_type_t type) {
+	wld_cursor_set(cursor, mat_get_block_default_protocol_id_by_type(type));
+}
+
+/*
+ * Moves the cursor over every block in the box (corners included) and calls the function at each one
+ * a chunk column at a time, then y, z and x, so chunks and sections are only looked up once
+ */
+extern void wld_cursor_foreach_in_box(wld_cursor_t* cursor, int32_t x1, int16_t y1, int32_t z1, int32_t x2, int16_t y2, int32_t z2, void (*const function) (wld_cursor_t*, void*), void* args);
@@ -0,0 +1,371 @@
+#include <stdlib.h>
+#include "edit.h"
+#include "../motor.h"
+#include "../jobs/board.h"
+
+static inline bool wld_edit_is_air(mat_block_protocol_id_t block) {
+	return mat_get_block_by_type(mat_get_block_type_by_protocol_id(block))->air;
+}
+
+// the sections of every chunk in the box are listed, chunks are loaded if they aren't already and pinned until the edit is released
+static wld_edit_t* wld_create_edit(wld_world_t* world, wld_edit_type_t type, int32_t x1, int16_t y1, int32_t z1, int32_t x2, int16_t y2, int32_t z2) {
+
+	const mat_dimension_type_t environment = wld_get_environment(world);
+	const int16_t world_min_y = mat_get_dimension_by_type(environment)->min_y;
+	const int16_t world_max_y = world_min_y + (mat_get_chunk_height(environment) << 4) - 1;
+
+	wld_edit_t* edit = calloc(1, sizeof(wld_edit_t));
+
+	edit->type = type;
+	edit->world_min_y = world_min_y;
+	edit->min.x = UTL_MIN(x1, x2);
+	edit->min.y = UTL_MAX(UTL_MIN(y1, y2), world_min_y);
+	edit->min.z = UTL_MIN(z1, z2);
+	edit->max.x = UTL_MAX(x1, x2);
+	edit->max.y = UTL_MIN(UTL_MAX(y1, y2), world_max_y);
+	edit->max.z = UTL_MAX(z1, z2);
+	edit->origin.x = edit->min.x;
+	edit->origin.y = UTL_MIN(y1, y2);
+	edit->origin.z = edit->min.z;
+
+	pthread_mutex_init(&edit->lock, NULL);
+	pthread_cond_init(&edit->finished, NULL);
+
+	// nothing is left in the world
+	if (edit->min.y > edit->max.y) {
+		return edit;
+	}
+
+	const uint16_t min_section = (edit->min.y - world_min_y) >> 4;
+	const uint16_t max_section = (edit->max.y - world_min_y) >> 4;
+
+	edit->sections = malloc(sizeof(wld_edit_section_t) * ((edit->max.x >> 4) - (edit->min.x >> 4) + 1) * ((edit->max.z >> 4) - (edit->min.z >> 4) + 1) * (max_section - min_section + 1));
+
+	for (int32_t c_x = edit->min.x >> 4; c_x <= edit->max.x >> 4; ++c_x) {
+		for (int32_t c_z = edit->min.z >> 4; c_z <= edit->max.z >> 4; ++c_z) {
+			wld_chunk_t* chunk = wld_pin_chunk(world, c_x, c_z);
+			for (uint16_t i = min_section; i <= max_section; ++i) {
+				edit->sections[edit->section_count++] = (wld_edit_section_t) {
+					.chunk = chunk,
+					.index = i
+				};
+			}
+		}
+	}
+
+	return edit;
+
+}
+
+void wld_release_edit(wld_edit_t* edit) {
+
+	if (--edit->references != 0) {
+		return;
+	}
+
+	// a chunk's sections are next to each other, so each chunk is unpinned once
+	for (uint32_t i = 0; i < edit->section_count; ++i) {
+		if (i == 0 || edit->sections[i].chunk != edit->sections[i - 1].chunk) {
+			wld_unpin_chunk(edit->sections[i].chunk);
+		}
+	}
+
+	pthread_mutex_destroy(&edit->lock);
+	pthread_cond_destroy(&edit->finished);
+	free(edit->sections);
+	free(edit);
+
+}
+
+static void wld_copy_section(wld_edit_t* edit, const wld_edit_section_t* edit_section, int32_t from_x, int16_t from_y, int32_t from_z, int32_t to_x, int16_t to_y, int32_t to_z) {
+
+	wld_chunk_section_t* section = wld_chunk_get_section(edit_section->chunk, edit_section->index);
+
+	for (int16_t y = from_y; y <= to_y; ++y) {
+		for (int32_t z = from_z; z <= to_z; ++z) {
+			for (int32_t x = from_x; x <= to_x; ++x) {
+				const mat_block_protocol_id_t block = wld_block_storage_get(section->blocks, ((y & 0xF) << 8) | ((z & 0xF) << 4) | (x & 0xF));
+				wld_clipboard_set(edit->clipboard, x - edit->origin.x, y - edit->origin.y, z - edit->origin.z, block);
+			}
+		}
+	}
+
+}
+
+static void wld_edit_section(wld_edit_t* edit, const wld_edit_section_t* edit_section) {
+
+	wld_chunk_t* chunk = edit_section->chunk;
+
+	// the part of the box in the section
+	const int32_t chunk_x = wld_get_chunk_x(chunk) << 4;
+	const int32_t chunk_z = wld_get_chunk_z(chunk) << 4;
+	const int16_t section_y = edit->world_min_y + (edit_section->index << 4);
+
+	const int32_t from_x = UTL_MAX(edit->min.x, chunk_x);
+	const int32_t to_x = UTL_MIN(edit->max.x, chunk_x + 15);
+	const int16_t from_y = UTL_MAX(edit->min.y, section_y);
+	const int16_t to_y = UTL_MIN(edit->max.y, section_y + 15);
+	const int32_t from_z = UTL_MAX(edit->min.z, chunk_z);
+	const int32_t to_z = UTL_MIN(edit->max.z, chunk_z + 15);
+
+	if (edit->type == wld_edit_copy) {
+		wld_copy_section(edit, edit_section, from_x, from_y, from_z, to_x, to_y, to_z);
+		return;
+	}
+
+	// air put in an empty section changes nothing, so it is only created for other blocks
+	const bool create = edit->type == wld_edit_paste || !wld_edit_is_air(edit->block);
+	wld_chunk_section_t* section = wld_chunk_edit_section(chunk, edit_section->index, create);
+
+	if (section == NULL) {
+		return;
+	}
+
+	wld_section_changes_t changes = { .count = 0 };
+	memset(changes.blocks, 0, sizeof(changes.blocks));
+
+	int32_t block_count = 0;
+
+	const uint8_t* shapes = mat_get_shape_table();
+
+	// the highest block and motion blocking block put in every column
+	int16_t highest[16 * 16];
+	int16_t highest_motion_blocking[16 * 16];
+	for (uint16_t i = 0; i < 16 * 16; ++i) {
+		highest[i] = INT16_MIN;
+		highest_motion_blocking[i] = INT16_MIN;
+	}
+
+	for (int16_t y = from_y; y <= to_y; ++y) {
+		for (int32_t z = from_z; z <= to_z; ++z) {
+			for (int32_t x = from_x; x <= to_x; ++x) {
+
+				const uint16_t index = ((y & 0xF) << 8) | ((z & 0xF) << 4) | (x & 0xF);
+
+				mat_block_protocol_id_t block = edit->block;
+				switch (edit->type) {
+					case wld_edit_replace: {
+						if (!edit->predicate(wld_block_storage_get(section->blocks, index), edit->args)) {
+							continue;
+						}
+					} break;
+					case wld_edit_paste: {
+						block = wld_clipboard_get(edit->clipboard, x - edit->origin.x, y - edit->origin.y, z - edit->origin.z);
+					} break;
+					default: break;
+				}
+
+				const mat_block_protocol_id_t old_block = wld_block_storage_set(&section->blocks, index, block);
+
+				if (old_block == block) {
+					continue;
+				}
+
+				changes.blocks[index >> 6] |= (uint64_t) 1 << (index & 63);
+				changes.count++;
+
+				const bool air = wld_edit_is_air(block);
+				const bool old_air = wld_edit_is_air(old_block);
+				if (old_air && !air) {
+					block_count++;
+				} else if (!old_air && air) {
+					block_count--;
+				}
+
+				if (!air && y > highest[index & 0xFF]) {
+					highest[index & 0xFF] = y;
+				}
+				if (y > highest_motion_blocking[index & 0xFF] && wld_is_motion_blocking(shapes, block)) {
+					highest_motion_blocking[index & 0xFF] = y;
+				}
+
+			}
+		}
+	}
+
+	if (changes.count == 0) {
+		return;
+	}
+
+	section->block_count += block_count;
+
+	// other sections of the chunk could be raising the same columns
+	for (uint16_t i = 0; i < 16 * 16; ++i) {
+		int16_t current = chunk->highest.world_surface[i];
+		while (current < highest[i] && !atomic_compare_exchange_weak(&chunk->highest.world_surface[i], &current, highest[i]));
+		current = chunk->highest.motion_blocking[i];
+		while (current < highest_motion_blocking[i] && !atomic_compare_exchange_weak(&chunk->highest.motion_blocking[i], &current, highest_motion_blocking[i]));
+	}
+
+	wld_chunk_section_edited(chunk, section, &changes);
+
+	edit->changed += changes.count;
+
+}
+
+void wld_work_edit(wld_edit_t* edit) {
+
+	for (;;) {
+
+		const uint32_t i = edit->next++;
+
+		if (i >= edit->section_count) {
+			return;
+		}
+
+		wld_edit_section(edit, &edit->sections[i]);
+
+		if (++edit->done == edit->section_count) {
+			with_lock (&edit->lock) {
+				pthread_cond_broadcast(&edit->finished);
+			}
+		}
+
+	}
+
+}
+
+// whether the block raises the heightmap, the motion blocking one or the world surface
+static inline bool wld_edit_raises(const uint8_t* shapes, bool motion_blocking, mat_block_protocol_id_t block) {
+	return motion_blocking ? wld_is_motion_blocking(shapes, block) : !wld_edit_is_air(block);
+}
+
+// lowers the heightmap in the column to the next block down that raises it, if its highest block is in the edit and no longer does
+static inline void wld_edit_lower_column(wld_edit_t* edit, wld_chunk_t* chunk, _Atomic int16_t* highest, int32_t x, int32_t z, const uint8_t* shapes, bool motion_blocking) {
+
+	int16_t y = *highest;
+
+	if (y < edit->min.y || y > edit->max.y || wld_edit_raises(shapes, motion_blocking, wld_get_block_at(chunk, x, y, z))) {
+		return;
+	}
+
+	while (y > edit->world_min_y && !wld_edit_raises(shapes, motion_blocking, wld_get_block_at(chunk, x, y, z))) {
+		y--;
+	}
+	*highest = y;
+
+}
+
+// columns whose highest block was removed are lowered to the next block down, once every section is done
+static void wld_edit_lower_highest(wld_edit_t* edit) {
+
+	const uint8_t* shapes = mat_get_shape_table();
+	wld_chunk_t* chunk = NULL;
+
+	for (uint32_t i = 0; i < edit->section_count; ++i) {
+
+		if (edit->sections[i].chunk == chunk) {
+			continue;
+		}
+		chunk = edit->sections[i].chunk;
+
+		const int32_t chunk_x = wld_get_chunk_x(chunk) << 4;
+		const int32_t chunk_z = wld_get_chunk_z(chunk) << 4;
+
+		for (int32_t z = UTL_MAX(edit->min.z, chunk_z); z <= UTL_MIN(edit->max.z, chunk_z + 15); ++z) {
+			for (int32_t x = UTL_MAX(edit->min.x, chunk_x); x <= UTL_MIN(edit->max.x, chunk_x + 15); ++x) {
+
+				const uint16_t column = ((z & 0xF) << 4) | (x & 0xF);
+				wld_edit_lower_column(edit, chunk, &chunk->highest.world_surface[column], x, z, shapes, false);
+				wld_edit_lower_column(edit, chunk, &chunk->highest.motion_blocking[column], x, z, shapes, true);
+
+			}
+		}
+
+	}
+
+}
+
+// edits the sections with the job workers, returns how many blocks changed
+static uint64_t wld_run_edit(wld_edit_t* edit) {
+
+	const uint32_t jobs = edit->section_count == 0 ? 0 : UTL_MIN(sky_get_worker_count(), edit->section_count - 1);
+
+	edit->references = jobs + 1;
+
+	for (uint32_t i = 0; i < jobs; ++i) {
+		job_add(job_new(job_edit_world, (job_payload_t) { .edit = edit }));
+	}
+
+	// the sections no worker took yet are edited here, so edits started by a worker can't wait for themselves
+	wld_work_edit(edit);
+
+	with_lock (&edit->lock) {
+		while (edit->done != edit->section_count) {
+			pthread_cond_wait(&edit->finished, &edit->lock);
+		}
+	}
+
+	if (edit->type != wld_edit_copy) {
+		wld_edit_lower_highest(edit);
+	}
+
+	const uint64_t changed = edit->changed;
+
+	wld_release_edit(edit);
+
+	return changed;
+
+}
+
+uint64_t wld_fill_blocks(wld_world_t* world, int32_t x1, int16_t y1, int32_t z1, int32_t x2, int16_t y2, int32_t z2, mat_block_protocol_id_t block) {
+
+	wld_edit_t* edit = wld_create_edit(world, wld_edit_fill, x1, y1, z1, x2, y2, z2);
+	edit->block = block;
+
+	return wld_run_edit(edit);
+
+}
+
+uint64_t wld_replace_blocks(wld_world_t* world, int32_t x1, int16_t y1, int32_t z1, int32_t x2, int16_t y2, int32_t z2, wld_edit_predicate_t predicate, void* args, mat_block_protocol_id_t block) {
+
+	wld_edit_t* edit = wld_create_edit(world, wld_edit_replace, x1, y1, z1, x2, y2, z2);
+	edit->block = block;
+	edit->predicate = predicate;
+	edit->args = args;
+
+	return wld_run_edit(edit);
+
+}
+
+wld_clipboard_t* wld_copy_blocks(wld_world_t* world, int32_t x1, int16_t y1, int32_t z1, int32_t x2, int16_t y2, int32_t z2) {
+
+	wld_edit_t* edit = wld_create_edit(world, wld_edit_copy, x1, y1, z1, x2, y2, z2);
+
+	if (edit->section_count == 0) {
+		wld_run_edit(edit);
+		return NULL;
+	}
+
+	// only what is inside the world is copied
+	edit->origin.y = edit->min.y;
+
+	const uint32_t width = edit->max.x - edit->min.x + 1;
+	const uint32_t length = edit->max.z - edit->min.z + 1;
+	const uint16_t height = edit->max.y - edit->min.y + 1;
+
+	wld_clipboard_t* clipboard = malloc(sizeof(wld_clipboard_t) + sizeof(mat_block_protocol_id_t) * width * length * height);
+	clipboard->width = width;
+	clipboard->length = length;
+	clipboard->height = height;
+
+	edit->clipboard = clipboard;
+
+	wld_run_edit(edit);
+
+	return clipboard;
+
+}
+
+uint64_t wld_paste_blocks(wld_world_t* world, const wld_clipboard_t* clipboard, int32_t x, int16_t y, int32_t z) {
+
+	wld_edit_t* edit = wld_create_edit(world, wld_edit_paste, x, y, z, x + clipboard->width - 1, y + clipboard->height - 1, z + clipboard->length - 1);
+	edit->clipboard = (wld_clipboard_t*) clipboard;
+
+	return wld_run_edit(edit);
+
+}
+
+void wld_free_clipboard(wld_clipboard_t* clipboard) {
+	free(clipboard);
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include <pthread.h>
+#include "../main.h"
+#include "world.d.h"
+#include "world.h"
+
+// blocks copied out of a world, x first, then z, then y
+struct wld_clipboard {
+
+	uint32_t width;
+	uint32_t length;
+	uint16_t height;
+
+	mat_block_protocol_id_t blocks[];
+
+};
+
+static inline mat_block_protocol_id_t wld_clipboard_get(const wld_clipboard_t* clipboard, uint32_t x, uint16_t y, uint32_t z) {
+	return clipboard->blocks[((size_t) y * clipboard->length + z) * clipboard->width + x];
+}
+
+static inline void wld_clipboard_set(wld_clipboard_t* clipboard, uint32_t x, uint16_t y, uint32_t z, mat_block_protocol_id_t block) {
+	clipboard->blocks[((size_t) y * clipboard->length + z) * clipboard->width + x] = block;
+}
+
+typedef enum {
+
+	wld_edit_fill,
+	wld_edit_replace,
+	wld_edit_copy,
+	wld_edit_paste
+
+} wld_edit_type_t;
+
+// true if the block should be replaced, called from the job workers
+typedef bool (*wld_edit_predicate_t) (mat_block_protocol_id_t block, void* args);
+
+typedef struct {
+
+	wld_chunk_t* chunk;
+	uint16_t index;
+
+} wld_edit_section_t;
+
+struct wld_edit {
+
+	wld_edit_type_t type;
+
+	// the part of the box inside the world, corners included
+	struct {
+
+		int32_t x;
+		int32_t z;
+		int16_t y;
+
+	} min, max;
+
+	// the position of the first block of the clipboard in the world
+	struct {
+
+		int32_t x;
+		int32_t z;
+		int16_t y;
+
+	} origin;
+
+	mat_block_protocol_id_t block;
+
+	wld_edit_predicate_t predicate;
+	void* args;
+
+	wld_clipboard_t* clipboard;
+
+	int16_t world_min_y;
+
+	// the sections in the box, a chunk's sections are next to each other
+	uint32_t section_count;
+	wld_edit_section_t* sections;
+
+	_Atomic uint32_t next;
+	_Atomic uint32_t done;
+
+	// blocks that were changed
+	_Atomic uint64_t changed;
+
+	// the thread that started the edit and the jobs helping it
+	_Atomic uint32_t references;
+
+	pthread_mutex_t lock;
+	pthread_cond_t finished;
+
+};
+
+/*
+ * Edits of many blocks at once, split into the sections they touch
+ *
+ * Sections are edited by the job workers and the thread that started the edit, which returns once they're all done,
+ * blocks are written straight to their section and every section's changes are sent together at the end of the tick
+ * the functions return how many blocks changed, boxes are clipped to the height of the world
+ */
+extern uint64_t wld_fill_blocks(wld_world_t* world, int32_t x1, int16_t y1, int32_t z1, int32_t x2, int16_t y2, int32_t z2, mat_block_protocol_id_t block);
+extern uint64_t wld_replace_blocks(wld_world_t* world, int32_t x1, int16_t y1, int32_t z1, int32_t x2, int16_t y2, int32_t z2, wld_edit_predicate_t predicate, void* args, mat_block_protocol_id_t block);
+
+// copies the box into a new clipboard, NULL if the box is outside the world
+extern wld_clipboard_t* wld_copy_blocks(wld_world_t* world, int32_t x1, int16_t y1, int32_t z1, int32_t x2, int16_t y2, int32_t z2);
+
+// pastes the clipboard with its first block at the position
+extern uint64_t wld_paste_blocks(wld_world_t* world, const wld_clipboard_t* clipboard, int32_t x, int16_t y, int32_t z);
+
+extern void wld_free_clipboard(wld_clipboard_t* clipboard);
+
+// edits sections of the edit until none are left, used by the job workers helping with it
+extern void wld_work_edit(wld_edit_t* edit);
+
+// the edit is freed once the thread that started it and every job are done with it
+extern void wld_release_edit(wld_edit_t* edit);
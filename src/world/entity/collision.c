@@ -0,0 +1,150 @@
+#include "collision.h"
+#include "../world.h"
+#include "../../util/util.h"
+
+// the axes other than the one moved along
+static const ent_axis_t ent_other_axes[3][2] = {
+	[ent_axis_x] = { ent_axis_y, ent_axis_z },
+	[ent_axis_y] = { ent_axis_x, ent_axis_z },
+	[ent_axis_z] = { ent_axis_x, ent_axis_y }
+};
+
+// shortens the motion along the axis so the box stops at the other one, if it is in the way
+static inline float64_t ent_clip(const ent_box_t* box, ent_axis_t axis, float64_t motion, const float64_t min[3], const float64_t max[3]) {
+
+	for (uint8_t i = 0; i < 2; ++i) {
+		const ent_axis_t other = ent_other_axes[axis][i];
+		if (box->max[other] <= min[other] + ENT_COLLISION_EPSILON || box->min[other] >= max[other] - ENT_COLLISION_EPSILON) {
+			return motion;
+		}
+	}
+
+	if (motion > 0 && box->max[axis] <= min[axis] + ENT_COLLISION_EPSILON) {
+		return UTL_MIN(motion, min[axis] - box->max[axis]);
+	} else if (motion < 0 && box->min[axis] >= max[axis] - ENT_COLLISION_EPSILON) {
+		return UTL_MAX(motion, max[axis] - box->min[axis]);
+	}
+
+	return motion;
+
+}
+
+// finds the chunk without creating it or its region, collisions shouldn't load the world around entities
+static inline wld_chunk_t* ent_find_chunk(wld_world_t* world, int32_t x, int32_t z) {
+
+	wld_region_t* region = utl_hash_map_get(&world->regions, wld_region_key(x >> 5, z >> 5));
+
+	if (region == NULL) {
+		return NULL;
+	}
+
+	return wld_region_get_chunk(region, x & 0x1F, z & 0x1F);
+
+}
+
+static float64_t ent_clip_axis(wld_world_t* world, const uint8_t* shapes, int16_t min_y, int16_t max_y, const ent_box_t* box, ent_axis_t axis, float64_t motion) {
+
+	// the blocks the box goes through, one lower for the blocks that stick out above
+	ent_box_t swept = *box;
+	swept.min[axis] += UTL_MIN(motion, 0);
+	swept.max[axis] += UTL_MAX(motion, 0);
+
+	const int32_t from_x = utl_int_floor(swept.min[ent_axis_x] + ENT_COLLISION_EPSILON);
+	const int32_t to_x = utl_int_ceil(swept.max[ent_axis_x] - ENT_COLLISION_EPSILON);
+	const int32_t from_z = utl_int_floor(swept.min[ent_axis_z] + ENT_COLLISION_EPSILON);
+	const int32_t to_z = utl_int_ceil(swept.max[ent_axis_z] - ENT_COLLISION_EPSILON);
+	const int32_t from_y = UTL_MAX(utl_int_floor(swept.min[ent_axis_y] + ENT_COLLISION_EPSILON) - 1, min_y);
+	const int32_t to_y = UTL_MIN(utl_int_ceil(swept.max[ent_axis_y] - ENT_COLLISION_EPSILON), max_y);
+
+	for (int32_t c_x = from_x >> 4; c_x <= (to_x - 1) >> 4; ++c_x) {
+		for (int32_t c_z = from_z >> 4; c_z <= (to_z - 1) >> 4; ++c_z) {
+
+			wld_chunk_t* chunk = ent_find_chunk(world, c_x, c_z);
+
+			if (chunk == NULL || !wld_chunk_is_loaded(chunk)) {
+				const float64_t min[3] = { c_x << 4, min_y, c_z << 4 };
+				const float64_t max[3] = { (c_x << 4) + 16, max_y, (c_z << 4) + 16 };
+				motion = ent_clip(box, axis, motion, min, max);
+				continue;
+			}
+
+			const int32_t chunk_from_x = UTL_MAX(from_x, c_x << 4);
+			const int32_t chunk_to_x = UTL_MIN(to_x, (c_x << 4) + 16);
+			const int32_t chunk_from_z = UTL_MAX(from_z, c_z << 4);
+			const int32_t chunk_to_z = UTL_MIN(to_z, (c_z << 4) + 16);
+
+			for (int32_t s_y = from_y & ~0xF; s_y < to_y; s_y += 16) {
+
+				wld_chunk_section_t* section = wld_chunk_get_section(chunk, (s_y - min_y) >> 4);
+
+				// most of what entities move through is air
+				if (wld_chunk_section_is_empty(section) || wld_chunk_section_get_block_count(section) == 0) {
+					continue;
+				}
+
+				wld_block_storage_t* blocks = wld_chunk_section_get_blocks(section);
+
+				const int32_t section_from_y = UTL_MAX(from_y, s_y);
+				const int32_t section_to_y = UTL_MIN(to_y, s_y + 16);
+
+				for (int32_t y = section_from_y; y < section_to_y; ++y) {
+					for (int32_t z = chunk_from_z; z < chunk_to_z; ++z) {
+						for (int32_t x = chunk_from_x; x < chunk_to_x; ++x) {
+
+							const mat_shape_t* shape = mat_get_shape(shapes[wld_block_storage_get(blocks, ((y & 0xF) << 8) | ((z & 0xF) << 4) | (x & 0xF))]);
+
+							for (uint8_t i = 0; i < shape->count; ++i) {
+								const mat_box_t* block = &shape->boxes[i];
+								const float64_t min[3] = { x + block->min_x, y + block->min_y, z + block->min_z };
+								const float64_t max[3] = { x + block->max_x, y + block->max_y, z + block->max_z };
+								motion = ent_clip(box, axis, motion, min, max);
+							}
+
+						}
+					}
+				}
+
+			}
+
+		}
+	}
+
+	return motion;
+
+}
+
+uint8_t ent_sweep(wld_chunk_t* chunk, ent_box_t* box, float64_t motion[3]) {
+
+	const uint8_t* shapes = mat_get_shape_table();
+	wld_world_t* world = wld_chunk_get_world(chunk);
+	const mat_dimension_t* dimension = mat_get_dimension_by_type(wld_get_environment(world));
+	const int16_t min_y = dimension->min_y;
+	const int16_t max_y = dimension->min_y + dimension->height;
+
+	static const ent_axis_t order[3] = { ent_axis_y, ent_axis_x, ent_axis_z };
+
+	uint8_t collisions = 0;
+
+	for (uint8_t i = 0; i < 3; ++i) {
+
+		const ent_axis_t axis = order[i];
+
+		if (motion[axis] == 0) {
+			continue;
+		}
+
+		const float64_t clipped = ent_clip_axis(world, shapes, min_y, max_y, box, axis, motion[axis]);
+
+		if (clipped != motion[axis]) {
+			collisions |= 1 << axis;
+			motion[axis] = clipped;
+		}
+
+		box->min[axis] += clipped;
+		box->max[axis] += clipped;
+
+	}
+
+	return collisions;
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "../world.d.h"
+#include "../../main.h"
+
+#define ENT_COLLISION_EPSILON 1e-7 // boxes closer than this touch, without it rounding lets entities sink into blocks
+
+typedef enum {
+
+	ent_axis_x,
+	ent_axis_y,
+	ent_axis_z
+
+} ent_axis_t;
+
+// the axes a sweep was stopped on
+typedef enum {
+
+	ent_collision_x = 1 << ent_axis_x,
+	ent_collision_y = 1 << ent_axis_y,
+	ent_collision_z = 1 << ent_axis_z
+
+} ent_collision_t;
+
+// a box in the world, indexed by ent_axis_t
+typedef struct {
+
+	float64_t min[3];
+	float64_t max[3];
+
+} ent_box_t;
+
+/*
+ * Moves the box by the motion, stopping it at the blocks in its way, the motion is changed to how far it got
+ *
+ * Blocks are read from the sections of the chunks in the world of the chunk given, sections without blocks are skipped,
+ * chunks that aren't loaded or don't exist are solid and nothing is loaded for the sweep, the motion is done one axis at a time, y first, like the client does it
+ * so both end up in the same place
+ */
+extern uint8_t ent_sweep(wld_chunk_t* chunk, ent_box_t* box, float64_t motion[3]);
@@ -15,6 +15,7 @@ uint32_t ent_register_entity(ent_entity_t* entity) {
 	memcpy((uint32_t*) &entity->id, &id, sizeof(id));
 
 	pthread_mutex_init(&entity->lock, NULL);
+	ent_init_tracker(&entity->tracker);
 	
 	ent_set_chunk(entity);
 
@@ -52,12 +53,13 @@ static inline void ent_destroy_entity(uint32_t client_id, void* entity) {
 
 static inline void ent_send_destroy_entity(uint32_t client_id, void* entity) {
 
+	// the entity is still in the chunk it's leaving, clients subscribed to that one don't see the new one
 	wld_chunk_t* entity_chunk = ((ent_entity_t*) entity)->chunk;
 
 	if (wld_chunk_has_subscriber(entity_chunk, client_id)) {
-		ent_send_entity(client_id, entity);
-	} else {
 		ent_destroy_entity(client_id, entity);
+	} else {
+		ent_send_entity(client_id, entity);
 	}
 
 }
@@ -113,6 +115,8 @@ void ent_set_chunk(ent_entity_t* entity) {
 		entity->chunk = chunk;
 	}
 
+	ent_store_set_chunk(entity, chunk);
+
 }
 
 void ent_free_entity(ent_entity_t* entity) {
@@ -121,10 +125,12 @@ void ent_free_entity(ent_entity_t* entity) {
 	wld_chunk_subscribers_foreach(ent_get_chunk(entity), ent_destroy_entity, entity);
 
 	ent_remove_chunk(entity);
+	ent_store_remove(entity);
 
 	utl_id_vector_remove(&ent_entities, entity->id);
 
 	pthread_mutex_destroy(&entity->lock);
+	ent_term_tracker(&entity->tracker);
 
 	free(entity);
 
@@ -8,6 +8,28 @@
 #include "../../util/lock_util.h"
 #include "../../jobs/board.h"
 #include "../positions.h"
+#include "tracker.h"
+#include "store.h"
+
+// where an entity was told to go since the last tick, all of it is applied at once in the next one
+typedef struct {
+
+	float64_t x;
+	float64_t y;
+	float64_t z;
+
+	// only for living entities
+	float32_t yaw;
+	float32_t pitch;
+
+	bool moved : 1;
+	bool looked : 1;
+	bool on_ground : 1;
+
+	// the job applying it is on the board, it stays there while a viewer is behind
+	bool queued : 1;
+
+} ent_movement_t;
 
 struct ent_entity {
 
@@ -16,6 +38,10 @@ struct ent_entity {
 	wld_chunk_t* chunk;
 	uint32_t chunk_node;
 
+	// where the tick state of the entity is, changed only by the job moving it or the tick of its region
+	ent_store_t* store;
+	uint32_t store_index;
+
 	const uint32_t id;
 	const ent_type_t type;
 
@@ -39,6 +65,11 @@ struct ent_entity {
 	bool on_ground : 1;
 	uint8_t powder_snow_ticks;
 
+	// guarded by the lock
+	ent_movement_t movement;
+
+	ent_tracker_t tracker;
+
 };
 
 extern uint32_t ent_register_entity(ent_entity_t* entity);
@@ -124,8 +155,39 @@ static inline void ent_remove_chunk(ent_entity_t* entity) {
 
 }
 
-static inline void ent_move(ent_entity_t* entity, float64_t d_x, float64_t d_y, float64_t d_z, bool on_ground) {
-	job_add(job_new(job_entity_move, (job_payload_t) { .entity_move = { .entity = entity, .initial_chunk = ent_get_chunk(entity), .d_x = d_x, .d_y = d_y, .d_z = d_z, .on_ground = on_ground } }));
+// marks the movement as changed, returns whether a job has to be added to apply it, entity locked
+static inline bool ent_movement_changed_l(ent_entity_t* entity) {
+
+	const bool queue = !entity->movement.queued;
+	entity->movement.queued = true;
+
+	return queue;
+
+}
+
+// adds the job applying the movement, at most one is on the board at a time
+static inline void ent_queue_movement(ent_entity_t* entity) {
+	job_add(job_new(job_entity_move, (job_payload_t) { .entity = entity }));
+}
+
+// moves the entity to the position in the next tick, only the last position given before then is used
+static inline void ent_move(ent_entity_t* entity, float64_t x, float64_t y, float64_t z, bool on_ground) {
+
+	bool queue = false;
+
+	with_lock (&entity->lock) {
+		entity->movement.x = x;
+		entity->movement.y = y;
+		entity->movement.z = z;
+		entity->movement.on_ground = on_ground;
+		entity->movement.moved = true;
+		queue = ent_movement_changed_l(entity);
+	}
+
+	if (queue) {
+		ent_queue_movement(entity);
+	}
+
 }
 
 extern void ent_set_chunk(ent_entity_t* entity);
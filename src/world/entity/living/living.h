@@ -63,40 +63,45 @@ static inline bool ent_le_is_dead(ent_living_entity_t* living_entity) {
 	return ent_le_get_health(living_entity) <= 0;
 }
 
+// turns the entity in the next tick, only the last rotation given before then is used
 static inline void ent_le_look(ent_living_entity_t* entity, float32_t yaw, float32_t pitch, bool on_ground) {
-	job_add(
-		job_new(
-			job_living_entity_look,
-			(job_payload_t) {
-				.living_entity_look = {
-					.entity = entity,
-					.yaw = yaw,
-					.pitch = pitch,
-					.on_ground = on_ground
-				}
-			}
-		)
-	);
+
+	bool queue = false;
+
+	with_lock (&entity->entity.lock) {
+		entity->entity.movement.yaw = yaw;
+		entity->entity.movement.pitch = pitch;
+		entity->entity.movement.on_ground = on_ground;
+		entity->entity.movement.looked = true;
+		queue = ent_movement_changed_l(ent_le_get_entity(entity));
+	}
+
+	if (queue) {
+		ent_queue_movement(ent_le_get_entity(entity));
+	}
+
 }
 
-static inline void ent_le_move_look(ent_living_entity_t* entity, float64_t d_x, float64_t d_y, float64_t d_z, float32_t yaw, float32_t pitch, bool on_ground) {
-	job_add(
-		job_new(
-			job_living_entity_move_look,
-			(job_payload_t) {
-				.living_entity_move_look = {
-					.entity = entity,
-					.initial_chunk = ent_get_chunk(ent_le_get_entity(entity)),
-					.d_x = d_x,
-					.d_y = d_y,
-					.d_z = d_z,
-					.yaw = yaw,
-					.pitch = pitch,
-					.on_ground = on_ground
-			 	}
-			}
-		)
-	);
+static inline void ent_le_move_look(ent_living_entity_t* entity, float64_t x, float64_t y, float64_t z, float32_t yaw, float32_t pitch, bool on_ground) {
+
+	bool queue = false;
+
+	with_lock (&entity->entity.lock) {
+		entity->entity.movement.x = x;
+		entity->entity.movement.y = y;
+		entity->entity.movement.z = z;
+		entity->entity.movement.yaw = yaw;
+		entity->entity.movement.pitch = pitch;
+		entity->entity.movement.on_ground = on_ground;
+		entity->entity.movement.moved = true;
+		entity->entity.movement.looked = true;
+		queue = ent_movement_changed_l(ent_le_get_entity(entity));
+	}
+
+	if (queue) {
+		ent_queue_movement(ent_le_get_entity(entity));
+	}
+
 }
 
 static inline void ent_le_teleport_look(ent_living_entity_t* entity, wld_world_t* world, float64_t x, float64_t y, float64_t z, float32_t yaw, float32_t pitch, bool on_ground) {
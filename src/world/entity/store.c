@@ -0,0 +1,979 @@
+#include <stdlib.h>
+#include <math.h>
+#include "store.h"
+#include "entity.h"
+#include "collision.h"
+#include "../world.h"
+#include "../../util/lock_util.h"
+
+#define ENT_STORE_REGION_MARGIN 8 // half the widest entity, entities of the next region over can reach this far in
+
+typedef void (*ent_store_function_t) (ent_store_t* store, uint32_t index, void* args);
+typedef void (*ent_store_pair_function_t) (ent_store_t* store, uint32_t a, uint32_t b, void* args);
+
+void ent_init_store(ent_store_t* store, int32_t x, int32_t z) {
+
+	pthread_mutex_init(&store->lock, NULL);
+
+	store->origin_x = x;
+	store->origin_z = z;
+
+	store->length = 0;
+	store->capacity = 0;
+
+	store->entities = NULL;
+	store->chunk = NULL;
+	store->flags = NULL;
+	store->x = NULL;
+	store->y = NULL;
+	store->z = NULL;
+	store->velocity_x = NULL;
+	store->velocity_y = NULL;
+	store->velocity_z = NULL;
+	store->width = NULL;
+	store->height = NULL;
+	store->ticking = NULL;
+	store->collided = NULL;
+	store->cell = NULL;
+	store->cell_next = NULL;
+	store->cell_previous = NULL;
+
+	for (uint32_t i = 0; i < ENT_STORE_GRID_SIZE * ENT_STORE_GRID_SIZE; ++i) {
+		store->cells[i] = ENT_STORE_NONE;
+	}
+
+	store->max_width = 0;
+	store->max_height = 0;
+
+}
+
+// makes every array fit one more entity, store locked
+static void ent_store_grow_l(ent_store_t* store) {
+
+	if (store->length < store->capacity) {
+		return;
+	}
+
+	const uint32_t capacity = store->capacity == 0 ? ENT_STORE_MIN_CAPACITY : store->capacity * 2;
+
+	store->entities = realloc(store->entities, sizeof(ent_entity_t*) * capacity);
+	store->chunk = realloc(store->chunk, sizeof(uint16_t) * capacity);
+	store->flags = realloc(store->flags, sizeof(uint8_t) * capacity);
+	store->x = realloc(store->x, sizeof(float64_t) * capacity);
+	store->y = realloc(store->y, sizeof(float64_t) * capacity);
+	store->z = realloc(store->z, sizeof(float64_t) * capacity);
+	store->velocity_x = realloc(store->velocity_x, sizeof(float64_t) * capacity);
+	store->velocity_y = realloc(store->velocity_y, sizeof(float64_t) * capacity);
+	store->velocity_z = realloc(store->velocity_z, sizeof(float64_t) * capacity);
+	store->width = realloc(store->width, sizeof(float32_t) * capacity);
+	store->height = realloc(store->height, sizeof(float32_t) * capacity);
+	store->ticking = realloc(store->ticking, sizeof(uint8_t) * capacity);
+	store->collided = realloc(store->collided, sizeof(uint8_t) * capacity);
+	store->cell = realloc(store->cell, sizeof(uint32_t) * capacity);
+	store->cell_next = realloc(store->cell_next, sizeof(uint32_t) * capacity);
+	store->cell_previous = realloc(store->cell_previous, sizeof(uint32_t) * capacity);
+
+	store->capacity = capacity;
+
+}
+
+// positions outside the region are put in the cells at its edge
+static inline uint32_t ent_store_get_cell_coordinate(int32_t origin, float64_t position) {
+
+	const int64_t cell = (utl_int_floor(position) - origin) >> ENT_STORE_CELL_BITS;
+
+	if (cell < 0) {
+		return 0;
+	} else if (cell >= ENT_STORE_GRID_SIZE) {
+		return ENT_STORE_GRID_SIZE - 1;
+	}
+
+	return cell;
+
+}
+
+static inline uint32_t ent_store_get_cell(const ent_store_t* store, float64_t x, float64_t z) {
+	return ent_store_get_cell_coordinate(store->origin_x, x) * ENT_STORE_GRID_SIZE + ent_store_get_cell_coordinate(store->origin_z, z);
+}
+
+// puts the entity first in the cell of its position, store locked
+static void ent_store_link_l(ent_store_t* store, uint32_t index) {
+
+	const uint32_t cell = ent_store_get_cell(store, store->x[index], store->z[index]);
+	const uint32_t first = store->cells[cell];
+
+	store->cell[index] = cell;
+	store->cell_previous[index] = ENT_STORE_NONE;
+	store->cell_next[index] = first;
+
+	if (first != ENT_STORE_NONE) {
+		store->cell_previous[first] = index;
+	}
+
+	store->cells[cell] = index;
+
+}
+
+static void ent_store_unlink_l(ent_store_t* store, uint32_t index) {
+
+	const uint32_t previous = store->cell_previous[index];
+	const uint32_t next = store->cell_next[index];
+
+	if (previous != ENT_STORE_NONE) {
+		store->cell_next[previous] = next;
+	} else {
+		store->cells[store->cell[index]] = next;
+	}
+
+	if (next != ENT_STORE_NONE) {
+		store->cell_previous[next] = previous;
+	}
+
+}
+
+// moves the entity to the cell of its position if it left its cell, store locked
+static inline void ent_store_relink_l(ent_store_t* store, uint32_t index) {
+
+	if (ent_store_get_cell(store, store->x[index], store->z[index]) != store->cell[index]) {
+		ent_store_unlink_l(store, index);
+		ent_store_link_l(store, index);
+	}
+
+}
+
+// the boxes of the entities as vanilla has them, slimes and magma cubes at their biggest
+static const struct {
+
+	float32_t width;
+	float32_t height;
+
+} ent_store_sizes[ent_type_count] = {
+	[ent_area_effect_cloud] = { 6.0f, 0.5f },
+	[ent_armor_stand] = { 0.5f, 1.975f },
+	[ent_arrow] = { 0.5f, 0.5f },
+	[ent_axolotl] = { 0.75f, 0.42f },
+	[ent_bat] = { 0.5f, 0.9f },
+	[ent_bee] = { 0.7f, 0.6f },
+	[ent_blaze] = { 0.6f, 1.8f },
+	[ent_boat] = { 1.375f, 0.5625f },
+	[ent_cat] = { 0.6f, 0.7f },
+	[ent_cave_spider] = { 0.7f, 0.5f },
+	[ent_chicken] = { 0.4f, 0.7f },
+	[ent_cod] = { 0.5f, 0.3f },
+	[ent_cow] = { 0.9f, 1.4f },
+	[ent_creeper] = { 0.6f, 1.7f },
+	[ent_dolphin] = { 0.9f, 0.6f },
+	[ent_donkey] = { 1.3964844f, 1.5f },
+	[ent_dragon_fireball] = { 1.0f, 1.0f },
+	[ent_drowned] = { 0.6f, 1.95f },
+	[ent_elder_guardian] = { 1.9975f, 1.9975f },
+	[ent_end_crystal] = { 2.0f, 2.0f },
+	[ent_ender_dragon] = { 16.0f, 8.0f },
+	[ent_enderman] = { 0.6f, 2.9f },
+	[ent_endermite] = { 0.4f, 0.3f },
+	[ent_evoker] = { 0.6f, 1.95f },
+	[ent_evoker_fangs] = { 0.5f, 0.8f },
+	[ent_experience_orb] = { 0.5f, 0.5f },
+	[ent_eye_of_ender] = { 0.25f, 0.25f },
+	[ent_falling_block] = { 0.98f, 0.98f },
+	[ent_firework_rocket] = { 0.25f, 0.25f },
+	[ent_fox] = { 0.6f, 0.7f },
+	[ent_ghast] = { 4.0f, 4.0f },
+	[ent_giant] = { 3.6f, 12.0f },
+	[ent_glow_item_frame] = { 0.5f, 0.5f },
+	[ent_glow_squid] = { 0.8f, 0.8f },
+	[ent_goat] = { 0.9f, 1.3f },
+	[ent_guardian] = { 0.85f, 0.85f },
+	[ent_hoglin] = { 1.3964844f, 1.4f },
+	[ent_horse] = { 1.3964844f, 1.6f },
+	[ent_husk] = { 0.6f, 1.95f },
+	[ent_illusioner] = { 0.6f, 1.95f },
+	[ent_iron_golem] = { 1.4f, 2.7f },
+	[ent_item] = { 0.25f, 0.25f },
+	[ent_item_frame] = { 0.5f, 0.5f },
+	[ent_fireball] = { 1.0f, 1.0f },
+	[ent_leash_knot] = { 0.375f, 0.5f },
+	[ent_lightning_bolt] = { 0.0f, 0.0f },
+	[ent_llama] = { 0.9f, 1.87f },
+	[ent_llama_spit] = { 0.25f, 0.25f },
+	[ent_magma_cube] = { 2.04f, 2.04f },
+	[ent_marker] = { 0.0f, 0.0f },
+	[ent_minecart] = { 0.98f, 0.7f },
+	[ent_minecart_chest] = { 0.98f, 0.7f },
+	[ent_minecart_command_block] = { 0.98f, 0.7f },
+	[ent_minecart_furnace] = { 0.98f, 0.7f },
+	[ent_minecart_hopper] = { 0.98f, 0.7f },
+	[ent_minecart_spawner] = { 0.98f, 0.7f },
+	[ent_minecart_tnt] = { 0.98f, 0.7f },
+	[ent_mule] = { 1.3964844f, 1.6f },
+	[ent_mooshroom] = { 0.9f, 1.4f },
+	[ent_ocelot] = { 0.6f, 0.7f },
+	[ent_painting] = { 0.5f, 0.5f },
+	[ent_panda] = { 1.3f, 1.25f },
+	[ent_parrot] = { 0.5f, 0.9f },
+	[ent_phantom] = { 0.9f, 0.5f },
+	[ent_pig] = { 0.9f, 0.9f },
+	[ent_piglin] = { 0.6f, 1.95f },
+	[ent_piglin_brute] = { 0.6f, 1.95f },
+	[ent_pillager] = { 0.6f, 1.95f },
+	[ent_polar_bear] = { 1.4f, 1.4f },
+	[ent_tnt] = { 0.98f, 0.98f },
+	[ent_pufferfish] = { 0.7f, 0.7f },
+	[ent_rabbit] = { 0.4f, 0.5f },
+	[ent_ravager] = { 1.95f, 2.2f },
+	[ent_salmon] = { 0.7f, 0.4f },
+	[ent_sheep] = { 0.9f, 1.3f },
+	[ent_shulker] = { 1.0f, 1.0f },
+	[ent_shulker_bullet] = { 0.3125f, 0.3125f },
+	[ent_silverfish] = { 0.4f, 0.3f },
+	[ent_skeleton] = { 0.6f, 1.99f },
+	[ent_skeleton_horse] = { 1.3964844f, 1.6f },
+	[ent_slime] = { 2.04f, 2.04f },
+	[ent_small_fireball] = { 0.3125f, 0.3125f },
+	[ent_snow_golem] = { 0.7f, 1.9f },
+	[ent_snowball] = { 0.25f, 0.25f },
+	[ent_spectral_arrow] = { 0.5f, 0.5f },
+	[ent_spider] = { 1.4f, 0.9f },
+	[ent_squid] = { 0.8f, 0.8f },
+	[ent_stray] = { 0.6f, 1.99f },
+	[ent_strider] = { 0.9f, 1.7f },
+	[ent_thrown_egg] = { 0.25f, 0.25f },
+	[ent_thrown_ender_pearl] = { 0.25f, 0.25f },
+	[ent_thrown_experience_bottle] = { 0.25f, 0.25f },
+	[ent_thrown_potion] = { 0.25f, 0.25f },
+	[ent_thrown_trident] = { 0.5f, 0.5f },
+	[ent_trader_llama] = { 0.9f, 1.87f },
+	[ent_tropical_fish] = { 0.5f, 0.4f },
+	[ent_turtle] = { 1.2f, 0.4f },
+	[ent_vex] = { 0.4f, 0.8f },
+	[ent_villager] = { 0.6f, 1.95f },
+	[ent_vindicator] = { 0.6f, 1.95f },
+	[ent_wandering_trader] = { 0.6f, 1.95f },
+	[ent_witch] = { 0.6f, 1.95f },
+	[ent_wither] = { 0.9f, 3.5f },
+	[ent_wither_skeleton] = { 0.7f, 2.4f },
+	[ent_wither_skull] = { 0.3125f, 0.3125f },
+	[ent_wolf] = { 0.6f, 0.85f },
+	[ent_zoglin] = { 1.3964844f, 1.4f },
+	[ent_zombie] = { 0.6f, 1.95f },
+	[ent_zombie_horse] = { 1.3964844f, 1.6f },
+	[ent_zombie_villager] = { 0.6f, 1.95f },
+	[ent_zombified_piglin] = { 0.6f, 1.95f },
+	[ent_player] = { 0.6f, 1.8f },
+	[ent_fishing_hook] = { 0.25f, 0.25f }
+};
+
+static inline void ent_store_get_size(ent_type_t type, float32_t* width, float32_t* height) {
+
+	*width = ent_store_sizes[type].width;
+	*height = ent_store_sizes[type].height;
+
+}
+
+static inline uint8_t ent_store_get_flags(ent_entity_t* entity) {
+
+	uint8_t flags = 0;
+
+	if (ent_get_type(entity) != ent_player) {
+		flags |= ent_store_simulated;
+	} else {
+		flags |= ent_store_player;
+	}
+	if (!entity->no_gravity) {
+		flags |= ent_store_gravity;
+	}
+	if (entity->on_ground) {
+		flags |= ent_store_on_ground;
+	}
+	if (ent_is_le(entity)) {
+		flags |= ent_store_living;
+	}
+
+	return flags;
+
+}
+
+void ent_store_add(ent_store_t* store, ent_entity_t* entity, uint16_t chunk) {
+
+	with_lock (&store->lock) {
+
+		ent_store_grow_l(store);
+
+		const uint32_t index = store->length++;
+
+		store->entities[index] = entity;
+		store->chunk[index] = chunk;
+		store->flags[index] = ent_store_get_flags(entity);
+		store->x[index] = entity->position.x;
+		store->y[index] = entity->position.y;
+		store->z[index] = entity->position.z;
+		store->velocity_x[index] = 0;
+		store->velocity_y[index] = 0;
+		store->velocity_z[index] = 0;
+		ent_store_get_size(ent_get_type(entity), &store->width[index], &store->height[index]);
+
+		store->max_width = UTL_MAX(store->max_width, store->width[index]);
+		store->max_height = UTL_MAX(store->max_height, store->height[index]);
+
+		ent_store_link_l(store, index);
+
+		entity->store = store;
+		entity->store_index = index;
+
+	}
+
+}
+
+void ent_store_remove(ent_entity_t* entity) {
+
+	ent_store_t* store = entity->store;
+
+	if (store == NULL) {
+		return;
+	}
+
+	with_lock (&store->lock) {
+
+		const uint32_t index = entity->store_index;
+		const uint32_t last = --store->length;
+
+		ent_store_unlink_l(store, index);
+
+		// the last entity takes the place of the removed one
+		if (index != last) {
+			ent_store_unlink_l(store, last);
+			store->entities[index] = store->entities[last];
+			store->chunk[index] = store->chunk[last];
+			store->flags[index] = store->flags[last];
+			store->x[index] = store->x[last];
+			store->y[index] = store->y[last];
+			store->z[index] = store->z[last];
+			store->velocity_x[index] = store->velocity_x[last];
+			store->velocity_y[index] = store->velocity_y[last];
+			store->velocity_z[index] = store->velocity_z[last];
+			store->width[index] = store->width[last];
+			store->height[index] = store->height[last];
+			store->entities[index]->store_index = index;
+			ent_store_link_l(store, index);
+		}
+
+		entity->store = NULL;
+
+	}
+
+}
+
+void ent_store_set_chunk(ent_entity_t* entity, wld_chunk_t* chunk) {
+
+	ent_store_t* store = &wld_chunk_get_region(chunk)->entities;
+	const uint16_t index = wld_chunk_get_region_idx(chunk);
+
+	if (entity->store == store) {
+		with_lock (&store->lock) {
+			store->chunk[entity->store_index] = index;
+		}
+		return;
+	}
+
+	// the velocity goes with the entity to the other region, and whether it's behind
+	float64_t velocity[3] = { 0, 0, 0 };
+	bool behind = false;
+	if (entity->store != NULL) {
+		with_lock (&entity->store->lock) {
+			velocity[0] = entity->store->velocity_x[entity->store_index];
+			velocity[1] = entity->store->velocity_y[entity->store_index];
+			velocity[2] = entity->store->velocity_z[entity->store_index];
+			behind = entity->store->flags[entity->store_index] & ent_store_behind;
+		}
+		ent_store_remove(entity);
+	}
+
+	ent_store_add(store, entity, index);
+	ent_store_set_velocity(entity, velocity[0], velocity[1], velocity[2]);
+	ent_store_set_behind(entity, behind);
+
+}
+
+void ent_store_update(ent_entity_t* entity) {
+
+	ent_store_t* store = entity->store;
+
+	if (store == NULL) {
+		return;
+	}
+
+	with_lock (&store->lock) {
+
+		const uint32_t index = entity->store_index;
+
+		store->x[index] = entity->position.x;
+		store->y[index] = entity->position.y;
+		store->z[index] = entity->position.z;
+
+		ent_store_relink_l(store, index);
+
+		if (entity->on_ground) {
+			store->flags[index] |= ent_store_on_ground;
+		} else {
+			store->flags[index] &= ~ent_store_on_ground;
+		}
+
+	}
+
+}
+
+void ent_store_set_velocity(ent_entity_t* entity, float64_t x, float64_t y, float64_t z) {
+
+	ent_store_t* store = entity->store;
+
+	if (store == NULL) {
+		return;
+	}
+
+	with_lock (&store->lock) {
+		store->velocity_x[entity->store_index] = x;
+		store->velocity_y[entity->store_index] = y;
+		store->velocity_z[entity->store_index] = z;
+	}
+
+}
+
+void ent_store_set_behind(ent_entity_t* entity, bool behind) {
+
+	ent_store_t* store = entity->store;
+
+	if (store == NULL) {
+		return;
+	}
+
+	with_lock (&store->lock) {
+		if (behind) {
+			store->flags[entity->store_index] |= ent_store_behind;
+		} else {
+			store->flags[entity->store_index] &= ~ent_store_behind;
+		}
+	}
+
+}
+
+// calls the function for every entity whose box overlaps the box, only looking in the cells around it, store locked
+static void ent_store_foreach_in_box_l(ent_store_t* store, float64_t min_x, float64_t min_y, float64_t min_z, float64_t max_x, float64_t max_y, float64_t max_z, ent_store_function_t function, void* args) {
+
+	// entities are in the cell of their position, their boxes can reach into the cells next to it
+	const float64_t reach = store->max_width / 2;
+
+	const uint32_t from_x = ent_store_get_cell_coordinate(store->origin_x, min_x - reach);
+	const uint32_t to_x = ent_store_get_cell_coordinate(store->origin_x, max_x + reach);
+	const uint32_t from_z = ent_store_get_cell_coordinate(store->origin_z, min_z - reach);
+	const uint32_t to_z = ent_store_get_cell_coordinate(store->origin_z, max_z + reach);
+
+	for (uint32_t c_x = from_x; c_x <= to_x; ++c_x) {
+		for (uint32_t c_z = from_z; c_z <= to_z; ++c_z) {
+			for (uint32_t i = store->cells[c_x * ENT_STORE_GRID_SIZE + c_z]; i != ENT_STORE_NONE; i = store->cell_next[i]) {
+
+				const float64_t half_width = store->width[i] / 2;
+
+				if (store->x[i] - half_width <= max_x && store->x[i] + half_width >= min_x
+				&& store->z[i] - half_width <= max_z && store->z[i] + half_width >= min_z
+				&& store->y[i] <= max_y && store->y[i] + store->height[i] >= min_y) {
+					function(store, i, args);
+				}
+
+			}
+		}
+	}
+
+}
+
+// the squared distance from the point to the closest point of the box of the entity, store locked
+static inline float64_t ent_store_get_distance_squared_l(const ent_store_t* store, uint32_t index, float64_t x, float64_t y, float64_t z) {
+
+	const float64_t half_width = store->width[index] / 2;
+
+	const float64_t d_x = UTL_MAX(UTL_MAX(store->x[index] - half_width - x, x - store->x[index] - half_width), 0.0);
+	const float64_t d_y = UTL_MAX(UTL_MAX(store->y[index] - y, y - store->y[index] - store->height[index]), 0.0);
+	const float64_t d_z = UTL_MAX(UTL_MAX(store->z[index] - half_width - z, z - store->z[index] - half_width), 0.0);
+
+	return d_x * d_x + d_y * d_y + d_z * d_z;
+
+}
+
+static void ent_store_push_found(ent_store_t* store, uint32_t index, void* found) {
+	utl_vector_push(found, &store->entities[index]);
+}
+
+void ent_store_get_in_box(ent_store_t* store, float64_t min_x, float64_t min_y, float64_t min_z, float64_t max_x, float64_t max_y, float64_t max_z, utl_vector_t* found) {
+
+	with_lock (&store->lock) {
+		ent_store_foreach_in_box_l(store, min_x, min_y, min_z, max_x, max_y, max_z, ent_store_push_found, found);
+	}
+
+}
+
+typedef struct {
+
+	float64_t x;
+	float64_t y;
+	float64_t z;
+	float64_t radius_squared;
+
+	utl_vector_t* found;
+
+	// closest player
+	uint32_t nearest;
+	float64_t nearest_distance_squared;
+
+} ent_store_radius_query_t;
+
+static void ent_store_push_in_radius(ent_store_t* store, uint32_t index, void* args) {
+
+	ent_store_radius_query_t* query = args;
+
+	if (ent_store_get_distance_squared_l(store, index, query->x, query->y, query->z) <= query->radius_squared) {
+		utl_vector_push(query->found, &store->entities[index]);
+	}
+
+}
+
+void ent_store_get_in_radius(ent_store_t* store, float64_t x, float64_t y, float64_t z, float64_t radius, utl_vector_t* found) {
+
+	ent_store_radius_query_t query = {
+		.x = x,
+		.y = y,
+		.z = z,
+		.radius_squared = radius * radius,
+		.found = found
+	};
+
+	with_lock (&store->lock) {
+		ent_store_foreach_in_box_l(store, x - radius, y - radius, z - radius, x + radius, y + radius, z + radius, ent_store_push_in_radius, &query);
+	}
+
+}
+
+static void ent_store_find_nearest_player(ent_store_t* store, uint32_t index, void* args) {
+
+	ent_store_radius_query_t* query = args;
+
+	if (!(store->flags[index] & ent_store_player)) {
+		return;
+	}
+
+	const float64_t distance_squared = ent_store_get_distance_squared_l(store, index, query->x, query->y, query->z);
+
+	if (distance_squared <= query->radius_squared && distance_squared < query->nearest_distance_squared) {
+		query->nearest = index;
+		query->nearest_distance_squared = distance_squared;
+	}
+
+}
+
+// the nearest player within the radius in the query, store locked
+static inline void ent_store_find_nearest_player_l(ent_store_t* store, ent_store_radius_query_t* query, float64_t radius) {
+	ent_store_foreach_in_box_l(store, query->x - radius, query->y - radius, query->z - radius, query->x + radius, query->y + radius, query->z + radius, ent_store_find_nearest_player, query);
+}
+
+ent_entity_t* ent_store_get_nearest_player(ent_store_t* store, float64_t x, float64_t y, float64_t z, float64_t radius) {
+
+	ent_store_radius_query_t query = {
+		.x = x,
+		.y = y,
+		.z = z,
+		.radius_squared = radius * radius,
+		.nearest = ENT_STORE_NONE,
+		.nearest_distance_squared = INFINITY
+	};
+
+	ent_entity_t* nearest = NULL;
+
+	with_lock (&store->lock) {
+		ent_store_find_nearest_player_l(store, &query, radius);
+		if (query.nearest != ENT_STORE_NONE) {
+			nearest = store->entities[query.nearest];
+		}
+	}
+
+	return nearest;
+
+}
+
+typedef struct {
+
+	uint32_t index;
+
+	ent_store_pair_function_t function;
+	void* args;
+
+} ent_store_pair_query_t;
+
+static void ent_store_call_pair(ent_store_t* store, uint32_t index, void* args) {
+
+	ent_store_pair_query_t* query = args;
+
+	// each pair is found from both entities, only the one from the first is used
+	if (index > query->index) {
+		query->function(store, query->index, index, query->args);
+	}
+
+}
+
+// calls the function for every two entities whose boxes overlap, store locked
+static void ent_store_foreach_pair_l(ent_store_t* store, ent_store_pair_function_t function, void* args) {
+
+	ent_store_pair_query_t query = {
+		.function = function,
+		.args = args
+	};
+
+	for (uint32_t i = 0; i < store->length; ++i) {
+
+		const float64_t half_width = store->width[i] / 2;
+		query.index = i;
+
+		ent_store_foreach_in_box_l(store, store->x[i] - half_width, store->y[i], store->z[i] - half_width, store->x[i] + half_width, store->y[i] + store->height[i], store->z[i] + half_width, ent_store_call_pair, &query);
+
+	}
+
+}
+
+static void ent_store_push_pair(ent_store_t* store, uint32_t a, uint32_t b, void* pairs) {
+
+	const ent_store_pair_t pair = {
+		.a = store->entities[a],
+		.b = store->entities[b]
+	};
+
+	utl_vector_push(pairs, &pair);
+
+}
+
+void ent_store_get_pairs(ent_store_t* store, utl_vector_t* pairs) {
+
+	with_lock (&store->lock) {
+		ent_store_foreach_pair_l(store, ent_store_push_pair, pairs);
+	}
+
+}
+
+// calls the function for the stores of the loaded regions in the box, and the ones next to it entities can reach into it from
+static void ent_foreach_store_in_box(wld_world_t* world, float64_t min_x, float64_t min_z, float64_t max_x, float64_t max_z, void (*const function) (ent_store_t*, void*), void* args) {
+
+	const int32_t from_x = (utl_int_floor(min_x) - ENT_STORE_REGION_MARGIN) >> 9;
+	const int32_t to_x = (utl_int_floor(max_x) + ENT_STORE_REGION_MARGIN) >> 9;
+	const int32_t from_z = (utl_int_floor(min_z) - ENT_STORE_REGION_MARGIN) >> 9;
+	const int32_t to_z = (utl_int_floor(max_z) + ENT_STORE_REGION_MARGIN) >> 9;
+
+	for (int32_t r_x = from_x; r_x <= to_x; ++r_x) {
+		for (int32_t r_z = from_z; r_z <= to_z; ++r_z) {
+
+			// regions that aren't loaded have no entities, they aren't loaded for this
+			wld_region_t* region = utl_hash_map_get(&world->regions, wld_region_key(r_x, r_z));
+
+			if (region != NULL) {
+				function(&region->entities, args);
+			}
+
+		}
+	}
+
+}
+
+typedef struct {
+
+	float64_t min_x;
+	float64_t min_y;
+	float64_t min_z;
+	float64_t max_x;
+	float64_t max_y;
+	float64_t max_z;
+
+	utl_vector_t* found;
+
+} ent_box_query_t;
+
+static void ent_get_store_in_box(ent_store_t* store, void* args) {
+
+	ent_box_query_t* query = args;
+
+	ent_store_get_in_box(store, query->min_x, query->min_y, query->min_z, query->max_x, query->max_y, query->max_z, query->found);
+
+}
+
+void ent_get_in_box(wld_world_t* world, float64_t min_x, float64_t min_y, float64_t min_z, float64_t max_x, float64_t max_y, float64_t max_z, utl_vector_t* found) {
+
+	ent_box_query_t query = {
+		.min_x = min_x,
+		.min_y = min_y,
+		.min_z = min_z,
+		.max_x = max_x,
+		.max_y = max_y,
+		.max_z = max_z,
+		.found = found
+	};
+
+	ent_foreach_store_in_box(world, min_x, min_z, max_x, max_z, ent_get_store_in_box, &query);
+
+}
+
+static void ent_get_store_in_radius(ent_store_t* store, void* args) {
+
+	ent_store_radius_query_t* query = args;
+	const float64_t radius = sqrt(query->radius_squared);
+
+	with_lock (&store->lock) {
+		ent_store_foreach_in_box_l(store, query->x - radius, query->y - radius, query->z - radius, query->x + radius, query->y + radius, query->z + radius, ent_store_push_in_radius, query);
+	}
+
+}
+
+void ent_get_in_radius(wld_world_t* world, float64_t x, float64_t y, float64_t z, float64_t radius, utl_vector_t* found) {
+
+	ent_store_radius_query_t query = {
+		.x = x,
+		.y = y,
+		.z = z,
+		.radius_squared = radius * radius,
+		.found = found
+	};
+
+	ent_foreach_store_in_box(world, x - radius, z - radius, x + radius, z + radius, ent_get_store_in_radius, &query);
+
+}
+
+typedef struct {
+
+	ent_store_radius_query_t query;
+	ent_entity_t* nearest;
+
+} ent_nearest_player_query_t;
+
+static void ent_get_store_nearest_player(ent_store_t* store, void* args) {
+
+	ent_nearest_player_query_t* nearest = args;
+
+	// the distance found so far carries over, so only closer players of this store are taken
+	with_lock (&store->lock) {
+		nearest->query.nearest = ENT_STORE_NONE;
+		ent_store_find_nearest_player_l(store, &nearest->query, sqrt(nearest->query.radius_squared));
+		if (nearest->query.nearest != ENT_STORE_NONE) {
+			nearest->nearest = store->entities[nearest->query.nearest];
+		}
+	}
+
+}
+
+ent_entity_t* ent_get_nearest_player(wld_world_t* world, float64_t x, float64_t y, float64_t z, float64_t radius) {
+
+	ent_nearest_player_query_t nearest = {
+		.query = {
+			.x = x,
+			.y = y,
+			.z = z,
+			.radius_squared = radius * radius,
+			.nearest_distance_squared = INFINITY
+		},
+		.nearest = NULL
+	};
+
+	ent_foreach_store_in_box(world, x - radius, z - radius, x + radius, z + radius, ent_get_store_nearest_player, &nearest);
+
+	return nearest.nearest;
+
+}
+
+// pushes the entities apart, on the side they're furthest apart on, only the simulated ones in ticking chunks move
+static void ent_store_push_apart(ent_store_t* store, uint32_t a, uint32_t b, void* args) {
+
+	const uint8_t* active = args;
+
+	float64_t d_x = store->x[b] - store->x[a];
+	float64_t d_z = store->z[b] - store->z[a];
+	float64_t distance = UTL_MAX(fabs(d_x), fabs(d_z));
+
+	if (distance < 0.01) {
+		return;
+	}
+
+	distance = sqrt(distance);
+	const float64_t push = ENT_PUSH * UTL_MIN(1 / distance, 1.0) / distance;
+
+	d_x *= push;
+	d_z *= push;
+
+	if (active[a]) {
+		store->velocity_x[a] -= d_x;
+		store->velocity_z[a] -= d_z;
+	}
+	if (active[b]) {
+		store->velocity_x[b] += d_x;
+		store->velocity_z[b] += d_z;
+	}
+
+}
+
+// cuts the velocity of the entities short where they would run into blocks, the axes they ran into are put in collided
+static void ent_store_collide_l(ent_store_t* store, wld_region_t* region, const uint8_t* active) {
+
+	for (uint32_t i = 0; i < store->length; ++i) {
+
+		if (!active[i]) {
+			continue;
+		}
+
+		// entities on the ground don't fall, they are moved down to find out whether there still is ground under them
+		const bool resting = (store->flags[i] & (ent_store_gravity | ent_store_on_ground)) == (ent_store_gravity | ent_store_on_ground) && store->velocity_y[i] == 0;
+		float64_t motion[3] = { store->velocity_x[i], resting ? -ENT_GRAVITY * ENT_DRAG : store->velocity_y[i], store->velocity_z[i] };
+		const float64_t fall = motion[ent_axis_y];
+
+		if (motion[ent_axis_x] == 0 && motion[ent_axis_y] == 0 && motion[ent_axis_z] == 0) {
+			continue;
+		}
+
+		const float64_t half_width = store->width[i] / 2;
+		ent_box_t box = {
+			.min = { store->x[i] - half_width, store->y[i], store->z[i] - half_width },
+			.max = { store->x[i] + half_width, store->y[i] + store->height[i], store->z[i] + half_width }
+		};
+
+		store->collided[i] = ent_sweep(wld_region_get_chunk_by_idx(region, store->chunk[i]), &box, motion);
+
+		store->velocity_x[i] = motion[ent_axis_x];
+		store->velocity_y[i] = motion[ent_axis_y];
+		store->velocity_z[i] = motion[ent_axis_z];
+
+		if (fall != 0) {
+			if ((store->collided[i] & ent_collision_y) && fall < 0) {
+				store->flags[i] |= ent_store_on_ground;
+			} else {
+				store->flags[i] &= ~ent_store_on_ground;
+			}
+		}
+
+	}
+
+}
+
+static inline void ent_store_stop(uint32_t length, const uint8_t* restrict collided, ent_collision_t axis, float64_t* restrict velocity) {
+
+	for (uint32_t i = 0; i < length; ++i) {
+		velocity[i] = (collided[i] & axis) ? 0 : velocity[i];
+	}
+
+}
+
+// the loops only read and write the arrays they are given, so the compiler can do several entities at once
+static inline void ent_store_integrate(uint32_t length, const uint8_t* restrict active, float64_t* restrict position, const float64_t* restrict velocity) {
+
+	for (uint32_t i = 0; i < length; ++i) {
+		position[i] += active[i] ? velocity[i] : 0;
+	}
+
+}
+
+static inline void ent_store_apply_gravity(uint32_t length, const uint8_t* restrict active, const uint8_t* restrict flags, float64_t* restrict velocity_y) {
+
+	for (uint32_t i = 0; i < length; ++i) {
+		const bool falling = active[i] && (flags[i] & (ent_store_gravity | ent_store_on_ground)) == ent_store_gravity;
+		velocity_y[i] = falling ? (velocity_y[i] - ENT_GRAVITY) * ENT_DRAG : velocity_y[i];
+	}
+
+}
+
+static inline void ent_store_apply_friction(uint32_t length, const uint8_t* restrict active, const uint8_t* restrict flags, float64_t* restrict velocity) {
+
+	for (uint32_t i = 0; i < length; ++i) {
+		const float64_t friction = (flags[i] & ent_store_on_ground) ? ENT_GROUND_FRICTION : ENT_AIR_FRICTION;
+		const float64_t slowed = fabs(velocity[i] * friction) < ENT_MIN_VELOCITY ? 0 : velocity[i] * friction;
+		velocity[i] = active[i] ? slowed : velocity[i];
+	}
+
+}
+
+void ent_store_tick(ent_store_t* store, wld_region_t* region, const bool ticking[32 * 32], float64_t void_y, utl_vector_t* moved, utl_vector_t* in_void) {
+
+	with_lock (&store->lock) {
+
+		const uint32_t length = store->length;
+		uint8_t* active = store->ticking;
+
+		// entities in chunks that don't tick entities are left alone, only simulated ones are moved
+		for (uint32_t i = 0; i < length; ++i) {
+			active[i] = ticking[store->chunk[i]];
+			store->collided[i] = 0;
+		}
+
+		for (uint32_t i = 0; i < length; ++i) {
+			if (active[i] && store->y[i] <= void_y) {
+				utl_vector_push(in_void, &store->entities[i]);
+			}
+		}
+
+		for (uint32_t i = 0; i < length; ++i) {
+			active[i] = active[i] && (store->flags[i] & ent_store_simulated);
+		}
+
+		ent_store_foreach_pair_l(store, ent_store_push_apart, active);
+
+		if (region != NULL) {
+			ent_store_collide_l(store, region, active);
+		}
+
+		ent_store_integrate(length, active, store->x, store->velocity_x);
+		ent_store_integrate(length, active, store->y, store->velocity_y);
+		ent_store_integrate(length, active, store->z, store->velocity_z);
+
+		for (uint32_t i = 0; i < length; ++i) {
+			if (active[i] && (store->velocity_x[i] != 0 || store->velocity_y[i] != 0 || store->velocity_z[i] != 0 || (store->flags[i] & ent_store_behind))) {
+				const ent_store_move_t move = {
+					.entity = store->entities[i],
+					.x = store->x[i],
+					.y = store->y[i],
+					.z = store->z[i],
+					.on_ground = store->flags[i] & ent_store_on_ground,
+					.behind = store->flags[i] & ent_store_behind
+				};
+				utl_vector_push(moved, &move);
+				ent_store_relink_l(store, i);
+			}
+		}
+
+		// entities that ran into a block stop moving that way
+		ent_store_stop(length, store->collided, ent_collision_x, store->velocity_x);
+		ent_store_stop(length, store->collided, ent_collision_y, store->velocity_y);
+		ent_store_stop(length, store->collided, ent_collision_z, store->velocity_z);
+
+		ent_store_apply_gravity(length, active, store->flags, store->velocity_y);
+		ent_store_apply_friction(length, active, store->flags, store->velocity_x);
+		ent_store_apply_friction(length, active, store->flags, store->velocity_z);
+
+	}
+
+}
+
+void ent_term_store(ent_store_t* store) {
+
+	// entities left in the store are taken out of it, so they don't point at the freed arrays
+	for (uint32_t i = 0; i < store->length; ++i) {
+		store->entities[i]->store = NULL;
+	}
+
+	free(store->entities);
+	free(store->chunk);
+	free(store->flags);
+	free(store->x);
+	free(store->y);
+	free(store->z);
+	free(store->velocity_x);
+	free(store->velocity_y);
+	free(store->velocity_z);
+	free(store->width);
+	free(store->height);
+	free(store->ticking);
+	free(store->collided);
+	free(store->cell);
+	free(store->cell_next);
+	free(store->cell_previous);
+
+	pthread_mutex_destroy(&store->lock);
+
+}
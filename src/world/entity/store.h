@@ -0,0 +1,153 @@
+#pragma once
+#include <pthread.h>
+#include "entity.d.h"
+#include "../world.d.h"
+#include "../../main.h"
+#include "../../util/vector.h"
+
+#define ENT_STORE_MIN_CAPACITY 16
+#define ENT_STORE_CELL_BITS 3 // cells of the grid are 8 by 8 blocks, as high as the world
+#define ENT_STORE_GRID_SIZE (512 >> ENT_STORE_CELL_BITS) // cells along each side of a region
+#define ENT_STORE_NONE UINT32_MAX // end of the entities in a cell
+
+#define ENT_GRAVITY 0.08 // blocks per tick taken from the vertical velocity of falling entities
+#define ENT_DRAG 0.98 // part of the vertical velocity kept every tick
+#define ENT_AIR_FRICTION 0.91 // part of the horizontal velocity kept every tick in the air
+#define ENT_GROUND_FRICTION 0.546 // part of the horizontal velocity kept every tick on the ground
+#define ENT_PUSH 0.05 // velocity entities that overlap push each other apart with
+#define ENT_MIN_VELOCITY 0.003 // horizontal velocity below this is stopped after friction, so entities come to rest
+
+typedef enum {
+
+	ent_store_simulated = 1 << 0, // moved by the server, players move themselves
+	ent_store_gravity = 1 << 1,
+	ent_store_on_ground = 1 << 2,
+	ent_store_living = 1 << 3,
+	ent_store_player = 1 << 4,
+	ent_store_behind = 1 << 5 // a viewer missed some movement, the entity is given by the tick even when it doesn't move
+
+} ent_store_flag_t;
+
+/*
+ * The state the tick needs of every entity in a region, each in its own array
+ *
+ * The tick goes over the arrays one at a time instead of over the entities, the index of an entity
+ * changes when another one is removed, the moving entity is put in its place
+ *
+ * Entities are also kept in a grid of cells by their position, so finding the ones in an area
+ * only looks at the cells around it
+ */
+typedef struct {
+
+	pthread_mutex_t lock;
+
+	// first block of the region
+	int32_t origin_x;
+	int32_t origin_z;
+
+	uint32_t length;
+	uint32_t capacity;
+
+	ent_entity_t** entities;
+
+	// index of the chunk in the region
+	uint16_t* chunk;
+	uint8_t* flags;
+
+	float64_t* x;
+	float64_t* y;
+	float64_t* z;
+
+	float64_t* velocity_x;
+	float64_t* velocity_y;
+	float64_t* velocity_z;
+
+	// bounding box around the position, at the bottom in the middle
+	float32_t* width;
+	float32_t* height;
+
+	// whether the chunk of the entity ticks entities, only used while ticking
+	uint8_t* ticking;
+
+	// the axes the entity ran into blocks on (ent_collision_t), only used while ticking
+	uint8_t* collided;
+
+	// the first entity in every cell, the rest are linked through the indexes
+	uint32_t cells[ENT_STORE_GRID_SIZE * ENT_STORE_GRID_SIZE];
+	uint32_t* cell;
+	uint32_t* cell_next;
+	uint32_t* cell_previous;
+
+	// the biggest entity the store has had, areas are searched that much further
+	float32_t max_width;
+	float32_t max_height;
+
+} ent_store_t;
+
+// where the tick moved an entity to
+typedef struct {
+
+	ent_entity_t* entity;
+
+	float64_t x;
+	float64_t y;
+	float64_t z;
+
+	bool on_ground;
+	bool behind;
+
+} ent_store_move_t;
+
+// two entities whose boxes overlap
+typedef struct {
+
+	ent_entity_t* a;
+	ent_entity_t* b;
+
+} ent_store_pair_t;
+
+// x and z are the first block of the region
+extern void ent_init_store(ent_store_t* store, int32_t x, int32_t z);
+
+extern void ent_store_add(ent_store_t* store, ent_entity_t* entity, uint16_t chunk);
+extern void ent_store_remove(ent_entity_t* entity);
+
+// puts the entity in the store of the region of the chunk, or only updates its chunk when it's already in it
+extern void ent_store_set_chunk(ent_entity_t* entity, wld_chunk_t* chunk);
+
+// copies the position of the entity into the store, after it moved
+extern void ent_store_update(ent_entity_t* entity);
+
+extern void ent_store_set_velocity(ent_entity_t* entity, float64_t x, float64_t y, float64_t z);
+
+// whether a viewer of the entity missed some movement
+extern void ent_store_set_behind(ent_entity_t* entity, bool behind);
+
+// adds the entities whose boxes overlap the box to found (ent_entity_t*)
+extern void ent_store_get_in_box(ent_store_t* store, float64_t min_x, float64_t min_y, float64_t min_z, float64_t max_x, float64_t max_y, float64_t max_z, utl_vector_t* found);
+
+// adds the entities whose boxes are within the radius of the point to found (ent_entity_t*)
+extern void ent_store_get_in_radius(ent_store_t* store, float64_t x, float64_t y, float64_t z, float64_t radius, utl_vector_t* found);
+
+// the player closest to the point within the radius, NULL if there's none
+extern ent_entity_t* ent_store_get_nearest_player(ent_store_t* store, float64_t x, float64_t y, float64_t z, float64_t radius);
+
+// adds every two entities whose boxes overlap to pairs (ent_store_pair_t), each pair once
+extern void ent_store_get_pairs(ent_store_t* store, utl_vector_t* pairs);
+
+// the same as the store ones, for every region the area is in
+extern void ent_get_in_box(wld_world_t* world, float64_t min_x, float64_t min_y, float64_t min_z, float64_t max_x, float64_t max_y, float64_t max_z, utl_vector_t* found);
+extern void ent_get_in_radius(wld_world_t* world, float64_t x, float64_t y, float64_t z, float64_t radius, utl_vector_t* found);
+extern ent_entity_t* ent_get_nearest_player(wld_world_t* world, float64_t x, float64_t y, float64_t z, float64_t radius);
+
+/*
+ * Pushes apart entities that overlap, moves the entities in ticking chunks by their velocity, then applies gravity and drag
+ * entities are stopped at the blocks of the region, the blocks are left out if region is NULL
+ *
+ * Entities that moved are put in moved (ent_store_move_t), with the ones that are behind, entities at or below void_y
+ * in in_void (ent_entity_t*), nothing is done to them while the store is locked
+ */
+extern void ent_store_tick(ent_store_t* store, wld_region_t* region, const bool ticking[32 * 32], float64_t void_y, utl_vector_t* moved, utl_vector_t* in_void);
+
+// entities still in the store are left without one, their velocity and flags are lost
+extern void ent_term_store(ent_store_t* store);
@@ -0,0 +1,64 @@
+#pragma once
+#include "../../main.h"
+#include "../../util/util.h"
+#include "../../util/bit_vector.h"
+
+#define ENT_TRACKER_NEAR 32 // blocks within which viewers are sent every movement
+#define ENT_TRACKER_MID 64 // blocks within which viewers are sent movement every 2 ticks
+#define ENT_TRACKER_FAR 96 // blocks within which viewers are sent movement every 4 ticks
+#define ENT_TRACKER_EDGE_INTERVAL 20 // ticks between movement sent to viewers further away
+
+/*
+ * Which viewers of an entity have been sent where it is
+ *
+ * Viewers further away are sent movement less often, one that misses some is marked behind and is sent
+ * where the entity is the next time it's due, only used by the job applying the movement of the entity
+ * and the tick of its region, which run in different phases
+ */
+typedef struct {
+
+	utl_bit_vector_t behind;
+
+} ent_tracker_t;
+
+static inline void ent_init_tracker(ent_tracker_t* tracker) {
+	utl_init_bit_vector(&tracker->behind);
+}
+
+// the ticks between movement sent to a viewer this far away (squared, in blocks)
+static inline uint32_t ent_tracker_get_interval(float64_t distance_squared) {
+
+	if (distance_squared < ENT_TRACKER_NEAR * ENT_TRACKER_NEAR) {
+		return 1;
+	} else if (distance_squared < ENT_TRACKER_MID * ENT_TRACKER_MID) {
+		return 2;
+	} else if (distance_squared < ENT_TRACKER_FAR * ENT_TRACKER_FAR) {
+		return 4;
+	}
+
+	return ENT_TRACKER_EDGE_INTERVAL;
+
+}
+
+// viewers with the same interval are spread over its ticks, so they aren't all sent movement in the same one
+static inline bool ent_tracker_is_due(uint32_t entity_id, uint32_t viewer_id, uint32_t interval, uint64_t tick) {
+	return tick % interval == (entity_id + viewer_id) % interval;
+}
+
+static inline bool ent_tracker_is_behind(ent_tracker_t* tracker, uint32_t viewer_id) {
+	return utl_bit_vector_test_bit(&tracker->behind, viewer_id);
+}
+
+static inline void ent_tracker_set_behind(ent_tracker_t* tracker, uint32_t viewer_id, bool behind) {
+
+	if (behind) {
+		utl_bit_vector_set_bit(&tracker->behind, viewer_id);
+	} else if (ent_tracker_is_behind(tracker, viewer_id)) {
+		utl_bit_vector_reset_bit(&tracker->behind, viewer_id);
+	}
+
+}
+
+static inline void ent_term_tracker(ent_tracker_t* tracker) {
+	utl_term_bit_vector(&tracker->behind);
+}
@@ -1,4 +1,6 @@
+#include <string.h>
 #include "blocks.h"
+#include "../../util/str_util.h"
 
 const mat_block_t mat_block_air_d = {
 	.resistance = 0,
@@ -11692,3 +11694,922 @@ const mat_block_t* mat_blocks[] = {
 	&mat_block_potted_azalea_bush_d,
 	&mat_block_potted_flowering_azalea_bush_d,
 };
+
+const string_t mat_blocks_name[] = {
+	UTL_CSTRTOSTR("minecraft:air"),
+	UTL_CSTRTOSTR("minecraft:stone"),
+	UTL_CSTRTOSTR("minecraft:granite"),
+	UTL_CSTRTOSTR("minecraft:polished_granite"),
+	UTL_CSTRTOSTR("minecraft:diorite"),
+	UTL_CSTRTOSTR("minecraft:polished_diorite"),
+	UTL_CSTRTOSTR("minecraft:andesite"),
+	UTL_CSTRTOSTR("minecraft:polished_andesite"),
+	UTL_CSTRTOSTR("minecraft:grass_block"),
+	UTL_CSTRTOSTR("minecraft:dirt"),
+	UTL_CSTRTOSTR("minecraft:coarse_dirt"),
+	UTL_CSTRTOSTR("minecraft:podzol"),
+	UTL_CSTRTOSTR("minecraft:cobblestone"),
+	UTL_CSTRTOSTR("minecraft:oak_planks"),
+	UTL_CSTRTOSTR("minecraft:spruce_planks"),
+	UTL_CSTRTOSTR("minecraft:birch_planks"),
+	UTL_CSTRTOSTR("minecraft:jungle_planks"),
+	UTL_CSTRTOSTR("minecraft:acacia_planks"),
+	UTL_CSTRTOSTR("minecraft:dark_oak_planks"),
+	UTL_CSTRTOSTR("minecraft:oak_sapling"),
+	UTL_CSTRTOSTR("minecraft:spruce_sapling"),
+	UTL_CSTRTOSTR("minecraft:birch_sapling"),
+	UTL_CSTRTOSTR("minecraft:jungle_sapling"),
+	UTL_CSTRTOSTR("minecraft:acacia_sapling"),
+	UTL_CSTRTOSTR("minecraft:dark_oak_sapling"),
+	UTL_CSTRTOSTR("minecraft:bedrock"),
+	UTL_CSTRTOSTR("minecraft:water"),
+	UTL_CSTRTOSTR("minecraft:lava"),
+	UTL_CSTRTOSTR("minecraft:sand"),
+	UTL_CSTRTOSTR("minecraft:red_sand"),
+	UTL_CSTRTOSTR("minecraft:gravel"),
+	UTL_CSTRTOSTR("minecraft:gold_ore"),
+	UTL_CSTRTOSTR("minecraft:deepslate_gold_ore"),
+	UTL_CSTRTOSTR("minecraft:iron_ore"),
+	UTL_CSTRTOSTR("minecraft:deepslate_iron_ore"),
+	UTL_CSTRTOSTR("minecraft:coal_ore"),
+	UTL_CSTRTOSTR("minecraft:deepslate_coal_ore"),
+	UTL_CSTRTOSTR("minecraft:nether_gold_ore"),
+	UTL_CSTRTOSTR("minecraft:oak_log"),
+	UTL_CSTRTOSTR("minecraft:spruce_log"),
+	UTL_CSTRTOSTR("minecraft:birch_log"),
+	UTL_CSTRTOSTR("minecraft:jungle_log"),
+	UTL_CSTRTOSTR("minecraft:acacia_log"),
+	UTL_CSTRTOSTR("minecraft:dark_oak_log"),
+	UTL_CSTRTOSTR("minecraft:stripped_spruce_log"),
+	UTL_CSTRTOSTR("minecraft:stripped_birch_log"),
+	UTL_CSTRTOSTR("minecraft:stripped_jungle_log"),
+	UTL_CSTRTOSTR("minecraft:stripped_acacia_log"),
+	UTL_CSTRTOSTR("minecraft:stripped_dark_oak_log"),
+	UTL_CSTRTOSTR("minecraft:stripped_oak_log"),
+	UTL_CSTRTOSTR("minecraft:oak_wood"),
+	UTL_CSTRTOSTR("minecraft:spruce_wood"),
+	UTL_CSTRTOSTR("minecraft:birch_wood"),
+	UTL_CSTRTOSTR("minecraft:jungle_wood"),
+	UTL_CSTRTOSTR("minecraft:acacia_wood"),
+	UTL_CSTRTOSTR("minecraft:dark_oak_wood"),
+	UTL_CSTRTOSTR("minecraft:stripped_oak_wood"),
+	UTL_CSTRTOSTR("minecraft:stripped_spruce_wood"),
+	UTL_CSTRTOSTR("minecraft:stripped_birch_wood"),
+	UTL_CSTRTOSTR("minecraft:stripped_jungle_wood"),
+	UTL_CSTRTOSTR("minecraft:stripped_acacia_wood"),
+	UTL_CSTRTOSTR("minecraft:stripped_dark_oak_wood"),
+	UTL_CSTRTOSTR("minecraft:oak_leaves"),
+	UTL_CSTRTOSTR("minecraft:spruce_leaves"),
+	UTL_CSTRTOSTR("minecraft:birch_leaves"),
+	UTL_CSTRTOSTR("minecraft:jungle_leaves"),
+	UTL_CSTRTOSTR("minecraft:acacia_leaves"),
+	UTL_CSTRTOSTR("minecraft:dark_oak_leaves"),
+	UTL_CSTRTOSTR("minecraft:azalea_leaves"),
+	UTL_CSTRTOSTR("minecraft:flowering_azalea_leaves"),
+	UTL_CSTRTOSTR("minecraft:sponge"),
+	UTL_CSTRTOSTR("minecraft:wet_sponge"),
+	UTL_CSTRTOSTR("minecraft:glass"),
+	UTL_CSTRTOSTR("minecraft:lapis_ore"),
+	UTL_CSTRTOSTR("minecraft:deepslate_lapis_ore"),
+	UTL_CSTRTOSTR("minecraft:lapis_block"),
+	UTL_CSTRTOSTR("minecraft:dispenser"),
+	UTL_CSTRTOSTR("minecraft:sandstone"),
+	UTL_CSTRTOSTR("minecraft:chiseled_sandstone"),
+	UTL_CSTRTOSTR("minecraft:cut_sandstone"),
+	UTL_CSTRTOSTR("minecraft:note_block"),
+	UTL_CSTRTOSTR("minecraft:white_bed"),
+	UTL_CSTRTOSTR("minecraft:orange_bed"),
+	UTL_CSTRTOSTR("minecraft:magenta_bed"),
+	UTL_CSTRTOSTR("minecraft:light_blue_bed"),
+	UTL_CSTRTOSTR("minecraft:yellow_bed"),
+	UTL_CSTRTOSTR("minecraft:lime_bed"),
+	UTL_CSTRTOSTR("minecraft:pink_bed"),
+	UTL_CSTRTOSTR("minecraft:gray_bed"),
+	UTL_CSTRTOSTR("minecraft:light_gray_bed"),
+	UTL_CSTRTOSTR("minecraft:cyan_bed"),
+	UTL_CSTRTOSTR("minecraft:purple_bed"),
+	UTL_CSTRTOSTR("minecraft:blue_bed"),
+	UTL_CSTRTOSTR("minecraft:brown_bed"),
+	UTL_CSTRTOSTR("minecraft:green_bed"),
+	UTL_CSTRTOSTR("minecraft:red_bed"),
+	UTL_CSTRTOSTR("minecraft:black_bed"),
+	UTL_CSTRTOSTR("minecraft:powered_rail"),
+	UTL_CSTRTOSTR("minecraft:detector_rail"),
+	UTL_CSTRTOSTR("minecraft:sticky_piston"),
+	UTL_CSTRTOSTR("minecraft:cobweb"),
+	UTL_CSTRTOSTR("minecraft:grass"),
+	UTL_CSTRTOSTR("minecraft:fern"),
+	UTL_CSTRTOSTR("minecraft:dead_bush"),
+	UTL_CSTRTOSTR("minecraft:seagrass"),
+	UTL_CSTRTOSTR("minecraft:tall_seagrass"),
+	UTL_CSTRTOSTR("minecraft:piston"),
+	UTL_CSTRTOSTR("minecraft:piston_head"),
+	UTL_CSTRTOSTR("minecraft:white_wool"),
+	UTL_CSTRTOSTR("minecraft:orange_wool"),
+	UTL_CSTRTOSTR("minecraft:magenta_wool"),
+	UTL_CSTRTOSTR("minecraft:light_blue_wool"),
+	UTL_CSTRTOSTR("minecraft:yellow_wool"),
+	UTL_CSTRTOSTR("minecraft:lime_wool"),
+	UTL_CSTRTOSTR("minecraft:pink_wool"),
+	UTL_CSTRTOSTR("minecraft:gray_wool"),
+	UTL_CSTRTOSTR("minecraft:light_gray_wool"),
+	UTL_CSTRTOSTR("minecraft:cyan_wool"),
+	UTL_CSTRTOSTR("minecraft:purple_wool"),
+	UTL_CSTRTOSTR("minecraft:blue_wool"),
+	UTL_CSTRTOSTR("minecraft:brown_wool"),
+	UTL_CSTRTOSTR("minecraft:green_wool"),
+	UTL_CSTRTOSTR("minecraft:red_wool"),
+	UTL_CSTRTOSTR("minecraft:black_wool"),
+	UTL_CSTRTOSTR("minecraft:moving_piston"),
+	UTL_CSTRTOSTR("minecraft:dandelion"),
+	UTL_CSTRTOSTR("minecraft:poppy"),
+	UTL_CSTRTOSTR("minecraft:blue_orchid"),
+	UTL_CSTRTOSTR("minecraft:allium"),
+	UTL_CSTRTOSTR("minecraft:azure_bluet"),
+	UTL_CSTRTOSTR("minecraft:red_tulip"),
+	UTL_CSTRTOSTR("minecraft:orange_tulip"),
+	UTL_CSTRTOSTR("minecraft:white_tulip"),
+	UTL_CSTRTOSTR("minecraft:pink_tulip"),
+	UTL_CSTRTOSTR("minecraft:oxeye_daisy"),
+	UTL_CSTRTOSTR("minecraft:cornflower"),
+	UTL_CSTRTOSTR("minecraft:wither_rose"),
+	UTL_CSTRTOSTR("minecraft:lily_of_the_valley"),
+	UTL_CSTRTOSTR("minecraft:brown_mushroom"),
+	UTL_CSTRTOSTR("minecraft:red_mushroom"),
+	UTL_CSTRTOSTR("minecraft:gold_block"),
+	UTL_CSTRTOSTR("minecraft:iron_block"),
+	UTL_CSTRTOSTR("minecraft:bricks"),
+	UTL_CSTRTOSTR("minecraft:tnt"),
+	UTL_CSTRTOSTR("minecraft:bookshelf"),
+	UTL_CSTRTOSTR("minecraft:mossy_cobblestone"),
+	UTL_CSTRTOSTR("minecraft:obsidian"),
+	UTL_CSTRTOSTR("minecraft:torch"),
+	UTL_CSTRTOSTR("minecraft:wall_torch"),
+	UTL_CSTRTOSTR("minecraft:fire"),
+	UTL_CSTRTOSTR("minecraft:soul_fire"),
+	UTL_CSTRTOSTR("minecraft:spawner"),
+	UTL_CSTRTOSTR("minecraft:oak_stairs"),
+	UTL_CSTRTOSTR("minecraft:chest"),
+	UTL_CSTRTOSTR("minecraft:redstone_wire"),
+	UTL_CSTRTOSTR("minecraft:diamond_ore"),
+	UTL_CSTRTOSTR("minecraft:deepslate_diamond_ore"),
+	UTL_CSTRTOSTR("minecraft:diamond_block"),
+	UTL_CSTRTOSTR("minecraft:crafting_table"),
+	UTL_CSTRTOSTR("minecraft:wheat"),
+	UTL_CSTRTOSTR("minecraft:farmland"),
+	UTL_CSTRTOSTR("minecraft:furnace"),
+	UTL_CSTRTOSTR("minecraft:oak_sign"),
+	UTL_CSTRTOSTR("minecraft:spruce_sign"),
+	UTL_CSTRTOSTR("minecraft:birch_sign"),
+	UTL_CSTRTOSTR("minecraft:acacia_sign"),
+	UTL_CSTRTOSTR("minecraft:jungle_sign"),
+	UTL_CSTRTOSTR("minecraft:dark_oak_sign"),
+	UTL_CSTRTOSTR("minecraft:oak_door"),
+	UTL_CSTRTOSTR("minecraft:ladder"),
+	UTL_CSTRTOSTR("minecraft:rail"),
+	UTL_CSTRTOSTR("minecraft:cobblestone_stairs"),
+	UTL_CSTRTOSTR("minecraft:oak_wall_sign"),
+	UTL_CSTRTOSTR("minecraft:spruce_wall_sign"),
+	UTL_CSTRTOSTR("minecraft:birch_wall_sign"),
+	UTL_CSTRTOSTR("minecraft:acacia_wall_sign"),
+	UTL_CSTRTOSTR("minecraft:jungle_wall_sign"),
+	UTL_CSTRTOSTR("minecraft:dark_oak_wall_sign"),
+	UTL_CSTRTOSTR("minecraft:lever"),
+	UTL_CSTRTOSTR("minecraft:stone_pressure_plate"),
+	UTL_CSTRTOSTR("minecraft:iron_door"),
+	UTL_CSTRTOSTR("minecraft:oak_pressure_plate"),
+	UTL_CSTRTOSTR("minecraft:spruce_pressure_plate"),
+	UTL_CSTRTOSTR("minecraft:birch_pressure_plate"),
+	UTL_CSTRTOSTR("minecraft:jungle_pressure_plate"),
+	UTL_CSTRTOSTR("minecraft:acacia_pressure_plate"),
+	UTL_CSTRTOSTR("minecraft:dark_oak_pressure_plate"),
+	UTL_CSTRTOSTR("minecraft:redstone_ore"),
+	UTL_CSTRTOSTR("minecraft:deepslate_redstone_ore"),
+	UTL_CSTRTOSTR("minecraft:redstone_torch"),
+	UTL_CSTRTOSTR("minecraft:redstone_wall_torch"),
+	UTL_CSTRTOSTR("minecraft:stone_button"),
+	UTL_CSTRTOSTR("minecraft:snow"),
+	UTL_CSTRTOSTR("minecraft:ice"),
+	UTL_CSTRTOSTR("minecraft:snow_block"),
+	UTL_CSTRTOSTR("minecraft:cactus"),
+	UTL_CSTRTOSTR("minecraft:clay"),
+	UTL_CSTRTOSTR("minecraft:sugar_cane"),
+	UTL_CSTRTOSTR("minecraft:jukebox"),
+	UTL_CSTRTOSTR("minecraft:oak_fence"),
+	UTL_CSTRTOSTR("minecraft:pumpkin"),
+	UTL_CSTRTOSTR("minecraft:netherrack"),
+	UTL_CSTRTOSTR("minecraft:soul_sand"),
+	UTL_CSTRTOSTR("minecraft:soul_soil"),
+	UTL_CSTRTOSTR("minecraft:basalt"),
+	UTL_CSTRTOSTR("minecraft:polished_basalt"),
+	UTL_CSTRTOSTR("minecraft:soul_torch"),
+	UTL_CSTRTOSTR("minecraft:soul_wall_torch"),
+	UTL_CSTRTOSTR("minecraft:glowstone"),
+	UTL_CSTRTOSTR("minecraft:nether_portal"),
+	UTL_CSTRTOSTR("minecraft:carved_pumpkin"),
+	UTL_CSTRTOSTR("minecraft:jack_o_lantern"),
+	UTL_CSTRTOSTR("minecraft:cake"),
+	UTL_CSTRTOSTR("minecraft:repeater"),
+	UTL_CSTRTOSTR("minecraft:white_stained_glass"),
+	UTL_CSTRTOSTR("minecraft:orange_stained_glass"),
+	UTL_CSTRTOSTR("minecraft:magenta_stained_glass"),
+	UTL_CSTRTOSTR("minecraft:light_blue_stained_glass"),
+	UTL_CSTRTOSTR("minecraft:yellow_stained_glass"),
+	UTL_CSTRTOSTR("minecraft:lime_stained_glass"),
+	UTL_CSTRTOSTR("minecraft:pink_stained_glass"),
+	UTL_CSTRTOSTR("minecraft:gray_stained_glass"),
+	UTL_CSTRTOSTR("minecraft:light_gray_stained_glass"),
+	UTL_CSTRTOSTR("minecraft:cyan_stained_glass"),
+	UTL_CSTRTOSTR("minecraft:purple_stained_glass"),
+	UTL_CSTRTOSTR("minecraft:blue_stained_glass"),
+	UTL_CSTRTOSTR("minecraft:brown_stained_glass"),
+	UTL_CSTRTOSTR("minecraft:green_stained_glass"),
+	UTL_CSTRTOSTR("minecraft:red_stained_glass"),
+	UTL_CSTRTOSTR("minecraft:black_stained_glass"),
+	UTL_CSTRTOSTR("minecraft:oak_trapdoor"),
+	UTL_CSTRTOSTR("minecraft:spruce_trapdoor"),
+	UTL_CSTRTOSTR("minecraft:birch_trapdoor"),
+	UTL_CSTRTOSTR("minecraft:jungle_trapdoor"),
+	UTL_CSTRTOSTR("minecraft:acacia_trapdoor"),
+	UTL_CSTRTOSTR("minecraft:dark_oak_trapdoor"),
+	UTL_CSTRTOSTR("minecraft:stone_bricks"),
+	UTL_CSTRTOSTR("minecraft:mossy_stone_bricks"),
+	UTL_CSTRTOSTR("minecraft:cracked_stone_bricks"),
+	UTL_CSTRTOSTR("minecraft:chiseled_stone_bricks"),
+	UTL_CSTRTOSTR("minecraft:infested_stone"),
+	UTL_CSTRTOSTR("minecraft:infested_cobblestone"),
+	UTL_CSTRTOSTR("minecraft:infested_stone_bricks"),
+	UTL_CSTRTOSTR("minecraft:infested_mossy_stone_bricks"),
+	UTL_CSTRTOSTR("minecraft:infested_cracked_stone_bricks"),
+	UTL_CSTRTOSTR("minecraft:infested_chiseled_stone_bricks"),
+	UTL_CSTRTOSTR("minecraft:brown_mushroom_block"),
+	UTL_CSTRTOSTR("minecraft:red_mushroom_block"),
+	UTL_CSTRTOSTR("minecraft:mushroom_stem"),
+	UTL_CSTRTOSTR("minecraft:iron_bars"),
+	UTL_CSTRTOSTR("minecraft:chain"),
+	UTL_CSTRTOSTR("minecraft:glass_pane"),
+	UTL_CSTRTOSTR("minecraft:melon"),
+	UTL_CSTRTOSTR("minecraft:attached_pumpkin_stem"),
+	UTL_CSTRTOSTR("minecraft:attached_melon_stem"),
+	UTL_CSTRTOSTR("minecraft:pumpkin_stem"),
+	UTL_CSTRTOSTR("minecraft:melon_stem"),
+	UTL_CSTRTOSTR("minecraft:vine"),
+	UTL_CSTRTOSTR("minecraft:glow_lichen"),
+	UTL_CSTRTOSTR("minecraft:oak_fence_gate"),
+	UTL_CSTRTOSTR("minecraft:brick_stairs"),
+	UTL_CSTRTOSTR("minecraft:stone_brick_stairs"),
+	UTL_CSTRTOSTR("minecraft:mycelium"),
+	UTL_CSTRTOSTR("minecraft:lily_pad"),
+	UTL_CSTRTOSTR("minecraft:nether_bricks"),
+	UTL_CSTRTOSTR("minecraft:nether_brick_fence"),
+	UTL_CSTRTOSTR("minecraft:nether_brick_stairs"),
+	UTL_CSTRTOSTR("minecraft:nether_wart"),
+	UTL_CSTRTOSTR("minecraft:enchanting_table"),
+	UTL_CSTRTOSTR("minecraft:brewing_stand"),
+	UTL_CSTRTOSTR("minecraft:cauldron"),
+	UTL_CSTRTOSTR("minecraft:water_cauldron"),
+	UTL_CSTRTOSTR("minecraft:lava_cauldron"),
+	UTL_CSTRTOSTR("minecraft:powder_snow_cauldron"),
+	UTL_CSTRTOSTR("minecraft:end_portal"),
+	UTL_CSTRTOSTR("minecraft:end_portal_frame"),
+	UTL_CSTRTOSTR("minecraft:end_stone"),
+	UTL_CSTRTOSTR("minecraft:dragon_egg"),
+	UTL_CSTRTOSTR("minecraft:redstone_lamp"),
+	UTL_CSTRTOSTR("minecraft:cocoa"),
+	UTL_CSTRTOSTR("minecraft:sandstone_stairs"),
+	UTL_CSTRTOSTR("minecraft:emerald_ore"),
+	UTL_CSTRTOSTR("minecraft:deepslate_emerald_ore"),
+	UTL_CSTRTOSTR("minecraft:ender_chest"),
+	UTL_CSTRTOSTR("minecraft:tripwire_hook"),
+	UTL_CSTRTOSTR("minecraft:tripwire"),
+	UTL_CSTRTOSTR("minecraft:emerald_block"),
+	UTL_CSTRTOSTR("minecraft:spruce_stairs"),
+	UTL_CSTRTOSTR("minecraft:birch_stairs"),
+	UTL_CSTRTOSTR("minecraft:jungle_stairs"),
+	UTL_CSTRTOSTR("minecraft:command_block"),
+	UTL_CSTRTOSTR("minecraft:beacon"),
+	UTL_CSTRTOSTR("minecraft:cobblestone_wall"),
+	UTL_CSTRTOSTR("minecraft:mossy_cobblestone_wall"),
+	UTL_CSTRTOSTR("minecraft:flower_pot"),
+	UTL_CSTRTOSTR("minecraft:potted_oak_sapling"),
+	UTL_CSTRTOSTR("minecraft:potted_spruce_sapling"),
+	UTL_CSTRTOSTR("minecraft:potted_birch_sapling"),
+	UTL_CSTRTOSTR("minecraft:potted_jungle_sapling"),
+	UTL_CSTRTOSTR("minecraft:potted_acacia_sapling"),
+	UTL_CSTRTOSTR("minecraft:potted_dark_oak_sapling"),
+	UTL_CSTRTOSTR("minecraft:potted_fern"),
+	UTL_CSTRTOSTR("minecraft:potted_dandelion"),
+	UTL_CSTRTOSTR("minecraft:potted_poppy"),
+	UTL_CSTRTOSTR("minecraft:potted_blue_orchid"),
+	UTL_CSTRTOSTR("minecraft:potted_allium"),
+	UTL_CSTRTOSTR("minecraft:potted_azure_bluet"),
+	UTL_CSTRTOSTR("minecraft:potted_red_tulip"),
+	UTL_CSTRTOSTR("minecraft:potted_orange_tulip"),
+	UTL_CSTRTOSTR("minecraft:potted_white_tulip"),
+	UTL_CSTRTOSTR("minecraft:potted_pink_tulip"),
+	UTL_CSTRTOSTR("minecraft:potted_oxeye_daisy"),
+	UTL_CSTRTOSTR("minecraft:potted_cornflower"),
+	UTL_CSTRTOSTR("minecraft:potted_lily_of_the_valley"),
+	UTL_CSTRTOSTR("minecraft:potted_wither_rose"),
+	UTL_CSTRTOSTR("minecraft:potted_red_mushroom"),
+	UTL_CSTRTOSTR("minecraft:potted_brown_mushroom"),
+	UTL_CSTRTOSTR("minecraft:potted_dead_bush"),
+	UTL_CSTRTOSTR("minecraft:potted_cactus"),
+	UTL_CSTRTOSTR("minecraft:carrots"),
+	UTL_CSTRTOSTR("minecraft:potatoes"),
+	UTL_CSTRTOSTR("minecraft:oak_button"),
+	UTL_CSTRTOSTR("minecraft:spruce_button"),
+	UTL_CSTRTOSTR("minecraft:birch_button"),
+	UTL_CSTRTOSTR("minecraft:jungle_button"),
+	UTL_CSTRTOSTR("minecraft:acacia_button"),
+	UTL_CSTRTOSTR("minecraft:dark_oak_button"),
+	UTL_CSTRTOSTR("minecraft:skeleton_skull"),
+	UTL_CSTRTOSTR("minecraft:skeleton_wall_skull"),
+	UTL_CSTRTOSTR("minecraft:wither_skeleton_skull"),
+	UTL_CSTRTOSTR("minecraft:wither_skeleton_wall_skull"),
+	UTL_CSTRTOSTR("minecraft:zombie_head"),
+	UTL_CSTRTOSTR("minecraft:zombie_wall_head"),
+	UTL_CSTRTOSTR("minecraft:player_head"),
+	UTL_CSTRTOSTR("minecraft:player_wall_head"),
+	UTL_CSTRTOSTR("minecraft:creeper_head"),
+	UTL_CSTRTOSTR("minecraft:creeper_wall_head"),
+	UTL_CSTRTOSTR("minecraft:dragon_head"),
+	UTL_CSTRTOSTR("minecraft:dragon_wall_head"),
+	UTL_CSTRTOSTR("minecraft:anvil"),
+	UTL_CSTRTOSTR("minecraft:chipped_anvil"),
+	UTL_CSTRTOSTR("minecraft:damaged_anvil"),
+	UTL_CSTRTOSTR("minecraft:trapped_chest"),
+	UTL_CSTRTOSTR("minecraft:light_weighted_pressure_plate"),
+	UTL_CSTRTOSTR("minecraft:heavy_weighted_pressure_plate"),
+	UTL_CSTRTOSTR("minecraft:comparator"),
+	UTL_CSTRTOSTR("minecraft:daylight_detector"),
+	UTL_CSTRTOSTR("minecraft:redstone_block"),
+	UTL_CSTRTOSTR("minecraft:nether_quartz_ore"),
+	UTL_CSTRTOSTR("minecraft:hopper"),
+	UTL_CSTRTOSTR("minecraft:quartz_block"),
+	UTL_CSTRTOSTR("minecraft:chiseled_quartz_block"),
+	UTL_CSTRTOSTR("minecraft:quartz_pillar"),
+	UTL_CSTRTOSTR("minecraft:quartz_stairs"),
+	UTL_CSTRTOSTR("minecraft:activator_rail"),
+	UTL_CSTRTOSTR("minecraft:dropper"),
+	UTL_CSTRTOSTR("minecraft:white_terracotta"),
+	UTL_CSTRTOSTR("minecraft:orange_terracotta"),
+	UTL_CSTRTOSTR("minecraft:magenta_terracotta"),
+	UTL_CSTRTOSTR("minecraft:light_blue_terracotta"),
+	UTL_CSTRTOSTR("minecraft:yellow_terracotta"),
+	UTL_CSTRTOSTR("minecraft:lime_terracotta"),
+	UTL_CSTRTOSTR("minecraft:pink_terracotta"),
+	UTL_CSTRTOSTR("minecraft:gray_terracotta"),
+	UTL_CSTRTOSTR("minecraft:light_gray_terracotta"),
+	UTL_CSTRTOSTR("minecraft:cyan_terracotta"),
+	UTL_CSTRTOSTR("minecraft:purple_terracotta"),
+	UTL_CSTRTOSTR("minecraft:blue_terracotta"),
+	UTL_CSTRTOSTR("minecraft:brown_terracotta"),
+	UTL_CSTRTOSTR("minecraft:green_terracotta"),
+	UTL_CSTRTOSTR("minecraft:red_terracotta"),
+	UTL_CSTRTOSTR("minecraft:black_terracotta"),
+	UTL_CSTRTOSTR("minecraft:white_stained_glass_pane"),
+	UTL_CSTRTOSTR("minecraft:orange_stained_glass_pane"),
+	UTL_CSTRTOSTR("minecraft:magenta_stained_glass_pane"),
+	UTL_CSTRTOSTR("minecraft:light_blue_stained_glass_pane"),
+	UTL_CSTRTOSTR("minecraft:yellow_stained_glass_pane"),
+	UTL_CSTRTOSTR("minecraft:lime_stained_glass_pane"),
+	UTL_CSTRTOSTR("minecraft:pink_stained_glass_pane"),
+	UTL_CSTRTOSTR("minecraft:gray_stained_glass_pane"),
+	UTL_CSTRTOSTR("minecraft:light_gray_stained_glass_pane"),
+	UTL_CSTRTOSTR("minecraft:cyan_stained_glass_pane"),
+	UTL_CSTRTOSTR("minecraft:purple_stained_glass_pane"),
+	UTL_CSTRTOSTR("minecraft:blue_stained_glass_pane"),
+	UTL_CSTRTOSTR("minecraft:brown_stained_glass_pane"),
+	UTL_CSTRTOSTR("minecraft:green_stained_glass_pane"),
+	UTL_CSTRTOSTR("minecraft:red_stained_glass_pane"),
+	UTL_CSTRTOSTR("minecraft:black_stained_glass_pane"),
+	UTL_CSTRTOSTR("minecraft:acacia_stairs"),
+	UTL_CSTRTOSTR("minecraft:dark_oak_stairs"),
+	UTL_CSTRTOSTR("minecraft:slime_block"),
+	UTL_CSTRTOSTR("minecraft:barrier"),
+	UTL_CSTRTOSTR("minecraft:light"),
+	UTL_CSTRTOSTR("minecraft:iron_trapdoor"),
+	UTL_CSTRTOSTR("minecraft:prismarine"),
+	UTL_CSTRTOSTR("minecraft:prismarine_bricks"),
+	UTL_CSTRTOSTR("minecraft:dark_prismarine"),
+	UTL_CSTRTOSTR("minecraft:prismarine_stairs"),
+	UTL_CSTRTOSTR("minecraft:prismarine_brick_stairs"),
+	UTL_CSTRTOSTR("minecraft:dark_prismarine_stairs"),
+	UTL_CSTRTOSTR("minecraft:prismarine_slab"),
+	UTL_CSTRTOSTR("minecraft:prismarine_brick_slab"),
+	UTL_CSTRTOSTR("minecraft:dark_prismarine_slab"),
+	UTL_CSTRTOSTR("minecraft:sea_lantern"),
+	UTL_CSTRTOSTR("minecraft:hay_block"),
+	UTL_CSTRTOSTR("minecraft:white_carpet"),
+	UTL_CSTRTOSTR("minecraft:orange_carpet"),
+	UTL_CSTRTOSTR("minecraft:magenta_carpet"),
+	UTL_CSTRTOSTR("minecraft:light_blue_carpet"),
+	UTL_CSTRTOSTR("minecraft:yellow_carpet"),
+	UTL_CSTRTOSTR("minecraft:lime_carpet"),
+	UTL_CSTRTOSTR("minecraft:pink_carpet"),
+	UTL_CSTRTOSTR("minecraft:gray_carpet"),
+	UTL_CSTRTOSTR("minecraft:light_gray_carpet"),
+	UTL_CSTRTOSTR("minecraft:cyan_carpet"),
+	UTL_CSTRTOSTR("minecraft:purple_carpet"),
+	UTL_CSTRTOSTR("minecraft:blue_carpet"),
+	UTL_CSTRTOSTR("minecraft:brown_carpet"),
+	UTL_CSTRTOSTR("minecraft:green_carpet"),
+	UTL_CSTRTOSTR("minecraft:red_carpet"),
+	UTL_CSTRTOSTR("minecraft:black_carpet"),
+	UTL_CSTRTOSTR("minecraft:terracotta"),
+	UTL_CSTRTOSTR("minecraft:coal_block"),
+	UTL_CSTRTOSTR("minecraft:packed_ice"),
+	UTL_CSTRTOSTR("minecraft:sunflower"),
+	UTL_CSTRTOSTR("minecraft:lilac"),
+	UTL_CSTRTOSTR("minecraft:rose_bush"),
+	UTL_CSTRTOSTR("minecraft:peony"),
+	UTL_CSTRTOSTR("minecraft:tall_grass"),
+	UTL_CSTRTOSTR("minecraft:large_fern"),
+	UTL_CSTRTOSTR("minecraft:white_banner"),
+	UTL_CSTRTOSTR("minecraft:orange_banner"),
+	UTL_CSTRTOSTR("minecraft:magenta_banner"),
+	UTL_CSTRTOSTR("minecraft:light_blue_banner"),
+	UTL_CSTRTOSTR("minecraft:yellow_banner"),
+	UTL_CSTRTOSTR("minecraft:lime_banner"),
+	UTL_CSTRTOSTR("minecraft:pink_banner"),
+	UTL_CSTRTOSTR("minecraft:gray_banner"),
+	UTL_CSTRTOSTR("minecraft:light_gray_banner"),
+	UTL_CSTRTOSTR("minecraft:cyan_banner"),
+	UTL_CSTRTOSTR("minecraft:purple_banner"),
+	UTL_CSTRTOSTR("minecraft:blue_banner"),
+	UTL_CSTRTOSTR("minecraft:brown_banner"),
+	UTL_CSTRTOSTR("minecraft:green_banner"),
+	UTL_CSTRTOSTR("minecraft:red_banner"),
+	UTL_CSTRTOSTR("minecraft:black_banner"),
+	UTL_CSTRTOSTR("minecraft:white_wall_banner"),
+	UTL_CSTRTOSTR("minecraft:orange_wall_banner"),
+	UTL_CSTRTOSTR("minecraft:magenta_wall_banner"),
+	UTL_CSTRTOSTR("minecraft:light_blue_wall_banner"),
+	UTL_CSTRTOSTR("minecraft:yellow_wall_banner"),
+	UTL_CSTRTOSTR("minecraft:lime_wall_banner"),
+	UTL_CSTRTOSTR("minecraft:pink_wall_banner"),
+	UTL_CSTRTOSTR("minecraft:gray_wall_banner"),
+	UTL_CSTRTOSTR("minecraft:light_gray_wall_banner"),
+	UTL_CSTRTOSTR("minecraft:cyan_wall_banner"),
+	UTL_CSTRTOSTR("minecraft:purple_wall_banner"),
+	UTL_CSTRTOSTR("minecraft:blue_wall_banner"),
+	UTL_CSTRTOSTR("minecraft:brown_wall_banner"),
+	UTL_CSTRTOSTR("minecraft:green_wall_banner"),
+	UTL_CSTRTOSTR("minecraft:red_wall_banner"),
+	UTL_CSTRTOSTR("minecraft:black_wall_banner"),
+	UTL_CSTRTOSTR("minecraft:red_sandstone"),
+	UTL_CSTRTOSTR("minecraft:chiseled_red_sandstone"),
+	UTL_CSTRTOSTR("minecraft:cut_red_sandstone"),
+	UTL_CSTRTOSTR("minecraft:red_sandstone_stairs"),
+	UTL_CSTRTOSTR("minecraft:oak_slab"),
+	UTL_CSTRTOSTR("minecraft:spruce_slab"),
+	UTL_CSTRTOSTR("minecraft:birch_slab"),
+	UTL_CSTRTOSTR("minecraft:jungle_slab"),
+	UTL_CSTRTOSTR("minecraft:acacia_slab"),
+	UTL_CSTRTOSTR("minecraft:dark_oak_slab"),
+	UTL_CSTRTOSTR("minecraft:stone_slab"),
+	UTL_CSTRTOSTR("minecraft:smooth_stone_slab"),
+	UTL_CSTRTOSTR("minecraft:sandstone_slab"),
+	UTL_CSTRTOSTR("minecraft:cut_sandstone_slab"),
+	UTL_CSTRTOSTR("minecraft:petrified_oak_slab"),
+	UTL_CSTRTOSTR("minecraft:cobblestone_slab"),
+	UTL_CSTRTOSTR("minecraft:brick_slab"),
+	UTL_CSTRTOSTR("minecraft:stone_brick_slab"),
+	UTL_CSTRTOSTR("minecraft:nether_brick_slab"),
+	UTL_CSTRTOSTR("minecraft:quartz_slab"),
+	UTL_CSTRTOSTR("minecraft:red_sandstone_slab"),
+	UTL_CSTRTOSTR("minecraft:cut_red_sandstone_slab"),
+	UTL_CSTRTOSTR("minecraft:purpur_slab"),
+	UTL_CSTRTOSTR("minecraft:smooth_stone"),
+	UTL_CSTRTOSTR("minecraft:smooth_sandstone"),
+	UTL_CSTRTOSTR("minecraft:smooth_quartz"),
+	UTL_CSTRTOSTR("minecraft:smooth_red_sandstone"),
+	UTL_CSTRTOSTR("minecraft:spruce_fence_gate"),
+	UTL_CSTRTOSTR("minecraft:birch_fence_gate"),
+	UTL_CSTRTOSTR("minecraft:jungle_fence_gate"),
+	UTL_CSTRTOSTR("minecraft:acacia_fence_gate"),
+	UTL_CSTRTOSTR("minecraft:dark_oak_fence_gate"),
+	UTL_CSTRTOSTR("minecraft:spruce_fence"),
+	UTL_CSTRTOSTR("minecraft:birch_fence"),
+	UTL_CSTRTOSTR("minecraft:jungle_fence"),
+	UTL_CSTRTOSTR("minecraft:acacia_fence"),
+	UTL_CSTRTOSTR("minecraft:dark_oak_fence"),
+	UTL_CSTRTOSTR("minecraft:spruce_door"),
+	UTL_CSTRTOSTR("minecraft:birch_door"),
+	UTL_CSTRTOSTR("minecraft:jungle_door"),
+	UTL_CSTRTOSTR("minecraft:acacia_door"),
+	UTL_CSTRTOSTR("minecraft:dark_oak_door"),
+	UTL_CSTRTOSTR("minecraft:end_rod"),
+	UTL_CSTRTOSTR("minecraft:chorus_plant"),
+	UTL_CSTRTOSTR("minecraft:chorus_flower"),
+	UTL_CSTRTOSTR("minecraft:purpur_block"),
+	UTL_CSTRTOSTR("minecraft:purpur_pillar"),
+	UTL_CSTRTOSTR("minecraft:purpur_stairs"),
+	UTL_CSTRTOSTR("minecraft:end_stone_bricks"),
+	UTL_CSTRTOSTR("minecraft:beetroots"),
+	UTL_CSTRTOSTR("minecraft:dirt_path"),
+	UTL_CSTRTOSTR("minecraft:end_gateway"),
+	UTL_CSTRTOSTR("minecraft:repeating_command_block"),
+	UTL_CSTRTOSTR("minecraft:chain_command_block"),
+	UTL_CSTRTOSTR("minecraft:frosted_ice"),
+	UTL_CSTRTOSTR("minecraft:magma_block"),
+	UTL_CSTRTOSTR("minecraft:nether_wart_block"),
+	UTL_CSTRTOSTR("minecraft:red_nether_bricks"),
+	UTL_CSTRTOSTR("minecraft:bone_block"),
+	UTL_CSTRTOSTR("minecraft:structure_void"),
+	UTL_CSTRTOSTR("minecraft:observer"),
+	UTL_CSTRTOSTR("minecraft:shulker_box"),
+	UTL_CSTRTOSTR("minecraft:white_shulker_box"),
+	UTL_CSTRTOSTR("minecraft:orange_shulker_box"),
+	UTL_CSTRTOSTR("minecraft:magenta_shulker_box"),
+	UTL_CSTRTOSTR("minecraft:light_blue_shulker_box"),
+	UTL_CSTRTOSTR("minecraft:yellow_shulker_box"),
+	UTL_CSTRTOSTR("minecraft:lime_shulker_box"),
+	UTL_CSTRTOSTR("minecraft:pink_shulker_box"),
+	UTL_CSTRTOSTR("minecraft:gray_shulker_box"),
+	UTL_CSTRTOSTR("minecraft:light_gray_shulker_box"),
+	UTL_CSTRTOSTR("minecraft:cyan_shulker_box"),
+	UTL_CSTRTOSTR("minecraft:purple_shulker_box"),
+	UTL_CSTRTOSTR("minecraft:blue_shulker_box"),
+	UTL_CSTRTOSTR("minecraft:brown_shulker_box"),
+	UTL_CSTRTOSTR("minecraft:green_shulker_box"),
+	UTL_CSTRTOSTR("minecraft:red_shulker_box"),
+	UTL_CSTRTOSTR("minecraft:black_shulker_box"),
+	UTL_CSTRTOSTR("minecraft:white_glazed_terracotta"),
+	UTL_CSTRTOSTR("minecraft:orange_glazed_terracotta"),
+	UTL_CSTRTOSTR("minecraft:magenta_glazed_terracotta"),
+	UTL_CSTRTOSTR("minecraft:light_blue_glazed_terracotta"),
+	UTL_CSTRTOSTR("minecraft:yellow_glazed_terracotta"),
+	UTL_CSTRTOSTR("minecraft:lime_glazed_terracotta"),
+	UTL_CSTRTOSTR("minecraft:pink_glazed_terracotta"),
+	UTL_CSTRTOSTR("minecraft:gray_glazed_terracotta"),
+	UTL_CSTRTOSTR("minecraft:light_gray_glazed_terracotta"),
+	UTL_CSTRTOSTR("minecraft:cyan_glazed_terracotta"),
+	UTL_CSTRTOSTR("minecraft:purple_glazed_terracotta"),
+	UTL_CSTRTOSTR("minecraft:blue_glazed_terracotta"),
+	UTL_CSTRTOSTR("minecraft:brown_glazed_terracotta"),
+	UTL_CSTRTOSTR("minecraft:green_glazed_terracotta"),
+	UTL_CSTRTOSTR("minecraft:red_glazed_terracotta"),
+	UTL_CSTRTOSTR("minecraft:black_glazed_terracotta"),
+	UTL_CSTRTOSTR("minecraft:white_concrete"),
+	UTL_CSTRTOSTR("minecraft:orange_concrete"),
+	UTL_CSTRTOSTR("minecraft:magenta_concrete"),
+	UTL_CSTRTOSTR("minecraft:light_blue_concrete"),
+	UTL_CSTRTOSTR("minecraft:yellow_concrete"),
+	UTL_CSTRTOSTR("minecraft:lime_concrete"),
+	UTL_CSTRTOSTR("minecraft:pink_concrete"),
+	UTL_CSTRTOSTR("minecraft:gray_concrete"),
+	UTL_CSTRTOSTR("minecraft:light_gray_concrete"),
+	UTL_CSTRTOSTR("minecraft:cyan_concrete"),
+	UTL_CSTRTOSTR("minecraft:purple_concrete"),
+	UTL_CSTRTOSTR("minecraft:blue_concrete"),
+	UTL_CSTRTOSTR("minecraft:brown_concrete"),
+	UTL_CSTRTOSTR("minecraft:green_concrete"),
+	UTL_CSTRTOSTR("minecraft:red_concrete"),
+	UTL_CSTRTOSTR("minecraft:black_concrete"),
+	UTL_CSTRTOSTR("minecraft:white_concrete_powder"),
+	UTL_CSTRTOSTR("minecraft:orange_concrete_powder"),
+	UTL_CSTRTOSTR("minecraft:magenta_concrete_powder"),
+	UTL_CSTRTOSTR("minecraft:light_blue_concrete_powder"),
+	UTL_CSTRTOSTR("minecraft:yellow_concrete_powder"),
+	UTL_CSTRTOSTR("minecraft:lime_concrete_powder"),
+	UTL_CSTRTOSTR("minecraft:pink_concrete_powder"),
+	UTL_CSTRTOSTR("minecraft:gray_concrete_powder"),
+	UTL_CSTRTOSTR("minecraft:light_gray_concrete_powder"),
+	UTL_CSTRTOSTR("minecraft:cyan_concrete_powder"),
+	UTL_CSTRTOSTR("minecraft:purple_concrete_powder"),
+	UTL_CSTRTOSTR("minecraft:blue_concrete_powder"),
+	UTL_CSTRTOSTR("minecraft:brown_concrete_powder"),
+	UTL_CSTRTOSTR("minecraft:green_concrete_powder"),
+	UTL_CSTRTOSTR("minecraft:red_concrete_powder"),
+	UTL_CSTRTOSTR("minecraft:black_concrete_powder"),
+	UTL_CSTRTOSTR("minecraft:kelp"),
+	UTL_CSTRTOSTR("minecraft:kelp_plant"),
+	UTL_CSTRTOSTR("minecraft:dried_kelp_block"),
+	UTL_CSTRTOSTR("minecraft:turtle_egg"),
+	UTL_CSTRTOSTR("minecraft:dead_tube_coral_block"),
+	UTL_CSTRTOSTR("minecraft:dead_brain_coral_block"),
+	UTL_CSTRTOSTR("minecraft:dead_bubble_coral_block"),
+	UTL_CSTRTOSTR("minecraft:dead_fire_coral_block"),
+	UTL_CSTRTOSTR("minecraft:dead_horn_coral_block"),
+	UTL_CSTRTOSTR("minecraft:tube_coral_block"),
+	UTL_CSTRTOSTR("minecraft:brain_coral_block"),
+	UTL_CSTRTOSTR("minecraft:bubble_coral_block"),
+	UTL_CSTRTOSTR("minecraft:fire_coral_block"),
+	UTL_CSTRTOSTR("minecraft:horn_coral_block"),
+	UTL_CSTRTOSTR("minecraft:dead_tube_coral"),
+	UTL_CSTRTOSTR("minecraft:dead_brain_coral"),
+	UTL_CSTRTOSTR("minecraft:dead_bubble_coral"),
+	UTL_CSTRTOSTR("minecraft:dead_fire_coral"),
+	UTL_CSTRTOSTR("minecraft:dead_horn_coral"),
+	UTL_CSTRTOSTR("minecraft:tube_coral"),
+	UTL_CSTRTOSTR("minecraft:brain_coral"),
+	UTL_CSTRTOSTR("minecraft:bubble_coral"),
+	UTL_CSTRTOSTR("minecraft:fire_coral"),
+	UTL_CSTRTOSTR("minecraft:horn_coral"),
+	UTL_CSTRTOSTR("minecraft:dead_tube_coral_fan"),
+	UTL_CSTRTOSTR("minecraft:dead_brain_coral_fan"),
+	UTL_CSTRTOSTR("minecraft:dead_bubble_coral_fan"),
+	UTL_CSTRTOSTR("minecraft:dead_fire_coral_fan"),
+	UTL_CSTRTOSTR("minecraft:dead_horn_coral_fan"),
+	UTL_CSTRTOSTR("minecraft:tube_coral_fan"),
+	UTL_CSTRTOSTR("minecraft:brain_coral_fan"),
+	UTL_CSTRTOSTR("minecraft:bubble_coral_fan"),
+	UTL_CSTRTOSTR("minecraft:fire_coral_fan"),
+	UTL_CSTRTOSTR("minecraft:horn_coral_fan"),
+	UTL_CSTRTOSTR("minecraft:dead_tube_coral_wall_fan"),
+	UTL_CSTRTOSTR("minecraft:dead_brain_coral_wall_fan"),
+	UTL_CSTRTOSTR("minecraft:dead_bubble_coral_wall_fan"),
+	UTL_CSTRTOSTR("minecraft:dead_fire_coral_wall_fan"),
+	UTL_CSTRTOSTR("minecraft:dead_horn_coral_wall_fan"),
+	UTL_CSTRTOSTR("minecraft:tube_coral_wall_fan"),
+	UTL_CSTRTOSTR("minecraft:brain_coral_wall_fan"),
+	UTL_CSTRTOSTR("minecraft:bubble_coral_wall_fan"),
+	UTL_CSTRTOSTR("minecraft:fire_coral_wall_fan"),
+	UTL_CSTRTOSTR("minecraft:horn_coral_wall_fan"),
+	UTL_CSTRTOSTR("minecraft:sea_pickle"),
+	UTL_CSTRTOSTR("minecraft:blue_ice"),
+	UTL_CSTRTOSTR("minecraft:conduit"),
+	UTL_CSTRTOSTR("minecraft:bamboo_sapling"),
+	UTL_CSTRTOSTR("minecraft:bamboo"),
+	UTL_CSTRTOSTR("minecraft:potted_bamboo"),
+	UTL_CSTRTOSTR("minecraft:void_air"),
+	UTL_CSTRTOSTR("minecraft:cave_air"),
+	UTL_CSTRTOSTR("minecraft:bubble_column"),
+	UTL_CSTRTOSTR("minecraft:polished_granite_stairs"),
+	UTL_CSTRTOSTR("minecraft:smooth_red_sandstone_stairs"),
+	UTL_CSTRTOSTR("minecraft:mossy_stone_brick_stairs"),
+	UTL_CSTRTOSTR("minecraft:polished_diorite_stairs"),
+	UTL_CSTRTOSTR("minecraft:mossy_cobblestone_stairs"),
+	UTL_CSTRTOSTR("minecraft:end_stone_brick_stairs"),
+	UTL_CSTRTOSTR("minecraft:stone_stairs"),
+	UTL_CSTRTOSTR("minecraft:smooth_sandstone_stairs"),
+	UTL_CSTRTOSTR("minecraft:smooth_quartz_stairs"),
+	UTL_CSTRTOSTR("minecraft:granite_stairs"),
+	UTL_CSTRTOSTR("minecraft:andesite_stairs"),
+	UTL_CSTRTOSTR("minecraft:red_nether_brick_stairs"),
+	UTL_CSTRTOSTR("minecraft:polished_andesite_stairs"),
+	UTL_CSTRTOSTR("minecraft:diorite_stairs"),
+	UTL_CSTRTOSTR("minecraft:polished_granite_slab"),
+	UTL_CSTRTOSTR("minecraft:smooth_red_sandstone_slab"),
+	UTL_CSTRTOSTR("minecraft:mossy_stone_brick_slab"),
+	UTL_CSTRTOSTR("minecraft:polished_diorite_slab"),
+	UTL_CSTRTOSTR("minecraft:mossy_cobblestone_slab"),
+	UTL_CSTRTOSTR("minecraft:end_stone_brick_slab"),
+	UTL_CSTRTOSTR("minecraft:smooth_sandstone_slab"),
+	UTL_CSTRTOSTR("minecraft:smooth_quartz_slab"),
+	UTL_CSTRTOSTR("minecraft:granite_slab"),
+	UTL_CSTRTOSTR("minecraft:andesite_slab"),
+	UTL_CSTRTOSTR("minecraft:red_nether_brick_slab"),
+	UTL_CSTRTOSTR("minecraft:polished_andesite_slab"),
+	UTL_CSTRTOSTR("minecraft:diorite_slab"),
+	UTL_CSTRTOSTR("minecraft:brick_wall"),
+	UTL_CSTRTOSTR("minecraft:prismarine_wall"),
+	UTL_CSTRTOSTR("minecraft:red_sandstone_wall"),
+	UTL_CSTRTOSTR("minecraft:mossy_stone_brick_wall"),
+	UTL_CSTRTOSTR("minecraft:granite_wall"),
+	UTL_CSTRTOSTR("minecraft:stone_brick_wall"),
+	UTL_CSTRTOSTR("minecraft:nether_brick_wall"),
+	UTL_CSTRTOSTR("minecraft:andesite_wall"),
+	UTL_CSTRTOSTR("minecraft:red_nether_brick_wall"),
+	UTL_CSTRTOSTR("minecraft:sandstone_wall"),
+	UTL_CSTRTOSTR("minecraft:end_stone_brick_wall"),
+	UTL_CSTRTOSTR("minecraft:diorite_wall"),
+	UTL_CSTRTOSTR("minecraft:scaffolding"),
+	UTL_CSTRTOSTR("minecraft:loom"),
+	UTL_CSTRTOSTR("minecraft:barrel"),
+	UTL_CSTRTOSTR("minecraft:smoker"),
+	UTL_CSTRTOSTR("minecraft:blast_furnace"),
+	UTL_CSTRTOSTR("minecraft:cartography_table"),
+	UTL_CSTRTOSTR("minecraft:fletching_table"),
+	UTL_CSTRTOSTR("minecraft:grindstone"),
+	UTL_CSTRTOSTR("minecraft:lectern"),
+	UTL_CSTRTOSTR("minecraft:smithing_table"),
+	UTL_CSTRTOSTR("minecraft:stonecutter"),
+	UTL_CSTRTOSTR("minecraft:bell"),
+	UTL_CSTRTOSTR("minecraft:lantern"),
+	UTL_CSTRTOSTR("minecraft:soul_lantern"),
+	UTL_CSTRTOSTR("minecraft:campfire"),
+	UTL_CSTRTOSTR("minecraft:soul_campfire"),
+	UTL_CSTRTOSTR("minecraft:sweet_berry_bush"),
+	UTL_CSTRTOSTR("minecraft:warped_stem"),
+	UTL_CSTRTOSTR("minecraft:stripped_warped_stem"),
+	UTL_CSTRTOSTR("minecraft:warped_hyphae"),
+	UTL_CSTRTOSTR("minecraft:stripped_warped_hyphae"),
+	UTL_CSTRTOSTR("minecraft:warped_nylium"),
+	UTL_CSTRTOSTR("minecraft:warped_fungus"),
+	UTL_CSTRTOSTR("minecraft:warped_wart_block"),
+	UTL_CSTRTOSTR("minecraft:warped_roots"),
+	UTL_CSTRTOSTR("minecraft:nether_sprouts"),
+	UTL_CSTRTOSTR("minecraft:crimson_stem"),
+	UTL_CSTRTOSTR("minecraft:stripped_crimson_stem"),
+	UTL_CSTRTOSTR("minecraft:crimson_hyphae"),
+	UTL_CSTRTOSTR("minecraft:stripped_crimson_hyphae"),
+	UTL_CSTRTOSTR("minecraft:crimson_nylium"),
+	UTL_CSTRTOSTR("minecraft:crimson_fungus"),
+	UTL_CSTRTOSTR("minecraft:shroomlight"),
+	UTL_CSTRTOSTR("minecraft:weeping_vines"),
+	UTL_CSTRTOSTR("minecraft:weeping_vines_plant"),
+	UTL_CSTRTOSTR("minecraft:twisting_vines"),
+	UTL_CSTRTOSTR("minecraft:twisting_vines_plant"),
+	UTL_CSTRTOSTR("minecraft:crimson_roots"),
+	UTL_CSTRTOSTR("minecraft:crimson_planks"),
+	UTL_CSTRTOSTR("minecraft:warped_planks"),
+	UTL_CSTRTOSTR("minecraft:crimson_slab"),
+	UTL_CSTRTOSTR("minecraft:warped_slab"),
+	UTL_CSTRTOSTR("minecraft:crimson_pressure_plate"),
+	UTL_CSTRTOSTR("minecraft:warped_pressure_plate"),
+	UTL_CSTRTOSTR("minecraft:crimson_fence"),
+	UTL_CSTRTOSTR("minecraft:warped_fence"),
+	UTL_CSTRTOSTR("minecraft:crimson_trapdoor"),
+	UTL_CSTRTOSTR("minecraft:warped_trapdoor"),
+	UTL_CSTRTOSTR("minecraft:crimson_fence_gate"),
+	UTL_CSTRTOSTR("minecraft:warped_fence_gate"),
+	UTL_CSTRTOSTR("minecraft:crimson_stairs"),
+	UTL_CSTRTOSTR("minecraft:warped_stairs"),
+	UTL_CSTRTOSTR("minecraft:crimson_button"),
+	UTL_CSTRTOSTR("minecraft:warped_button"),
+	UTL_CSTRTOSTR("minecraft:crimson_door"),
+	UTL_CSTRTOSTR("minecraft:warped_door"),
+	UTL_CSTRTOSTR("minecraft:crimson_sign"),
+	UTL_CSTRTOSTR("minecraft:warped_sign"),
+	UTL_CSTRTOSTR("minecraft:crimson_wall_sign"),
+	UTL_CSTRTOSTR("minecraft:warped_wall_sign"),
+	UTL_CSTRTOSTR("minecraft:structure_block"),
+	UTL_CSTRTOSTR("minecraft:jigsaw"),
+	UTL_CSTRTOSTR("minecraft:composter"),
+	UTL_CSTRTOSTR("minecraft:target"),
+	UTL_CSTRTOSTR("minecraft:bee_nest"),
+	UTL_CSTRTOSTR("minecraft:beehive"),
+	UTL_CSTRTOSTR("minecraft:honey_block"),
+	UTL_CSTRTOSTR("minecraft:honeycomb_block"),
+	UTL_CSTRTOSTR("minecraft:netherite_block"),
+	UTL_CSTRTOSTR("minecraft:ancient_debris"),
+	UTL_CSTRTOSTR("minecraft:crying_obsidian"),
+	UTL_CSTRTOSTR("minecraft:respawn_anchor"),
+	UTL_CSTRTOSTR("minecraft:potted_crimson_fungus"),
+	UTL_CSTRTOSTR("minecraft:potted_warped_fungus"),
+	UTL_CSTRTOSTR("minecraft:potted_crimson_roots"),
+	UTL_CSTRTOSTR("minecraft:potted_warped_roots"),
+	UTL_CSTRTOSTR("minecraft:lodestone"),
+	UTL_CSTRTOSTR("minecraft:blackstone"),
+	UTL_CSTRTOSTR("minecraft:blackstone_stairs"),
+	UTL_CSTRTOSTR("minecraft:blackstone_wall"),
+	UTL_CSTRTOSTR("minecraft:blackstone_slab"),
+	UTL_CSTRTOSTR("minecraft:polished_blackstone"),
+	UTL_CSTRTOSTR("minecraft:polished_blackstone_bricks"),
+	UTL_CSTRTOSTR("minecraft:cracked_polished_blackstone_bricks"),
+	UTL_CSTRTOSTR("minecraft:chiseled_polished_blackstone"),
+	UTL_CSTRTOSTR("minecraft:polished_blackstone_brick_slab"),
+	UTL_CSTRTOSTR("minecraft:polished_blackstone_brick_stairs"),
+	UTL_CSTRTOSTR("minecraft:polished_blackstone_brick_wall"),
+	UTL_CSTRTOSTR("minecraft:gilded_blackstone"),
+	UTL_CSTRTOSTR("minecraft:polished_blackstone_stairs"),
+	UTL_CSTRTOSTR("minecraft:polished_blackstone_slab"),
+	UTL_CSTRTOSTR("minecraft:polished_blackstone_pressure_plate"),
+	UTL_CSTRTOSTR("minecraft:polished_blackstone_button"),
+	UTL_CSTRTOSTR("minecraft:polished_blackstone_wall"),
+	UTL_CSTRTOSTR("minecraft:chiseled_nether_bricks"),
+	UTL_CSTRTOSTR("minecraft:cracked_nether_bricks"),
+	UTL_CSTRTOSTR("minecraft:quartz_bricks"),
+	UTL_CSTRTOSTR("minecraft:candle"),
+	UTL_CSTRTOSTR("minecraft:white_candle"),
+	UTL_CSTRTOSTR("minecraft:orange_candle"),
+	UTL_CSTRTOSTR("minecraft:magenta_candle"),
+	UTL_CSTRTOSTR("minecraft:light_blue_candle"),
+	UTL_CSTRTOSTR("minecraft:yellow_candle"),
+	UTL_CSTRTOSTR("minecraft:lime_candle"),
+	UTL_CSTRTOSTR("minecraft:pink_candle"),
+	UTL_CSTRTOSTR("minecraft:gray_candle"),
+	UTL_CSTRTOSTR("minecraft:light_gray_candle"),
+	UTL_CSTRTOSTR("minecraft:cyan_candle"),
+	UTL_CSTRTOSTR("minecraft:purple_candle"),
+	UTL_CSTRTOSTR("minecraft:blue_candle"),
+	UTL_CSTRTOSTR("minecraft:brown_candle"),
+	UTL_CSTRTOSTR("minecraft:green_candle"),
+	UTL_CSTRTOSTR("minecraft:red_candle"),
+	UTL_CSTRTOSTR("minecraft:black_candle"),
+	UTL_CSTRTOSTR("minecraft:candle_cake"),
+	UTL_CSTRTOSTR("minecraft:white_candle_cake"),
+	UTL_CSTRTOSTR("minecraft:orange_candle_cake"),
+	UTL_CSTRTOSTR("minecraft:magenta_candle_cake"),
+	UTL_CSTRTOSTR("minecraft:light_blue_candle_cake"),
+	UTL_CSTRTOSTR("minecraft:yellow_candle_cake"),
+	UTL_CSTRTOSTR("minecraft:lime_candle_cake"),
+	UTL_CSTRTOSTR("minecraft:pink_candle_cake"),
+	UTL_CSTRTOSTR("minecraft:gray_candle_cake"),
+	UTL_CSTRTOSTR("minecraft:light_gray_candle_cake"),
+	UTL_CSTRTOSTR("minecraft:cyan_candle_cake"),
+	UTL_CSTRTOSTR("minecraft:purple_candle_cake"),
+	UTL_CSTRTOSTR("minecraft:blue_candle_cake"),
+	UTL_CSTRTOSTR("minecraft:brown_candle_cake"),
+	UTL_CSTRTOSTR("minecraft:green_candle_cake"),
+	UTL_CSTRTOSTR("minecraft:red_candle_cake"),
+	UTL_CSTRTOSTR("minecraft:black_candle_cake"),
+	UTL_CSTRTOSTR("minecraft:amethyst_block"),
+	UTL_CSTRTOSTR("minecraft:budding_amethyst"),
+	UTL_CSTRTOSTR("minecraft:amethyst_cluster"),
+	UTL_CSTRTOSTR("minecraft:large_amethyst_bud"),
+	UTL_CSTRTOSTR("minecraft:medium_amethyst_bud"),
+	UTL_CSTRTOSTR("minecraft:small_amethyst_bud"),
+	UTL_CSTRTOSTR("minecraft:tuff"),
+	UTL_CSTRTOSTR("minecraft:calcite"),
+	UTL_CSTRTOSTR("minecraft:tinted_glass"),
+	UTL_CSTRTOSTR("minecraft:powder_snow"),
+	UTL_CSTRTOSTR("minecraft:sculk_sensor"),
+	UTL_CSTRTOSTR("minecraft:oxidized_copper"),
+	UTL_CSTRTOSTR("minecraft:weathered_copper"),
+	UTL_CSTRTOSTR("minecraft:exposed_copper"),
+	UTL_CSTRTOSTR("minecraft:copper_block"),
+	UTL_CSTRTOSTR("minecraft:copper_ore"),
+	UTL_CSTRTOSTR("minecraft:deepslate_copper_ore"),
+	UTL_CSTRTOSTR("minecraft:oxidized_cut_copper"),
+	UTL_CSTRTOSTR("minecraft:weathered_cut_copper"),
+	UTL_CSTRTOSTR("minecraft:exposed_cut_copper"),
+	UTL_CSTRTOSTR("minecraft:cut_copper"),
+	UTL_CSTRTOSTR("minecraft:oxidized_cut_copper_stairs"),
+	UTL_CSTRTOSTR("minecraft:weathered_cut_copper_stairs"),
+	UTL_CSTRTOSTR("minecraft:exposed_cut_copper_stairs"),
+	UTL_CSTRTOSTR("minecraft:cut_copper_stairs"),
+	UTL_CSTRTOSTR("minecraft:oxidized_cut_copper_slab"),
+	UTL_CSTRTOSTR("minecraft:weathered_cut_copper_slab"),
+	UTL_CSTRTOSTR("minecraft:exposed_cut_copper_slab"),
+	UTL_CSTRTOSTR("minecraft:cut_copper_slab"),
+	UTL_CSTRTOSTR("minecraft:waxed_copper_block"),
+	UTL_CSTRTOSTR("minecraft:waxed_weathered_copper"),
+	UTL_CSTRTOSTR("minecraft:waxed_exposed_copper"),
+	UTL_CSTRTOSTR("minecraft:waxed_oxidized_copper"),
+	UTL_CSTRTOSTR("minecraft:waxed_oxidized_cut_copper"),
+	UTL_CSTRTOSTR("minecraft:waxed_weathered_cut_copper"),
+	UTL_CSTRTOSTR("minecraft:waxed_exposed_cut_copper"),
+	UTL_CSTRTOSTR("minecraft:waxed_cut_copper"),
+	UTL_CSTRTOSTR("minecraft:waxed_oxidized_cut_copper_stairs"),
+	UTL_CSTRTOSTR("minecraft:waxed_weathered_cut_copper_stairs"),
+	UTL_CSTRTOSTR("minecraft:waxed_exposed_cut_copper_stairs"),
+	UTL_CSTRTOSTR("minecraft:waxed_cut_copper_stairs"),
+	UTL_CSTRTOSTR("minecraft:waxed_oxidized_cut_copper_slab"),
+	UTL_CSTRTOSTR("minecraft:waxed_weathered_cut_copper_slab"),
+	UTL_CSTRTOSTR("minecraft:waxed_exposed_cut_copper_slab"),
+	UTL_CSTRTOSTR("minecraft:waxed_cut_copper_slab"),
+	UTL_CSTRTOSTR("minecraft:lightning_rod"),
+	UTL_CSTRTOSTR("minecraft:pointed_dripstone"),
+	UTL_CSTRTOSTR("minecraft:dripstone_block"),
+	UTL_CSTRTOSTR("minecraft:cave_vines"),
+	UTL_CSTRTOSTR("minecraft:cave_vines_plant"),
+	UTL_CSTRTOSTR("minecraft:spore_blossom"),
+	UTL_CSTRTOSTR("minecraft:azalea"),
+	UTL_CSTRTOSTR("minecraft:flowering_azalea"),
+	UTL_CSTRTOSTR("minecraft:moss_carpet"),
+	UTL_CSTRTOSTR("minecraft:moss_block"),
+	UTL_CSTRTOSTR("minecraft:big_dripleaf"),
+	UTL_CSTRTOSTR("minecraft:big_dripleaf_stem"),
+	UTL_CSTRTOSTR("minecraft:small_dripleaf"),
+	UTL_CSTRTOSTR("minecraft:hanging_roots"),
+	UTL_CSTRTOSTR("minecraft:rooted_dirt"),
+	UTL_CSTRTOSTR("minecraft:deepslate"),
+	UTL_CSTRTOSTR("minecraft:cobbled_deepslate"),
+	UTL_CSTRTOSTR("minecraft:cobbled_deepslate_stairs"),
+	UTL_CSTRTOSTR("minecraft:cobbled_deepslate_slab"),
+	UTL_CSTRTOSTR("minecraft:cobbled_deepslate_wall"),
+	UTL_CSTRTOSTR("minecraft:polished_deepslate"),
+	UTL_CSTRTOSTR("minecraft:polished_deepslate_stairs"),
+	UTL_CSTRTOSTR("minecraft:polished_deepslate_slab"),
+	UTL_CSTRTOSTR("minecraft:polished_deepslate_wall"),
+	UTL_CSTRTOSTR("minecraft:deepslate_tiles"),
+	UTL_CSTRTOSTR("minecraft:deepslate_tile_stairs"),
+	UTL_CSTRTOSTR("minecraft:deepslate_tile_slab"),
+	UTL_CSTRTOSTR("minecraft:deepslate_tile_wall"),
+	UTL_CSTRTOSTR("minecraft:deepslate_bricks"),
+	UTL_CSTRTOSTR("minecraft:deepslate_brick_stairs"),
+	UTL_CSTRTOSTR("minecraft:deepslate_brick_slab"),
+	UTL_CSTRTOSTR("minecraft:deepslate_brick_wall"),
+	UTL_CSTRTOSTR("minecraft:chiseled_deepslate"),
+	UTL_CSTRTOSTR("minecraft:cracked_deepslate_bricks"),
+	UTL_CSTRTOSTR("minecraft:cracked_deepslate_tiles"),
+	UTL_CSTRTOSTR("minecraft:infested_deepslate"),
+	UTL_CSTRTOSTR("minecraft:smooth_basalt"),
+	UTL_CSTRTOSTR("minecraft:raw_iron_block"),
+	UTL_CSTRTOSTR("minecraft:raw_copper_block"),
+	UTL_CSTRTOSTR("minecraft:raw_gold_block"),
+	UTL_CSTRTOSTR("minecraft:potted_azalea_bush"),
+	UTL_CSTRTOSTR("minecraft:potted_flowering_azalea_bush"),
+};
+
+mat_block_type_t mat_get_block_type_by_name(const char* name, size_t length) {
+
+	// the namespace can be left out, every block is in the minecraft namespace
+	if (length >= 10 && memcmp(name, "minecraft:", 10) == 0) {
+		name += 10;
+		length -= 10;
+	}
+
+	for (mat_block_type_t type = 0; type < mat_block_count; ++type) {
+		if (mat_blocks_name[type].length == length + 10 && memcmp(mat_blocks_name[type].value + 10, name, length) == 0) {
+			return type;
+		}
+	}
+
+	return mat_block_count;
+
+}
@@ -1097,6 +1097,10 @@ extern const mat_block_t* mat_blocks[];
 extern const uint16_t mat_blocks_protocol[];
 extern const mat_block_protocol_id_t mat_blocks_base_protocol[];
 extern const mat_block_protocol_id_t mat_blocks_default_protocol[];
+extern const string_t mat_blocks_name[];
+
+// finds the block by its name, with or without the minecraft namespace, mat_block_count if there is no such block
+extern mat_block_type_t mat_get_block_type_by_name(const char* name, size_t length);
 
 static inline const mat_block_t* mat_get_block_by_type(mat_block_type_t id) {
 	return mat_blocks[id];
@@ -1106,6 +1110,10 @@ static inline mat_block_type_t mat_get_block_type_by_protocol_id(mat_block_proto
 	return mat_blocks_protocol[protocol];
 }
 
+static inline string_t mat_get_block_name_by_type(mat_block_type_t type) {
+	return mat_blocks_name[type];
+}
+
 static inline mat_block_protocol_id_t mat_get_block_base_protocol_id_by_type(mat_block_type_t type) {
 	return mat_blocks_base_protocol[type];
 }
@@ -1114,6 +1122,21 @@ static inline mat_block_protocol_id_t mat_get_block_default_protocol_id_by_type(
 	return mat_blocks_default_protocol[type];
 }
 
+// the number of block states, protocol ids go from 0 to one less than it
+static inline uint32_t mat_get_block_state_count() {
+
+	// the states of the last block end the protocol ids
+	const mat_block_t* last = mat_get_block_by_type(mat_block_count - 1);
+	uint32_t count = mat_get_block_base_protocol_id_by_type(mat_block_count - 1);
+	uint32_t last_states = 1;
+	for (uint8_t i = 0; i < last->modifiers_count; ++i) {
+		last_states *= mat_get_state_modifier_by_type(last->modifiers[i])->count;
+	}
+
+	return count + last_states;
+
+}
+
 /*
 Read the value of a state field of a block with certain protocol
 */
@@ -6,5 +6,6 @@
 #include "codec.h"
 #include "dimensions.h"
 #include "items.h"
+#include "shapes.h"
 #include "state_modifiers.h"
 #include "tags/tags.h"
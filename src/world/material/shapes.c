@@ -0,0 +1,339 @@
+#include <stdlib.h>
+#include <pthread.h>
+#include "shapes.h"
+#include "state_modifiers.h"
+
+#define MAT_BOX(min_x, min_y, min_z, max_x, max_y, max_z) { min_x, min_y, min_z, max_x, max_y, max_z }
+#define MAT_SHAPE_1(a) { .count = 1, .boxes = { a } }
+#define MAT_SHAPE_2(a, b) { .count = 2, .boxes = { a, b } }
+#define MAT_SHAPE_SNOW(layers) MAT_SHAPE_1(MAT_BOX(0, 0, 0, 1, (layers - 1) / 8.0f, 1))
+// the north to south bar, then the west to east bar, each reaching the sides it connects to
+#define MAT_SHAPE_PANE(connections) MAT_SHAPE_2( \
+	MAT_BOX(7 / 16.0f, 0, (connections) & 1 ? 0 : 7 / 16.0f, 9 / 16.0f, 1, (connections) & 2 ? 1 : 9 / 16.0f), \
+	MAT_BOX((connections) & 4 ? 0 : 7 / 16.0f, 0, 7 / 16.0f, (connections) & 8 ? 1 : 9 / 16.0f, 1, 9 / 16.0f) \
+)
+#define MAT_SHAPE_CAKE(bites) MAT_SHAPE_1(MAT_BOX((1 + (bites) * 2) / 16.0f, 0, 1 / 16.0f, 15 / 16.0f, 0.5f, 15 / 16.0f))
+
+const mat_shape_t mat_shapes[mat_shape_count] = {
+	[mat_shape_empty] = { .count = 0 },
+	[mat_shape_full] = MAT_SHAPE_1(MAT_BOX(0, 0, 0, 1, 1, 1)),
+	[mat_shape_slab_bottom] = MAT_SHAPE_1(MAT_BOX(0, 0, 0, 1, 0.5f, 1)),
+	[mat_shape_slab_top] = MAT_SHAPE_1(MAT_BOX(0, 0.5f, 0, 1, 1, 1)),
+	[mat_shape_carpet] = MAT_SHAPE_1(MAT_BOX(0, 0, 0, 1, 1 / 16.0f, 1)),
+	[mat_shape_snow_2] = MAT_SHAPE_SNOW(2),
+	[mat_shape_snow_3] = MAT_SHAPE_SNOW(3),
+	[mat_shape_snow_4] = MAT_SHAPE_SNOW(4),
+	[mat_shape_snow_5] = MAT_SHAPE_SNOW(5),
+	[mat_shape_snow_6] = MAT_SHAPE_SNOW(6),
+	[mat_shape_snow_7] = MAT_SHAPE_SNOW(7),
+	[mat_shape_snow_8] = MAT_SHAPE_SNOW(8),
+	// the slab, then the step on the side the stairs face
+	[mat_shape_stairs_bottom_north] = MAT_SHAPE_2(MAT_BOX(0, 0, 0, 1, 0.5f, 1), MAT_BOX(0, 0.5f, 0, 1, 1, 0.5f)),
+	[mat_shape_stairs_bottom_south] = MAT_SHAPE_2(MAT_BOX(0, 0, 0, 1, 0.5f, 1), MAT_BOX(0, 0.5f, 0.5f, 1, 1, 1)),
+	[mat_shape_stairs_bottom_west] = MAT_SHAPE_2(MAT_BOX(0, 0, 0, 1, 0.5f, 1), MAT_BOX(0, 0.5f, 0, 0.5f, 1, 1)),
+	[mat_shape_stairs_bottom_east] = MAT_SHAPE_2(MAT_BOX(0, 0, 0, 1, 0.5f, 1), MAT_BOX(0.5f, 0.5f, 0, 1, 1, 1)),
+	[mat_shape_stairs_top_north] = MAT_SHAPE_2(MAT_BOX(0, 0.5f, 0, 1, 1, 1), MAT_BOX(0, 0, 0, 1, 0.5f, 0.5f)),
+	[mat_shape_stairs_top_south] = MAT_SHAPE_2(MAT_BOX(0, 0.5f, 0, 1, 1, 1), MAT_BOX(0, 0, 0.5f, 1, 0.5f, 1)),
+	[mat_shape_stairs_top_west] = MAT_SHAPE_2(MAT_BOX(0, 0.5f, 0, 1, 1, 1), MAT_BOX(0, 0, 0, 0.5f, 0.5f, 1)),
+	[mat_shape_stairs_top_east] = MAT_SHAPE_2(MAT_BOX(0, 0.5f, 0, 1, 1, 1), MAT_BOX(0.5f, 0, 0, 1, 0.5f, 1)),
+	[mat_shape_tall] = MAT_SHAPE_1(MAT_BOX(0, 0, 0, 1, 1.5f, 1)),
+	[mat_shape_trapdoor_bottom] = MAT_SHAPE_1(MAT_BOX(0, 0, 0, 1, 3 / 16.0f, 1)),
+	[mat_shape_trapdoor_top] = MAT_SHAPE_1(MAT_BOX(0, 13 / 16.0f, 0, 1, 1, 1)),
+	[mat_shape_side_north] = MAT_SHAPE_1(MAT_BOX(0, 0, 0, 1, 1, 3 / 16.0f)),
+	[mat_shape_side_south] = MAT_SHAPE_1(MAT_BOX(0, 0, 13 / 16.0f, 1, 1, 1)),
+	[mat_shape_side_west] = MAT_SHAPE_1(MAT_BOX(0, 0, 0, 3 / 16.0f, 1, 1)),
+	[mat_shape_side_east] = MAT_SHAPE_1(MAT_BOX(13 / 16.0f, 0, 0, 1, 1, 1)),
+	[mat_shape_pane + 0] = MAT_SHAPE_PANE(0),
+	[mat_shape_pane + 1] = MAT_SHAPE_PANE(1),
+	[mat_shape_pane + 2] = MAT_SHAPE_PANE(2),
+	[mat_shape_pane + 3] = MAT_SHAPE_PANE(3),
+	[mat_shape_pane + 4] = MAT_SHAPE_PANE(4),
+	[mat_shape_pane + 5] = MAT_SHAPE_PANE(5),
+	[mat_shape_pane + 6] = MAT_SHAPE_PANE(6),
+	[mat_shape_pane + 7] = MAT_SHAPE_PANE(7),
+	[mat_shape_pane + 8] = MAT_SHAPE_PANE(8),
+	[mat_shape_pane + 9] = MAT_SHAPE_PANE(9),
+	[mat_shape_pane + 10] = MAT_SHAPE_PANE(10),
+	[mat_shape_pane + 11] = MAT_SHAPE_PANE(11),
+	[mat_shape_pane + 12] = MAT_SHAPE_PANE(12),
+	[mat_shape_pane + 13] = MAT_SHAPE_PANE(13),
+	[mat_shape_pane + 14] = MAT_SHAPE_PANE(14),
+	[mat_shape_pane + 15] = MAT_SHAPE_PANE(15),
+	[mat_shape_chain_x] = MAT_SHAPE_1(MAT_BOX(0, 6.5f / 16, 6.5f / 16, 1, 9.5f / 16, 9.5f / 16)),
+	[mat_shape_chain_y] = MAT_SHAPE_1(MAT_BOX(6.5f / 16, 0, 6.5f / 16, 9.5f / 16, 1, 9.5f / 16)),
+	[mat_shape_chain_z] = MAT_SHAPE_1(MAT_BOX(6.5f / 16, 6.5f / 16, 0, 9.5f / 16, 9.5f / 16, 1)),
+	// the lantern, then its top
+	[mat_shape_lantern] = MAT_SHAPE_2(MAT_BOX(5 / 16.0f, 0, 5 / 16.0f, 11 / 16.0f, 7 / 16.0f, 11 / 16.0f), MAT_BOX(6 / 16.0f, 7 / 16.0f, 6 / 16.0f, 10 / 16.0f, 9 / 16.0f, 10 / 16.0f)),
+	[mat_shape_lantern_hanging] = MAT_SHAPE_2(MAT_BOX(5 / 16.0f, 1 / 16.0f, 5 / 16.0f, 11 / 16.0f, 8 / 16.0f, 11 / 16.0f), MAT_BOX(6 / 16.0f, 8 / 16.0f, 6 / 16.0f, 10 / 16.0f, 10 / 16.0f, 10 / 16.0f)),
+	[mat_shape_head] = MAT_SHAPE_1(MAT_BOX(0.25f, 0, 0.25f, 0.75f, 0.5f, 0.75f)),
+	// against the side opposite to the facing
+	[mat_shape_wall_head_north] = MAT_SHAPE_1(MAT_BOX(0.25f, 0.25f, 0.5f, 0.75f, 0.75f, 1)),
+	[mat_shape_wall_head_south] = MAT_SHAPE_1(MAT_BOX(0.25f, 0.25f, 0, 0.75f, 0.75f, 0.5f)),
+	[mat_shape_wall_head_west] = MAT_SHAPE_1(MAT_BOX(0.5f, 0.25f, 0.25f, 1, 0.75f, 0.75f)),
+	[mat_shape_wall_head_east] = MAT_SHAPE_1(MAT_BOX(0, 0.25f, 0.25f, 0.5f, 0.75f, 0.75f)),
+	[mat_shape_candles_1] = MAT_SHAPE_1(MAT_BOX(7 / 16.0f, 0, 7 / 16.0f, 9 / 16.0f, 6 / 16.0f, 9 / 16.0f)),
+	[mat_shape_candles_2] = MAT_SHAPE_1(MAT_BOX(5 / 16.0f, 0, 6 / 16.0f, 11 / 16.0f, 6 / 16.0f, 9 / 16.0f)),
+	[mat_shape_candles_3] = MAT_SHAPE_1(MAT_BOX(5 / 16.0f, 0, 6 / 16.0f, 10 / 16.0f, 6 / 16.0f, 11 / 16.0f)),
+	[mat_shape_candles_4] = MAT_SHAPE_1(MAT_BOX(5 / 16.0f, 0, 5 / 16.0f, 11 / 16.0f, 6 / 16.0f, 10 / 16.0f)),
+	[mat_shape_cake + 0] = MAT_SHAPE_CAKE(0),
+	[mat_shape_cake + 1] = MAT_SHAPE_CAKE(1),
+	[mat_shape_cake + 2] = MAT_SHAPE_CAKE(2),
+	[mat_shape_cake + 3] = MAT_SHAPE_CAKE(3),
+	[mat_shape_cake + 4] = MAT_SHAPE_CAKE(4),
+	[mat_shape_cake + 5] = MAT_SHAPE_CAKE(5),
+	[mat_shape_cake + 6] = MAT_SHAPE_CAKE(6),
+	// the cake, then the candle on it
+	[mat_shape_candle_cake] = MAT_SHAPE_2(MAT_BOX(1 / 16.0f, 0, 1 / 16.0f, 15 / 16.0f, 0.5f, 15 / 16.0f), MAT_BOX(7 / 16.0f, 0.5f, 7 / 16.0f, 9 / 16.0f, 14 / 16.0f, 9 / 16.0f)),
+	[mat_shape_flower_pot] = MAT_SHAPE_1(MAT_BOX(5 / 16.0f, 0, 5 / 16.0f, 11 / 16.0f, 6 / 16.0f, 11 / 16.0f)),
+	[mat_shape_scaffolding] = MAT_SHAPE_1(MAT_BOX(0, 14 / 16.0f, 0, 1, 1, 1)),
+	[mat_shape_bed] = MAT_SHAPE_1(MAT_BOX(0, 0, 0, 1, 9 / 16.0f, 1)),
+	[mat_shape_chest] = MAT_SHAPE_1(MAT_BOX(1 / 16.0f, 0, 1 / 16.0f, 15 / 16.0f, 14 / 16.0f, 15 / 16.0f)),
+	[mat_shape_enchanting_table] = MAT_SHAPE_1(MAT_BOX(0, 0, 0, 1, 0.75f, 1)),
+	[mat_shape_end_portal_frame] = MAT_SHAPE_1(MAT_BOX(0, 0, 0, 1, 13 / 16.0f, 1)),
+	[mat_shape_soul_sand] = MAT_SHAPE_1(MAT_BOX(0, 0, 0, 1, 14 / 16.0f, 1)),
+	[mat_shape_inset] = MAT_SHAPE_1(MAT_BOX(1 / 16.0f, 0, 1 / 16.0f, 15 / 16.0f, 15 / 16.0f, 15 / 16.0f)),
+	[mat_shape_path] = MAT_SHAPE_1(MAT_BOX(0, 0, 0, 1, 15 / 16.0f, 1))
+};
+
+static uint8_t* mat_shape_table = NULL;
+static pthread_once_t mat_shape_table_once = PTHREAD_ONCE_INIT;
+
+// blocks entities go through that no tag covers
+static inline bool mat_block_type_is_passable(mat_block_type_t type) {
+
+	switch (type) {
+		case mat_block_vine:
+		case mat_block_torch:
+		case mat_block_wall_torch:
+		case mat_block_soul_torch:
+		case mat_block_soul_wall_torch:
+		case mat_block_redstone_torch:
+		case mat_block_redstone_wall_torch:
+		case mat_block_redstone_wire:
+		case mat_block_tripwire:
+		case mat_block_tripwire_hook:
+		case mat_block_lever:
+		case mat_block_cobweb:
+		case mat_block_sugar_cane:
+		case mat_block_kelp:
+		case mat_block_kelp_plant:
+		case mat_block_seagrass:
+		case mat_block_tall_seagrass:
+		case mat_block_sweet_berry_bush:
+		case mat_block_structure_void:
+		case mat_block_light:
+		case mat_block_bubble_column:
+		case mat_block_twisting_vines:
+		case mat_block_twisting_vines_plant:
+		case mat_block_weeping_vines:
+		case mat_block_weeping_vines_plant:
+		case mat_block_glow_lichen:
+		case mat_block_hanging_roots:
+		case mat_block_spore_blossom:
+		case mat_block_small_dripleaf:
+		case mat_block_big_dripleaf_stem:
+		case mat_block_nether_sprouts:
+		case mat_block_warped_roots:
+		case mat_block_crimson_roots:
+		case mat_block_brown_mushroom:
+		case mat_block_red_mushroom:
+		case mat_block_crimson_fungus:
+		case mat_block_warped_fungus:
+		case mat_block_dead_bush:
+		case mat_block_nether_wart:
+		case mat_block_powder_snow:
+			return true;
+		default:
+			return false;
+	}
+
+}
+
+// the tags of the block data only list the blocks added by the tag itself, not the ones of the tags it includes,
+// so block families are told apart by the states they have instead
+static inline bool mat_block_has_state_modifier(const mat_block_t* block, mat_state_modifier_type_t modifier) {
+
+	for (uint8_t i = 0; i < block->modifiers_count; ++i) {
+		if (block->modifiers[i] == modifier) {
+			return true;
+		}
+	}
+
+	return false;
+
+}
+
+static mat_shape_type_t mat_get_block_shape_type(mat_block_protocol_id_t protocol) {
+
+	const mat_block_type_t type = mat_get_block_type_by_protocol_id(protocol);
+	const mat_block_t* block = mat_get_block_by_type(type);
+
+	if (block->air || block->water || block->lava || block->fire || block->portals
+	|| block->flowers || block->small_flowers || block->tall_flowers || block->saplings || block->crops || block->replaceable_plants
+	|| block->corals || block->wall_corals || block->cave_vines
+	|| block->rails || block->pressure_plates || block->wooden_pressure_plates || block->stone_pressure_plates
+	|| block->buttons || block->wooden_buttons || block->signs || block->standing_signs || block->wall_signs || block->banners
+	|| mat_block_type_is_passable(type)) {
+		return mat_shape_empty;
+	}
+
+	// state values are in the order of the game: top before bottom, true before false
+	if (mat_block_has_state_modifier(block, mat_state_modifier_slab_type)) {
+		switch (mat_get_block_state_value(protocol, mat_state_modifier_slab_type)) {
+			case 0: return mat_shape_slab_top;
+			case 1: return mat_shape_slab_bottom;
+			default: return mat_shape_full;
+		}
+	}
+
+	if (mat_block_has_state_modifier(block, mat_state_modifier_stairs_half)) {
+		const uint8_t facing = mat_get_block_state_value(protocol, mat_state_modifier_facing_cardinal);
+		const bool top = mat_get_block_state_value(protocol, mat_state_modifier_stairs_half) == 0;
+		return (top ? mat_shape_stairs_top_north : mat_shape_stairs_bottom_north) + facing;
+	}
+
+	if (block->carpets || type == mat_block_moss_carpet) {
+		return mat_shape_carpet;
+	}
+
+	if (type == mat_block_snow) {
+		const uint8_t layers = mat_get_block_state_value(protocol, mat_state_modifier_snow_layers) + 1;
+		return layers == 1 ? mat_shape_empty : mat_shape_snow_2 + (layers - 2);
+	}
+
+	if (block->fences || block->wooden_fences || block->walls) {
+		return mat_shape_tall;
+	}
+
+	if (block->fence_gates) {
+		return mat_get_block_state_value(protocol, mat_state_modifier_open) == 0 ? mat_shape_empty : mat_shape_tall;
+	}
+
+	// facings are north, south, west and east, like the panels, so the panel against the other side is the facing with the lowest bit flipped
+	if (mat_block_has_state_modifier(block, mat_state_modifier_trapdoor_open)) {
+		if (mat_get_block_state_value(protocol, mat_state_modifier_trapdoor_open) == 0) {
+			return mat_shape_side_north + (mat_get_block_state_value(protocol, mat_state_modifier_facing_cardinal) ^ 1);
+		}
+		return mat_get_block_state_value(protocol, mat_state_modifier_trapdoor_half) == 0 ? mat_shape_trapdoor_top : mat_shape_trapdoor_bottom;
+	}
+
+	// closed doors stand against the side opposite to the facing, open doors swing to the side of their hinge
+	if (mat_block_has_state_modifier(block, mat_state_modifier_door_hinge)) {
+		static const uint8_t open_right[] = { 3, 2, 0, 1 };
+		static const uint8_t open_left[] = { 2, 3, 1, 0 };
+		const uint8_t facing = mat_get_block_state_value(protocol, mat_state_modifier_facing_cardinal);
+		if (mat_get_block_state_value(protocol, mat_state_modifier_door_open) != 0) {
+			return mat_shape_side_north + (facing ^ 1);
+		}
+		const bool left = mat_get_block_state_value(protocol, mat_state_modifier_door_hinge) == 0;
+		return mat_shape_side_north + (left ? open_left[facing] : open_right[facing]);
+	}
+
+	switch (type) {
+		case mat_block_ladder:
+			return mat_shape_side_north + (mat_get_block_state_value(protocol, mat_state_modifier_facing_cardinal) ^ 1);
+		case mat_block_glass_pane:
+		case mat_block_white_stained_glass_pane:
+		case mat_block_orange_stained_glass_pane:
+		case mat_block_magenta_stained_glass_pane:
+		case mat_block_light_blue_stained_glass_pane:
+		case mat_block_yellow_stained_glass_pane:
+		case mat_block_lime_stained_glass_pane:
+		case mat_block_pink_stained_glass_pane:
+		case mat_block_gray_stained_glass_pane:
+		case mat_block_light_gray_stained_glass_pane:
+		case mat_block_cyan_stained_glass_pane:
+		case mat_block_purple_stained_glass_pane:
+		case mat_block_blue_stained_glass_pane:
+		case mat_block_brown_stained_glass_pane:
+		case mat_block_green_stained_glass_pane:
+		case mat_block_red_stained_glass_pane:
+		case mat_block_black_stained_glass_pane:
+		case mat_block_iron_bars:
+			return mat_shape_pane
+				+ (mat_get_block_state_value(protocol, mat_state_modifier_north) == 0 ? 1 : 0)
+				+ (mat_get_block_state_value(protocol, mat_state_modifier_south) == 0 ? 2 : 0)
+				+ (mat_get_block_state_value(protocol, mat_state_modifier_west) == 0 ? 4 : 0)
+				+ (mat_get_block_state_value(protocol, mat_state_modifier_east) == 0 ? 8 : 0);
+		case mat_block_chain:
+			return mat_shape_chain_x + mat_get_block_state_value(protocol, mat_state_modifier_axis);
+		case mat_block_lantern:
+		case mat_block_soul_lantern:
+			return mat_get_block_state_value(protocol, mat_state_modifier_lantern_hanging) == 0 ? mat_shape_lantern_hanging : mat_shape_lantern;
+		case mat_block_skeleton_skull:
+		case mat_block_wither_skeleton_skull:
+		case mat_block_zombie_head:
+		case mat_block_player_head:
+		case mat_block_creeper_head:
+		case mat_block_dragon_head:
+			return mat_shape_head;
+		case mat_block_skeleton_wall_skull:
+		case mat_block_wither_skeleton_wall_skull:
+		case mat_block_zombie_wall_head:
+		case mat_block_player_wall_head:
+		case mat_block_creeper_wall_head:
+		case mat_block_dragon_wall_head:
+			return mat_shape_wall_head_north + mat_get_block_state_value(protocol, mat_state_modifier_facing_cardinal);
+		case mat_block_cake:
+			return mat_shape_cake + mat_get_block_state_value(protocol, mat_state_modifier_cake_bites);
+		case mat_block_scaffolding:
+			return mat_shape_scaffolding;
+		case mat_block_chest:
+		case mat_block_trapped_chest:
+		case mat_block_ender_chest:
+			return mat_shape_chest;
+		case mat_block_enchanting_table:
+			return mat_shape_enchanting_table;
+		case mat_block_end_portal_frame:
+			return mat_shape_end_portal_frame;
+		case mat_block_soul_sand:
+			return mat_shape_soul_sand;
+		case mat_block_honey_block:
+		case mat_block_cactus:
+			return mat_shape_inset;
+		case mat_block_farmland:
+		case mat_block_dirt_path:
+			return mat_shape_path;
+		default:
+			break;
+	}
+
+	if (mat_block_has_state_modifier(block, mat_state_modifier_candle_candles)) {
+		return mat_shape_candles_1 + mat_get_block_state_value(protocol, mat_state_modifier_candle_candles);
+	}
+
+	if (block->candle_cakes) {
+		return mat_shape_candle_cake;
+	}
+
+	if (block->flower_pots) {
+		return mat_shape_flower_pot;
+	}
+
+	if (block->beds) {
+		return mat_shape_bed;
+	}
+
+	return mat_shape_full;
+
+}
+
+static void mat_init_shape_table() {
+
+	const uint32_t count = mat_get_block_state_count();
+
+	mat_shape_table = malloc(count);
+
+	for (uint32_t i = 0; i < count; ++i) {
+		mat_shape_table[i] = mat_get_block_shape_type(i);
+	}
+
+}
+
+const uint8_t* mat_get_shape_table() {
+
+	pthread_once(&mat_shape_table_once, mat_init_shape_table);
+
+	return mat_shape_table;
+
+}
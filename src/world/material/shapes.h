@@ -0,0 +1,125 @@
+#pragma once
+#include "../../main.h"
+#include "blocks.h"
+
+#define MAT_SHAPE_MAX_BOXES 2
+
+// a box in a block, from 0 to 1 (higher for blocks that stick out above)
+typedef struct {
+
+	float32_t min_x;
+	float32_t min_y;
+	float32_t min_z;
+	float32_t max_x;
+	float32_t max_y;
+	float32_t max_z;
+
+} mat_box_t;
+
+// what entities collide with in a block
+typedef struct {
+
+	uint8_t count;
+	mat_box_t boxes[MAT_SHAPE_MAX_BOXES];
+
+} mat_shape_t;
+
+typedef enum {
+
+	mat_shape_empty,
+	mat_shape_full,
+	mat_shape_slab_bottom,
+	mat_shape_slab_top,
+	mat_shape_carpet,
+
+	// by layers, one layer has no collision
+	mat_shape_snow_2,
+	mat_shape_snow_3,
+	mat_shape_snow_4,
+	mat_shape_snow_5,
+	mat_shape_snow_6,
+	mat_shape_snow_7,
+	mat_shape_snow_8,
+
+	// by facing, in the order of the state
+	mat_shape_stairs_bottom_north,
+	mat_shape_stairs_bottom_south,
+	mat_shape_stairs_bottom_west,
+	mat_shape_stairs_bottom_east,
+	mat_shape_stairs_top_north,
+	mat_shape_stairs_top_south,
+	mat_shape_stairs_top_west,
+	mat_shape_stairs_top_east,
+
+	// fences, walls and closed fence gates
+	mat_shape_tall,
+
+	mat_shape_trapdoor_bottom,
+	mat_shape_trapdoor_top,
+
+	// 3/16 thick panels against one side of the block, for doors, open trapdoors and ladders, in the order of the facing state
+	mat_shape_side_north,
+	mat_shape_side_south,
+	mat_shape_side_west,
+	mat_shape_side_east,
+
+	// panes and iron bars, the post and the arms to the sides they connect to, by connection bits (north 1, south 2, west 4, east 8)
+	mat_shape_pane,
+	mat_shape_pane_last = mat_shape_pane + 15,
+
+	// by axis, in the order of the state
+	mat_shape_chain_x,
+	mat_shape_chain_y,
+	mat_shape_chain_z,
+
+	mat_shape_lantern,
+	mat_shape_lantern_hanging,
+
+	mat_shape_head,
+	// by facing, in the order of the state
+	mat_shape_wall_head_north,
+	mat_shape_wall_head_south,
+	mat_shape_wall_head_west,
+	mat_shape_wall_head_east,
+
+	// by the number of candles
+	mat_shape_candles_1,
+	mat_shape_candles_2,
+	mat_shape_candles_3,
+	mat_shape_candles_4,
+
+	// by bites
+	mat_shape_cake,
+	mat_shape_cake_last = mat_shape_cake + 6,
+	mat_shape_candle_cake,
+
+	mat_shape_flower_pot,
+	// the top of the scaffolding entities stand on, they climb through the rest
+	mat_shape_scaffolding,
+	mat_shape_bed,
+	mat_shape_chest,
+	mat_shape_enchanting_table,
+	mat_shape_end_portal_frame,
+	mat_shape_soul_sand,
+	// honey and cactus, a bit smaller than the block on every side but the bottom
+	mat_shape_inset,
+	// farmland and dirt paths
+	mat_shape_path,
+
+	mat_shape_count
+
+} mat_shape_type_t;
+
+extern const mat_shape_t mat_shapes[mat_shape_count];
+
+/*
+ * Gets the shape type of every block state, indexed by protocol id
+ *
+ * The table is made from the block data and states the first time it's needed, blocks not told apart here
+ * (inner and outer stairs, fence connections, anvils, hoppers...) are given the closest shape there is
+ */
+extern const uint8_t* mat_get_shape_table();
+
+static inline const mat_shape_t* mat_get_shape(mat_shape_type_t type) {
+	return &mat_shapes[type];
+}
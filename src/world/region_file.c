@@ -0,0 +1,843 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <libdeflate.h>
+#include "region_file.h"
+#include "world.h"
+#include "../io/io.h"
+#include "../io/nbt/mnbt.h"
+#include "../io/logger/logger.h"
+#include "../util/str_util.h"
+
+typedef enum {
+
+	wld_compression_gzip = 1,
+	wld_compression_zlib = 2,
+	wld_compression_none = 3
+
+} wld_compression_t;
+
+// chunks are compressed by the thread saving them and decompressed by the thread loading them
+static pthread_key_t wld_region_file_compressor;
+static pthread_key_t wld_region_file_decompressor;
+static pthread_once_t wld_region_file_keys_once = PTHREAD_ONCE_INIT;
+
+static void wld_free_compressor(void* compressor) {
+	libdeflate_free_compressor(compressor);
+}
+
+static void wld_free_decompressor(void* decompressor) {
+	libdeflate_free_decompressor(decompressor);
+}
+
+static void wld_create_region_file_keys() {
+	pthread_key_create(&wld_region_file_compressor, wld_free_compressor);
+	pthread_key_create(&wld_region_file_decompressor, wld_free_decompressor);
+}
+
+static inline struct libdeflate_compressor* wld_get_compressor() {
+
+	pthread_once(&wld_region_file_keys_once, wld_create_region_file_keys);
+
+	struct libdeflate_compressor* compressor = pthread_getspecific(wld_region_file_compressor);
+
+	if (compressor == NULL) {
+		compressor = libdeflate_alloc_compressor(6);
+		pthread_setspecific(wld_region_file_compressor, compressor);
+	}
+
+	return compressor;
+
+}
+
+static inline struct libdeflate_decompressor* wld_get_decompressor() {
+
+	pthread_once(&wld_region_file_keys_once, wld_create_region_file_keys);
+
+	struct libdeflate_decompressor* decompressor = pthread_getspecific(wld_region_file_decompressor);
+
+	if (decompressor == NULL) {
+		decompressor = libdeflate_alloc_decompressor();
+		pthread_setspecific(wld_region_file_decompressor, decompressor);
+	}
+
+	return decompressor;
+
+}
+
+wld_region_file_t* wld_open_region_file(const char* path) {
+
+	const int fd = open(path, O_RDWR | O_CREAT, 0666);
+
+	if (fd == -1) {
+		log_error("Could not open region file %s", path);
+		return NULL;
+	}
+
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) == -1) {
+		log_error("Could not read region file %s", path);
+		close(fd);
+		return NULL;
+	}
+
+	size_t length = file_stat.st_size;
+
+	// new files start with an empty header
+	if (length < WLD_REGION_FILE_SECTOR * WLD_REGION_FILE_HEADER_SECTORS) {
+		length = WLD_REGION_FILE_SECTOR * WLD_REGION_FILE_HEADER_SECTORS;
+		if (ftruncate(fd, length) == -1) {
+			log_error("Could not create region file %s", path);
+			close(fd);
+			return NULL;
+		}
+	}
+
+	// no memory is used for the part of the mapping past the end of the file, it can be read once the file grows into it
+	const size_t mapped = UTL_MAX(length, WLD_REGION_FILE_MAPPED);
+	const byte_t* bytes = mmap(NULL, mapped, PROT_READ, MAP_SHARED | MAP_NORESERVE, fd, 0);
+
+	if (bytes == MAP_FAILED) {
+		log_error("Could not map region file %s", path);
+		close(fd);
+		return NULL;
+	}
+
+	wld_region_file_t* file = malloc(sizeof(wld_region_file_t));
+	*file = (wld_region_file_t) {
+		.lock = PTHREAD_MUTEX_INITIALIZER,
+		.fd = fd,
+		.bytes = bytes,
+		.length = length,
+		.mapped = mapped,
+		.sectors = (length + WLD_REGION_FILE_SECTOR - 1) / WLD_REGION_FILE_SECTOR
+	};
+
+	// mark the sectors the header and chunks are in
+	file->used = calloc(file->sectors, sizeof(bool));
+	for (uint32_t i = 0; i < WLD_REGION_FILE_HEADER_SECTORS; ++i) {
+		file->used[i] = true;
+	}
+	for (uint16_t i = 0; i < 32 * 32; ++i) {
+
+		const uint32_t location = io_read_int32(bytes + (i << 2), io_big_endian);
+		const uint32_t offset = location >> 8;
+		const uint32_t count = location & 0xFF;
+
+		if (offset >= WLD_REGION_FILE_HEADER_SECTORS && offset + count <= file->sectors) {
+			for (uint32_t j = 0; j < count; ++j) {
+				file->used[offset + j] = true;
+			}
+		}
+
+	}
+
+	return file;
+
+}
+
+void wld_close_region_file(wld_region_file_t* file) {
+
+	munmap((void*) file->bytes, file->mapped);
+	close(file->fd);
+
+	pthread_mutex_destroy(&file->lock);
+
+	free(file->used);
+	free(file);
+
+}
+
+static inline bool wld_region_file_has_chunk_l(wld_region_file_t* file, uint16_t index) {
+
+	const uint32_t location = io_read_int32(file->bytes + (index << 2), io_big_endian);
+
+	return (location >> 8) >= WLD_REGION_FILE_HEADER_SECTORS && (location & 0xFF) != 0;
+
+}
+
+// the chunk as it is stored in the mapped file, NULL if it isn't in the file or is invalid, the file must be locked
+static const byte_t* wld_region_file_get_chunk_l(wld_region_file_t* file, uint16_t index, uint32_t* length, wld_compression_t* compression) {
+
+	const uint32_t location = io_read_int32(file->bytes + (index << 2), io_big_endian);
+	const uint32_t offset = location >> 8;
+	const uint32_t count = location & 0xFF;
+
+	if (offset < WLD_REGION_FILE_HEADER_SECTORS || count == 0) {
+		return NULL;
+	}
+
+	if ((size_t) offset * WLD_REGION_FILE_SECTOR + 5 > file->length) {
+		log_error("Chunk %u is outside of its region file", index);
+		return NULL;
+	}
+
+	const byte_t* chunk = file->bytes + (size_t) offset * WLD_REGION_FILE_SECTOR;
+	const uint32_t chunk_length = io_read_int32(chunk, io_big_endian);
+
+	if (chunk_length <= 1 || chunk_length > count * WLD_REGION_FILE_SECTOR - 4 || (size_t) offset * WLD_REGION_FILE_SECTOR + 4 + chunk_length > file->length) {
+		log_error("Chunk %u has an invalid length in its region file", index);
+		return NULL;
+	}
+
+	*compression = chunk[4];
+	*length = chunk_length - 1;
+
+	return chunk + 5;
+
+}
+
+static mnbt_doc* wld_region_file_read(const byte_t* bytes, uint32_t length, wld_compression_t compression) {
+
+	if (compression == wld_compression_none) {
+		return mnbt_read(bytes, length, NULL, MNBT_NONE);
+	}
+
+	if (compression != wld_compression_gzip && compression != wld_compression_zlib) {
+		log_error("Unsupported chunk compression %u", compression);
+		return NULL;
+	}
+
+	struct libdeflate_decompressor* decompressor = wld_get_decompressor();
+
+	// the uncompressed length isn't stored, so the buffer grows until it fits
+	size_t capacity = (size_t) length * 4;
+	size_t uncompressed_length = 0;
+	byte_t* uncompressed = NULL;
+
+	enum libdeflate_result result;
+	do {
+
+		capacity <<= 1;
+		uncompressed = realloc(uncompressed, capacity);
+
+		if (compression == wld_compression_gzip) {
+			result = libdeflate_gzip_decompress(decompressor, bytes, length, uncompressed, capacity, &uncompressed_length);
+		} else {
+			result = libdeflate_zlib_decompress(decompressor, bytes, length, uncompressed, capacity, &uncompressed_length);
+		}
+
+	} while (result == LIBDEFLATE_INSUFFICIENT_SPACE && capacity < (1 << 26));
+
+	mnbt_doc* doc = NULL;
+
+	if (result == LIBDEFLATE_SUCCESS && uncompressed_length > 0) {
+		doc = mnbt_read(uncompressed, uncompressed_length, NULL, MNBT_NONE);
+	} else {
+		log_error("Could not decompress chunk");
+	}
+
+	free(uncompressed);
+
+	return doc;
+
+}
+
+// writes the chunk into free sectors and points the header to it, the file must be locked
+// the old sectors are only freed after that, so the chunk is never written over its only copy
+static bool wld_region_file_write_l(wld_region_file_t* file, uint16_t index, const byte_t* bytes, size_t length) {
+
+	const uint32_t count = (length + WLD_REGION_FILE_SECTOR - 1) / WLD_REGION_FILE_SECTOR;
+
+	if (count > WLD_REGION_FILE_MAX_SECTORS) {
+		log_error("Chunk %u is too big to be saved (%zu bytes)", index, length);
+		return false;
+	}
+
+	const uint32_t location = io_read_int32(file->bytes + (index << 2), io_big_endian);
+	const uint32_t old_offset = location >> 8;
+	const uint32_t old_count = location & 0xFF;
+
+	// find the first free sectors that fit the chunk, the end of the file if none do
+	uint32_t offset = WLD_REGION_FILE_HEADER_SECTORS;
+	for (uint32_t free_sectors = 0; free_sectors < count && offset + free_sectors < file->sectors;) {
+		if (file->used[offset + free_sectors]) {
+			offset += free_sectors + 1;
+			free_sectors = 0;
+		} else {
+			free_sectors++;
+		}
+	}
+
+	if (offset + count > file->sectors) {
+
+		// only files that were already bigger than a saved one gets can grow past the mapping
+		if ((size_t) (offset + count) * WLD_REGION_FILE_SECTOR > file->mapped) {
+			log_error("Region file is too big to save chunk %u", index);
+			return false;
+		}
+
+		if (ftruncate(file->fd, (off_t) (offset + count) * WLD_REGION_FILE_SECTOR) == -1) {
+			log_error("Could not grow region file");
+			return false;
+		}
+
+		file->used = realloc(file->used, sizeof(bool) * (offset + count));
+		memset(file->used + file->sectors, 0, sizeof(bool) * (offset + count - file->sectors));
+		file->sectors = offset + count;
+
+	}
+
+	if (pwrite(file->fd, bytes, length, (off_t) offset * WLD_REGION_FILE_SECTOR) != (ssize_t) length) {
+		log_error("Could not write chunk %u to its region file", index);
+		return false;
+	}
+
+	for (uint32_t i = offset; i < offset + count; ++i) {
+		file->used[i] = true;
+	}
+
+	// location and timestamp
+	byte_t header[4];
+	io_write_int32(header, (offset << 8) | count, io_big_endian);
+	if (pwrite(file->fd, header, 4, index << 2) != 4) {
+		log_error("Could not write chunk %u to its region file", index);
+		return false;
+	}
+
+	// the header points to the new sectors, the old ones can be written over
+	if (old_offset >= WLD_REGION_FILE_HEADER_SECTORS) {
+		for (uint32_t i = old_offset; i < old_offset + old_count && i < file->sectors; ++i) {
+			file->used[i] = false;
+		}
+	}
+
+	io_write_int32(header, time(NULL), io_big_endian);
+	if (pwrite(file->fd, header, 4, WLD_REGION_FILE_SECTOR + (index << 2)) != 4) {
+		log_error("Could not write chunk %u to its region file", index);
+		return false;
+	}
+
+	// the mapping already covers the part the file grew by
+	file->length = UTL_MAX(file->length, (size_t) file->sectors * WLD_REGION_FILE_SECTOR);
+
+	return true;
+
+}
+
+// finds the tag with the label and type in the compound, NULL if it isn't there
+static mnbt_tag* wld_nbt_get(mnbt_val compound, const char* label, mnbt_type type) {
+
+	const uint32_t size = mnbt_val_get_size(compound);
+
+	for (uint32_t i = 0; i < size; ++i) {
+		mnbt_tag* tag = mnbt_val_get_tag(compound, i);
+		if (mnbt_get_type(tag) == type && strcmp(mnbt_get_label(tag), label) == 0) {
+			return tag;
+		}
+	}
+
+	return NULL;
+
+}
+
+static inline uint8_t wld_bits_for(uint32_t count) {
+
+	uint8_t bits = 0;
+	while (((uint32_t) 1 << bits) < count) {
+		bits++;
+	}
+
+	return bits;
+
+}
+
+static inline uint16_t wld_packed_length(uint16_t count, uint8_t bits) {
+
+	const uint8_t values_per_long = 64 / bits;
+
+	return (count + values_per_long - 1) / values_per_long;
+
+}
+
+// packs the values into longs, no value is split between two longs
+static inline void wld_pack_longs(const uint16_t* values, uint16_t count, uint8_t bits, int64_t* data) {
+
+	const uint8_t values_per_long = 64 / bits;
+
+	memset(data, 0, sizeof(int64_t) * wld_packed_length(count, bits));
+
+	for (uint16_t i = 0; i < count; ++i) {
+		data[i / values_per_long] |= (int64_t) ((uint64_t) values[i] << ((i % values_per_long) * bits));
+	}
+
+}
+
+static inline void wld_unpack_longs(const int64_t* data, uint16_t count, uint8_t bits, uint16_t* values) {
+
+	const uint8_t values_per_long = 64 / bits;
+
+	for (uint16_t i = 0; i < count; ++i) {
+		values[i] = ((uint64_t) data[i / values_per_long] >> ((i % values_per_long) * bits)) & (((uint64_t) 1 << bits) - 1);
+	}
+
+}
+
+static inline void wld_push_packed(mnbt_doc* doc, mnbt_val* compound, const char* label, const uint16_t* values, uint16_t count, uint8_t bits) {
+
+	int64_t data[wld_packed_length(count, bits)];
+	wld_pack_longs(values, count, bits, data);
+
+	mnbt_val_push_tag(compound, mnbt_new_tag(doc, label, strlen(label), MNBT_LONG_ARRAY, mnbt_val_long_array(data, wld_packed_length(count, bits))));
+
+}
+
+static void wld_push_block_states(mnbt_doc* doc, mnbt_val* section_nbt, wld_chunk_section_t* section, uint32_t epoch) {
+
+	mnbt_tag* block_states = mnbt_new_tag(doc, UTL_CSTRTOARG("block_states"), MNBT_COMPOUND, mnbt_val_compound());
+
+	wld_block_storage_t* blocks = wld_chunk_section_get_saved_blocks(section, epoch);
+
+	// the data is copied before the palette is read, so the palette has every block it points to
+	int64_t data[blocks->data_length];
+	for (uint16_t i = 0; i < blocks->data_length; ++i) {
+		data[i] = blocks->data[i];
+	}
+
+	// palettes hold protocol ids, entries that were never set are air
+	if (blocks->bits != WLD_STORAGE_DIRECT_BITS) {
+
+		const uint16_t palette_length = blocks->palette_length;
+		int32_t palette[palette_length];
+
+		for (uint16_t i = 0; i < palette_length; ++i) {
+			const mat_block_protocol_id_t block = wld_block_storage_get_palette(blocks)[i];
+			palette[i] = block == WLD_STORAGE_NO_BLOCK ? mat_get_block_default_protocol_id_by_type(mat_block_air) : block;
+		}
+
+		mnbt_push_tag(block_states, mnbt_new_tag(doc, UTL_CSTRTOARG("palette"), MNBT_INT_ARRAY, mnbt_val_int_array(palette, palette_length)));
+
+	}
+
+	if (blocks->bits != 0) {
+		mnbt_push_tag(block_states, mnbt_new_tag(doc, UTL_CSTRTOARG("data"), MNBT_LONG_ARRAY, mnbt_val_long_array(data, blocks->data_length)));
+	}
+
+	mnbt_val_push_tag(section_nbt, block_states);
+
+}
+
+static void wld_push_biomes(mnbt_doc* doc, mnbt_val* section_nbt, wld_chunk_section_t* section) {
+
+	mnbt_val biomes = mnbt_val_compound();
+
+	int32_t palette[64];
+	uint16_t palette_length = 0;
+	uint16_t entries[64];
+
+	// stored y, z, x like blocks are
+	for (uint8_t x = 0; x < 4; ++x) {
+		for (uint8_t z = 0; z < 4; ++z) {
+			for (uint8_t y = 0; y < 4; ++y) {
+
+				const uint8_t biome = wld_chunk_section_get_biome(section, x, y, z);
+
+				uint16_t entry = 0;
+				while (entry < palette_length && palette[entry] != biome) {
+					entry++;
+				}
+				if (entry == palette_length) {
+					palette[palette_length++] = biome;
+				}
+
+				entries[(y << 4) | (z << 2) | x] = entry;
+
+			}
+		}
+	}
+
+	mnbt_val_push_tag(&biomes, mnbt_new_tag(doc, UTL_CSTRTOARG("palette"), MNBT_INT_ARRAY, mnbt_val_int_array(palette, palette_length)));
+
+	if (palette_length > 1) {
+		wld_push_packed(doc, &biomes, "data", entries, 64, wld_bits_for(palette_length));
+	}
+
+	mnbt_val_push_tag(section_nbt, mnbt_new_tag(doc, UTL_CSTRTOARG("biomes"), MNBT_COMPOUND, biomes));
+
+}
+
+/*
+ * Chunks are saved like vanilla saves them, except block state palettes hold protocol ids
+ * and biome palettes hold biome types, instead of names, so they are marked with the format
+ * they are saved in and chunks without it aren't read
+ */
+static mnbt_doc* wld_chunk_to_nbt(wld_chunk_t* chunk) {
+
+	wld_world_t* world = wld_chunk_get_world(chunk);
+	const mat_dimension_t* dimension = mat_get_dimension_by_type(wld_get_environment(world));
+	const uint16_t chunk_height = mat_get_chunk_height(wld_get_environment(world));
+
+	mnbt_doc* doc = mnbt_new();
+	mnbt_tag* root = mnbt_new_tag(doc, UTL_CSTRTOARG(""), MNBT_COMPOUND, mnbt_val_compound());
+
+	mnbt_push_tag(root, mnbt_new_tag(doc, UTL_CSTRTOARG("DataVersion"), MNBT_INT, mnbt_val_int(WLD_DATA_VERSION)));
+	mnbt_push_tag(root, mnbt_new_tag(doc, UTL_CSTRTOARG("MotorFormat"), MNBT_INT, mnbt_val_int(WLD_REGION_FILE_FORMAT)));
+	mnbt_push_tag(root, mnbt_new_tag(doc, UTL_CSTRTOARG("xPos"), MNBT_INT, mnbt_val_int(wld_get_chunk_x(chunk))));
+	mnbt_push_tag(root, mnbt_new_tag(doc, UTL_CSTRTOARG("zPos"), MNBT_INT, mnbt_val_int(wld_get_chunk_z(chunk))));
+	mnbt_push_tag(root, mnbt_new_tag(doc, UTL_CSTRTOARG("yPos"), MNBT_INT, mnbt_val_int(dimension->min_y >> 4)));
+	mnbt_push_tag(root, mnbt_new_tag(doc, UTL_CSTRTOARG("Status"), MNBT_STRING, mnbt_val_string(UTL_CSTRTOARG("full"))));
+	mnbt_push_tag(root, mnbt_new_tag(doc, UTL_CSTRTOARG("LastUpdate"), MNBT_LONG, mnbt_val_long(wld_get_age(world))));
+
+	// sections, empty sections are left out
+	mnbt_tag* sections = mnbt_new_tag(doc, UTL_CSTRTOARG("sections"), MNBT_LIST, mnbt_val_list(MNBT_COMPOUND));
+
+	for (uint16_t i = 0; i < chunk_height; ++i) {
+
+		wld_chunk_section_t* section = wld_chunk_get_section(chunk, i);
+
+		if (wld_chunk_section_is_empty(section)) {
+			continue;
+		}
+
+		mnbt_val section_nbt = mnbt_val_compound();
+		mnbt_val_push_tag(&section_nbt, mnbt_new_tag(doc, UTL_CSTRTOARG("Y"), MNBT_BYTE, mnbt_val_byte(i + (dimension->min_y >> 4))));
+		wld_push_block_states(doc, &section_nbt, section, wld_get_save_epoch(world));
+		wld_push_biomes(doc, &section_nbt, section);
+
+		mnbt_list_push(sections, section_nbt);
+
+	}
+
+	mnbt_push_tag(root, sections);
+
+	// heightmaps, stored as the height above the bottom of the world
+	mnbt_val heightmaps = mnbt_val_compound();
+	const uint8_t heightmap_bits = wld_bits_for((chunk_height << 4) + 1);
+
+	uint16_t heights[256];
+	for (uint16_t i = 0; i < 256; ++i) {
+		heights[i] = wld_chunk_get_highest_motion_blocking(chunk)[i] - dimension->min_y;
+	}
+	wld_push_packed(doc, &heightmaps, "MOTION_BLOCKING", heights, 256, heightmap_bits);
+	for (uint16_t i = 0; i < 256; ++i) {
+		heights[i] = wld_chunk_get_highest_world_surface(chunk)[i] - dimension->min_y;
+	}
+	wld_push_packed(doc, &heightmaps, "WORLD_SURFACE", heights, 256, heightmap_bits);
+
+	mnbt_push_tag(root, mnbt_new_tag(doc, UTL_CSTRTOARG("Heightmaps"), MNBT_COMPOUND, heightmaps));
+
+	mnbt_set_root(doc, root);
+
+	return doc;
+
+}
+
+// the most bytes a chunk can take as nbt, sections with direct block states are the biggest
+static inline size_t wld_chunk_nbt_bound(uint16_t chunk_height) {
+	return 4096 + chunk_height * (1024 * 8 + 4096);
+}
+
+static wld_block_storage_t* wld_block_storage_from_nbt(mnbt_tag* block_states) {
+
+	if (block_states == NULL) {
+		return NULL;
+	}
+
+	mnbt_tag* palette = wld_nbt_get(block_states->value, "palette", MNBT_INT_ARRAY);
+	mnbt_tag* data = wld_nbt_get(block_states->value, "data", MNBT_LONG_ARRAY);
+
+	// the bits per entry are known from the length of the data
+	uint8_t bits = 0;
+	if (data != NULL) {
+
+		const uint8_t possible_bits[] = { 4, 5, 6, 7, 8, WLD_STORAGE_DIRECT_BITS };
+
+		bits = UINT8_MAX;
+		for (size_t i = 0; i < sizeof(possible_bits); ++i) {
+			if (mnbt_get_size(data) == 1 + 4095u / (64 / possible_bits[i])) {
+				bits = possible_bits[i];
+			}
+		}
+
+		if (bits == UINT8_MAX) {
+			return NULL;
+		}
+
+	}
+
+	const uint32_t state_count = mat_get_block_state_count();
+
+	// every entry has to point into the palette, or be a block state if there's none
+	if (data != NULL) {
+
+		const uint32_t entry_count = bits == WLD_STORAGE_DIRECT_BITS ? state_count : (palette == NULL ? 0 : mnbt_get_size(palette));
+
+		uint16_t entries[4096];
+		wld_unpack_longs(mnbt_get_long_array(data), 4096, bits, entries);
+
+		for (uint16_t i = 0; i < 4096; ++i) {
+			if (entries[i] >= entry_count) {
+				return NULL;
+			}
+		}
+
+	}
+
+	if (bits == WLD_STORAGE_DIRECT_BITS) {
+		return wld_create_block_storage_from(bits, NULL, 0, (uint64_t*) mnbt_get_long_array(data));
+	}
+
+	if (palette == NULL || mnbt_get_size(palette) == 0 || mnbt_get_size(palette) > (1u << bits)) {
+		return NULL;
+	}
+
+	const uint16_t palette_length = mnbt_get_size(palette);
+	mat_block_protocol_id_t blocks[palette_length];
+	for (uint16_t i = 0; i < palette_length; ++i) {
+		if (mnbt_get_int_array(palette)[i] < 0 || (uint32_t) mnbt_get_int_array(palette)[i] >= state_count) {
+			return NULL;
+		}
+		blocks[i] = mnbt_get_int_array(palette)[i];
+	}
+
+	return wld_create_block_storage_from(bits, blocks, palette_length, data == NULL ? NULL : (uint64_t*) mnbt_get_long_array(data));
+
+}
+
+static uint16_t wld_block_storage_count_blocks(wld_block_storage_t* storage) {
+
+	uint16_t count = 0;
+
+	if (storage->bits == WLD_STORAGE_DIRECT_BITS) {
+		for (uint16_t i = 0; i < 4096; ++i) {
+			count += !mat_get_block_by_type(mat_get_block_type_by_protocol_id(wld_block_storage_get(storage, i)))->air;
+		}
+		return count;
+	}
+
+	// check each palette entry once
+	bool air[storage->palette_length];
+	for (uint16_t i = 0; i < storage->palette_length; ++i) {
+		air[i] = mat_get_block_by_type(mat_get_block_type_by_protocol_id(wld_block_storage_get_palette(storage)[i]))->air;
+	}
+
+	for (uint16_t i = 0; i < 4096; ++i) {
+		count += !air[wld_block_storage_get_entry(storage, i)];
+	}
+
+	return count;
+
+}
+
+static void wld_biomes_from_nbt(wld_chunk_section_t* section, mnbt_tag* biomes) {
+
+	if (biomes == NULL) {
+		return;
+	}
+
+	mnbt_tag* palette = wld_nbt_get(biomes->value, "palette", MNBT_INT_ARRAY);
+	mnbt_tag* data = wld_nbt_get(biomes->value, "data", MNBT_LONG_ARRAY);
+
+	if (palette == NULL || mnbt_get_size(palette) == 0 || mnbt_get_size(palette) > 64) {
+		return;
+	}
+
+	uint16_t entries[64] = { 0 };
+
+	const uint8_t bits = wld_bits_for(mnbt_get_size(palette));
+	if (bits > 0) {
+		if (data == NULL || mnbt_get_size(data) < wld_packed_length(64, bits)) {
+			return;
+		}
+		wld_unpack_longs(mnbt_get_long_array(data), 64, bits, entries);
+	}
+
+	for (uint8_t x = 0; x < 4; ++x) {
+		for (uint8_t z = 0; z < 4; ++z) {
+			for (uint8_t y = 0; y < 4; ++y) {
+				const uint16_t entry = entries[(y << 4) | (z << 2) | x];
+				if (entry < mnbt_get_size(palette)) {
+					section->biomes[(x << 4) + (z << 2) + y] = mnbt_get_int_array(palette)[entry];
+				}
+			}
+		}
+	}
+
+}
+
+static void wld_heightmap_from_nbt(_Atomic int16_t* heightmap, mnbt_tag* heights, uint8_t bits, int16_t min_y) {
+
+	if (heights == NULL || mnbt_get_size(heights) < wld_packed_length(256, bits)) {
+		return;
+	}
+
+	uint16_t values[256];
+	wld_unpack_longs(mnbt_get_long_array(heights), 256, bits, values);
+
+	for (uint16_t i = 0; i < 256; ++i) {
+		heightmap[i] = values[i] + min_y;
+	}
+
+}
+
+// frees the sections read before a section couldn't be read
+static void wld_free_read_sections(wld_chunk_t* chunk, uint16_t chunk_height) {
+
+	for (uint16_t i = 0; i < chunk_height; ++i) {
+		wld_chunk_section_t* section = chunk->sections[i];
+		if (section != NULL) {
+			wld_free_block_storage(section->blocks);
+			free(section);
+			chunk->sections[i] = NULL;
+		}
+	}
+
+}
+
+// reads the chunk into its sections, false if any part of it can't be read, then nothing is read
+static bool wld_chunk_from_nbt(wld_chunk_t* chunk, mnbt_tag* root) {
+
+	if (root == NULL || mnbt_get_type(root) != MNBT_COMPOUND) {
+		return false;
+	}
+
+	wld_world_t* world = wld_chunk_get_world(chunk);
+	const mat_dimension_t* dimension = mat_get_dimension_by_type(wld_get_environment(world));
+	const uint16_t chunk_height = mat_get_chunk_height(wld_get_environment(world));
+
+	mnbt_tag* format = wld_nbt_get(root->value, "MotorFormat", MNBT_INT);
+
+	if (format == NULL || mnbt_get_int(format) != WLD_REGION_FILE_FORMAT) {
+		log_error("Chunk %d, %d wasn't saved in a format that can be read", wld_get_chunk_x(chunk), wld_get_chunk_z(chunk));
+		return false;
+	}
+
+	// blocks are saved as protocol ids, which are different in other versions
+	mnbt_tag* data_version = wld_nbt_get(root->value, "DataVersion", MNBT_INT);
+
+	if (data_version == NULL || mnbt_get_int(data_version) != WLD_DATA_VERSION) {
+		log_error("Chunk %d, %d was saved by another version (%d)", wld_get_chunk_x(chunk), wld_get_chunk_z(chunk), data_version == NULL ? 0 : mnbt_get_int(data_version));
+		return false;
+	}
+
+	mnbt_tag* sections = wld_nbt_get(root->value, "sections", MNBT_LIST);
+
+	if (sections == NULL || (mnbt_get_size(sections) != 0 && mnbt_get_list_type(sections) != MNBT_COMPOUND)) {
+		return false;
+	}
+
+	for (uint32_t i = 0; i < mnbt_get_size(sections); ++i) {
+
+		const mnbt_val section_nbt = mnbt_get_list(sections, i);
+
+		mnbt_tag* y = wld_nbt_get(section_nbt, "Y", MNBT_BYTE);
+		if (y == NULL) {
+			continue;
+		}
+
+		const int16_t index = mnbt_get_byte(y) - (dimension->min_y >> 4);
+		if (index < 0 || index >= chunk_height || chunk->sections[index] != NULL) {
+			continue;
+		}
+
+		wld_block_storage_t* blocks = wld_block_storage_from_nbt(wld_nbt_get(section_nbt, "block_states", MNBT_COMPOUND));
+		if (blocks == NULL) {
+			log_error("Invalid block states in chunk %d, %d", wld_get_chunk_x(chunk), wld_get_chunk_z(chunk));
+			wld_free_read_sections(chunk, chunk_height);
+			return false;
+		}
+
+		wld_chunk_section_t* section = calloc(1, sizeof(wld_chunk_section_t));
+		section->blocks = blocks;
+		section->block_count = wld_block_storage_count_blocks(blocks);
+		wld_biomes_from_nbt(section, wld_nbt_get(section_nbt, "biomes", MNBT_COMPOUND));
+
+		chunk->sections[index] = section;
+
+	}
+
+	mnbt_tag* heightmaps = wld_nbt_get(root->value, "Heightmaps", MNBT_COMPOUND);
+	if (heightmaps != NULL) {
+		const uint8_t heightmap_bits = wld_bits_for((chunk_height << 4) + 1);
+		wld_heightmap_from_nbt(chunk->highest.motion_blocking, wld_nbt_get(heightmaps->value, "MOTION_BLOCKING", MNBT_LONG_ARRAY), heightmap_bits, dimension->min_y);
+		wld_heightmap_from_nbt(chunk->highest.world_surface, wld_nbt_get(heightmaps->value, "WORLD_SURFACE", MNBT_LONG_ARRAY), heightmap_bits, dimension->min_y);
+	}
+
+	return true;
+
+}
+
+wld_region_file_load_t wld_region_file_load_chunk(wld_region_file_t* file, wld_chunk_t* chunk) {
+
+	const uint16_t index = ((uint16_t) chunk->z << 5) | chunk->x;
+
+	bool saved = false;
+	const byte_t* compressed = NULL;
+	uint32_t length = 0;
+	wld_compression_t compression = wld_compression_none;
+
+	// only finding the chunk needs the file locked, the mapping never moves and the sectors of a chunk that is loading
+	// aren't written, so it is decompressed and read straight from the mapping while other threads use the file
+	with_lock (&file->lock) {
+
+		saved = wld_region_file_has_chunk_l(file, index);
+
+		if (saved) {
+			compressed = wld_region_file_get_chunk_l(file, index, &length, &compression);
+		}
+
+	}
+
+	if (!saved) {
+		return wld_region_file_missing;
+	}
+
+	if (compressed == NULL) {
+		return wld_region_file_unreadable;
+	}
+
+	mnbt_doc* doc = wld_region_file_read(compressed, length, compression);
+
+	if (doc == NULL) {
+		return wld_region_file_unreadable;
+	}
+
+	const bool loaded = wld_chunk_from_nbt(chunk, mnbt_get_root(doc));
+
+	mnbt_free(doc);
+
+	return loaded ? wld_region_file_loaded : wld_region_file_unreadable;
+
+}
+
+byte_t* wld_region_file_encode_chunk(wld_chunk_t* chunk, size_t* length) {
+
+	mnbt_doc* doc = wld_chunk_to_nbt(chunk);
+
+	byte_t* uncompressed = malloc(wld_chunk_nbt_bound(mat_get_chunk_height(wld_get_environment(wld_chunk_get_world(chunk)))));
+	*length = mnbt_write(doc, uncompressed, MNBT_NONE);
+
+	mnbt_free(doc);
+
+	return uncompressed;
+
+}
+
+bool wld_region_file_write_chunk(wld_region_file_t* file, wld_chunk_t* chunk, byte_t* uncompressed, size_t length) {
+
+	// length and compression type come before the compressed chunk
+	struct libdeflate_compressor* compressor = wld_get_compressor();
+	const size_t capacity = libdeflate_zlib_compress_bound(compressor, length);
+	byte_t* bytes = malloc(capacity + 5);
+
+	const size_t compressed_length = libdeflate_zlib_compress(compressor, uncompressed, length, bytes + 5, capacity);
+	io_write_int32(bytes, compressed_length + 1, io_big_endian);
+	bytes[4] = wld_compression_zlib;
+
+	free(uncompressed);
+
+	bool saved = false;
+
+	with_lock (&file->lock) {
+		saved = wld_region_file_write_l(file, ((uint16_t) chunk->z << 5) | chunk->x, bytes, compressed_length + 5);
+	}
+
+	free(bytes);
+
+	return saved;
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <pthread.h>
+#include "../main.h"
+#include "world.d.h"
+
+#define WLD_REGION_FILE_SECTOR 4096 // chunks are stored in sectors of this many bytes
+#define WLD_REGION_FILE_HEADER_SECTORS 2 // the locations of the chunks, then the times they were saved
+#define WLD_REGION_FILE_MAX_SECTORS 255 // sectors a chunk can use, bigger chunks can't be saved
+#define WLD_REGION_FILE_FORMAT 1 // saved with every chunk, chunks without it weren't saved by motor and can't be read
+#define WLD_REGION_FILE_MAPPED ((size_t) (WLD_REGION_FILE_HEADER_SECTORS + 1025 * WLD_REGION_FILE_MAX_SECTORS) * WLD_REGION_FILE_SECTOR) // the biggest the file gets from saving, every chunk at its biggest and one being moved
+
+/*
+ * An Anvil (.mca) region file, holding the chunks of a region
+ *
+ * The first two sectors are the header, the location (offset and sector count) of each chunk, then the time it was saved
+ * The file is mapped into memory once, chunks are read straight from the mapping and written with pwrite,
+ * the mapping is as big as the file can get so it never moves, and chunks are read from it without the file locked
+ */
+struct wld_region_file {
+
+	pthread_mutex_t lock;
+
+	int fd;
+
+	// the mapped file, the mapping is bigger than the file, only length bytes can be read
+	const byte_t* bytes;
+	size_t length;
+	size_t mapped;
+
+	// sectors that are used by the header or a chunk
+	bool* used;
+	uint32_t sectors;
+
+};
+
+// opens the region file, creating it if it doesn't exist, NULL on error
+extern wld_region_file_t* wld_open_region_file(const char* path);
+extern void wld_close_region_file(wld_region_file_t* file);
+
+typedef enum {
+
+	wld_region_file_missing, // the chunk isn't in the file
+	wld_region_file_loaded,
+	wld_region_file_unreadable // the chunk is in the file but couldn't be read, nothing is loaded
+
+} wld_region_file_load_t;
+
+// loads the chunk from the region file
+extern wld_region_file_load_t wld_region_file_load_chunk(wld_region_file_t* file, wld_chunk_t* chunk);
+
+// encodes the chunk as uncompressed nbt, as it was when the save in progress started, the chunk should be locked
+extern byte_t* wld_region_file_encode_chunk(wld_chunk_t* chunk, size_t* length);
+// compresses the encoded chunk and writes it to the region file, freeing the encoded chunk
+extern bool wld_region_file_write_chunk(wld_region_file_t* file, wld_chunk_t* chunk, byte_t* uncompressed, size_t length);
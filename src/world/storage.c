@@ -0,0 +1,289 @@
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+#include "storage.h"
+#include "../util/lock_util.h"
+
+#define WLD_STORAGE_SPINS 64 // times a writer pauses while a storage is copied, before it gives up its core
+
+// storages replaced since the last reclaim, and the ones replaced before it, which are freed by the next one
+static struct {
+
+	pthread_mutex_t lock;
+
+	wld_block_storage_t* retired;
+	wld_block_storage_t* reclaimable;
+
+} wld_retired_storages = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.retired = NULL,
+	.reclaimable = NULL
+};
+
+// waits a little for the thread copying a storage, yielding once it takes longer, it could have been descheduled
+static inline void wld_block_storage_back_off(uint32_t* spins) {
+
+	if (++*spins < WLD_STORAGE_SPINS) {
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#elif defined(__aarch64__)
+		__asm__ volatile ("yield");
+#endif
+	} else {
+		sched_yield();
+	}
+
+}
+
+wld_block_storage_t* wld_create_block_storage(uint8_t bits, mat_block_protocol_id_t block) {
+
+	uint16_t palette_capacity = 0;
+	uint16_t data_length = 0;
+
+	if (bits == 0) {
+		palette_capacity = 1;
+	} else {
+		if (bits != WLD_STORAGE_DIRECT_BITS) {
+			palette_capacity = 1 << bits;
+		}
+		data_length = 1 + (4095 / (64 / bits));
+	}
+
+	wld_block_storage_t* storage = malloc(sizeof(wld_block_storage_t) + sizeof(uint64_t) * data_length + sizeof(mat_block_protocol_id_t) * palette_capacity);
+
+	storage->next_retired = NULL;
+	storage->frozen = false;
+	storage->bits = bits;
+	storage->palette_capacity = palette_capacity;
+	storage->data_length = data_length;
+
+	if (bits == WLD_STORAGE_DIRECT_BITS) {
+
+		storage->palette_length = 0;
+
+		// every entry is the block itself
+		uint64_t data = 0;
+		for (uint8_t i = 0; i < wld_block_storage_get_values_per_long(storage); ++i) {
+			data |= (uint64_t) block << (i * bits);
+		}
+		for (uint16_t i = 0; i < data_length; ++i) {
+			storage->data[i] = data;
+		}
+
+	} else {
+
+		storage->palette_length = 1;
+
+		// every entry is the first in the palette
+		memset((uint64_t*) storage->data, 0, sizeof(uint64_t) * data_length);
+		memset((mat_block_protocol_id_t*) wld_block_storage_get_palette(storage), 0xFF, sizeof(mat_block_protocol_id_t) * palette_capacity);
+		wld_block_storage_get_palette(storage)[0] = block;
+
+	}
+
+	return storage;
+
+}
+
+wld_block_storage_t* wld_create_block_storage_from(uint8_t bits, const mat_block_protocol_id_t* palette, uint16_t palette_length, const uint64_t* data) {
+
+	wld_block_storage_t* storage = wld_create_block_storage(bits, bits == WLD_STORAGE_DIRECT_BITS ? 0 : palette[0]);
+
+	if (bits != WLD_STORAGE_DIRECT_BITS) {
+		for (uint16_t i = 0; i < palette_length; ++i) {
+			wld_block_storage_get_palette(storage)[i] = palette[i];
+		}
+		storage->palette_length = palette_length;
+	}
+
+	for (uint16_t i = 0; i < storage->data_length; ++i) {
+		storage->data[i] = data[i];
+	}
+
+	return storage;
+
+}
+
+wld_block_storage_t* wld_copy_block_storage(wld_block_storage_t* storage) {
+
+	// the data is copied before the palette is read, so the palette has every block it points to
+	uint64_t data[storage->data_length];
+	for (uint16_t i = 0; i < storage->data_length; ++i) {
+		data[i] = storage->data[i];
+	}
+
+	const uint16_t palette_length = storage->palette_length;
+	mat_block_protocol_id_t palette[palette_length + 1];
+	for (uint16_t i = 0; i < palette_length; ++i) {
+		palette[i] = wld_block_storage_get_palette(storage)[i];
+	}
+
+	return wld_create_block_storage_from(storage->bits, palette, palette_length, data);
+
+}
+
+void wld_free_block_storage(wld_block_storage_t* storage) {
+
+	free(storage);
+
+}
+
+void wld_reclaim_block_storages() {
+
+	wld_block_storage_t* reclaimable = NULL;
+
+	with_lock (&wld_retired_storages.lock) {
+		reclaimable = wld_retired_storages.reclaimable;
+		wld_retired_storages.reclaimable = wld_retired_storages.retired;
+		wld_retired_storages.retired = NULL;
+	}
+
+	while (reclaimable != NULL) {
+		wld_block_storage_t* next = reclaimable->next_retired;
+		free(reclaimable);
+		reclaimable = next;
+	}
+
+}
+
+// gets the entry of a block, adding it to the palette if it isn't in it yet, returns -1 if the palette is full
+static inline int32_t wld_block_storage_claim_entry(wld_block_storage_t* storage, mat_block_protocol_id_t block) {
+
+	if (storage->bits == WLD_STORAGE_DIRECT_BITS) {
+		return block;
+	}
+
+	_Atomic mat_block_protocol_id_t* palette = wld_block_storage_get_palette(storage);
+
+	uint16_t length = storage->palette_length;
+	for (uint16_t i = 0; i < length; ++i) {
+		if (palette[i] == block) {
+			return i;
+		}
+	}
+
+	// two threads could add the same block at once, which only wastes an entry
+	do {
+		if (length == storage->palette_capacity) {
+			return -1;
+		}
+	} while (!atomic_compare_exchange_weak(&storage->palette_length, &length, length + 1));
+
+	palette[length] = block;
+
+	return length;
+
+}
+
+// copies the storage into one with more bits per entry and replaces it
+static void wld_block_storage_grow(wld_block_storage_t* _Atomic* reference, wld_block_storage_t* storage) {
+
+	// only one thread copies the storage
+	bool frozen = false;
+	if (!atomic_compare_exchange_strong(&storage->frozen, &frozen, true)) {
+		return;
+	}
+
+	uint8_t bits;
+	if (storage->bits == 0) {
+		bits = 4;
+	} else if (storage->bits < 8) {
+		bits = storage->bits + 1;
+	} else {
+		bits = WLD_STORAGE_DIRECT_BITS;
+	}
+
+	// entries are read before the palette, so the palette has every block they point to
+	uint16_t entries[4096];
+	for (uint16_t i = 0; i < 4096; ++i) {
+		entries[i] = wld_block_storage_get_entry(storage, i);
+	}
+
+	_Atomic mat_block_protocol_id_t* palette = wld_block_storage_get_palette(storage);
+
+	wld_block_storage_t* copy = wld_create_block_storage(bits, palette[0]);
+
+	if (bits == WLD_STORAGE_DIRECT_BITS) {
+		for (uint16_t i = 0; i < 4096; ++i) {
+			entries[i] = palette[entries[i]];
+		}
+	} else {
+		const uint16_t palette_length = storage->palette_length;
+		for (uint16_t i = 0; i < palette_length; ++i) {
+			wld_block_storage_get_palette(copy)[i] = palette[i];
+		}
+		copy->palette_length = palette_length;
+	}
+
+	const uint8_t values_per_long = wld_block_storage_get_values_per_long(copy);
+	for (uint16_t i = 0; i < copy->data_length; ++i) {
+		uint64_t data = 0;
+		for (uint8_t j = 0; j < values_per_long && i * values_per_long + j < 4096; ++j) {
+			data |= (uint64_t) entries[i * values_per_long + j] << (j * bits);
+		}
+		copy->data[i] = data;
+	}
+
+	*reference = copy;
+
+	with_lock (&wld_retired_storages.lock) {
+		storage->next_retired = wld_retired_storages.retired;
+		wld_retired_storages.retired = storage;
+	}
+
+}
+
+mat_block_protocol_id_t wld_block_storage_set(wld_block_storage_t* _Atomic* reference, uint16_t index, mat_block_protocol_id_t block) {
+
+	bool written = false;
+	mat_block_protocol_id_t previous = block;
+	uint32_t spins = 0;
+
+	for (;;) {
+
+		wld_block_storage_t* storage = *reference;
+
+		// being copied, wait for the copy to replace it
+		if (storage->frozen) {
+			wld_block_storage_back_off(&spins);
+			continue;
+		}
+
+		const int32_t entry = wld_block_storage_claim_entry(storage, block);
+
+		if (entry == -1) {
+			wld_block_storage_grow(reference, storage);
+			continue;
+		}
+
+		// a single block storage can only be set to the block it already has
+		if (storage->bits != 0) {
+
+			const uint8_t values_per_long = wld_block_storage_get_values_per_long(storage);
+			const uint8_t shift = (index % values_per_long) * storage->bits;
+			const uint64_t mask = ((uint64_t) 1 << storage->bits) - 1;
+
+			_Atomic uint64_t* data = &storage->data[index / values_per_long];
+			uint64_t old_data = *data;
+			while (!atomic_compare_exchange_weak(data, &old_data, (old_data & ~(mask << shift)) | ((uint64_t) entry << shift)));
+
+			if (!written) {
+				const uint16_t old_entry = (old_data >> shift) & mask;
+				previous = storage->bits == WLD_STORAGE_DIRECT_BITS ? old_entry : wld_block_storage_get_palette(storage)[old_entry];
+			}
+
+		}
+
+		written = true;
+
+		// the copy might not have the block, so it is set again on the copy
+		if (storage->frozen) {
+			continue;
+		}
+
+		return previous;
+
+	}
+
+}
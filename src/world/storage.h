@@ -0,0 +1,82 @@
+#pragma once
+#include "../main.h"
+#include "world.d.h"
+#include "material/blocks.h"
+
+#define WLD_STORAGE_DIRECT_BITS 15 // log2(block state count)
+#define WLD_STORAGE_NO_BLOCK 0xFFFF // palette entry that has been claimed, but not set yet
+
+/*
+ * Block states of a chunk section, stored as indices into a palette (or block states directly once it gets too big)
+ * the layout of the data is the same as in the chunk data packet
+ *
+ * Reads and writes don't lock, when the palette is full the storage is copied into a bigger one,
+ * writes made while it is being copied are made again on the copy, readers could still be using the old one
+ * so it is only freed at the end of the next tick
+ */
+struct wld_block_storage {
+
+	// the storage replaced before this one, while they wait to be freed
+	wld_block_storage_t* next_retired;
+
+	// set when the storage starts being copied into a bigger one
+	_Atomic bool frozen;
+
+	// 0 = single block, 4 to 8 = palette, 15 = direct
+	uint8_t bits;
+
+	uint16_t palette_capacity;
+	_Atomic uint16_t palette_length;
+
+	uint16_t data_length;
+	_Atomic uint64_t data[]; // the palette follows the data
+
+};
+
+extern wld_block_storage_t* wld_create_block_storage(uint8_t bits, mat_block_protocol_id_t block);
+// creates a storage from data packed with the bits given and its palette (ignored if direct)
+extern wld_block_storage_t* wld_create_block_storage_from(uint8_t bits, const mat_block_protocol_id_t* palette, uint16_t palette_length, const uint64_t* data);
+// copies the storage as it is now
+extern wld_block_storage_t* wld_copy_block_storage(wld_block_storage_t* storage);
+extern void wld_free_block_storage(wld_block_storage_t* storage);
+
+// frees the storages replaced before the last call, called at the end of every tick
+// readers only keep a storage while they read a section, so they are done with it a tick after it's replaced
+extern void wld_reclaim_block_storages();
+
+// sets the block at the index, returning the block that was there before
+extern mat_block_protocol_id_t wld_block_storage_set(wld_block_storage_t* _Atomic* reference, uint16_t index, mat_block_protocol_id_t block);
+
+static inline _Atomic mat_block_protocol_id_t* wld_block_storage_get_palette(wld_block_storage_t* storage) {
+	return (_Atomic mat_block_protocol_id_t*) &storage->data[storage->data_length];
+}
+
+static inline uint8_t wld_block_storage_get_values_per_long(wld_block_storage_t* storage) {
+	return 64 / storage->bits;
+}
+
+// gets the palette index (or block state if direct) at the index
+static inline uint16_t wld_block_storage_get_entry(wld_block_storage_t* storage, uint16_t index) {
+
+	if (storage->bits == 0) {
+		return 0;
+	}
+
+	const uint8_t values_per_long = wld_block_storage_get_values_per_long(storage);
+	const uint64_t data = storage->data[index / values_per_long];
+
+	return (data >> ((index % values_per_long) * storage->bits)) & ((1 << storage->bits) - 1);
+
+}
+
+static inline mat_block_protocol_id_t wld_block_storage_get(wld_block_storage_t* storage, uint16_t index) {
+
+	const uint16_t entry = wld_block_storage_get_entry(storage, index);
+
+	if (storage->bits == WLD_STORAGE_DIRECT_BITS) {
+		return entry;
+	}
+
+	return wld_block_storage_get_palette(storage)[entry];
+
+}
@@ -1,16 +1,48 @@
 #include "world.h"
+#include "region_file.h"
 #include "../util/vector.h"
 #include "../util/id_vector.h"
+#include "../util/dll.h"
+#include "../util/str_util.h"
 #include "../listening/listening.h"
 #include "../io/logger/logger.h"
+#include "../io/filesystem/filesystem.h"
+#include "../io/nbt/mnbt.h"
 #include "../motor.h"
 #include "../jobs/scheduler/scheduler.h"
+#include "../jobs/tick/tick.h"
 #include "entity/living/player/player.h"
 #include <stdlib.h>
+#include <stdio.h>
 
 // worlds global vector
 utl_id_vector_t wld_worlds = UTL_ID_VECTOR_INITIALIZER(wld_world_t*);
 
+// chunks with a cached chunk data packet, least recently sent first
+struct {
+	pthread_mutex_t lock;
+	utl_dll_t chunks;
+} wld_cached_chunk_packets = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.chunks = UTL_DLL_INITIALIZER
+};
+
+// chunks waiting to be read or generated by the chunk I/O threads, which are started with the first chunk queued
+struct {
+	pthread_mutex_t lock;
+	pthread_cond_t queued;
+	pthread_cond_t loaded;
+	utl_list_t queue;
+	pthread_t threads[WLD_CHUNK_IO_THREADS];
+	bool running;
+} wld_chunk_io = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.queued = PTHREAD_COND_INITIALIZER,
+	.loaded = PTHREAD_COND_INITIALIZER,
+	.queue = UTL_LIST_INITIALIZER(wld_chunk_t*),
+	.running = false
+};
+
 static inline uint16_t wld_add(wld_world_t* world) {
 	
 	uint16_t id = 0;
@@ -23,16 +55,21 @@ static inline uint16_t wld_add(wld_world_t* world) {
 
 static inline void wld_prepare_spawn(wld_world_t* world) {
 	
-	const wld_chunk_t* spawn_chunk = wld_gen_chunk(wld_get_region_at(world, world->spawn.x, world->spawn.z), (world->spawn.x >> 4) & 0x1F, (world->spawn.z >> 4) & 0x1F, 3);
+	const wld_chunk_t* spawn_chunk = wld_request_chunk(wld_get_region_at(world, world->spawn.x, world->spawn.z), (world->spawn.x >> 4) & 0x1F, (world->spawn.z >> 4) & 0x1F, 3);
 
-	// prepare spawn region
+	// prepare spawn region, every chunk is queued first so they load in parallel
+	wld_chunk_t* chunks[23 * 23];
 	for (int32_t x = -11; x <= 11; ++x) {
 		for (int32_t z = -11; z <= 11; ++z) {
 			assert(UTL_MAX(14 - (11 - UTL_ABS(x)), 14 - (11 - UTL_ABS(z))) != WLD_TICKET_INACCESSIBLE);
-			wld_gen_relative_chunk(spawn_chunk, x, z, UTL_MAX(14 - (11 - UTL_ABS(x)), 14 - (11 - UTL_ABS(z))));
+			chunks[(x + 11) * 23 + z + 11] = wld_request_relative_chunk(spawn_chunk, x, z, UTL_MAX(14 - (11 - UTL_ABS(x)), 14 - (11 - UTL_ABS(z))));
 		}
 	}
 
+	for (size_t i = 0; i < 23 * 23; ++i) {
+		wld_await_chunk(chunks[i]);
+	}
+
 }
 
 static inline uint64_t wld_hash_seed(int64_t seed) {
@@ -49,6 +86,60 @@ static inline uint64_t wld_hash_seed(int64_t seed) {
 
 }
 
+// level.dat holds what is needed to load the world again, in the same layout as vanilla
+static void wld_save_level(wld_world_t* world) {
+
+	mnbt_doc* doc = mnbt_new();
+	mnbt_tag* data = mnbt_new_tag(doc, UTL_CSTRTOARG("Data"), MNBT_COMPOUND, mnbt_val_compound());
+
+	mnbt_push_tag(data, mnbt_new_tag(doc, UTL_CSTRTOARG("DataVersion"), MNBT_INT, mnbt_val_int(WLD_DATA_VERSION)));
+	mnbt_push_tag(data, mnbt_new_tag(doc, UTL_CSTRTOARG("LevelName"), MNBT_STRING, mnbt_val_string(UTL_STRTOARG(world->name))));
+	mnbt_push_tag(data, mnbt_new_tag(doc, UTL_CSTRTOARG("SpawnX"), MNBT_INT, mnbt_val_int(world->spawn.x)));
+	mnbt_push_tag(data, mnbt_new_tag(doc, UTL_CSTRTOARG("SpawnZ"), MNBT_INT, mnbt_val_int(world->spawn.z)));
+	mnbt_push_tag(data, mnbt_new_tag(doc, UTL_CSTRTOARG("Time"), MNBT_LONG, mnbt_val_long(world->age)));
+	mnbt_push_tag(data, mnbt_new_tag(doc, UTL_CSTRTOARG("DayTime"), MNBT_LONG, mnbt_val_long(world->time)));
+
+	mnbt_tag* settings = mnbt_new_tag(doc, UTL_CSTRTOARG("WorldGenSettings"), MNBT_COMPOUND, mnbt_val_compound());
+	mnbt_push_tag(settings, mnbt_new_tag(doc, UTL_CSTRTOARG("seed"), MNBT_LONG, mnbt_val_long(world->seed)));
+	mnbt_push_tag(data, settings);
+
+	mnbt_tag* root = mnbt_new_tag(doc, UTL_CSTRTOARG(""), MNBT_COMPOUND, mnbt_val_compound());
+	mnbt_push_tag(root, data);
+	mnbt_set_root(doc, root);
+
+	char path[world->name.length + 16];
+	sprintf(path, "%s/level.dat", UTL_STRTOCSTR(world->name));
+
+	if (mnbt_write_file(doc, path, 4096, MNBT_GZIP) == 0) {
+		log_error("Could not save %s", path);
+	}
+
+	mnbt_free(doc);
+
+}
+
+static inline mnbt_tag* wld_get_level_tag(mnbt_tag* compound, const char* label, mnbt_type type) {
+
+	for (uint32_t i = 0; i < mnbt_get_size(compound); ++i) {
+		mnbt_tag* tag = mnbt_get_tag(compound, i);
+		if (mnbt_get_type(tag) == type && strcmp(mnbt_get_label(tag), label) == 0) {
+			return tag;
+		}
+	}
+
+	return NULL;
+
+}
+
+static inline void wld_create_region_file(wld_region_t* region) {
+
+	char path[region->world->name.length + 32];
+	sprintf(path, "%s/region/r.%d.%d.mca", UTL_STRTOCSTR(region->world->name), region->x, region->z);
+
+	region->file = wld_open_region_file(path);
+
+}
+
 wld_world_t* wld_new(const string_t name, int64_t seed, mat_dimension_type_t environment) {
 
 	wld_world_t* world = calloc(1, sizeof(wld_world_t));
@@ -60,7 +151,7 @@ wld_world_t* wld_new(const string_t name, int64_t seed, mat_dimension_type_t env
 		.seed_hash = wld_hash_seed(seed),
 		.environment = environment,
 		.name = name,
-		.regions = UTL_TREE_INITIALIZER,
+		.regions = UTL_HASH_MAP_INITIALIZER,
 		.id = id,
 		.spawn = {
 			.x = (rand() % 512) - 256,
@@ -72,9 +163,17 @@ wld_world_t* wld_new(const string_t name, int64_t seed, mat_dimension_type_t env
 	};
 	memcpy(world, &world_init, sizeof(wld_world_t));
 
+	char path[name.length + 8];
+	sprintf(path, "%s/region", UTL_STRTOCSTR(name));
+	fs_mkdir(UTL_STRTOCSTR(name));
+	fs_mkdir(path);
+
+	wld_save_level(world);
+
 	wld_prepare_spawn(world);
 
-	world->tick = sch_schedule_repeating(job_new(job_tick_world, (job_payload_t) { .world = world }), 1, 1);
+	world->tick = tck_schedule_repeating(job_new(job_tick_world, (job_payload_t) { .world = world }));
+	world->autosave = sch_schedule_repeating(job_new(job_save_world, (job_payload_t) { .world = world }), WLD_AUTOSAVE_INTERVAL, WLD_AUTOSAVE_INTERVAL);
 
 	return world;
 
@@ -82,24 +181,72 @@ wld_world_t* wld_new(const string_t name, int64_t seed, mat_dimension_type_t env
 
 wld_world_t* wld_load(const string_t name) {
 
+	int64_t seed = 0;
+	int32_t spawn_x = 0;
+	int32_t spawn_z = 0;
+	uint64_t age = 0;
+	uint16_t time = 0;
+
+	char path[name.length + 16];
+	sprintf(path, "%s/level.dat", UTL_STRTOCSTR(name));
+
+	mnbt_doc* level = mnbt_read_file(path, MNBT_GZIP);
+	mnbt_tag* data = (level == NULL || mnbt_get_root(level) == NULL) ? NULL : wld_get_level_tag(mnbt_get_root(level), "Data", MNBT_COMPOUND);
+
+	if (data != NULL) {
+
+		mnbt_tag* settings = wld_get_level_tag(data, "WorldGenSettings", MNBT_COMPOUND);
+		mnbt_tag* tag = settings == NULL ? NULL : wld_get_level_tag(settings, "seed", MNBT_LONG);
+		if (tag != NULL) {
+			seed = mnbt_get_long(tag);
+		}
+		if ((tag = wld_get_level_tag(data, "SpawnX", MNBT_INT)) != NULL) {
+			spawn_x = mnbt_get_int(tag);
+		}
+		if ((tag = wld_get_level_tag(data, "SpawnZ", MNBT_INT)) != NULL) {
+			spawn_z = mnbt_get_int(tag);
+		}
+		if ((tag = wld_get_level_tag(data, "Time", MNBT_LONG)) != NULL) {
+			age = mnbt_get_long(tag);
+		}
+		if ((tag = wld_get_level_tag(data, "DayTime", MNBT_LONG)) != NULL) {
+			time = mnbt_get_long(tag) % 24000;
+		}
+
+	} else {
+		log_error("Could not read %s", path);
+	}
+
+	if (level != NULL) {
+		mnbt_free(level);
+	}
+
 	wld_world_t* world = calloc(1, sizeof(wld_world_t));
 	const uint16_t id = wld_add(world);
 	wld_world_t world_init = {
 		.lock = PTHREAD_MUTEX_INITIALIZER,
+		.seed = seed,
+		.seed_hash = wld_hash_seed(seed),
 		.name = name,
-		.regions = UTL_TREE_INITIALIZER,
+		.regions = UTL_HASH_MAP_INITIALIZER,
 		.id = id,
-		.age = 0,
-		.time = 0,
+		.spawn = {
+			.x = spawn_x,
+			.z = spawn_z
+		},
+		.age = age,
+		.time = time,
 		.time_progressing = true,
 	};
 	memcpy(world, &world_init, sizeof(wld_world_t));
 
-	// TODO load world
+	sprintf(path, "%s/region", UTL_STRTOCSTR(name));
+	fs_mkdir(path);
 
 	wld_prepare_spawn(world);
 
-	world->tick = sch_schedule_repeating(job_new(job_tick_world, (job_payload_t) { .world = world }), 1, 1);
+	world->tick = tck_schedule_repeating(job_new(job_tick_world, (job_payload_t) { .world = world }));
+	world->autosave = sch_schedule_repeating(job_new(job_save_world, (job_payload_t) { .world = world }), WLD_AUTOSAVE_INTERVAL, WLD_AUTOSAVE_INTERVAL);
 
 	return world;
 
@@ -126,56 +273,248 @@ wld_world_t* wld_get_world(uint16_t world_id) {
 wld_region_t* wld_gen_region(wld_world_t* world, int16_t x, int16_t z) {
 
 	wld_region_t* region = calloc(1, sizeof(wld_region_t));
-	const int64_t key = ((uint64_t) (uint16_t) x << 16) | (uint16_t) z;
-
-	// tick job
-	uint32_t tick_job = job_new(job_tick_region, (job_payload_t) { .region = region });
+	wld_region_t* existing = NULL;
 
 	with_lock (&world->lock) {
-		wld_region_t region_init = (wld_region_t) {
-			.world = world,
-			.x = x,
-			.z = z,
-			.relative = {
-				.north = utl_tree_get(&world->regions, ((uint64_t) (uint16_t) x << 16) | (uint16_t) (z - 1)),
-				.south = utl_tree_get(&world->regions, ((uint64_t) (uint16_t) x << 16) | (uint16_t) (z + 1)),
-				.west = utl_tree_get(&world->regions, ((uint64_t) (uint16_t) (x - 1) << 16) | (uint16_t) z),
-				.east = utl_tree_get(&world->regions, ((uint64_t) (uint16_t) (x + 1) << 16) | (uint16_t) z)
+
+		// another thread could have created it first
+		existing = utl_hash_map_get(&world->regions, wld_region_key(x, z));
+
+		if (existing == NULL) {
+
+			wld_region_t region_init = (wld_region_t) {
+				.world = world,
+				.x = x,
+				.z = z,
+				.relative = {
+					.north = utl_hash_map_get(&world->regions, wld_region_key(x, z - 1)),
+					.south = utl_hash_map_get(&world->regions, wld_region_key(x, z + 1)),
+					.west = utl_hash_map_get(&world->regions, wld_region_key(x - 1, z)),
+					.east = utl_hash_map_get(&world->regions, wld_region_key(x + 1, z))
+				}
+			};
+			memcpy(region, &region_init, sizeof(wld_region_t));
+			ent_init_store(&region->entities, x << 9, z << 9);
+
+			// the region file is opened before the region can be found
+			wld_create_region_file(region);
+
+			if (region->relative.north != NULL) {
+				region->relative.north->relative.south = region;
+			}
+			if (region->relative.south != NULL) {
+				region->relative.south->relative.north = region;
+			}
+			if (region->relative.west != NULL) {
+				region->relative.west->relative.east = region;
+			}
+			if (region->relative.east != NULL) {
+				region->relative.east->relative.west = region;
 			}
-		};
-		memcpy(region, &region_init, sizeof(wld_region_t));
+			utl_hash_map_put(&world->regions, wld_region_key(x, z), region);
+			
+			// tick jobs
+			region->tick = tck_schedule_repeating(job_new(job_tick_region, (job_payload_t) { .region = region }));
+			region->update_blocks = tck_schedule_repeating(job_new(job_update_region_blocks, (job_payload_t) { .region = region }));
 
-		if (region->relative.north != NULL) {
-			region->relative.north->relative.south = region;
 		}
-		if (region->relative.south != NULL) {
-			region->relative.south->relative.north = region;
+
+	}
+
+	if (existing != NULL) {
+		free(region);
+		return existing;
+	}
+
+	return region;
+
+}
+
+wld_chunk_section_t wld_empty_section;
+
+static pthread_once_t wld_empty_section_once = PTHREAD_ONCE_INIT;
+
+static void wld_init_empty_section() {
+	wld_empty_section.blocks = wld_create_block_storage(0, mat_get_block_default_protocol_id_by_type(mat_block_air));
+}
+
+wld_chunk_section_t* wld_chunk_create_section(wld_chunk_t* chunk, uint16_t index) {
+
+	wld_chunk_section_t* section = chunk->sections[index];
+
+	if (section != NULL) {
+		return section;
+	}
+
+	section = calloc(1, sizeof(wld_chunk_section_t));
+	section->blocks = wld_create_block_storage(0, mat_get_block_default_protocol_id_by_type(mat_block_air));
+	memcpy((uint8_t*) section->biomes, (uint8_t*) wld_empty_section.biomes, sizeof(section->biomes));
+
+	// another thread could have created it first
+	wld_chunk_section_t* expected = NULL;
+	if (!atomic_compare_exchange_strong(&chunk->sections[index], &expected, section)) {
+		wld_free_block_storage(section->blocks);
+		free(section);
+		return expected;
+	}
+
+	return section;
+
+}
+
+// reads the chunk from its region file, chunks that aren't saved yet are generated
+static void wld_fill_chunk(wld_chunk_t* chunk) {
+
+	wld_region_t* region = chunk->region;
+
+	const wld_region_file_load_t loaded = region->file == NULL ? wld_region_file_missing : wld_region_file_load_chunk(region->file, chunk);
+
+	if (loaded == wld_region_file_unreadable) {
+		log_error("Could not read chunk %d, %d, it is generated but won't be saved", wld_get_chunk_x(chunk), wld_get_chunk_z(chunk));
+		chunk->unreadable = true;
+	}
+
+	if (loaded != wld_region_file_loaded) {
+
+		// TODO generate actual chunk
+		for (uint32_t g_x  = 0; g_x < 16; ++g_x) {
+			for (uint32_t g_z = 0; g_z < 16; ++g_z) {
+				wld_chunk_section_t* section = wld_chunk_create_section(chunk, (g_x + g_z) >> 4);
+				wld_block_storage_set(&section->blocks, (((g_x + g_z) & 0xF) << 8) | (g_z << 4) | g_x, mat_get_block_default_protocol_id_by_type(mat_block_dirt));
+				section->block_count++;
+			}
+		}
+
+		chunk->dirty = !chunk->unreadable;
+
+	}
+
+}
+
+// loads the chunk if it is still queued, false if another thread took it first
+static bool wld_load_queued_chunk(wld_chunk_t* chunk) {
+
+	wld_chunk_state_t state = wld_chunk_queued;
+	if (!atomic_compare_exchange_strong(&chunk->state, &state, wld_chunk_loading)) {
+		return false;
+	}
+
+	wld_fill_chunk(chunk);
+
+	// set with the chunk locked so callbacks are either added before or called right away
+	bool requested = false;
+	with_lock (&chunk->lock) {
+		chunk->state = wld_chunk_loaded;
+		requested = chunk->requests != NULL;
+	}
+
+	with_lock (&wld_chunk_io.lock) {
+		pthread_cond_broadcast(&wld_chunk_io.loaded);
+	}
+
+	if (requested) {
+		chunk->region->loading++;
+		job_add(job_new(job_chunk_loaded, (job_payload_t) { .chunk = chunk }));
+	}
+
+	return true;
+
+}
+
+static void* t_wld_chunk_io(__attribute__((unused)) void* args) {
+
+	for (;;) {
+
+		wld_chunk_t* chunk = NULL;
+
+		with_lock (&wld_chunk_io.lock) {
+
+			while (wld_chunk_io.queue.length == 0 && wld_chunk_io.running) {
+				pthread_cond_wait(&wld_chunk_io.queued, &wld_chunk_io.lock);
+			}
+
+			if (wld_chunk_io.queue.length != 0) {
+				memcpy(&chunk, utl_list_first(&wld_chunk_io.queue), sizeof(wld_chunk_t*));
+				utl_list_shift(&wld_chunk_io.queue);
+			}
+
 		}
-		if (region->relative.west != NULL) {
-			region->relative.west->relative.east = region;
+
+		// stopped and every queued chunk is loaded
+		if (chunk == NULL) {
+			return NULL;
 		}
-		if (region->relative.east != NULL) {
-			region->relative.east->relative.west = region;
+
+		wld_load_queued_chunk(chunk);
+
+		chunk->region->loading--;
+
+	}
+
+}
+
+// the chunk is counted as loading by the one queueing it
+static void wld_queue_chunk_load(wld_chunk_t* chunk) {
+
+	with_lock (&wld_chunk_io.lock) {
+
+		if (!wld_chunk_io.running) {
+			wld_chunk_io.running = true;
+			for (size_t i = 0; i < WLD_CHUNK_IO_THREADS; ++i) {
+				pthread_create(&wld_chunk_io.threads[i], NULL, t_wld_chunk_io, NULL);
+			}
 		}
-		utl_tree_put(&world->regions, key, region);
-		
-		region->tick = sch_schedule_repeating(tick_job, 1, 1);
+
+		utl_list_push(&wld_chunk_io.queue, &chunk);
+		pthread_cond_signal(&wld_chunk_io.queued);
+
 	}
 
-	return region;
+}
+
+// loads every queued chunk and stops the chunk I/O threads, they start again when another chunk is queued
+static void wld_stop_chunk_io() {
+
+	bool running = false;
+
+	with_lock (&wld_chunk_io.lock) {
+		running = wld_chunk_io.running;
+		wld_chunk_io.running = false;
+		pthread_cond_broadcast(&wld_chunk_io.queued);
+	}
+
+	if (running) {
+		for (size_t i = 0; i < WLD_CHUNK_IO_THREADS; ++i) {
+			pthread_join(wld_chunk_io.threads[i], NULL);
+		}
+	}
 
 }
 
-wld_chunk_t* wld_gen_chunk(wld_region_t* region, uint8_t x, uint8_t z, uint8_t max_ticket) {
+wld_chunk_t* wld_request_chunk(wld_region_t* region, uint8_t x, uint8_t z, uint8_t max_ticket) {
 
 	assert(x < 32 && z < 32);
 
+	wld_chunk_t* chunk = region->chunks[(x << 5) | z];
+
+	if (chunk != NULL) {
+		return chunk;
+	}
+
+	pthread_once(&wld_empty_section_once, wld_init_empty_section);
+
 	const uint16_t chunk_height = mat_get_chunk_height(region->world->environment);
-	wld_chunk_t* chunk = malloc(sizeof(wld_chunk_t) + sizeof(wld_chunk_section_t) * chunk_height);
+	chunk = malloc(sizeof(wld_chunk_t) + sizeof(wld_chunk_section_t*) * chunk_height);
 	
 	wld_chunk_t chunk_init = {
 		.region = region,
 		.lock = PTHREAD_MUTEX_INITIALIZER,
+		.encode_lock = PTHREAD_MUTEX_INITIALIZER,
+		.changes_lock = PTHREAD_MUTEX_INITIALIZER,
+		.changed = false,
+		.state = wld_chunk_queued,
+		.requests = NULL,
+		.saved_epoch = wld_get_save_epoch(region->world),
 		.block_entities = UTL_ID_VECTOR_INITIALIZER(void*), // TODO block entity struct
 		.entities = UTL_ID_VECTOR_INITIALIZER(ent_entity_t*),
 		.players = UTL_BIT_VECTOR_INITIALIZER,
@@ -186,27 +525,151 @@ wld_chunk_t* wld_gen_chunk(wld_region_t* region, uint8_t x, uint8_t z, uint8_t m
 		.ticket = max_ticket
 	};
 	memcpy(chunk, &chunk_init, sizeof(wld_chunk_t)); // coppy init to chunk
-	memset(chunk->sections, 0, sizeof(wld_chunk_section_t) * chunk_height); // set chunk sections to 0
+	memset(chunk->sections, 0, sizeof(wld_chunk_section_t*) * chunk_height); // all sections start empty
+
+	wld_world_t* world = region->world;
+	const int16_t r_x = wld_region_get_x(region);
+	const int16_t r_z = wld_region_get_z(region);
+	wld_chunk_t* expected = NULL;
+	bool added = false;
+	bool unloaded = false;
+
+	// added and counted with the world locked, so the region can't be unloaded before the chunk is counted
+	with_lock (&world->lock) {
 
-	region->chunks[(x << 5) | z] = chunk;
+		unloaded = region->unloaded;
 
-	// TODO generate actual chunk
-	for (uint32_t g_x  = 0; g_x < 16; ++g_x) {
-		for (uint32_t g_z = 0; g_z < 16; ++g_z) {
-			chunk->sections[(g_x + g_z) >> 4].blocks[(((g_x + g_z) & 0xF) << 8) | (g_z << 4) | g_x] = mat_get_block_default_protocol_id_by_type(mat_block_dirt);
-			chunk->sections[(g_x + g_z) >> 4].block_count++;
+		// another thread could have requested it first
+		if (!unloaded && atomic_compare_exchange_strong(&region->chunks[(x << 5) | z], &expected, chunk)) {
+			added = true;
+			region->loading++;
+			if (max_ticket < WLD_TICKET_INACCESSIBLE) {
+				region->loaded_chunks += 1;
+			}
 		}
+
 	}
 
-	// add region
-	if (max_ticket < WLD_TICKET_INACCESSIBLE) {
-		region->loaded_chunks += 1;
+	if (!added) {
+		free(chunk);
 	}
 
+	// the region was unloaded after it was found, the chunk goes in the region that replaces it
+	if (unloaded) {
+		return wld_request_chunk(wld_get_region(world, r_x, r_z), x, z, max_ticket);
+	}
+
+	if (!added) {
+		return expected;
+	}
+
+	wld_queue_chunk_load(chunk);
+
 	return chunk;
 
 }
 
+wld_chunk_t* wld_pin_chunk(wld_world_t* world, int32_t x, int32_t z) {
+
+	const int16_t r_x = x >> 5;
+	const int16_t r_z = z >> 5;
+	wld_region_t* region = NULL;
+
+	while (region == NULL) {
+		with_lock (&world->lock) {
+			region = utl_hash_map_get(&world->regions, wld_region_key(r_x, r_z));
+			if (region != NULL) {
+				region->pinned++;
+			}
+		}
+		if (region == NULL) {
+			wld_gen_region(world, r_x, r_z);
+		}
+	}
+
+	return wld_await_chunk(wld_request_chunk(region, x & 0x1F, z & 0x1F, WLD_TICKET_MAX));
+
+}
+
+void wld_unpin_chunk(wld_chunk_t* chunk) {
+
+	wld_region_t* region = wld_chunk_get_region(chunk);
+
+	// nothing else keeps the region loaded, it was kept from being unloaded by the pin
+	if (--region->pinned == 0 && region->loaded_chunks == 0) {
+		sch_schedule(job_new(job_unload_region, (job_payload_t) { .region = region }), 100);
+	}
+
+}
+
+void wld_wait_chunk_load(wld_chunk_t* chunk) {
+
+	// still queued, the chunk I/O thread will skip it
+	if (wld_load_queued_chunk(chunk)) {
+		return;
+	}
+
+	with_lock (&wld_chunk_io.lock) {
+		while (!wld_chunk_is_loaded(chunk)) {
+			pthread_cond_wait(&wld_chunk_io.loaded, &wld_chunk_io.lock);
+		}
+	}
+
+}
+
+void wld_on_chunk_load(wld_chunk_t* chunk, wld_chunk_callback_t callback, void* arg) {
+
+	bool loaded = false;
+
+	with_lock (&chunk->lock) {
+
+		loaded = wld_chunk_is_loaded(chunk);
+
+		if (!loaded) {
+			wld_chunk_request_t* request = malloc(sizeof(wld_chunk_request_t));
+			request->next = chunk->requests;
+			request->callback = callback;
+			request->arg = arg;
+			chunk->requests = request;
+		}
+
+	}
+
+	if (loaded) {
+		callback(chunk, arg);
+	}
+
+}
+
+static inline void wld_free_chunk_requests(wld_chunk_request_t* request) {
+
+	while (request != NULL) {
+		wld_chunk_request_t* next = request->next;
+		free(request);
+		request = next;
+	}
+
+}
+
+void wld_run_chunk_requests(wld_chunk_t* chunk) {
+
+	wld_chunk_request_t* requests = NULL;
+
+	with_lock (&chunk->lock) {
+		requests = chunk->requests;
+		chunk->requests = NULL;
+	}
+
+	for (wld_chunk_request_t* request = requests; request != NULL; request = request->next) {
+		request->callback(chunk, request->arg);
+	}
+
+	wld_free_chunk_requests(requests);
+
+	chunk->region->loading--;
+
+}
+
 static inline void wld_calc_player_ticket(uint32_t client_id, void* args) {
 	
 	wld_chunk_t* chunk = args;
@@ -239,67 +702,396 @@ void wld_recalc_chunk_ticket_l(wld_chunk_t* chunk) {
 	wld_set_chunk_ticket(chunk, new_ticket);
 }
 
-static inline void wld_set_block_send(uint32_t client_id, void* arg) {
+// copies the blocks of the section before it is written, if its chunk is still waiting to be saved
+static void wld_snapshot_section(wld_chunk_t* chunk, wld_chunk_section_t* section) {
+
+	wld_world_t* world = wld_chunk_get_world(chunk);
+
+	with_lock (&chunk->lock) {
+
+		const uint32_t epoch = wld_get_save_epoch(world);
 
-	pck_packet_t* packet = arg;
-	ltg_client_t* client = ltg_get_client_by_id(sky_get_listener(), client_id);
+		if (wld_is_saving(world) && chunk->saved_epoch != epoch && section->snapshot.epoch != epoch) {
+			if (section->snapshot.blocks != NULL) {
+				wld_free_block_storage(section->snapshot.blocks);
+			}
+			section->snapshot.blocks = wld_copy_block_storage(section->blocks);
+			section->snapshot.epoch = epoch;
+		}
 
-	ltg_send(client, packet);
+	}
 
 }
 
-void wld_set_block_at(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_block_protocol_id_t type) {
+// marks the block as changed, its new state is sent with the other changes of the tick
+static inline void wld_chunk_section_change(wld_chunk_t* chunk, wld_chunk_section_t* section, uint16_t index) {
 
-	const int16_t min_y = mat_get_dimension_by_type(wld_get_environment(wld_chunk_get_world(chunk)))->min_y;
+	with_lock (&chunk->changes_lock) {
 
-	wld_chunk_t* block_chunk = wld_relative_chunk(chunk, (x >> 4) - wld_get_chunk_x(chunk), (z >> 4) - wld_get_chunk_z(chunk));
-	wld_chunk_section_t* section = wld_chunk_get_section(block_chunk, (y - min_y) >> 4);
+		if (section->changes == NULL) {
+			section->changes = calloc(1, sizeof(wld_section_changes_t));
+		}
+
+		// changed again before the changes were sent, only sent once
+		if (!wld_section_changes_has(section->changes, index)) {
+			section->changes->blocks[index >> 6] |= (uint64_t) 1 << (index & 63);
+			section->changes->count++;
+		}
+
+	}
+
+	chunk->changed = true;
+
+}
+
+wld_chunk_section_t* wld_chunk_edit_section(wld_chunk_t* chunk, uint16_t index, bool create) {
+
+	wld_chunk_section_t* section = wld_chunk_get_section(chunk, index);
+
+	if (wld_chunk_section_is_empty(section)) {
+		if (!create) {
+			return NULL;
+		}
+		section = wld_chunk_create_section(chunk, index);
+	}
+
+	if (wld_is_saving(wld_chunk_get_world(chunk)) && chunk->saved_epoch != wld_get_save_epoch(wld_chunk_get_world(chunk))) {
+		wld_snapshot_section(chunk, section);
+	}
+
+	return section;
+
+}
+
+void wld_chunk_section_edited(wld_chunk_t* chunk, wld_chunk_section_t* section, const wld_section_changes_t* changes) {
+
+	with_lock (&chunk->changes_lock) {
+
+		if (section->changes == NULL) {
+			section->changes = malloc(sizeof(wld_section_changes_t));
+			memcpy(section->changes, changes, sizeof(wld_section_changes_t));
+		} else {
+			section->changes->count = 0;
+			for (uint16_t i = 0; i < 4096 / 64; ++i) {
+				section->changes->blocks[i] |= changes->blocks[i];
+				section->changes->count += __builtin_popcountll(section->changes->blocks[i]);
+			}
+		}
+
+	}
+
+	section->encoded.outdated = true;
+	chunk->version++;
+	chunk->dirty = true;
+	chunk->changed = true;
+
+}
+
+bool wld_chunk_take_changes(wld_chunk_t* chunk, wld_section_changes_t** changes) {
+
+	if (!atomic_exchange(&chunk->changed, false)) {
+		return false;
+	}
+
+	const uint16_t chunk_height = mat_get_chunk_height(wld_get_environment(wld_chunk_get_world(chunk)));
+
+	bool changed = false;
+
+	with_lock (&chunk->changes_lock) {
+		for (uint16_t i = 0; i < chunk_height; ++i) {
+			wld_chunk_section_t* section = chunk->sections[i];
+			if (section != NULL && section->changes != NULL) {
+				changes[i] = section->changes;
+				section->changes = NULL;
+				changed = true;
+			} else {
+				changes[i] = NULL;
+			}
+		}
+	}
+
+	return changed;
+
+}
+
+wld_chunk_section_t* wld_chunk_set_block(wld_chunk_t* block_chunk, uint16_t section_index, int32_t x, int16_t y, int32_t z, mat_block_protocol_id_t type) {
+
+	wld_chunk_section_t* section = wld_chunk_get_section(block_chunk, section_index);
 
 	const uint8_t s_x = x & 0xF;
 	const uint8_t s_y = y & 0xF;
 	const uint8_t s_z = z & 0xF;
 
-	const mat_block_protocol_id_t old_type = section->blocks[(s_y << 8) | (s_z << 4) | s_x];
-	const bool old_type_air = mat_get_block_by_type(mat_get_block_type_by_protocol_id(old_type))->air;
 	const bool type_air = mat_get_block_by_type(mat_get_block_type_by_protocol_id(type))->air;
-	if (old_type_air && !type_air) {
-		section->block_count++;
 
-		if (block_chunk->highest.motion_blocking[(s_z << 4) | s_x] < y) {
+	// empty sections are only allocated when something that isn't air is put in them
+	if (wld_chunk_section_is_empty(section) && !type_air) {
+		section = wld_chunk_create_section(block_chunk, section_index);
+	}
+
+	// putting air in an empty section changes nothing
+	if (!wld_chunk_section_is_empty(section)) {
+
+		if (wld_is_saving(wld_chunk_get_world(block_chunk)) && block_chunk->saved_epoch != wld_get_save_epoch(wld_chunk_get_world(block_chunk))) {
+			wld_snapshot_section(block_chunk, section);
+		}
+
+		const mat_block_protocol_id_t old_type = wld_block_storage_set(&section->blocks, (s_y << 8) | (s_z << 4) | s_x, type);
+		const bool old_type_air = mat_get_block_by_type(mat_get_block_type_by_protocol_id(old_type))->air;
+		if (old_type_air && !type_air) {
+			section->block_count++;
+
+			if (block_chunk->highest.world_surface[(s_z << 4) | s_x] < y) {
+				block_chunk->highest.world_surface[(s_z << 4) | s_x] = y;
+			}
+		} else if (!old_type_air && type_air) {
+			section->block_count--;
+
+			if (block_chunk->highest.motion_blocking[(s_z << 4) | s_x] == y) {
+				// TODO calculate new highest motion_blocking block
+			}
+		}
+
+		if (block_chunk->highest.motion_blocking[(s_z << 4) | s_x] < y && wld_is_motion_blocking(mat_get_shape_table(), type)) {
 			block_chunk->highest.motion_blocking[(s_z << 4) | s_x] = y;
 		}
-	} else if (!old_type_air && type_air) {
-		section->block_count--;
 
-		if (block_chunk->highest.motion_blocking[(s_z << 4) | s_x] == y) {
-			// TODO calculate new highest motion_blocking block
+		section->encoded.outdated = true;
+		block_chunk->version++;
+		block_chunk->dirty = true;
+
+		if (old_type != type) {
+			wld_chunk_section_change(block_chunk, section, (s_y << 8) | (s_z << 4) | s_x);
 		}
+
 	}
-	section->blocks[(s_y << 8) | (s_z << 4) | s_x] = type;
 
-	// send block to player
-	PCK_INLINE(packet, 14, io_big_endian);
-	pck_write_var_int(packet, 0x0C);
-	pck_write_position(packet, (pck_position_t) {
-		.x = x,
-		.y = y,
-		.z = z
-	});
-	pck_write_var_int(packet, type);
+	return section;
+
+}
+
+void wld_set_block_at(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_block_protocol_id_t type) {
+
+	const int16_t min_y = mat_get_dimension_by_type(wld_get_environment(wld_chunk_get_world(chunk)))->min_y;
+
+	wld_chunk_t* block_chunk = wld_relative_chunk(chunk, (x >> 4) - wld_get_chunk_x(chunk), (z >> 4) - wld_get_chunk_z(chunk));
+
+	wld_chunk_set_block(block_chunk, (y - min_y) >> 4, x, y, z, type);
+
+}
+
+ltg_broadcast_t* wld_get_cached_chunk_packet(wld_chunk_t* chunk, uint32_t version) {
+
+	ltg_broadcast_t* packet = NULL;
+
+	with_lock (&wld_cached_chunk_packets.lock) {
+
+		if (chunk->cached.packet != NULL && chunk->cached.version == version) {
+
+			packet = chunk->cached.packet;
+			ltg_broadcast_retain(packet);
+
+			// move to the back of the list
+			utl_dll_remove(&wld_cached_chunk_packets.chunks, chunk->cached.node);
+			chunk->cached.node = utl_dll_push(&wld_cached_chunk_packets.chunks, chunk);
+
+		}
+
+	}
 
-	utl_bit_vector_foreach(&block_chunk->subscribers, wld_set_block_send, packet);
+	return packet;
 
 }
 
-void wld_unload_region(wld_region_t* region) {
+static inline void wld_uncache_chunk_packet_l(wld_chunk_t* chunk) {
+
+	if (chunk->cached.packet != NULL) {
+		utl_dll_remove(&wld_cached_chunk_packets.chunks, chunk->cached.node);
+		ltg_broadcast_release(chunk->cached.packet);
+		chunk->cached.packet = NULL;
+	}
+
+}
+
+void wld_uncache_chunk_packet(wld_chunk_t* chunk) {
+
+	with_lock (&wld_cached_chunk_packets.lock) {
+		wld_uncache_chunk_packet_l(chunk);
+	}
+
+}
+
+void wld_cache_chunk_packet(wld_chunk_t* chunk, uint32_t version, ltg_broadcast_t* packet) {
+
+	with_lock (&wld_cached_chunk_packets.lock) {
+
+		wld_uncache_chunk_packet_l(chunk);
+
+		// evict the least recently sent
+		if (utl_dll_length(&wld_cached_chunk_packets.chunks) == WLD_MAX_CACHED_CHUNK_PACKETS) {
+			wld_chunk_t* evicted = utl_dll_shift(&wld_cached_chunk_packets.chunks);
+			ltg_broadcast_release(evicted->cached.packet);
+			evicted->cached.packet = NULL;
+		}
+
+		ltg_broadcast_retain(packet);
+		chunk->cached.packet = packet;
+		chunk->cached.version = version;
+		chunk->cached.node = utl_dll_push(&wld_cached_chunk_packets.chunks, chunk);
+
+	}
+
+}
+
+static inline void wld_free_section_snapshot(wld_chunk_section_t* section) {
+
+	if (section->snapshot.blocks != NULL) {
+		wld_free_block_storage(section->snapshot.blocks);
+		section->snapshot.blocks = NULL;
+	}
+
+}
+
+// saves the chunk as it was when the save with the epoch started, or as it is when no save is running
+static void wld_save_chunk(wld_chunk_t* chunk, uint32_t epoch) {
+
+	wld_world_t* world = wld_chunk_get_world(chunk);
+	const uint16_t chunk_height = mat_get_chunk_height(wld_get_environment(world));
+
+	byte_t* bytes = NULL;
+	size_t length = 0;
+	bool written = false;
+
+	with_lock (&chunk->lock) {
+
+		const bool saving = wld_is_saving(world);
+
+		// saved once by a save, and every time outside of one
+		if (chunk->saved_epoch != epoch || !saving) {
+
+			for (uint16_t i = 0; i < chunk_height; ++i) {
+				wld_chunk_section_t* section = chunk->sections[i];
+				if (section == NULL || section->snapshot.blocks == NULL || section->snapshot.epoch != epoch) {
+					continue;
+				}
+				if (saving) {
+					// sections with a snapshot were written during the save, so the chunk stays dirty
+					written = true;
+				} else {
+					// outside of a save the chunk is saved as it is
+					wld_free_section_snapshot(section);
+					chunk->dirty = true;
+				}
+			}
+
+			// chunks still loading are saved next time
+			if (wld_chunk_is_loaded(chunk) && !chunk->unreadable && (chunk->dirty || written)) {
+				// cleared first, so changes made while saving are saved next time
+				chunk->dirty = false;
+				bytes = wld_region_file_encode_chunk(chunk, &length);
+			}
+
+			chunk->saved_epoch = epoch;
+
+			for (uint16_t i = 0; i < chunk_height; ++i) {
+				wld_chunk_section_t* section = chunk->sections[i];
+				if (section != NULL) {
+					wld_free_section_snapshot(section);
+				}
+			}
+
+		}
+
+	}
+
+	if (written) {
+		chunk->dirty = true;
+	}
+
+	// compressed and written without the chunk locked
+	if (bytes != NULL && !wld_region_file_write_chunk(wld_chunk_get_region(chunk)->file, chunk, bytes, length)) {
+		chunk->dirty = true;
+	}
+
+}
+
+static void wld_save_region(wld_region_t* region, uint32_t epoch) {
+
+	if (region->file == NULL) {
+		return;
+	}
+
+	for (size_t i = 0; i < 32 * 32; ++i) {
+		wld_chunk_t* chunk = region->chunks[i];
+		if (chunk != NULL) {
+			wld_save_chunk(chunk, epoch);
+		}
+	}
+
+}
+
+void wld_save(wld_world_t* world) {
+
+	wld_save_level(world);
+
+	bool started = false;
+	uint32_t epoch = 0;
+	size_t region_count = 0;
+	wld_region_t** regions = NULL;
+
+	// regions are unloaded with the world locked and not while it's saving, so the regions listed here stay until the save is done
+	with_lock (&world->lock) {
+
+		// one save at a time
+		bool saving = false;
+		started = atomic_compare_exchange_strong(&world->saving, &saving, true);
+
+		if (started) {
+
+			// chunks are waiting to be saved from here, until they are saved
+			epoch = ++world->save_epoch;
+
+			regions = malloc(sizeof(wld_region_t*) * (utl_hash_map_length(&world->regions) + 1));
+			region_count = utl_hash_map_values(&world->regions, (void**) regions);
+
+		}
+
+	}
+
+	if (!started) {
+		return;
+	}
+
+	for (size_t i = 0; i < region_count; ++i) {
+		wld_save_region(regions[i], epoch);
+	}
+
+	free(regions);
+
+	world->saving = false;
+
+}
+
+bool wld_unload_region(wld_region_t* region) {
 
 	// unload region crashes sometimes on stop server TODO
 
+	bool unloaded = false;
+
+	// chunks are added and saves are started with the world locked, so none can start between the check and the region being taken out
 	with_lock (&region->world->lock) {
-		utl_tree_remove(&region->world->regions, ((uint64_t) wld_region_get_x(region) << 16) | (uint64_t) wld_region_get_z(region));
+		if (region->loaded_chunks == 0 && region->loading == 0 && region->pinned == 0 && !wld_is_saving(region->world)) {
+			region->unloaded = true;
+			utl_hash_map_remove(&region->world->regions, wld_region_key(wld_region_get_x(region), wld_region_get_z(region)));
+			unloaded = true;
+		}
 	}
 
-	wld_free_region(region);
+	if (unloaded) {
+		wld_free_region(region);
+	}
+
+	return unloaded;
 
 }
 
@@ -323,15 +1115,42 @@ void wld_free_region(wld_region_t* region) {
 	}
 	
 	sch_cancel(region->tick);
+	sch_cancel(region->update_blocks);
+
+	ent_term_store(&region->entities);
+
+	// regions are only freed while the world isn't saving, so the epoch is the one of the last save
+	wld_save_region(region, wld_get_save_epoch(region->world));
+	if (region->file != NULL) {
+		wld_close_region_file(region->file);
+	}
+
+	const uint16_t chunk_height = mat_get_chunk_height(region->world->environment);
 
 	for (size_t i = 0; i < 32 * 32; ++i) {
 		wld_chunk_t* chunk = region->chunks[i];
 		if (chunk != NULL) {
 			pthread_mutex_destroy(&chunk->lock);
+			pthread_mutex_destroy(&chunk->encode_lock);
+			pthread_mutex_destroy(&chunk->changes_lock);
+			with_lock (&wld_cached_chunk_packets.lock) {
+				wld_uncache_chunk_packet_l(chunk);
+			}
+			for (uint16_t j = 0; j < chunk_height; ++j) {
+				wld_chunk_section_t* section = chunk->sections[j];
+				if (section != NULL) {
+					wld_free_section_snapshot(section);
+					wld_free_block_storage(section->blocks);
+					free(section->encoded.bytes);
+					free(section->changes);
+					free(section);
+				}
+			}
 			utl_term_bit_vector(&chunk->subscribers);
 			utl_term_bit_vector(&chunk->players);
 			utl_term_id_vector(&chunk->entities);
 			utl_term_id_vector(&chunk->block_entities);
+			wld_free_chunk_requests(chunk->requests);
 			free(chunk);
 		}
 	}
@@ -345,13 +1164,22 @@ void wld_unload(wld_world_t* world) {
 	utl_id_vector_remove(&wld_worlds, world->id);
 
 	sch_cancel(world->tick);
+	sch_cancel(world->autosave);
+
+	// chunks still being loaded are finished before they are saved
+	wld_stop_chunk_io();
+
+	log_info("Saving world \"%s\"...", UTL_STRTOCSTR(world->name));
+
+	wld_save_level(world);
 
 	with_lock (&world->lock) {
-		wld_region_t* region;
-		while ((region = utl_tree_shift(&world->regions)) != NULL) {
-			wld_free_region(region);
+		wld_region_t* regions[utl_hash_map_length(&world->regions) + 1];
+		const uint32_t region_count = utl_hash_map_values(&world->regions, (void**) regions);
+		for (uint32_t i = 0; i < region_count; ++i) {
+			wld_free_region(regions[i]);
 		}
-		utl_term_tree(&world->regions);
+		utl_term_hash_map(&world->regions);
 	}
 	
 	pthread_mutex_destroy(&world->lock);
@@ -4,9 +4,33 @@ typedef struct wld_world wld_world_t;
 typedef struct wld_region wld_region_t;
 typedef struct wld_chunk wld_chunk_t;
 typedef struct wld_chunk_section wld_chunk_section_t;
+typedef struct wld_block_storage wld_block_storage_t;
+typedef struct wld_region_file wld_region_file_t;
+typedef struct wld_chunk_request wld_chunk_request_t;
+typedef struct wld_cursor wld_cursor_t;
+typedef struct wld_section_changes wld_section_changes_t;
+typedef struct wld_edit wld_edit_t;
+typedef struct wld_clipboard wld_clipboard_t;
+
+// called once the chunk is loaded
+typedef void (*wld_chunk_callback_t) (wld_chunk_t* chunk, void* arg);
+
+typedef enum {
+
+	wld_chunk_queued,
+	wld_chunk_loading,
+	wld_chunk_loaded
+
+} wld_chunk_state_t;
 
 #define WLD_TICKET_TICK_ENTITIES 12
 #define WLD_TICKET_TICK 13
 #define WLD_TICKET_BORDER 14
 #define WLD_TICKET_INACCESSIBLE 15
-#define WLD_TICKET_MAX 15
\ No newline at end of file
+#define WLD_TICKET_MAX 15
+
+#define WLD_MAX_CACHED_CHUNK_PACKETS 2048 // chunk data packets kept ready to send
+#define WLD_AUTOSAVE_INTERVAL 6000 // ticks between saves of every changed chunk
+#define WLD_DATA_VERSION 2860 // the data version of 1.18, saved with chunks and level.dat, chunks of other versions aren't loaded since their block ids differ
+#define WLD_CHUNK_IO_THREADS 2 // threads reading and generating chunks
+#define WLD_SECTION_RESEND_CHANGES 1024 // blocks of a section changed in a tick after which the whole chunk is sent again
\ No newline at end of file
@@ -4,28 +4,71 @@
 
 #include "world.d.h"
 #include "entity/entity.d.h"
+#include "../listening/listening.d.h"
 
 #include "../main.h"
 #include "../util/id_vector.h"
 #include "../util/bit_vector.h"
-#include "../util/tree.h"
+#include "../util/hash_map.h"
 #include "../util/lock_util.h"
 #include "../util/util.h"
 #include "../jobs/board.h"
 #include "../jobs/scheduler/scheduler.h"
 #include "material/material.h"
+#include "material/shapes.h"
+#include "storage.h"
+#include "entity/store.h"
 
 struct wld_chunk_section {
 
-	// block map
-	_Atomic mat_block_protocol_id_t blocks[16 * 16 * 16];
-	_Atomic uint16_t entity_idx[16 * 16 * 16];
+	// block map, replaced by a bigger storage when its palette is full
+	wld_block_storage_t* _Atomic blocks;
 
 	atomic_uint_fast16_t block_count;
 
 	// biome map
 	_Atomic uint8_t biomes[4 * 4 * 4];
 
+	// the blocks as they were when the save with this epoch started
+	// copied the first time the section is written while its chunk waits to be saved, guarded by the chunk's lock
+	struct {
+
+		wld_block_storage_t* blocks;
+		uint32_t epoch;
+
+	} snapshot;
+
+	// block states and biomes as they are sent in chunk data, shared by every client the chunk is sent to
+	// guarded by the chunk's encode lock, rebuilt when outdated
+	struct {
+
+		byte_t* bytes;
+		uint32_t length;
+
+		_Atomic bool outdated;
+
+	} encoded;
+
+	// blocks changed since the chunk's changes were last sent, guarded by the chunk's changes lock
+	wld_section_changes_t* changes;
+
+};
+
+struct wld_section_changes {
+
+	// a bit for every block in the section
+	uint64_t blocks[4096 / 64];
+	uint16_t count;
+
+};
+
+struct wld_chunk_request {
+
+	wld_chunk_request_t* next;
+
+	wld_chunk_callback_t callback;
+	void* arg;
+
 };
 
 struct wld_chunk {
@@ -34,6 +77,42 @@ struct wld_chunk {
 
 	pthread_mutex_t lock;
 
+	// chunks are published before they are read or generated, so they can be requested without waiting
+	_Atomic wld_chunk_state_t state;
+
+	// callbacks waiting for the chunk to load, guarded by lock
+	wld_chunk_request_t* requests;
+
+	// guards the encoded sections
+	pthread_mutex_t encode_lock;
+
+	// guards the changes of the sections
+	pthread_mutex_t changes_lock;
+
+	// set when a block changes, cleared when the changes are sent at the end of the tick
+	_Atomic bool changed;
+
+	// increased every time a block in the chunk changes
+	_Atomic uint32_t version;
+
+	// set when the chunk changes, cleared when it is saved to its region file
+	_Atomic bool dirty;
+
+	// set when the chunk in the region file couldn't be read, the chunk is then never saved so it isn't written over
+	bool unreadable;
+
+	// the epoch of the last save that saved or skipped the chunk, guarded by lock
+	_Atomic uint32_t saved_epoch;
+
+	// the last chunk data packet built for the chunk, guarded by the cached chunk packets lock
+	struct {
+
+		ltg_broadcast_t* packet;
+		uint32_t version;
+		uint32_t node;
+
+	} cached;
+
 	// subscribers are "subscribed" to updates in the chunk
 	utl_bit_vector_t subscribers;
 
@@ -60,7 +139,9 @@ struct wld_chunk {
 	_Atomic uint8_t ticket;
 	const uint8_t max_ticket;
 
-	wld_chunk_section_t sections[]; // y = section index * 16, count of sections = World.height / 16
+	// y = section index * 16, count of sections = World.height / 16
+	// sections are NULL until something is put in them
+	wld_chunk_section_t* _Atomic sections[];
 
 };
 
@@ -68,11 +149,18 @@ struct wld_region {
 	
 	wld_world_t* const world; // typeof wld_world_t*
 
+	// NULL if it couldn't be opened, the region isn't saved then
+	wld_region_file_t* file;
+
 	uint32_t tick;
+	uint32_t update_blocks;
 
 	// chunks
 	wld_chunk_t* _Atomic chunks[32 * 32];
 
+	// entities in the chunks, for the region tick
+	ent_store_t entities;
+
 	// relative regions
 	struct {
 
@@ -85,6 +173,15 @@ struct wld_region {
 
 	atomic_uint_fast16_t loaded_chunks;
 
+	// chunks queued to load or waiting to run their callbacks, the region can't be unloaded until they are done
+	atomic_uint_fast16_t loading;
+
+	// chunks used by edits without a ticket, the region can't be unloaded until they are unpinned
+	atomic_uint_fast16_t pinned;
+
+	// set with the world locked when the region is taken out of the world, no chunks are added to it after that
+	bool unloaded;
+
 	const int16_t x;
 	const int16_t z;
 };
@@ -100,8 +197,8 @@ struct wld_world {
 
 	const string_t name;
 
-	// regions
-	utl_tree_t regions;
+	// regions by wld_region_key, looked up without locking, changed with the world locked
+	utl_hash_map_t regions;
 
 	const struct {
 
@@ -111,6 +208,11 @@ struct wld_world {
 	} spawn;
 	
 	uint32_t tick;
+	uint32_t autosave;
+
+	// increased every time a save starts, sections written during a save are copied before they are changed
+	_Atomic uint32_t save_epoch;
+	_Atomic bool saving;
 	
 	_Atomic uint16_t time;
 	const uint16_t id;
@@ -170,6 +272,14 @@ static inline bool wld_is_time_progressing(wld_world_t* world) {
 	return world->time_progressing;
 }
 
+static inline uint32_t wld_get_save_epoch(wld_world_t* world) {
+	return world->save_epoch;
+}
+
+static inline bool wld_is_saving(wld_world_t* world) {
+	return world->saving;
+}
+
 extern uint16_t wld_get_count();
 extern uint16_t wld_get_length();
 extern wld_world_t* wld_get_world(uint16_t world_id);
@@ -178,15 +288,16 @@ static inline wld_world_t* wld_get_default() {
 	return wld_get_world(0);
 }
 
+static inline uint32_t wld_region_key(int16_t x, int16_t z) {
+	return ((uint32_t) (uint16_t) x << 16) | (uint16_t) z;
+}
+
+// creates the region, or gets it if another thread created it first
 extern wld_region_t* wld_gen_region(wld_world_t* world, int16_t x, int16_t z);
 
 static inline wld_region_t* wld_get_region(wld_world_t* world, int16_t x, int16_t z) {
 
-	wld_region_t* region = NULL;
-
-	with_lock (&world->lock) {
-		region = utl_tree_get(&world->regions, ((uint64_t) (uint16_t) x << 16) | (uint16_t) z);
-	}
+	wld_region_t* region = utl_hash_map_get(&world->regions, wld_region_key(x, z));
 
 	if (region == NULL) {
 		region = wld_gen_region(world, x, z);
@@ -224,9 +335,40 @@ static inline uint_fast16_t wld_region_get_loaded_chunks(wld_region_t* region) {
 	return region->loaded_chunks;
 }
 
-extern wld_chunk_t* wld_gen_chunk(wld_region_t* region, uint8_t x, uint8_t z, uint8_t max_ticket);
+// gets the chunk without waiting for it, chunks that don't exist yet are queued to be loaded by the chunk I/O threads
+extern wld_chunk_t* wld_request_chunk(wld_region_t* region, uint8_t x, uint8_t z, uint8_t max_ticket);
 
-static inline wld_chunk_t* wld_get_chunk(wld_world_t* world, int32_t x, int32_t z) {
+static inline bool wld_chunk_is_loaded(const wld_chunk_t* chunk) {
+	return chunk->state == wld_chunk_loaded;
+}
+
+// loads the chunk on this thread if no chunk I/O thread took it yet, otherwise waits for it
+extern void wld_wait_chunk_load(wld_chunk_t* chunk);
+
+static inline wld_chunk_t* wld_await_chunk(wld_chunk_t* chunk) {
+
+	if (!wld_chunk_is_loaded(chunk)) {
+		wld_wait_chunk_load(chunk);
+	}
+
+	return chunk;
+
+}
+
+/*
+ * Calls the callback once the chunk is loaded, right away if it already is
+ * otherwise it is called by a job on a worker
+ */
+extern void wld_on_chunk_load(wld_chunk_t* chunk, wld_chunk_callback_t callback, void* arg);
+
+// runs the callbacks of a chunk that finished loading, called by the chunk loaded job
+extern void wld_run_chunk_requests(wld_chunk_t* chunk);
+
+static inline wld_chunk_t* wld_gen_chunk(wld_region_t* region, uint8_t x, uint8_t z, uint8_t max_ticket) {
+	return wld_await_chunk(wld_request_chunk(region, x, z, max_ticket));
+}
+
+static inline wld_chunk_t* wld_request_world_chunk(wld_world_t* world, int32_t x, int32_t z) {
 
 	wld_region_t* region = wld_get_region(world, x >> 5, z >> 5);
 
@@ -237,7 +379,7 @@ static inline wld_chunk_t* wld_get_chunk(wld_world_t* world, int32_t x, int32_t
 
 	if (chunk == NULL) {
 
-		chunk = wld_gen_chunk(region, c_x, c_z, WLD_TICKET_MAX);
+		chunk = wld_request_chunk(region, c_x, c_z, WLD_TICKET_MAX);
 
 	}
 
@@ -247,6 +389,17 @@ static inline wld_chunk_t* wld_get_chunk(wld_world_t* world, int32_t x, int32_t
 
 }
 
+static inline wld_chunk_t* wld_get_chunk(wld_world_t* world, int32_t x, int32_t z) {
+	return wld_await_chunk(wld_request_world_chunk(world, x, z));
+}
+
+/*
+ * Gets the chunk and keeps its region from being unloaded until the chunk is unpinned
+ * the region is found and pinned with the world locked, so it can't be unloaded in between
+ */
+extern wld_chunk_t* wld_pin_chunk(wld_world_t* world, int32_t x, int32_t z);
+extern void wld_unpin_chunk(wld_chunk_t* chunk);
+
 static inline wld_chunk_t* wld_get_chunk_at(wld_world_t* world, int32_t x, int32_t z) {
 	return wld_get_chunk(world, x >> 4, z >> 4);
 }
@@ -255,6 +408,11 @@ static inline wld_region_t* wld_chunk_get_region(const wld_chunk_t* chunk) {
 	return chunk->region;
 }
 
+// index of the chunk in the chunks of its region
+static inline uint16_t wld_chunk_get_region_idx(const wld_chunk_t* chunk) {
+	return (chunk->x << 5) | chunk->z;
+}
+
 static inline wld_world_t* wld_chunk_get_world(const wld_chunk_t* chunk) {
 	return wld_region_get_world(wld_chunk_get_region(chunk));
 }
@@ -290,7 +448,8 @@ static inline int32_t wld_get_chunk_z(const wld_chunk_t* chunk) {
 	return (wld_region_get_z(wld_chunk_get_region(chunk)) << 5) | chunk->z;
 }
 
-static inline wld_chunk_t* wld_gen_relative_chunk(const wld_chunk_t* chunk, int16_t x, int16_t z, uint8_t max_ticket) {
+// gets the relative chunk without waiting for it to load
+static inline wld_chunk_t* wld_request_relative_chunk(const wld_chunk_t* chunk, int16_t x, int16_t z, uint8_t max_ticket) {
 	
 	const int32_t f_x = x + wld_get_chunk_x(chunk);
 	const int32_t f_z = z + wld_get_chunk_z(chunk);
@@ -308,17 +467,22 @@ static inline wld_chunk_t* wld_gen_relative_chunk(const wld_chunk_t* chunk, int1
 	wld_region_t* region = wld_chunk_get_region(chunk);
 	wld_world_t* world = region->world;
 
+	// regions further than the next one over are quicker to look up
+	if (r_x < -1 || r_x > 1 || r_z < -1 || r_z > 1) {
+		return wld_request_world_chunk(world, f_x, f_z);
+	}
+
 	while (r_x < 0) {
 		region = region->relative.west;
 		if (region == NULL) {
-			return wld_get_chunk(world, f_x, f_z);
+			return wld_request_world_chunk(world, f_x, f_z);
 		}
 		r_x++;
 	}
 	while (r_x > 0) {
 		region = region->relative.east;
 		if (region == NULL) {
-			return wld_get_chunk(world, f_x, f_z);
+			return wld_request_world_chunk(world, f_x, f_z);
 		}
 		
 		r_x--;
@@ -327,21 +491,21 @@ static inline wld_chunk_t* wld_gen_relative_chunk(const wld_chunk_t* chunk, int1
 	while (r_z < 0) {
 		region = region->relative.north;
 		if (region == NULL) {
-			return wld_get_chunk(world, f_x, f_z);
+			return wld_request_world_chunk(world, f_x, f_z);
 		}
 		r_z++;
 	}
 	while (r_z > 0) {
 		region = region->relative.south;
 		if (region == NULL) {
-			return wld_get_chunk(world, f_x, f_z);
+			return wld_request_world_chunk(world, f_x, f_z);
 		}
 		r_z--;
 	}
 
 	wld_chunk_t* found_chunk = region->chunks[idx];
 	if (found_chunk == NULL) {
-		found_chunk = wld_gen_chunk(region, i_x, i_z, max_ticket);
+		found_chunk = wld_request_chunk(region, i_x, i_z, max_ticket);
 	}
 
 	assert(found_chunk != NULL);
@@ -350,7 +514,13 @@ static inline wld_chunk_t* wld_gen_relative_chunk(const wld_chunk_t* chunk, int1
 
 }
 
-// This is fast for short distances (within regions to a few regions over), but for long distances this is excruciatingly slow
+static inline wld_chunk_t* wld_gen_relative_chunk(const wld_chunk_t* chunk, int16_t x, int16_t z, uint8_t max_ticket) {
+
+	return wld_await_chunk(wld_request_relative_chunk(chunk, x, z, max_ticket));
+
+}
+
+// This follows the relative links for neighbouring regions, and looks further regions up in the world's region map
 static inline wld_chunk_t* wld_relative_chunk(const wld_chunk_t* chunk, int32_t x, int32_t z) {
 
 	return wld_gen_relative_chunk(chunk, x, z, WLD_TICKET_MAX);
@@ -376,8 +546,10 @@ static inline void wld_unsubscribe_chunk(wld_chunk_t* chunk, uint32_t client_id)
 static inline void wld_set_chunk_ticket(wld_chunk_t* chunk, uint8_t ticket) {
 	ticket = UTL_MIN(chunk->max_ticket, ticket);
 	if (chunk->ticket == WLD_TICKET_INACCESSIBLE && ticket < WLD_TICKET_INACCESSIBLE) {
-		// loading chunk
-		wld_chunk_get_region(chunk)->loaded_chunks += 1;
+		// loading chunk, counted with the world locked so the region can't be unloaded at the same time
+		with_lock (&wld_chunk_get_world(chunk)->lock) {
+			wld_chunk_get_region(chunk)->loaded_chunks += 1;
+		}
 	} else if (chunk->ticket < WLD_TICKET_INACCESSIBLE && ticket == WLD_TICKET_INACCESSIBLE) {
 		// unloading chunk
 		wld_chunk_get_region(chunk)->loaded_chunks -= 1;
@@ -411,10 +583,32 @@ static inline void wld_remove_player_chunk(wld_chunk_t* chunk, uint32_t client_i
 	}
 }
 
+static inline uint32_t wld_chunk_get_version(wld_chunk_t* chunk) {
+	return chunk->version;
+}
+
+// the section every empty section points to, it should never be modified
+extern wld_chunk_section_t wld_empty_section;
+
+static inline bool wld_chunk_section_is_empty(const wld_chunk_section_t* section) {
+	return section == &wld_empty_section;
+}
+
 static inline wld_chunk_section_t* wld_chunk_get_section(wld_chunk_t* chunk, uint16_t index) {
-	return &chunk->sections[index];
+
+	wld_chunk_section_t* section = chunk->sections[index];
+
+	if (section == NULL) {
+		return &wld_empty_section;
+	}
+
+	return section;
+
 }
 
+// gets a section that can be modified, allocating it if it is empty
+extern wld_chunk_section_t* wld_chunk_create_section(wld_chunk_t* chunk, uint16_t index);
+
 static inline uint_fast16_t wld_chunk_section_get_block_count(wld_chunk_section_t* section) {
 	return section->block_count;
 }
@@ -423,8 +617,19 @@ static inline uint8_t wld_chunk_section_get_biome(wld_chunk_section_t* section,
 	return section->biomes[(x << 4) + (z << 2) + y];
 }
 
-static inline mat_block_protocol_id_t* wld_chunk_section_get_blocks(wld_chunk_section_t* section) {
-	return (mat_block_protocol_id_t*) section->blocks;
+static inline wld_block_storage_t* wld_chunk_section_get_blocks(wld_chunk_section_t* section) {
+	return section->blocks;
+}
+
+// the blocks to save, the copy made before the section was written if it was written during the save
+static inline wld_block_storage_t* wld_chunk_section_get_saved_blocks(wld_chunk_section_t* section, uint32_t epoch) {
+
+	if (section->snapshot.blocks != NULL && section->snapshot.epoch == epoch) {
+		return section->snapshot.blocks;
+	}
+
+	return section->blocks;
+
 }
 
 static inline uint8_t* wld_chunk_section_get_biomes(wld_chunk_section_t* section) {
@@ -447,6 +652,15 @@ static inline int16_t* wld_chunk_get_highest_world_surface(wld_chunk_t* chunk) {
 	return (int16_t*) chunk->highest.world_surface;
 }
 
+// blocks that raise the motion blocking heightmap, the ones entities collide with and fluids, any block but air raises the world surface
+static inline bool wld_is_motion_blocking(const uint8_t* shapes, mat_block_protocol_id_t block) {
+
+	const mat_block_t* type = mat_get_block_by_type(mat_get_block_type_by_protocol_id(block));
+
+	return shapes[block] != mat_shape_empty || type->water || type->lava;
+
+}
+
 static inline uint32_t wld_chunk_add_entity(wld_chunk_t* chunk, ent_entity_t* entity) {
 	
 	uint32_t chunk_node = 0;
@@ -489,7 +703,7 @@ static inline mat_block_protocol_id_t wld_get_block_at(wld_chunk_t* chunk, int32
 	wld_chunk_t* block_chunk = wld_relative_chunk(chunk, (x >> 4) - wld_get_chunk_x(chunk), (z >> 4) - wld_get_chunk_z(chunk));
 	wld_chunk_section_t* section = wld_chunk_get_section(block_chunk, (y - min_y) >> 4);
 
-	return section->blocks[((y & 0xF) << 8) | ((z & 0xF) << 4) | (x & 0xF)];
+	return wld_block_storage_get(section->blocks, ((y & 0xF) << 8) | ((z & 0xF) << 4) | (x & 0xF));
 
 }
 
@@ -499,6 +713,8 @@ static inline mat_block_type_t wld_get_block_type_at(wld_chunk_t* chunk, int32_t
 
 }
 
+// sets a block in the chunk itself, in the section with the index given, returns the section (it is created for blocks that aren't air)
+extern wld_chunk_section_t* wld_chunk_set_block(wld_chunk_t* chunk, uint16_t section, int32_t x, int16_t y, int32_t z, mat_block_protocol_id_t type);
 extern void wld_set_block_at(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_block_protocol_id_t type);
 
 static inline void wld_set_block_type_at(wld_chunk_t* chunk, int32_t x, int16_t y, int32_t z, mat_block_type_t type) {
@@ -507,7 +723,35 @@ static inline void wld_set_block_type_at(wld_chunk_t* chunk, int32_t x, int16_t
 
 }
 
-extern void wld_unload_region(wld_region_t* region);
+/*
+ * Gets the section ready to have its blocks written directly, for writing many blocks at once
+ * it is copied first if its chunk is waiting to be saved, empty sections are created if create is set and NULL otherwise
+ */
+extern wld_chunk_section_t* wld_chunk_edit_section(wld_chunk_t* chunk, uint16_t index, bool create);
+
+// records blocks written directly to the section, they are sent with the other changes of the tick
+extern void wld_chunk_section_edited(wld_chunk_t* chunk, wld_chunk_section_t* section, const wld_section_changes_t* changes);
+
+// moves the changes of every section out of the chunk into the array given (one for each section, NULL if it didn't change), false if nothing changed
+extern bool wld_chunk_take_changes(wld_chunk_t* chunk, wld_section_changes_t** changes);
+
+static inline bool wld_section_changes_has(const wld_section_changes_t* changes, uint16_t index) {
+	return (changes->blocks[index >> 6] >> (index & 63)) & 1;
+}
+
+// returns the cached chunk data packet (retained) if it is still the same version, NULL otherwise
+extern ltg_broadcast_t* wld_get_cached_chunk_packet(wld_chunk_t* chunk, uint32_t version);
+extern void wld_cache_chunk_packet(wld_chunk_t* chunk, uint32_t version, ltg_broadcast_t* packet);
+extern void wld_uncache_chunk_packet(wld_chunk_t* chunk);
+
+/*
+ * Saves every chunk in the world that changed since it was last saved, as they were when the save started
+ * the world isn't locked while chunks are saved, sections written before their chunk is saved are copied first
+ */
+extern void wld_save(wld_world_t* world);
+
+// unloads the region if none of its chunks are loaded, loading, pinned or being saved, false when it can't be unloaded yet
+extern bool wld_unload_region(wld_region_t* region);
 extern void wld_free_region(wld_region_t* region);
 extern void wld_unload(wld_world_t* world);
 extern void wld_unload_all();
\ No newline at end of file